@@ -0,0 +1,52 @@
+/*
+	Engine Tests
+
+	Checks of the parts of the renderer that run on the CPU. GPU objects are replaced by small fakes,
+	so no window or context is created.
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Log.h"
+
+namespace ge {
+
+	// Counts the failed checks of a group and logs each result
+	class TestContext
+	{
+	public:
+		TestContext(const char* group) : m_Group(group) {}
+
+		bool Check(bool passed, const char* name)
+		{
+			if (passed)
+			{
+				GE_INFO("[PASS] {0}: {1}", m_Group, name);
+			}
+			else
+			{
+				GE_ERROR("[FAIL] {0}: {1}", m_Group, name);
+				m_Failed++;
+			}
+			return passed;
+		}
+
+		int GetFailed() const { return m_Failed; }
+	private:
+		const char* m_Group;
+		int m_Failed = 0;
+	};
+
+	// Each returns the number of failed checks
+	int RunRenderQueueTests();
+	int RunTextureStreamerTests();
+	int RunRenderGraphTests();
+	int RunMeshArenaTests();
+	int RunMeshOptimizerTests();
+	int RunTextureCookingTests();
+	int RunIBLBakerTests();
+	int RunFrustumTests();
+	int RunOcclusionCullerTests();
+	int RunSoftwareRendererTests();
+
+}
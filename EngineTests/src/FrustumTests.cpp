@@ -0,0 +1,162 @@
+/*
+	Frustum Tests
+
+	Takes the planes of a 90 degree perspective camera at the origin looking down -z, where every plane
+	is known by hand, and classifies spheres and boxes inside, outside, across a plane and behind the
+	camera. The batched culler has to agree with the single tests, on one thread and on a pool.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Core/ThreadPool.h"
+#include "GameEngine/Renderer/FrustumCuller.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace ge {
+
+	static const float s_Near = 1.0f;
+	static const float s_Far = 100.0f;
+
+	// The distance is compared relative to its size, the far plane is 100 away and only has float precision
+	static bool SamePlane(const glm::vec4& a, const glm::vec4& b)
+	{
+		return std::abs(a.x - b.x) < 1e-5f && std::abs(a.y - b.y) < 1e-5f && std::abs(a.z - b.z) < 1e-5f && std::abs(a.w - b.w) < 1e-5f * (1.0f + std::abs(b.w));
+	}
+
+	static bool SamePoint(const glm::vec3& a, const glm::vec3& b)
+	{
+		return SamePlane(glm::vec4(a, 0.0f), glm::vec4(b, 0.0f));
+	}
+
+	static BoundingBox MakeBox(const glm::vec3& center, float extent)
+	{
+		return { center - glm::vec3(extent), center + glm::vec3(extent) };
+	}
+
+	int RunFrustumTests()
+	{
+		TestContext test("Frustum");
+
+		// Square 90 degree view: the side planes are at 45 degrees, x and y reach -z
+		const glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, s_Near, s_Far);
+		const Frustum frustum(projection);
+		const float s = 1.0f / std::sqrt(2.0f);
+
+		test.Check(SamePlane(frustum.GetPlane(Frustum::Left), glm::vec4(s, 0.0f, -s, 0.0f))
+			&& SamePlane(frustum.GetPlane(Frustum::Right), glm::vec4(-s, 0.0f, -s, 0.0f)), "left and right planes of a perspective matrix");
+		test.Check(SamePlane(frustum.GetPlane(Frustum::Bottom), glm::vec4(0.0f, s, -s, 0.0f))
+			&& SamePlane(frustum.GetPlane(Frustum::Top), glm::vec4(0.0f, -s, -s, 0.0f)), "bottom and top planes of a perspective matrix");
+		test.Check(SamePlane(frustum.GetPlane(Frustum::Near), glm::vec4(0.0f, 0.0f, -1.0f, -s_Near))
+			&& SamePlane(frustum.GetPlane(Frustum::Far), glm::vec4(0.0f, 0.0f, 1.0f, s_Far)), "near and far planes are normalized distances");
+
+		{
+			// Moving the camera moves the planes with it
+			const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			const Frustum moved(projection * view);
+			test.Check(SamePlane(moved.GetPlane(Frustum::Near), glm::vec4(0.0f, 0.0f, -1.0f, 10.0f - s_Near))
+				&& SamePlane(moved.GetPlane(Frustum::Left), glm::vec4(s, 0.0f, -s, 10.0f * s)), "planes of a view projection matrix");
+			test.Check(!moved.Intersects(MakeBox(glm::vec3(0.0f, 0.0f, 15.0f), 1.0f)) && moved.Intersects(MakeBox(glm::vec3(0.0f), 1.0f)),
+				"boxes behind and in front of a moved camera");
+		}
+
+		// Boxes and whether they are visible, in the order they are added to the culler
+		const std::vector<std::pair<BoundingBox, bool>> boxes = {
+			{ MakeBox(glm::vec3(0.0f, 0.0f, -10.0f), 1.0f), true },			// Inside
+			{ MakeBox(glm::vec3(-30.0f, 0.0f, -10.0f), 1.0f), false },		// Left of the view
+			{ MakeBox(glm::vec3(0.0f, 30.0f, -10.0f), 1.0f), false },		// Above the view
+			{ MakeBox(glm::vec3(-10.0f, 0.0f, -10.0f), 1.0f), true },		// Across the left plane
+			{ MakeBox(glm::vec3(0.0f, 0.0f, -0.5f), 1.0f), true },			// Across the near plane
+			{ MakeBox(glm::vec3(0.0f, 0.0f, 5.0f), 1.0f), false },			// Behind the camera
+			{ MakeBox(glm::vec3(0.0f, 0.0f, -150.0f), 1.0f), false },		// Past the far plane
+			{ MakeBox(glm::vec3(0.0f, 0.0f, -100.0f), 5.0f), true },		// Across the far plane
+			{ MakeBox(glm::vec3(0.0f, 0.0f, -50.0f), 500.0f), true },		// Around the whole view
+		};
+
+		bool boxesClassified = true;
+		for (const auto& [box, visible] : boxes)
+			boxesClassified &= frustum.Intersects(box) == visible;
+		test.Check(boxesClassified, "boxes inside, outside, across a plane and behind the camera");
+
+		const std::vector<std::pair<BoundingSphere, bool>> spheres = {
+			{ { glm::vec3(0.0f, 0.0f, -10.0f), 1.0f }, true },
+			{ { glm::vec3(20.0f, 0.0f, -10.0f), 1.0f }, false },
+			{ { glm::vec3(10.0f, 0.0f, -10.0f), 1.0f }, true },				// Across the right plane
+			{ { glm::vec3(0.0f, 0.0f, 5.0f), 1.0f }, false },				// Behind the camera
+			{ { glm::vec3(0.0f, 0.0f, 5.0f), 10.0f }, true },				// Behind the camera but reaching in front of it
+		};
+
+		bool spheresClassified = true;
+		for (const auto& [sphere, visible] : spheres)
+			spheresClassified &= frustum.Intersects(sphere) == visible;
+		test.Check(spheresClassified, "spheres inside, outside, across a plane and behind the camera");
+
+		{
+			// The corner nearest the view touches the left plane x = z when the centre is at x = -12
+			test.Check(frustum.Intersects(MakeBox(glm::vec3(-11.99f, 0.0f, -10.0f), 1.0f))
+				&& !frustum.Intersects(MakeBox(glm::vec3(-12.01f, 0.0f, -10.0f), 1.0f)), "boxes just inside and outside a plane");
+		}
+
+		{
+			const BoundingBox box = MakeBox(glm::vec3(0.0f), 1.0f);
+			const BoundingBox moved = box.Transform(glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -10.0f)), glm::vec3(2.0f)));
+			test.Check(SamePoint(moved.Min, glm::vec3(-2.0f, -2.0f, -12.0f)) && SamePoint(moved.Max, glm::vec3(2.0f, 2.0f, -8.0f)),
+				"transformed boxes are moved and scaled");
+			const BoundingSphere sphere = BoundingSphere{ glm::vec3(1.0f, 0.0f, 0.0f), 1.0f }.Transform(glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 3.0f, 1.0f)));
+			test.Check(sphere.Radius == 3.0f && sphere.Center.x == 1.0f, "transformed spheres grow with the largest scale");
+		}
+
+		{
+			FrustumCuller culler;
+			std::vector<uint32_t> expected;
+			for (const auto& [box, visible] : boxes)
+			{
+				const uint32_t index = culler.Add(box);
+				if (visible)
+					expected.push_back(index);
+			}
+			for (const auto& [sphere, visible] : spheres)
+			{
+				const uint32_t index = culler.Add(sphere);
+				if (visible)
+					expected.push_back(index);
+			}
+
+			culler.Cull(frustum);
+			test.Check(culler.GetVisible() == expected, "the culler keeps the same shapes in the order they were added");
+			test.Check(culler.GetStatistics().Tested == culler.GetCount() && culler.GetStatistics().Visible == (uint32_t)expected.size()
+				&& culler.GetStatistics().Culled == culler.GetCount() - (uint32_t)expected.size(), "culler statistics");
+			test.Check(SamePoint(culler.GetBox(culler.GetCount() - 1).Min, glm::vec3(-10.0f, -10.0f, -5.0f)),
+				"the box of a sphere surrounds it");
+		}
+
+		{
+			// Enough bounds to be split into ranges on the pool, the joined list stays in order
+			FrustumCuller culler;
+			std::vector<uint32_t> expected;
+			const uint32_t count = FrustumCuller::ParallelThreshold * 2 + 100;
+			culler.Reserve(count);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				const auto& [box, visible] = boxes[i % boxes.size()];
+				culler.Add(box);
+				if (visible)
+					expected.push_back(i);
+			}
+
+			ThreadPool pool(3);
+			culler.Cull(frustum, &pool);
+			test.Check(culler.GetVisible() == expected, "a parallel cull gives the same list as a serial one");
+
+			culler.Clear();
+			culler.Cull(frustum, &pool);
+			test.Check(culler.GetCount() == 0 && culler.GetVisible().empty(), "a cleared culler has nothing visible");
+		}
+
+		return test.GetFailed();
+	}
+
+}
@@ -0,0 +1,157 @@
+/*
+	IBL Baker Tests
+
+	Bakes small environments on the CPU: a constant one, whose irradiance is known exactly, and a smooth
+	one written to a temporary HDR file, whose mirror prefilter level has to reproduce the image.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Renderer/IBLBaker.h"
+#include "GameEngine/Renderer/ImageData.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace ge {
+
+	static const float s_Pi = 3.14159265358979f;
+
+	// Small maps keep the bake quick, the checks don't depend on the sizes
+	static IBLBakeSettings MakeTestSettings()
+	{
+		IBLBakeSettings settings;
+		settings.CubemapSize = 64;
+		settings.IrradianceSize = 8;
+		settings.PrefilterSize = 16;
+		settings.PrefilterLevels = 5;
+		settings.PrefilterSamples = 64;
+		settings.BrdfLUTSize = 8;
+		settings.BrdfSamples = 64;
+		settings.ThreadCount = 2;
+		return settings;
+	}
+
+	// Changes linearly with the direction, so bilinear and box filtering keep it
+	static glm::vec3 SmoothRadiance(const glm::vec3& direction)
+	{
+		return glm::vec3(1.0f + 0.5f * direction.x, 1.0f + 0.5f * direction.y, 1.0f + 0.5f * direction.z);
+	}
+
+	// Radiance .hdr file with flat RGBE scanlines of the equirectangular projection EquirectangularToCubemap.glsl reads.
+	// LoadHDR flips it, so the first scanline is the top of the sphere.
+	static bool WriteSmoothHDR(const std::string& path, uint32_t width, uint32_t height)
+	{
+		std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		out << "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y " << height << " +X " << width << "\n";
+		for (uint32_t row = 0; row < height; row++)
+		{
+			const float v = ((float)(height - 1 - row) + 0.5f) / (float)height;
+			const float latitude = (v - 0.5f) * s_Pi;
+			for (uint32_t x = 0; x < width; x++)
+			{
+				const float u = ((float)x + 0.5f) / (float)width;
+				const float longitude = (u - 0.5f) * 2.0f * s_Pi;
+				const glm::vec3 direction(std::cos(longitude) * std::cos(latitude), std::sin(latitude), std::sin(longitude) * std::cos(latitude));
+				const glm::vec3 color = SmoothRadiance(direction);
+
+				int exponent;
+				const float largest = std::max(color.x, std::max(color.y, color.z));
+				const float scale = std::frexp(largest, &exponent) * 256.0f / largest;
+				const char rgbe[4] = { (char)(uint8_t)(color.x * scale), (char)(uint8_t)(color.y * scale), (char)(uint8_t)(color.z * scale),
+					(char)(uint8_t)(exponent + 128) };
+				out.write(rgbe, 4);
+			}
+		}
+		return (bool)out;
+	}
+
+	static float MaxDifference(const glm::vec3& a, const glm::vec3& b)
+	{
+		return std::max(std::abs(a.x - b.x), std::max(std::abs(a.y - b.y), std::abs(a.z - b.z)));
+	}
+
+	static glm::vec3 GetTexel(const CubemapData& cubemap, uint32_t level, uint32_t face, uint32_t x, uint32_t y)
+	{
+		const float* pixel = cubemap.GetFace(level, face) + ((size_t)y * cubemap.GetLevelSize(level) + x) * 3;
+		return glm::vec3(pixel[0], pixel[1], pixel[2]);
+	}
+
+	int RunIBLBakerTests()
+	{
+		TestContext test("IBLBaker");
+
+		{
+			const float radiance[3] = { 0.5f, 1.0f, 2.0f };
+			const glm::vec3 L(radiance[0], radiance[1], radiance[2]);
+			ImageData image = ImageData::Fill(32, 16, 3, true, radiance);
+
+			IBLData data;
+			const bool baked = IBLBaker::Bake(image, MakeTestSettings(), data);
+			test.Check(baked, "a constant environment bakes");
+
+			// The irradiance map holds E / pi, every texel of a constant environment has E = pi * L
+			float irradianceError = 0.0f;
+			for (uint32_t face = 0; baked && face < 6; face++)
+				for (uint32_t y = 0; y < data.Irradiance.Size; y++)
+					for (uint32_t x = 0; x < data.Irradiance.Size; x++)
+						irradianceError = std::max(irradianceError, MaxDifference(s_Pi * GetTexel(data.Irradiance, 0, face, x, y), s_Pi * L));
+			test.Check(baked && irradianceError < 0.01f * s_Pi * 2.0f, "a constant environment gives an irradiance of pi times its radiance");
+
+			const glm::vec3 up = IBLBaker::EvaluateIrradiance(data.SH, glm::vec3(0.0f, 1.0f, 0.0f));
+			const glm::vec3 diagonal = IBLBaker::EvaluateIrradiance(data.SH, glm::normalize(glm::vec3(1.0f, -1.0f, 1.0f)));
+			test.Check(MaxDifference(up, L) < 0.02f && MaxDifference(diagonal, L) < 0.02f, "the irradiance does not depend on the normal");
+
+			// Any lobe over a constant environment averages to the same radiance
+			float prefilterError = 0.0f;
+			for (uint32_t level = 0; baked && level < data.Prefilter.Levels; level++)
+			{
+				const uint32_t size = data.Prefilter.GetLevelSize(level);
+				for (uint32_t face = 0; face < 6; face++)
+					prefilterError = std::max(prefilterError, MaxDifference(GetTexel(data.Prefilter, level, face, size / 2, size / 3), L));
+			}
+			test.Check(baked && data.Prefilter.Levels == 5 && prefilterError < 0.001f, "every prefilter level of a constant environment is the radiance");
+		}
+
+		{
+			const std::string path = (std::filesystem::temp_directory_path() / "EngineTests.hdr").string();
+			ImageData image;
+			const bool loaded = WriteSmoothHDR(path, 256, 128) && ImageData::LoadHDR(path, image);
+			test.Check(loaded && image.IsHDR() && image.GetWidth() == 256, "a smooth environment is written and loaded");
+
+			IBLData data;
+			const bool baked = loaded && IBLBaker::Bake(image, MakeTestSettings(), data);
+
+			// RGBE keeps 8 bits of mantissa, the rest is the filtering of the cubemap levels
+			float environmentError = 0.0f, prefilterError = 0.0f;
+			for (uint32_t face = 0; baked && face < 6; face++)
+			{
+				const uint32_t size = data.Environment.Size;
+				for (uint32_t y = 0; y < size; y += 7)
+					for (uint32_t x = 0; x < size; x += 7)
+						environmentError = std::max(environmentError,
+							MaxDifference(GetTexel(data.Environment, 0, face, x, y), SmoothRadiance(CubemapData::GetDirection(face, x, y, size))));
+
+				const uint32_t prefilterSize = data.Prefilter.Size;
+				for (uint32_t y = 0; y < prefilterSize; y++)
+					for (uint32_t x = 0; x < prefilterSize; x++)
+						prefilterError = std::max(prefilterError,
+							MaxDifference(GetTexel(data.Prefilter, 0, face, x, y), SmoothRadiance(CubemapData::GetDirection(face, x, y, prefilterSize))));
+			}
+			test.Check(baked && environmentError < 0.02f, "the environment cubemap matches the source image");
+			test.Check(baked && prefilterError < 0.03f, "the mirror prefilter level matches the source image");
+
+			// The cosine lobe of a linear radiance halves its slope: E / pi = 1 + 0.5 * (2 / 3) * N
+			const glm::vec3 N = glm::normalize(glm::vec3(0.3f, 0.8f, -0.5f));
+			const glm::vec3 expected = glm::vec3(1.0f) + N * (0.5f * 2.0f / 3.0f);
+			test.Check(baked && MaxDifference(IBLBaker::EvaluateIrradiance(data.SH, N), expected) < 0.02f, "the irradiance of a smooth environment follows the cosine lobe");
+
+			std::error_code error;
+			std::filesystem::remove(path, error);
+		}
+
+		return test.GetFailed();
+	}
+
+}
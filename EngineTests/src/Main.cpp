@@ -0,0 +1,31 @@
+/*
+	Engine Tests
+
+	Entry point. Runs every test group and returns a non-zero exit code when any check fails.
+*/
+
+#include "EngineTests.h"
+
+int main()
+{
+	ge::Log::Init();
+
+	int failed = 0;
+	failed += ge::RunRenderQueueTests();
+	failed += ge::RunTextureStreamerTests();
+	failed += ge::RunRenderGraphTests();
+	failed += ge::RunMeshArenaTests();
+	failed += ge::RunMeshOptimizerTests();
+	failed += ge::RunTextureCookingTests();
+	failed += ge::RunIBLBakerTests();
+	failed += ge::RunFrustumTests();
+	failed += ge::RunOcclusionCullerTests();
+	failed += ge::RunSoftwareRendererTests();
+
+	if (failed == 0)
+		GE_INFO("All engine tests passed");
+	else
+		GE_ERROR("{0} engine tests failed", failed);
+
+	return failed == 0 ? 0 : 1;
+}
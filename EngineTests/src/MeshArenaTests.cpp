@@ -0,0 +1,103 @@
+/*
+	Mesh Arena Tests
+
+	Packs small meshes into a MeshArena and checks where they end up: the ranges and draw commands of
+	copied meshes, the counts of ranges recorded for data already in a buffer (a cooked mesh) and what
+	is left after the CPU copies are released.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Renderer/MeshArena.h"
+
+#include <vector>
+
+namespace ge {
+
+	// Vertices whose x position is their number, so they can be told apart once packed
+	static std::vector<MeshVertex> MakeVertices(uint32_t count, float first)
+	{
+		std::vector<MeshVertex> vertices(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			vertices[i] = MeshVertex();
+			vertices[i].Position = glm::vec3(first + (float)i, 0.0f, 0.0f);
+		}
+		return vertices;
+	}
+
+	static bool operator==(const DrawIndirectCommand& a, const DrawIndirectCommand& b)
+	{
+		return a.Count == b.Count && a.InstanceCount == b.InstanceCount && a.FirstIndex == b.FirstIndex
+			&& a.BaseVertex == b.BaseVertex && a.BaseInstance == b.BaseInstance;
+	}
+
+	int RunMeshArenaTests()
+	{
+		TestContext test("MeshArena");
+
+		{
+			MeshArena arena;
+			const IndexedDrawRange triangle = arena.Add(MakeVertices(3, 0.0f), { 0, 1, 2 });
+			const IndexedDrawRange quad = arena.Add(MakeVertices(4, 3.0f), { 0, 1, 2, 2, 3, 0 });
+
+			test.Check(triangle.Count == 3 && triangle.FirstIndex == 0 && triangle.BaseVertex == 0, "the first mesh starts at the beginning");
+			test.Check(quad.Count == 6 && quad.FirstIndex == 3 && quad.BaseVertex == 3, "the next mesh starts after the previous one");
+			test.Check(arena.GetVertexCount() == 7 && arena.GetIndexCount() == 9 && arena.GetRanges().size() == 2, "counts of added meshes");
+
+			bool verticesInOrder = arena.GetVertices().size() == 7;
+			for (uint32_t i = 0; verticesInOrder && i < 7; i++)
+				verticesInOrder = arena.GetVertices()[i].Position.x == (float)i;
+			test.Check(verticesInOrder, "vertices are copied back to back");
+			test.Check(arena.GetIndices() == std::vector<unsigned int>{ 0, 1, 2, 0, 1, 2, 2, 3, 0 }, "indices stay relative to their mesh");
+
+			bool indicesReachTheirVertices = true;
+			for (const IndexedDrawRange& range : arena.GetRanges())
+			{
+				for (uint32_t i = 0; i < range.Count; i++)
+				{
+					const uint32_t vertex = arena.GetIndices()[range.FirstIndex + i] + range.BaseVertex;
+					indicesReachTheirVertices &= vertex < arena.GetVertexCount() && vertex >= (uint32_t)range.BaseVertex;
+				}
+			}
+			test.Check(indicesReachTheirVertices, "indices plus the base vertex stay inside their mesh");
+
+			std::vector<DrawIndirectCommand> commands;
+			arena.BuildDrawCommands(commands);
+			test.Check(commands.size() == 2 && commands[0] == DrawIndirectCommand{ 3, 1, 0, 0, 0 } && commands[1] == DrawIndirectCommand{ 6, 1, 3, 3, 0 },
+				"one command per mesh in the order they were added");
+
+			arena.BuildDrawCommands(commands, 4, 2);
+			test.Check(commands.size() == 2 && commands[1] == DrawIndirectCommand{ 6, 4, 3, 3, 2 }, "commands carry the instance count and base instance");
+
+			arena.ReleaseCPUData();
+			arena.BuildDrawCommands(commands);
+			test.Check(arena.GetVertices().empty() && arena.GetIndices().empty() && arena.GetCPUMemory() == 0, "releasing frees the CPU copies");
+			test.Check(arena.GetVertexCount() == 7 && arena.GetIndexCount() == 9 && commands.size() == 2, "the ranges and counts outlive the CPU copies");
+		}
+
+		{
+			// The submeshes of a cooked file, in any order
+			MeshArena arena;
+			arena.AddRange({ 6, 3, 3 }, 4);
+			arena.AddRange({ 3, 0, 0 }, 3);
+			test.Check(arena.GetVertexCount() == 7 && arena.GetIndexCount() == 9, "recorded ranges cover the buffers they point into");
+			test.Check(arena.GetVertices().empty() && arena.GetIndices().empty(), "recording a range copies nothing");
+
+			std::vector<DrawIndirectCommand> commands;
+			arena.BuildDrawCommands(commands);
+			test.Check(commands.size() == 2 && commands[0] == DrawIndirectCommand{ 6, 1, 3, 3, 0 } && commands[1] == DrawIndirectCommand{ 3, 1, 0, 0, 0 },
+				"recorded ranges keep their order");
+		}
+
+		{
+			MeshArena arena;
+			std::vector<DrawIndirectCommand> commands = { { 1, 1, 0, 0, 0 } };
+			arena.BuildDrawCommands(commands);
+			test.Check(commands.empty() && arena.GetVertexCount() == 0, "an empty arena builds no commands");
+		}
+
+		return test.GetFailed();
+	}
+
+}
@@ -0,0 +1,206 @@
+/*
+	Mesh Optimizer Tests
+
+	Runs the optimizer passes on a grid, the shape most imported surfaces are made of: the simulated
+	vertex cache must not get worse, the triangles must stay the same triangles with the same winding
+	and the vertex fetch remapping must keep what every index points at.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Renderer/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace ge {
+
+	// A triangle by the positions of its corners, rotated so the smallest corner comes first. The
+	// rotation keeps the winding, so a flipped triangle compares different.
+	using TrianglePositions = std::array<float, 9>;
+
+	static void MakeGrid(uint32_t size, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		vertices.clear();
+		indices.clear();
+		for (uint32_t y = 0; y <= size; y++)
+		{
+			for (uint32_t x = 0; x <= size; x++)
+			{
+				MeshVertex vertex = MeshVertex();
+				vertex.Position = glm::vec3((float)x, std::sin((float)x * 0.5f) * std::cos((float)y * 0.5f), (float)y);
+				vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+				vertex.TexCoords = glm::vec2((float)x / size, (float)y / size);
+				vertices.push_back(vertex);
+			}
+		}
+
+		// Row by row, the order a simple exporter writes them in
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				const uint32_t i0 = y * (size + 1) + x;
+				const uint32_t i2 = i0 + size + 1;
+				indices.insert(indices.end(), { i0, i2, i0 + 1, i0 + 1, i2, i2 + 1 });
+			}
+		}
+	}
+
+	// Every triangle with its own three vertices, as unindexed exports and flat shaded meshes come in
+	static void Unweld(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		std::vector<MeshVertex> unwelded;
+		unwelded.reserve(indices.size());
+		for (unsigned int& index : indices)
+		{
+			unwelded.push_back(vertices[index]);
+			index = (unsigned int)unwelded.size() - 1;
+		}
+		vertices.swap(unwelded);
+	}
+
+	// Same triangles in a fixed pseudo random order, the worst case for the vertex cache
+	static void ShuffleTriangles(std::vector<unsigned int>& indices)
+	{
+		uint32_t state = 12345;
+		const uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		for (uint32_t i = triangleCount - 1; i > 0; i--)
+		{
+			state = state * 1664525u + 1013904223u;
+			const uint32_t j = (state >> 8) % (i + 1);
+			for (uint32_t k = 0; k < 3; k++)
+				std::swap(indices[i * 3 + k], indices[j * 3 + k]);
+		}
+	}
+
+	static std::vector<TrianglePositions> GetTriangles(const std::vector<MeshVertex>& vertices, const std::vector<unsigned int>& indices)
+	{
+		std::vector<TrianglePositions> triangles;
+		triangles.reserve(indices.size() / 3);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			std::array<std::array<float, 3>, 3> corners;
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				const glm::vec3& position = vertices[indices[i + k]].Position;
+				corners[k] = { position.x, position.y, position.z };
+			}
+			const uint32_t first = (uint32_t)(std::min_element(corners.begin(), corners.end()) - corners.begin());
+
+			TrianglePositions triangle;
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+					triangle[k * 3 + c] = corners[(first + k) % 3][c];
+			}
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	// MeshVertex is only floats, the optimizer copies vertices so they stay bit for bit the same
+	static bool SameVertex(const MeshVertex& a, const MeshVertex& b)
+	{
+		return std::memcmp(&a, &b, sizeof(MeshVertex)) == 0;
+	}
+
+	int RunMeshOptimizerTests()
+	{
+		TestContext test("MeshOptimizer");
+
+		const uint32_t gridSize = 48;
+
+		{
+			std::vector<MeshVertex> vertices;
+			std::vector<unsigned int> indices;
+			MakeGrid(gridSize, vertices, indices);
+			const std::vector<TrianglePositions> triangles = GetTriangles(vertices, indices);
+
+			const MeshOptimizer::Report report = MeshOptimizer::Optimize(vertices, indices);
+			test.Check(report.After.ACMR <= report.Before.ACMR && report.After.ATVR <= report.Before.ATVR, "a row ordered grid does not get worse");
+			test.Check(report.After.ACMR < 0.9f * report.Before.ACMR, "a row ordered grid reuses more vertices from the cache");
+			test.Check(report.VerticesAfter == report.VerticesBefore && indices.size() == (size_t)gridSize * gridSize * 6, "a welded grid keeps its vertices and triangles");
+			test.Check(GetTriangles(vertices, indices) == triangles, "the triangles of the grid survive the reordering");
+		}
+
+		{
+			std::vector<MeshVertex> vertices;
+			std::vector<unsigned int> indices;
+			MakeGrid(gridSize, vertices, indices);
+			ShuffleTriangles(indices);
+			Unweld(vertices, indices);
+			const std::vector<TrianglePositions> triangles = GetTriangles(vertices, indices);
+
+			const MeshOptimizer::Report report = MeshOptimizer::Optimize(vertices, indices);
+			test.Check(report.VerticesAfter == (gridSize + 1) * (gridSize + 1), "duplicate vertices are welded");
+			// Every unwelded vertex is transformed exactly once, so the ATVR before is 1 and only the transform count compares
+			test.Check(report.After.ACMR < report.Before.ACMR && report.After.VerticesTransformed < report.Before.VerticesTransformed,
+				"a shuffled grid gets better");
+			test.Check(report.After.ACMR < 1.0f, "a shuffled grid reuses cached vertices after optimizing");
+			test.Check(GetTriangles(vertices, indices) == triangles, "the triangles of a shuffled grid survive welding and reordering");
+		}
+
+		{
+			std::vector<MeshVertex> vertices;
+			std::vector<unsigned int> indices;
+			MakeGrid(gridSize, vertices, indices);
+			ShuffleTriangles(indices);
+			const uint32_t vertexCount = (uint32_t)vertices.size();
+
+			MeshOptimizer::OptimizeVertexCache(indices, vertexCount);
+			const VertexCacheStatistics cacheOrdered = MeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+			const float threshold = 1.05f;
+			MeshOptimizer::OptimizeOverdraw(indices, vertices, threshold);
+			const VertexCacheStatistics overdrawOrdered = MeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+			test.Check(overdrawOrdered.ACMR <= cacheOrdered.ACMR * threshold, "the overdraw order stays within the ACMR threshold");
+		}
+
+		{
+			std::vector<MeshVertex> vertices;
+			std::vector<unsigned int> indices;
+			MakeGrid(gridSize, vertices, indices);
+			ShuffleTriangles(indices);
+			// A vertex no triangle uses is dropped
+			vertices.push_back(vertices.front());
+			vertices.back().Position = glm::vec3(-1.0f);
+
+			const std::vector<MeshVertex> before = vertices;
+			const std::vector<unsigned int> beforeIndices = indices;
+			MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+
+			bool sameData = indices.size() == beforeIndices.size();
+			for (size_t i = 0; sameData && i < indices.size(); i++)
+				sameData = indices[i] < vertices.size() && SameVertex(vertices[indices[i]], before[beforeIndices[i]]);
+			test.Check(sameData, "fetch remapping keeps the vertex every index points at");
+			test.Check(vertices.size() == before.size() - 1, "unused vertices are dropped");
+
+			bool firstUseOrder = true;
+			uint32_t next = 0;
+			for (size_t i = 0; firstUseOrder && i < indices.size(); i++)
+			{
+				firstUseOrder = indices[i] <= next;
+				if (indices[i] == next)
+					next++;
+			}
+			test.Check(firstUseOrder, "vertices are in the order the triangles first fetch them");
+		}
+
+		{
+			// 3 triangles of a strip: 5 vertices, each new triangle fetches one
+			const std::vector<unsigned int> strip = { 0, 1, 2, 2, 1, 3, 2, 3, 4 };
+			const VertexCacheStatistics statistics = MeshOptimizer::AnalyzeVertexCache(strip, 5);
+			test.Check(statistics.VerticesTransformed == 5 && statistics.ACMR == 5.0f / 3.0f && statistics.ATVR == 1.0f, "cache statistics of a strip");
+
+			const VertexCacheStatistics tiny = MeshOptimizer::AnalyzeVertexCache({ 0, 1, 2, 3, 4, 5, 0, 1, 2 }, 6, 3);
+			test.Check(tiny.VerticesTransformed == 9 && tiny.ATVR == 1.5f, "vertices evicted from a small cache are transformed again");
+		}
+
+		return test.GetFailed();
+	}
+
+}
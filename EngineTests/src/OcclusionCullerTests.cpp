@@ -0,0 +1,125 @@
+/*
+	Occlusion Culler Tests
+
+	Rasterizes a wall covering the left half of a perspective view and tests boxes behind it, past its
+	edge and in front of it. A quad drawn straight in normalized device coordinates checks the depth
+	buffer pixel by pixel: pixels the quad covers entirely take its depth, pixels on the diagonal the two
+	triangles share keep the far depth, as the file header of the culler describes.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Core/ThreadPool.h"
+#include "GameEngine/Renderer/OcclusionCuller.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+
+namespace ge {
+
+	static BoundingBox MakeBox(const glm::vec3& center, const glm::vec3& extents)
+	{
+		return { center - extents, center + extents };
+	}
+
+	int RunOcclusionCullerTests()
+	{
+		TestContext test("OcclusionCuller");
+
+		{
+			// Camera at the origin looking down -z. The wall at z = -10 ends on the vertical through the
+			// centre of the screen and its slanted edge is off screen, so it hides the whole left half.
+			const glm::mat4 viewProjection = glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f);
+			const std::vector<glm::vec3> wall = { { -40.0f, -20.0f, -10.0f }, { 0.0f, -20.0f, -10.0f }, { 0.0f, 40.0f, -10.0f } };
+			const std::vector<uint32_t> indices = { 0, 1, 2 };
+
+			OcclusionCuller culler(128, 128);
+			culler.Begin(viewProjection);
+			culler.AddOccluder(wall, indices, glm::mat4(1.0f));
+			test.Check(culler.NeedsRasterize() && culler.GetStatistics().Triangles == 1, "a front facing occluder is kept");
+			culler.Rasterize();
+			test.Check(!culler.NeedsRasterize(), "rasterizing takes every occluder added");
+
+			test.Check(!culler.Test(MakeBox(glm::vec3(-5.0f, 0.0f, -20.0f), glm::vec3(1.0f))), "a box fully behind the occluder is culled");
+			test.Check(!culler.Test(MakeBox(glm::vec3(-2.0f, 3.0f, -20.0f), glm::vec3(1.0f))), "a box behind the occluder just inside its edge is culled");
+			test.Check(culler.Test(MakeBox(glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(2.0f))), "a box showing past the edge of the occluder is kept");
+			test.Check(culler.Test(MakeBox(glm::vec3(5.0f, 0.0f, -20.0f), glm::vec3(1.0f))), "a box beside the occluder is kept");
+			test.Check(culler.Test(MakeBox(glm::vec3(-3.0f, 0.0f, -5.0f), glm::vec3(1.0f))), "a box in front of the occluder is kept");
+			test.Check(culler.Test(MakeBox(glm::vec3(-5.0f, 0.0f, -10.0f), glm::vec3(1.0f))), "a box through the occluder is kept");
+			test.Check(culler.Test(MakeBox(glm::vec3(-5.0f, 0.0f, 0.0f), glm::vec3(1.0f))), "a box reaching past the near plane is kept");
+			test.Check(culler.GetStatistics().Tested == 7 && culler.GetStatistics().Occluded == 2, "occlusion statistics");
+
+			// A clockwise wall faces away from the camera
+			culler.Begin(viewProjection);
+			culler.AddOccluder(wall, { 0, 2, 1 }, glm::mat4(1.0f));
+			culler.Rasterize();
+			test.Check(culler.GetStatistics().Triangles == 0 && culler.IsVisible(MakeBox(glm::vec3(-5.0f, 0.0f, -20.0f), glm::vec3(1.0f))),
+				"back faces do not occlude");
+
+			// The transform moves the wall, the box it hid is now in front of it
+			culler.Begin(viewProjection);
+			culler.AddOccluder(wall, indices, glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -20.0f)));
+			culler.Rasterize();
+			test.Check(culler.IsVisible(MakeBox(glm::vec3(-5.0f, 0.0f, -20.0f), glm::vec3(1.0f)))
+				&& !culler.IsVisible(MakeBox(glm::vec3(-10.0f, 0.0f, -40.0f), glm::vec3(1.0f))), "occluders are placed by their transform");
+		}
+
+		{
+			// With an identity matrix the quad is in normalized device coordinates: x and y from -0.5 to 0.5
+			// are pixels 4 to 12 of 16, at depth 0.25. Its diagonal runs from pixel corner (4, 4) to (12, 12).
+			const std::vector<glm::vec3> quad = { { -0.5f, -0.5f, 0.25f }, { 0.5f, -0.5f, 0.25f }, { 0.5f, 0.5f, 0.25f }, { -0.5f, 0.5f, 0.25f } };
+			const std::vector<uint32_t> indices = { 0, 1, 2, 2, 3, 0 };
+			const uint32_t size = 16;
+
+			OcclusionCuller culler(size, size);
+			culler.Begin(glm::mat4(1.0f));
+			culler.AddOccluder(quad, indices, glm::mat4(1.0f));
+			culler.Rasterize();
+
+			const std::vector<float>& depth = culler.GetLevel(0);
+			auto at = [&depth, size](uint32_t x, uint32_t y) { return depth[(size_t)y * size + x]; };
+
+			bool covered = true, diagonalFar = true, outsideFar = true;
+			for (uint32_t y = 0; y < size; y++)
+			{
+				for (uint32_t x = 0; x < size; x++)
+				{
+					const bool inside = x >= 4 && x < 12 && y >= 4 && y < 12;
+					if (!inside)
+						outsideFar &= at(x, y) == 1.0f;
+					else if (x == y)
+						diagonalFar &= at(x, y) == 1.0f;
+					else
+						covered &= at(x, y) == 0.25f;
+				}
+			}
+			test.Check(covered, "pixels either triangle covers entirely take the depth of the quad");
+			test.Check(diagonalFar, "pixels on the edge both triangles share keep the far depth");
+			test.Check(outsideFar, "pixels outside the quad keep the far depth");
+			test.Check(culler.GetLevel(1)[2 * (size / 2) + 3] == 0.25f && culler.GetLevel(1)[2 * (size / 2) + 2] == 1.0f,
+				"the pyramid keeps the furthest depth of each 2x2 block");
+
+			// Boxes behind the quad, one above the diagonal and one across it
+			test.Check(!culler.IsVisible(MakeBox(glm::vec3(-0.25f, 0.25f, 0.5f), glm::vec3(0.1f))), "a box behind one triangle is culled");
+			test.Check(culler.IsVisible(MakeBox(glm::vec3(0.0f, 0.0f, 0.5f), glm::vec3(0.1f))), "a box behind the shared edge is kept");
+
+			// Tiles rasterized on a pool give the same buffer, 64 pixels is 2x2 tiles
+			OcclusionCuller serial(64, 64), parallel(64, 64);
+			ThreadPool pool(3);
+			for (OcclusionCuller* target : { &serial, &parallel })
+			{
+				target->Begin(glm::mat4(1.0f));
+				target->AddOccluder(quad, indices, glm::mat4(1.0f));
+				target->AddOccluder(quad, indices, glm::scale(glm::mat4(1.0f), glm::vec3(1.8f, 0.6f, 0.5f)));
+			}
+			serial.Rasterize();
+			parallel.Rasterize(&pool);
+			test.Check(serial.GetLevel(0) == parallel.GetLevel(0) && serial.GetLevel(0)[32 * 64 + 56] == 0.125f,
+				"tiles rasterized on a pool give the same depth buffer");
+		}
+
+		return test.GetFailed();
+	}
+
+}
@@ -0,0 +1,140 @@
+/*
+	Render Graph Tests
+
+	Compiles small graphs without executing them, so no framebuffer is created: the order of passes
+	sharing a resource, the culling of passes nothing needs, the graphs that are rejected and the
+	aliasing of transient framebuffers.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Renderer/RenderGraph.h"
+
+#include <vector>
+
+namespace ge {
+
+	static const FramebufferDesc s_Desc = { 64, 64, false };
+
+	static void NoExecute(const RenderGraphContext& /*context*/) {}
+
+	// Pass reading and writing the given resources
+	static uint32_t AddPass(RenderGraph& graph, const std::string& name,
+		const std::vector<RenderGraphResource>& reads, const std::vector<RenderGraphResource>& writes)
+	{
+		return graph.AddPass(name, [&](RenderGraphBuilder& builder)
+			{
+				for (RenderGraphResource resource : reads)
+					builder.Read(resource);
+				for (RenderGraphResource resource : writes)
+					builder.Write(resource);
+			}, NoExecute);
+	}
+
+	int RunRenderGraphTests()
+	{
+		TestContext test("RenderGraph");
+
+		{
+			RenderGraph graph;
+			const RenderGraphResource backBuffer = graph.Import("Back buffer", nullptr, s_Desc);
+			const RenderGraphResource color = graph.Create("Color", s_Desc);
+			const RenderGraphResource result = graph.Create("Result", s_Desc);
+
+			const uint32_t write = AddPass(graph, "Write", {}, { color });
+			const uint32_t read = AddPass(graph, "Read", { color }, { result });
+			const uint32_t modify = AddPass(graph, "Modify", { color }, { color });
+			const uint32_t present = AddPass(graph, "Present", { color, result }, { backBuffer });
+
+			test.Check(graph.Compile(), "a graph reading and overwriting a resource compiles");
+			test.Check(graph.GetExecutionOrder() == std::vector<uint32_t>{ write, read, modify, present },
+				"a reader runs before the next writer of what it read");
+		}
+
+		{
+			// Added in the reverse order, only the write after read dependency keeps the reader first
+			RenderGraph graph;
+			const RenderGraphResource backBuffer = graph.Import("Back buffer", nullptr, s_Desc);
+			const RenderGraphResource color = graph.Create("Color", s_Desc);
+			const RenderGraphResource result = graph.Create("Result", s_Desc);
+
+			const uint32_t write = AddPass(graph, "Write", {}, { color });
+			const uint32_t read = AddPass(graph, "Read", { color }, { result });
+			const uint32_t overwrite = AddPass(graph, "Overwrite", {}, { color });
+			const uint32_t present = AddPass(graph, "Present", { color, result }, { backBuffer });
+
+			test.Check(graph.Compile() && graph.GetExecutionOrder() == std::vector<uint32_t>{ write, read, overwrite, present },
+				"a pass only writing a resource waits for its readers");
+		}
+
+		{
+			RenderGraph graph;
+			const RenderGraphResource backBuffer = graph.Import("Back buffer", nullptr, s_Desc);
+			const RenderGraphResource color = graph.Create("Color", s_Desc);
+			const RenderGraphResource unused = graph.Create("Unused", s_Desc);
+
+			const uint32_t write = AddPass(graph, "Write", {}, { color });
+			const uint32_t read = AddPass(graph, "Read unused", { color }, { unused });
+			const uint32_t modify = AddPass(graph, "Modify", { color }, { color });
+			const uint32_t present = AddPass(graph, "Present", { color }, { backBuffer });
+			const uint32_t sideEffect = graph.AddPass("Side effect", [](RenderGraphBuilder& builder) { builder.SetSideEffect(); }, NoExecute);
+
+			test.Check(graph.Compile(), "a graph with an unused pass compiles");
+			test.Check(graph.IsPassCulled(read) && graph.GetStatistics().CulledPasses == 1, "a pass nothing reads is culled");
+			test.Check(!graph.IsPassCulled(sideEffect), "passes with side effects are kept");
+			test.Check(graph.GetExecutionOrder() == std::vector<uint32_t>{ write, modify, present, sideEffect },
+				"a culled reader does not keep or order the later writers");
+			test.Check(graph.GetAllocation(unused) == RenderGraph::Invalid, "resources of culled passes are not allocated");
+		}
+
+		{
+			RenderGraph graph;
+			const RenderGraphResource backBuffer = graph.Import("Back buffer", nullptr, s_Desc);
+			const RenderGraphResource color = graph.Create("Color", s_Desc);
+			AddPass(graph, "Read", { color }, { backBuffer });
+			AddPass(graph, "Write", {}, { color });
+			test.Check(!graph.Compile(), "reading a transient resource before a pass writes it is rejected");
+		}
+
+		{
+			RenderGraph graph;
+			const RenderGraphResource backBuffer = graph.Import("Back buffer", nullptr, s_Desc);
+			const RenderGraphResource color = graph.Create("Color", s_Desc);
+			AddPass(graph, "Modify", { color }, { color, backBuffer });
+			test.Check(!graph.Compile(), "reading a resource the pass writes first is rejected");
+		}
+
+		{
+			RenderGraph graph;
+			const RenderGraphResource backBuffer = graph.Import("Back buffer", nullptr, s_Desc);
+			AddPass(graph, "Draw", { backBuffer }, { backBuffer });
+			test.Check(graph.Compile(), "imported resources can be read before any pass writes them");
+		}
+
+		{
+			RenderGraph graph;
+			const RenderGraphResource backBuffer = graph.Import("Back buffer", nullptr, s_Desc);
+			const RenderGraphResource a = graph.Create("A", s_Desc);
+			const RenderGraphResource b = graph.Create("B", s_Desc);
+			const RenderGraphResource c = graph.Create("C", s_Desc);
+			const RenderGraphResource small = graph.Create("Small", { 32, 32, false });
+
+			AddPass(graph, "Write A", {}, { a });
+			AddPass(graph, "A to B", { a }, { b });
+			AddPass(graph, "B to C", { b }, { c, small });
+			AddPass(graph, "Present", { c, small }, { backBuffer });
+
+			const RenderGraph::Statistics& statistics = graph.GetStatistics();
+			test.Check(graph.Compile(), "a chain of transient resources compiles");
+			test.Check(graph.GetAllocation(a) == graph.GetAllocation(c) && graph.GetAllocation(a) != graph.GetAllocation(b),
+				"resources whose lifetimes don't overlap share a framebuffer");
+			test.Check(graph.GetAllocation(small) != graph.GetAllocation(a) && graph.GetAllocation(small) != graph.GetAllocation(b),
+				"only matching descriptions alias");
+			test.Check(graph.GetAllocation(backBuffer) == RenderGraph::Invalid, "imported resources are not allocated");
+			test.Check(statistics.TransientResources == 4 && statistics.Framebuffers == 3, "allocation statistics");
+		}
+
+		return test.GetFailed();
+	}
+
+}
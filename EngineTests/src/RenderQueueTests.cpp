@@ -0,0 +1,242 @@
+/*
+	Render Queue Tests
+
+	Submits packets to a RenderQueue and checks the command stream the RecordingRenderQueueBackend
+	receives: the sort order of the passes and depths, the filtering of redundant binds and the
+	grouping of instanced runs.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Renderer/RenderQueue.h"
+
+#include <vector>
+
+namespace ge {
+
+	class FakeShader : public Shader
+	{
+	public:
+		FakeShader(const std::string& name, bool instanced) : m_Name(name), m_Instanced(instanced) {}
+
+		virtual void Bind() const override {}
+		virtual void Unbind() const override {}
+
+		virtual const std::string& GetName() const override { return m_Name; }
+		virtual bool IsInstanced() const override { return m_Instanced; }
+		virtual bool IsReady() const override { return true; }
+
+		virtual void SetInt(const UniformID& /*id*/, int /*value*/) override {}
+		virtual void SetIntArray(const UniformID& /*id*/, const int* /*values*/, uint32_t /*count*/) override {}
+		virtual void SetFloat(const UniformID& /*id*/, float /*value*/) override {}
+		virtual void SetFloat2(const UniformID& /*id*/, const glm::vec2& /*value*/) override {}
+		virtual void SetFloat3(const UniformID& /*id*/, const glm::vec3& /*value*/) override {}
+		virtual void SetFloat4(const UniformID& /*id*/, const glm::vec4& /*value*/) override {}
+		virtual void SetMat3(const UniformID& /*id*/, const glm::mat3& /*value*/) override {}
+		virtual void SetMat4(const UniformID& /*id*/, const glm::mat4& /*value*/) override {}
+	private:
+		std::string m_Name;
+		bool m_Instanced;
+	};
+
+	class FakeVertexArray : public VertexArray
+	{
+	public:
+		virtual void Bind() const override {}
+		virtual void Unbind() const override {}
+
+		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) override { m_VertexBuffers.push_back(vertexBuffer); }
+		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, uint32_t /*firstAttributeIndex*/) override { m_VertexBuffers.push_back(vertexBuffer); }
+		virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) override { m_IndexBuffer = indexBuffer; }
+
+		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const override { return m_VertexBuffers; }
+		virtual const Ref<IndexBuffer>& GetIndexBuffer() const override { return m_IndexBuffer; }
+	private:
+		std::vector<Ref<VertexBuffer>> m_VertexBuffers;
+		Ref<IndexBuffer> m_IndexBuffer;
+	};
+
+	using Command = RecordingRenderQueueBackend::Command;
+	using CommandType = RecordingRenderQueueBackend::CommandType;
+
+	// The instance colour carries an id so the tests can tell the packets apart after sorting
+	static InstanceData MakeInstance(float id)
+	{
+		InstanceData instance;
+		instance.Transform = glm::mat4(1.0f);
+		instance.Color = glm::vec4(id);
+		return instance;
+	}
+
+	static void Run(RenderQueue& queue, RecordingRenderQueueBackend& backend)
+	{
+		queue.Sort();
+		queue.Execute(backend, glm::mat4(1.0f));
+		queue.Clear();
+	}
+
+	static std::vector<Command> Filter(const RecordingRenderQueueBackend& backend, CommandType type)
+	{
+		std::vector<Command> commands;
+		for (const Command& command : backend.GetCommands())
+		{
+			if (command.Type == type)
+				commands.push_back(command);
+		}
+		return commands;
+	}
+
+	// The counts of the non-instanced draws in the order they were issued
+	static std::vector<uint32_t> DrawCounts(const RecordingRenderQueueBackend& backend)
+	{
+		std::vector<uint32_t> counts;
+		for (const Command& command : Filter(backend, CommandType::Draw))
+			counts.push_back(command.Count);
+		return counts;
+	}
+
+	int RunRenderQueueTests()
+	{
+		TestContext test("RenderQueue");
+
+		FakeShader shaderA("A", false);
+		FakeShader shaderB("B", false);
+		FakeShader instancedShader("Instanced", true);
+		FakeVertexArray vertexArrayA;
+		FakeVertexArray vertexArrayB;
+
+		// The index count is used as the id of each packet
+		{
+			RenderQueue queue;
+			RecordingRenderQueueBackend backend;
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 50, MakeInstance(0), 5.0f);
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 10, MakeInstance(0), 1.0f);
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 30, MakeInstance(0), 3.0f);
+			Run(queue, backend);
+			test.Check(DrawCounts(backend) == std::vector<uint32_t>{ 10, 30, 50 }, "opaque draws are ordered front to back");
+		}
+
+		{
+			RenderQueue queue;
+			RecordingRenderQueueBackend backend;
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 1, MakeInstance(0), 2.0f, RenderPass::Transparent);
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 2, MakeInstance(0), 8.0f, RenderPass::Transparent);
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 3, MakeInstance(0), 4.0f, RenderPass::Opaque);
+			Run(queue, backend);
+			test.Check(DrawCounts(backend) == std::vector<uint32_t>{ 3, 2, 1 }, "transparent draws follow the opaque ones back to front");
+		}
+
+		{
+			RenderQueue queue;
+			RecordingRenderQueueBackend backend;
+			for (uint32_t i = 0; i < 4; i++)
+				queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, i + 1, MakeInstance(0), 2.0f);
+			Run(queue, backend);
+			test.Check(DrawCounts(backend) == std::vector<uint32_t>{ 1, 2, 3, 4 }, "packets with equal keys keep their submission order");
+		}
+
+		{
+			RenderQueue queue;
+			RecordingRenderQueueBackend backend;
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 1, MakeInstance(0), 1.0f);
+			queue.Submit(&shaderB, &vertexArrayA, DrawMode::Indexed, 2, MakeInstance(0), 2.0f);
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 3, MakeInstance(0), 3.0f);
+			queue.Submit(&shaderB, &vertexArrayA, DrawMode::Indexed, 4, MakeInstance(0), 4.0f);
+			Run(queue, backend);
+
+			const std::vector<Command>& commands = backend.GetCommands();
+			const std::vector<Command> binds = Filter(backend, CommandType::BindShader);
+			test.Check(binds.size() == 2 && binds[0].Object == &shaderA && binds[1].Object == &shaderB, "draws are grouped by shader");
+			test.Check(DrawCounts(backend) == std::vector<uint32_t>{ 1, 3, 2, 4 }, "draws of a shader stay front to back");
+
+			bool viewProjectionAfterBind = Filter(backend, CommandType::SetViewProjection).size() == binds.size();
+			for (size_t i = 0; i < commands.size(); i++)
+			{
+				if (commands[i].Type == CommandType::BindShader)
+					viewProjectionAfterBind &= i + 1 < commands.size() && commands[i + 1].Type == CommandType::SetViewProjection;
+			}
+			test.Check(viewProjectionAfterBind, "the view projection is set once after each shader bind");
+			test.Check(Filter(backend, CommandType::BindVertexArray).size() == 1, "a shared vertex array is bound once");
+		}
+
+		{
+			RenderQueue queue;
+			RecordingRenderQueueBackend backend;
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 1, MakeInstance(0), 1.0f);
+			queue.Submit(&shaderA, &vertexArrayB, DrawMode::Indexed, 2, MakeInstance(0), 2.0f);
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 3, MakeInstance(0), 3.0f);
+			queue.Submit(&shaderA, &vertexArrayB, DrawMode::Indexed, 4, MakeInstance(0), 4.0f);
+			Run(queue, backend);
+			test.Check(Filter(backend, CommandType::BindVertexArray).size() == 2, "draws are grouped by vertex array inside a shader");
+		}
+
+		{
+			RenderQueue queue;
+			RecordingRenderQueueBackend backend;
+			const float depths[] = { 5.0f, 1.0f, 4.0f, 2.0f, 3.0f };
+			for (float depth : depths)
+				queue.Submit(&instancedShader, &vertexArrayA, DrawMode::Indexed, 36, MakeInstance(depth), depth);
+			Run(queue, backend);
+
+			const std::vector<Command> uploads = Filter(backend, CommandType::UploadInstances);
+			const std::vector<Command> draws = Filter(backend, CommandType::DrawInstanced);
+			test.Check(uploads.size() == 1 && uploads[0].Count == 5, "an instanced run is uploaded once");
+			test.Check(draws.size() == 1 && draws[0].Count == 5 && draws[0].First == 0 && DrawCounts(backend).empty(), "an instanced run is one draw");
+
+			const std::vector<InstanceData>& instances = backend.GetLastInstances();
+			bool frontToBack = instances.size() == 5;
+			for (size_t i = 0; frontToBack && i < instances.size(); i++)
+				frontToBack = instances[i].Color.x == (float)(i + 1);
+			test.Check(frontToBack, "instances are uploaded front to back");
+
+			const RenderQueue::Statistics& statistics = queue.GetStatistics();
+			test.Check(statistics.DrawCalls == 1 && statistics.InstancedDrawCalls == 1 && statistics.Instances == 5, "instanced statistics");
+		}
+
+		{
+			RenderQueue queue;
+			RecordingRenderQueueBackend backend(4);
+			for (uint32_t i = 0; i < 10; i++)
+				queue.Submit(&instancedShader, &vertexArrayA, DrawMode::Indexed, 36, MakeInstance((float)i), 1.0f + i);
+			Run(queue, backend);
+
+			std::vector<uint32_t> uploads;
+			for (const Command& command : Filter(backend, CommandType::UploadInstances))
+				uploads.push_back(command.Count);
+			std::vector<uint32_t> draws;
+			for (const Command& command : Filter(backend, CommandType::DrawInstanced))
+				draws.push_back(command.Count);
+			test.Check(uploads == std::vector<uint32_t>{ 4, 4, 2 } && draws == uploads, "a run larger than the instance buffer is split");
+			test.Check(Filter(backend, CommandType::BindShader).size() == 1, "splitting a run does not rebind the shader");
+		}
+
+		{
+			RenderQueue queue;
+			RecordingRenderQueueBackend backend;
+			queue.Submit(&instancedShader, &vertexArrayA, DrawMode::Indexed, 36, MakeInstance(0), 1.0f);
+			queue.Submit(&instancedShader, &vertexArrayA, DrawMode::Indexed, 36, MakeInstance(1), 2.0f);
+			queue.Submit(&instancedShader, &vertexArrayB, DrawMode::Indexed, 36, MakeInstance(2), 3.0f);
+			Run(queue, backend);
+
+			const std::vector<Command> draws = Filter(backend, CommandType::DrawInstanced);
+			test.Check(draws.size() == 2 && draws[0].Count == 2 && draws[1].Count == 1 && draws[1].First == 2,
+				"instanced runs break at a different vertex array and share one upload");
+		}
+
+		{
+			// Shader ids are in bits 48 to 59 and vertex array ids in bits 16 to 31 of an opaque key
+			RenderQueue queue;
+			queue.Submit(&shaderB, &vertexArrayB, DrawMode::Indexed, 1, MakeInstance(0), 1.0f);
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 2, MakeInstance(0), 1.0f);
+			queue.Clear();
+
+			queue.Submit(&shaderA, &vertexArrayA, DrawMode::Indexed, 2, MakeInstance(0), 1.0f);
+			queue.Sort();
+			const uint64_t key = queue.GetPacket(0).SortKey;
+			test.Check(((key >> 48) & 0xFFF) == 0 && ((key >> 16) & 0xFFFF) == 0, "ids are handed out again from 0 after a clear");
+		}
+
+		return test.GetFailed();
+	}
+
+}
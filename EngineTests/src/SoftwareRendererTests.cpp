@@ -0,0 +1,163 @@
+/*
+	Software Renderer Tests
+
+	Renders through RenderCommand on the software renderer API into a 16x16 back buffer: a clear and
+	three flat coloured triangles, one behind the others, then reads pixels back where each colour has
+	to win. The same frame without the depth test shows the last triangle drawn on top instead.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Renderer/RenderCommand.h"
+#include "GameEngine/Renderer/Shader.h"
+#include "Platform/Software/SoftwareRendererAPI.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace ge {
+
+	static const UniformID s_ColorID("u_Color");
+
+	// Positions are already in clip space, the colour is a uniform
+	static void RegisterFlatColorProgram()
+	{
+		SoftwareProgram flatColor;
+		flatColor.VaryingCount = 1;
+		flatColor.Vertex = [](const SoftwareShader& shader, const glm::vec4* attributes, SoftwareVertex& vertex)
+		{
+			vertex.Position = glm::vec4(glm::vec3(attributes[0]), 1.0f);
+			vertex.Varyings[0] = shader.GetFloat4(s_ColorID);
+		};
+		flatColor.Pixel = [](const SoftwareShader& /*shader*/, const glm::vec4* varyings, glm::vec4& color)
+		{
+			color = varyings[0];
+			return true;
+		};
+		SoftwareShader::Register("EngineTestsFlatColor", flatColor);
+	}
+
+	struct SoftwareTestPixel
+	{
+		uint8_t R, G, B, A;
+
+		bool operator==(const SoftwareTestPixel& other) const { return R == other.R && G == other.G && B == other.B && A == other.A; }
+	};
+
+	static const uint32_t s_Size = 16;
+	static const SoftwareTestPixel s_ClearPixel = { 51, 102, 153, 255 };
+	static const SoftwareTestPixel s_RedPixel = { 255, 0, 0, 255 };
+	static const SoftwareTestPixel s_GreenPixel = { 0, 255, 0, 255 };
+	static const SoftwareTestPixel s_BluePixel = { 0, 0, 255, 255 };
+
+	// x and y in pixels from the bottom left, ReadPixels gives the top row first
+	static SoftwareTestPixel GetPixel(const std::vector<uint8_t>& pixels, uint32_t x, uint32_t y)
+	{
+		const uint8_t* pixel = pixels.data() + ((size_t)(s_Size - 1 - y) * s_Size + x) * 4;
+		return { pixel[0], pixel[1], pixel[2], pixel[3] };
+	}
+
+	static bool OnlyColors(const std::vector<uint8_t>& pixels, const std::vector<SoftwareTestPixel>& colors)
+	{
+		for (uint32_t y = 0; y < s_Size; y++)
+		{
+			for (uint32_t x = 0; x < s_Size; x++)
+			{
+				if (std::find(colors.begin(), colors.end(), GetPixel(pixels, x, y)) == colors.end())
+					return false;
+			}
+		}
+		return true;
+	}
+
+	int RunSoftwareRendererTests()
+	{
+		TestContext test("SoftwareRenderer");
+
+		const RendererAPI::API previousAPI = RendererAPI::GetAPI();
+		RenderCommand::SetAPI(RendererAPI::API::Software);
+		RenderCommand::Init();
+		RegisterFlatColorProgram();
+
+		{
+			// Red covers the left and bottom quarters of the screen at depth 0, green the right and bottom
+			// ones behind it at 0.5. Blue is a small triangle in the bottom quarter in front of both.
+			float vertices[] = {
+				-1.0f, -1.0f,  0.0f,    1.0f, -1.0f,  0.0f,   -1.0f,  1.0f,  0.0f,
+				-1.0f, -1.0f,  0.5f,    1.0f, -1.0f,  0.5f,    1.0f,  1.0f,  0.5f,
+				-0.5f, -0.9f, -0.5f,    0.5f, -0.9f, -0.5f,    0.0f, -0.3f, -0.5f,
+			};
+			uint32_t indices[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+
+			Ref<VertexArray> vertexArray;
+			vertexArray.reset(VertexArray::Create());
+			Ref<VertexBuffer> vertexBuffer;
+			vertexBuffer.reset(VertexBuffer::Create(vertices, sizeof(vertices)));
+			vertexBuffer->SetLayout({ { ShaderDataType::Float3, "a_Position" } });
+			vertexArray->AddVertexBuffer(vertexBuffer);
+			Ref<IndexBuffer> indexBuffer;
+			indexBuffer.reset(IndexBuffer::Create(indices, 9));
+			vertexArray->SetIndexBuffer(indexBuffer);
+
+			Ref<Shader> shader = Shader::Create("EngineTestsFlatColor", "", "");
+			shader->Bind();
+
+			auto drawTriangle = [&](uint32_t triangle, const glm::vec4& color)
+			{
+				shader->SetFloat4(s_ColorID, color);
+				RenderCommand::DrawIndexedRange(vertexArray, 3, triangle * 3, 0);
+			};
+
+			auto drawFrame = [&](bool depthTest, std::vector<uint8_t>& pixels)
+			{
+				RenderCommand::SetViewport(0, 0, s_Size, s_Size);
+				RenderCommand::SetClearColor(glm::vec4(0.2f, 0.4f, 0.6f, 1.0f));
+				RenderCommand::Clear();
+				if (depthTest)
+				{
+					RenderCommand::EnableZBuffer();
+					RenderCommand::DepthFunc("LESS");
+				}
+				else
+				{
+					RenderCommand::DisableZBuffer();
+				}
+
+				drawTriangle(0, glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+				drawTriangle(2, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+				drawTriangle(1, glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+				SoftwareRendererAPI::GetBackBuffer().ReadPixels(pixels);
+			};
+
+			std::vector<uint8_t> pixels;
+			SoftwareRendererAPI::SetThreadCount(1);
+			drawFrame(true, pixels);
+
+			test.Check(SoftwareRendererAPI::GetBackBuffer().GetWidth() == s_Size && pixels.size() == (size_t)s_Size * s_Size * 4,
+				"the back buffer takes the size of the viewport");
+			test.Check(GetPixel(pixels, 8, 14) == s_ClearPixel && GetPixel(pixels, 7, 15) == s_ClearPixel, "pixels no triangle covers keep the clear colour");
+			test.Check(GetPixel(pixels, 1, 8) == s_RedPixel && GetPixel(pixels, 14, 8) == s_GreenPixel, "triangles fill the pixels they cover");
+			test.Check(GetPixel(pixels, 3, 1) == s_RedPixel && GetPixel(pixels, 12, 1) == s_RedPixel, "a triangle behind an earlier one is hidden by the depth test");
+			test.Check(GetPixel(pixels, 8, 2) == s_BluePixel && GetPixel(pixels, 3, 2) == s_RedPixel, "a triangle in front of both is drawn over them");
+			test.Check(OnlyColors(pixels, { s_ClearPixel, s_RedPixel, s_GreenPixel, s_BluePixel }), "every pixel has one of the colours drawn");
+
+			// Tiles filled on a pool give the same image as drawing on one thread
+			std::vector<uint8_t> threaded;
+			SoftwareRendererAPI::SetThreadCount(4);
+			drawFrame(true, threaded);
+			test.Check(threaded == pixels, "a frame drawn on several threads matches one drawn on one");
+
+			std::vector<uint8_t> noDepth;
+			drawFrame(false, noDepth);
+			test.Check(GetPixel(noDepth, 12, 1) == s_GreenPixel && GetPixel(noDepth, 8, 2) == s_GreenPixel && GetPixel(noDepth, 1, 8) == s_RedPixel,
+				"without the depth test the last triangle drawn is on top");
+
+			shader->Unbind();
+			SoftwareRendererAPI::SetThreadCount(0);
+		}
+
+		RenderCommand::SetAPI(previousAPI);
+		return test.GetFailed();
+	}
+
+}
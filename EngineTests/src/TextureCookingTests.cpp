@@ -0,0 +1,300 @@
+/*
+	Texture Cooking Tests
+
+	Encodes blocks with the BC encoders and decodes them again with the reference decoding of each format,
+	then checks the error on a gradient and a solid block. Writes a cooked texture to the temporary
+	directory and reads it back, and checks that Open rejects damaged files.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Renderer/BlockCompression.h"
+#include "GameEngine/Renderer/CookedTexture.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace ge {
+
+	////// Reference decoders //////
+
+	static void DecodeRGB565(uint16_t packed, int color[3])
+	{
+		const int r = (packed >> 11) & 31;
+		const int g = (packed >> 5) & 63;
+		const int b = packed & 31;
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+
+	// Four colours when the first endpoint is the larger one, otherwise three and black
+	static void DecodeColorBlock(const uint8_t* block, uint8_t pixels[16][4])
+	{
+		const uint16_t color0 = (uint16_t)(block[0] | (block[1] << 8));
+		const uint16_t color1 = (uint16_t)(block[2] | (block[3] << 8));
+		int palette[4][3];
+		DecodeRGB565(color0, palette[0]);
+		DecodeRGB565(color1, palette[1]);
+		for (int c = 0; c < 3; c++)
+		{
+			if (color0 > color1)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+
+		uint32_t indices;
+		std::memcpy(&indices, block + 4, 4);
+		for (int i = 0; i < 16; i++)
+		{
+			const uint32_t index = (indices >> (2 * i)) & 3;
+			for (int c = 0; c < 3; c++)
+				pixels[i][c] = (uint8_t)palette[index][c];
+		}
+	}
+
+	// Eight levels when the first endpoint is the larger one, otherwise six and 0 and 255
+	static void DecodeSingleChannelBlock(const uint8_t* block, uint8_t values[16])
+	{
+		const int value0 = block[0];
+		const int value1 = block[1];
+		int palette[8] = { value0, value1 };
+		for (int p = 2; p < 8; p++)
+		{
+			if (value0 > value1)
+				palette[p] = ((8 - p) * value0 + (p - 1) * value1 + 3) / 7;
+			else if (p < 6)
+				palette[p] = ((6 - p) * value0 + (p - 1) * value1 + 2) / 5;
+			else
+				palette[p] = p == 6 ? 0 : 255;
+		}
+
+		uint64_t indices = 0;
+		for (int i = 0; i < 6; i++)
+			indices |= (uint64_t)block[2 + i] << (8 * i);
+		for (int i = 0; i < 16; i++)
+			values[i] = (uint8_t)palette[(indices >> (3 * i)) & 7];
+	}
+
+	////// Blocks //////
+
+	// Every channel changes linearly along the pixels, with a different slope and direction each
+	static void MakeGradientBlock(uint8_t pixels[16][4])
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			pixels[i][0] = (uint8_t)(30 + 12 * i);
+			pixels[i][1] = (uint8_t)(220 - 9 * i);
+			pixels[i][2] = (uint8_t)(80 + 5 * i);
+			pixels[i][3] = (uint8_t)(255 - 15 * i);
+		}
+	}
+
+	static void MakeSolidBlock(uint8_t pixels[16][4])
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			pixels[i][0] = 200;
+			pixels[i][1] = 100;
+			pixels[i][2] = 50;
+			pixels[i][3] = 128;
+		}
+	}
+
+	// Largest difference of the channels from first to first + count
+	static int MaxError(const uint8_t a[16][4], const uint8_t b[16][4], int first, int count)
+	{
+		int error = 0;
+		for (int i = 0; i < 16; i++)
+			for (int c = first; c < first + count; c++)
+				error = std::max(error, std::abs(a[i][c] - b[i][c]));
+		return error;
+	}
+
+	static int RoundTripBC1(const uint8_t pixels[16][4])
+	{
+		uint8_t block[8];
+		uint8_t decoded[16][4] = {};
+		BlockCompression::EncodeBC1(pixels, block);
+		DecodeColorBlock(block, decoded);
+		return MaxError(pixels, decoded, 0, 3);
+	}
+
+	// Colour and alpha errors
+	static void RoundTripBC3(const uint8_t pixels[16][4], int& colorError, int& alphaError)
+	{
+		uint8_t block[16];
+		uint8_t decoded[16][4] = {};
+		uint8_t alpha[16];
+		BlockCompression::EncodeBC3(pixels, block);
+		DecodeSingleChannelBlock(block, alpha);
+		DecodeColorBlock(block + 8, decoded);
+		for (int i = 0; i < 16; i++)
+			decoded[i][3] = alpha[i];
+		colorError = MaxError(pixels, decoded, 0, 3);
+		alphaError = MaxError(pixels, decoded, 3, 1);
+	}
+
+	static int RoundTripBC5(const uint8_t pixels[16][4])
+	{
+		uint8_t block[16];
+		uint8_t decoded[16][4] = {};
+		uint8_t red[16], green[16];
+		BlockCompression::EncodeBC5(pixels, block);
+		DecodeSingleChannelBlock(block, red);
+		DecodeSingleChannelBlock(block + 8, green);
+		for (int i = 0; i < 16; i++)
+		{
+			decoded[i][0] = red[i];
+			decoded[i][1] = green[i];
+		}
+		return MaxError(pixels, decoded, 0, 2);
+	}
+
+	////// Files //////
+
+	static bool WriteBytes(const std::string& path, const std::vector<char>& bytes)
+	{
+		std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		out.write(bytes.data(), (std::streamsize)bytes.size());
+		return (bool)out;
+	}
+
+	static std::vector<char> ReadBytes(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	int RunTextureCookingTests()
+	{
+		TestContext test("TextureCooking");
+
+		{
+			uint8_t gradient[16][4], solid[16][4];
+			MakeGradientBlock(gradient);
+			MakeSolidBlock(solid);
+
+			// The encoder pulls the ends of a range of 180 in by 1/16 each, its four colours are then 53 apart.
+			// Half of that plus the RGB565 rounding.
+			test.Check(RoundTripBC1(gradient) <= 30, "BC1 keeps a gradient within the error bound");
+			// RGB565 keeps 5 and 6 bits, the dropped bits are off by at most 4
+			test.Check(RoundTripBC1(solid) <= 4, "BC1 keeps a solid colour within the RGB565 rounding");
+
+			int colorError, alphaError;
+			RoundTripBC3(gradient, colorError, alphaError);
+			// Eight levels over the alpha range of 225 are 32 apart, half of that plus the rounding of the levels
+			test.Check(colorError <= 30 && alphaError <= 17, "BC3 keeps a gradient within the error bound");
+			RoundTripBC3(solid, colorError, alphaError);
+			test.Check(colorError <= 4 && alphaError == 0, "BC3 keeps a solid block, alpha exactly");
+
+			// The widest of the two channels spans 180, its levels are 26 apart
+			test.Check(RoundTripBC5(gradient) <= 14, "BC5 keeps a gradient within the error bound");
+			test.Check(RoundTripBC5(solid) == 0, "BC5 keeps a solid block exactly");
+		}
+
+		{
+			test.Check(BlockCompression::GetBlockSize(TextureCompression::BC1) == 8 && BlockCompression::GetBlockSize(TextureCompression::BC3) == 16
+				&& BlockCompression::GetBlockSize(TextureCompression::BC5) == 16, "block sizes");
+
+			// A 6x5 image needs 2x2 blocks, the edge blocks repeat the last row and column
+			std::vector<uint8_t> image(6 * 5 * 4, 0);
+			for (size_t i = 0; i < image.size(); i += 4)
+				image[i] = 255;
+			std::vector<uint8_t> data;
+			BlockCompression::Encode(TextureCompression::BC1, image.data(), 6, 5, data);
+
+			bool allRed = data.size() == 4 * 8;
+			for (size_t b = 0; allRed && b < data.size(); b += 8)
+			{
+				uint8_t decoded[16][4] = {};
+				DecodeColorBlock(data.data() + b, decoded);
+				for (int i = 0; i < 16; i++)
+					allRed &= decoded[i][0] == 255 && decoded[i][1] == 0 && decoded[i][2] == 0;
+			}
+			test.Check(allRed, "images are encoded in whole blocks");
+		}
+
+		{
+			const std::filesystem::path directory = std::filesystem::temp_directory_path();
+			const std::string path = (directory / "EngineTests.getex").string();
+
+			// An 8x8 BC1 texture with its full mip chain, every byte numbered so misplaced levels show
+			CookedTextureHeader header;
+			header.Compression = (uint32_t)TextureCompression::BC1;
+			header.Flags = CookedTextureFlags_sRGB;
+			header.Width = 8;
+			header.Height = 8;
+			header.SourceSize = 1234;
+			header.SourceTime = 5678;
+			std::vector<std::vector<uint8_t>> levels = { std::vector<uint8_t>(32), std::vector<uint8_t>(8), std::vector<uint8_t>(8), std::vector<uint8_t>(8) };
+			for (size_t l = 0; l < levels.size(); l++)
+				for (size_t i = 0; i < levels[l].size(); i++)
+					levels[l][i] = (uint8_t)(l * 64 + i);
+
+			test.Check(CookedTexture::Write(path, header, levels), "a cooked texture is written");
+
+			CookedTexture cooked;
+			uint64_t levelOffset = 0;
+			const bool opened = cooked.Open(path);
+			test.Check(opened, "a cooked texture is read back");
+			if (opened)
+			{
+				const CookedTextureHeader& read = cooked.GetHeader();
+				levelOffset = read.LevelOffset;
+				test.Check(read.Magic == CookedTexture::Magic && read.Version == CookedTexture::Version && read.Width == 8 && read.Height == 8
+					&& read.LevelCount == 4 && cooked.GetCompression() == TextureCompression::BC1 && cooked.IsSRGB(), "the header is read back");
+				test.Check(cooked.IsCurrent({ 1234, 5678 }, true) && !cooked.IsCurrent({ 1234, 5679 }, true) && !cooked.IsCurrent({ 1234, 5678 }, false),
+					"the source stamp and colour space are read back");
+
+				bool sameLevels = cooked.GetDataSize() == 56;
+				for (uint32_t l = 0; sameLevels && l < 4; l++)
+				{
+					const CookedTextureLevel& level = cooked.GetLevels()[l];
+					sameLevels = level.Width == std::max(8u >> l, 1u) && level.Height == std::max(8u >> l, 1u) && level.Size == levels[l].size()
+						&& level.Offset % CookedTexture::Alignment == 0 && std::memcmp(cooked.GetLevelData(l), levels[l].data(), levels[l].size()) == 0;
+				}
+				test.Check(sameLevels, "every mip is read back aligned and unchanged");
+				cooked.Close();
+			}
+
+			const std::vector<char> bytes = ReadBytes(path);
+			const std::string damagedPath = (directory / "EngineTests.damaged.getex").string();
+
+			std::vector<char> truncated(bytes.begin(), bytes.end() - 4);
+			test.Check(WriteBytes(damagedPath, truncated) && !cooked.Open(damagedPath), "a truncated file is rejected");
+
+			std::vector<char> headerOnly(bytes.begin(), bytes.begin() + sizeof(CookedTextureHeader) / 2);
+			test.Check(WriteBytes(damagedPath, headerOnly) && !cooked.Open(damagedPath), "a file shorter than the header is rejected");
+
+			std::vector<char> wrongVersion = bytes;
+			const uint32_t version = CookedTexture::Version + 1;
+			std::memcpy(wrongVersion.data() + offsetof(CookedTextureHeader, Version), &version, sizeof(version));
+			test.Check(WriteBytes(damagedPath, wrongVersion) && !cooked.Open(damagedPath), "a file of another version is rejected");
+
+			// Only the size of the first level changes, the file still holds it
+			std::vector<char> wrongLevel = bytes;
+			const uint64_t levelSize = 16;
+			std::memcpy(wrongLevel.data() + levelOffset + offsetof(CookedTextureLevel, Size), &levelSize, sizeof(levelSize));
+			test.Check(WriteBytes(damagedPath, wrongLevel) && !cooked.Open(damagedPath), "a level of the wrong size is rejected");
+
+			std::error_code error;
+			std::filesystem::remove(path, error);
+			std::filesystem::remove(damagedPath, error);
+		}
+
+		return test.GetFailed();
+	}
+
+}
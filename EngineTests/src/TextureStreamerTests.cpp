@@ -0,0 +1,195 @@
+/*
+	Texture Streamer Tests
+
+	Runs the TextureStreamer against fake streamable textures that only record their resident mip:
+	the mips picked from requests and screen sizes, the memory and upload budgets and the eviction
+	of textures that stopped being requested.
+*/
+
+#include "EngineTests.h"
+
+#include "GameEngine/Renderer/TextureStreamer.h"
+
+namespace ge {
+
+	// Square RGBA8 texture with a full mip chain. Registers itself like the OpenGL textures do,
+	// starting with only its base mips resident.
+	class FakeStreamableTexture : public Texture, public StreamableTexture
+	{
+	public:
+		FakeStreamableTexture(uint32_t size) : m_Size(size)
+		{
+			while ((size >> m_MipCount) > 0)
+				m_MipCount++;
+			m_ResidentMip = TextureStreamer::GetBaseMip(m_Size, m_Size, m_MipCount);
+			TextureStreamer::Register(this);
+		}
+
+		~FakeStreamableTexture()
+		{
+			TextureStreamer::Unregister(this);
+		}
+
+		virtual uint32_t GetWidth() const override { return m_Size; }
+		virtual uint32_t GetHeight() const override { return m_Size; }
+		virtual void Bind(uint32_t /*slot*/) const override {}
+		virtual StreamableTexture* GetStreamable() override { return this; }
+
+		virtual uint32_t GetMipCount() const override { return m_MipCount; }
+		virtual size_t GetMipSize(uint32_t level) const override
+		{
+			const size_t size = std::max(m_Size >> level, 1u);
+			return size * size * 4;
+		}
+
+		virtual uint32_t GetResidentMip() const override { return m_ResidentMip; }
+		virtual void SetResidentMip(uint32_t level) override { m_ResidentMip = level; }
+
+		// Bytes of every level from level down to 1x1
+		size_t GetTailSize(uint32_t level) const
+		{
+			size_t size = 0;
+			for (uint32_t i = level; i < m_MipCount; i++)
+				size += GetMipSize(i);
+			return size;
+		}
+	private:
+		uint32_t m_Size;
+		uint32_t m_MipCount = 0;
+		uint32_t m_ResidentMip = 0;
+	};
+
+	// A texture that is always fully resident
+	class FakeTexture : public Texture
+	{
+	public:
+		virtual uint32_t GetWidth() const override { return 256; }
+		virtual uint32_t GetHeight() const override { return 256; }
+		virtual void Bind(uint32_t /*slot*/) const override {}
+	};
+
+	// The settings are global, every case starts from the defaults
+	static void ResetSettings()
+	{
+		TextureStreamer::SetMemoryBudget(256 * 1024 * 1024);
+		TextureStreamer::SetUploadBudget(16 * 1024 * 1024);
+		TextureStreamer::SetMinResidentSize(64);
+		TextureStreamer::SetEvictDelay(60);
+		TextureStreamer::SetMipBias(0.0f);
+	}
+
+	int RunTextureStreamerTests()
+	{
+		TestContext test("TextureStreamer");
+
+		{
+			ResetSettings();
+			test.Check(TextureStreamer::ComputeMip(1024, 1024, 11, 1024.0f) == 0, "a texture as large as on screen needs level 0");
+			test.Check(TextureStreamer::ComputeMip(1024, 1024, 11, 256.0f) == 2, "a quarter of the size needs level 2");
+			test.Check(TextureStreamer::ComputeMip(1024, 1024, 11, 300.0f) == 1, "levels are rounded towards the finer one");
+			test.Check(TextureStreamer::ComputeMip(1024, 1024, 11, 0.0f) == 10, "a texture off screen needs the last level");
+			test.Check(TextureStreamer::ComputeMip(1024, 1024, 11, 4096.0f) == 0, "magnified textures need level 0");
+
+			TextureStreamer::SetMipBias(1.0f);
+			test.Check(TextureStreamer::ComputeMip(1024, 1024, 11, 256.0f) == 3, "the mip bias moves to a coarser level");
+			ResetSettings();
+
+			test.Check(TextureStreamer::GetBaseMip(1024, 1024, 11) == 4, "the base mip is the first one no larger than the minimum resident size");
+			test.Check(TextureStreamer::GetBaseMip(1024, 256, 11) == 4, "the base mip fits both dimensions");
+			test.Check(TextureStreamer::GetBaseMip(32, 32, 6) == 0, "small textures are fully resident");
+		}
+
+		{
+			ResetSettings();
+			FakeStreamableTexture texture(1024);
+			test.Check(texture.GetResidentMip() == 4, "textures start with their base mips");
+
+			TextureStreamer::Update();
+			test.Check(texture.GetResidentMip() == 4 && TextureStreamer::GetStatistics().LevelsLoaded == 0, "nothing is loaded without a request");
+
+			TextureStreamer::RequestMip(&texture, 3);
+			TextureStreamer::RequestMip(&texture, 1);
+			TextureStreamer::RequestMip(&texture, 2);
+			TextureStreamer::Update();
+			const TextureStreamer::Statistics statistics = TextureStreamer::GetStatistics();
+			test.Check(texture.GetResidentMip() == 1, "the finest request of a frame is loaded");
+			test.Check(statistics.LevelsLoaded == 3 && statistics.ResidentBytes == texture.GetTailSize(1), "loaded statistics");
+
+			TextureStreamer::RequestMip(&texture, 3);
+			TextureStreamer::Update();
+			test.Check(texture.GetResidentMip() == 3 && TextureStreamer::GetStatistics().LevelsEvicted == 2, "a coarser request evicts the finer levels");
+
+			TextureStreamer::RequestMip(&texture, 20);
+			TextureStreamer::Update();
+			test.Check(texture.GetResidentMip() == 4, "the base mips are never evicted");
+		}
+
+		{
+			ResetSettings();
+			FakeStreamableTexture texture(256);
+			FakeTexture resident;
+
+			TextureStreamer::RequestScreenSize(texture, 256.0f);
+			TextureStreamer::RequestScreenSize(resident, 256.0f);
+			TextureStreamer::Update();
+			test.Check(texture.GetResidentMip() == 0, "a screen size request loads the matching level");
+			test.Check(TextureStreamer::GetStatistics().Textures == 1, "textures without a streamable side are ignored");
+		}
+
+		{
+			ResetSettings();
+			TextureStreamer::SetEvictDelay(2);
+			FakeStreamableTexture texture(256);
+
+			TextureStreamer::RequestMip(&texture, 0);
+			TextureStreamer::Update();
+			TextureStreamer::Update();
+			TextureStreamer::Update();
+			test.Check(texture.GetResidentMip() == 0, "a request is kept for the evict delay");
+			TextureStreamer::Update();
+			test.Check(texture.GetResidentMip() == 2, "a texture no longer requested falls back to its base mips");
+		}
+
+		{
+			ResetSettings();
+			// Room for a level at a time, one level always gets in so the texture gets there eventually
+			TextureStreamer::SetUploadBudget(1);
+			FakeStreamableTexture texture(1024);
+
+			bool oneLevelPerFrame = true;
+			for (uint32_t frame = 0; frame < 4; frame++)
+			{
+				TextureStreamer::RequestMip(&texture, 0);
+				TextureStreamer::Update();
+				oneLevelPerFrame &= texture.GetResidentMip() == 3 - frame && TextureStreamer::GetStatistics().LevelsLoaded == 1;
+			}
+			test.Check(oneLevelPerFrame, "the upload budget spreads the loads over frames");
+		}
+
+		{
+			ResetSettings();
+			FakeStreamableTexture magnified(256);
+			FakeStreamableTexture other(256);
+
+			// Both reach level 1, there is no room left for level 0 of the first one
+			TextureStreamer::SetMemoryBudget(magnified.GetTailSize(1) + other.GetTailSize(1));
+			TextureStreamer::RequestMip(&magnified, 0);
+			TextureStreamer::RequestMip(&other, 1);
+			TextureStreamer::Update();
+			const TextureStreamer::Statistics statistics = TextureStreamer::GetStatistics();
+			test.Check(magnified.GetResidentMip() == 1 && other.GetResidentMip() == 1, "the most magnified levels are loaded first within the memory budget");
+			test.Check(statistics.OverBudget && statistics.ResidentBytes <= TextureStreamer::GetMemoryBudget(), "the memory budget is respected");
+			test.Check(statistics.RequestedBytes == magnified.GetTailSize(0) + other.GetTailSize(1), "requested statistics");
+
+			TextureStreamer::SetMemoryBudget(0);
+			TextureStreamer::RequestMip(&magnified, 0);
+			TextureStreamer::RequestMip(&other, 1);
+			TextureStreamer::Update();
+			test.Check(magnified.GetResidentMip() == 2 && other.GetResidentMip() == 2, "the base mips stay above the memory budget");
+		}
+
+		ResetSettings();
+		return test.GetFailed();
+	}
+
+}
@@ -15,11 +15,14 @@
 #include "GameEngine/Renderer/PerspectiveCameraController.h"
 #include "GameEngine/Renderer/Model.h"
 #include "GameEngine/Renderer/Framebuffer.h"
+#include "GameEngine/Renderer/FramebufferPool.h"
+#include "GameEngine/Renderer/RenderGraph.h"
 #include "GameEngine/Core/Scene.h"
 
 #include "GameEngine/Math/Quat.h"
 #include "GameEngine/Math/Matrix.h"
 #include "GameEngine/Math/Vector.h"
+#include "GameEngine/Math/Transform.h"
 
 #include "GameEngine/Physics/Body.h"
 
@@ -27,11 +30,19 @@
 
 // ---Renderer--------------------
 #include "GameEngine/Renderer/Renderer.h"
+#include "GameEngine/Renderer/Renderer2D.h"
 #include "GameEngine/Renderer/RenderCommand.h"
 
 #include "GameEngine/Renderer/Buffer.h"
 #include "GameEngine/Renderer/Shader.h"
+#include "GameEngine/Renderer/Material.h"
 #include "GameEngine/Renderer/Texture.h"
+#include "GameEngine/Renderer/AssetManager.h"
+#include "GameEngine/Renderer/TextureCache.h"
+#include "GameEngine/Renderer/TextureCooker.h"
+#include "GameEngine/Renderer/TextureStreamer.h"
+#include "GameEngine/Renderer/CookedTexture.h"
+#include "GameEngine/Renderer/IBLBaker.h"
 #include "GameEngine/Renderer/VertexArray.h"
 
 #include "GameEngine/Renderer/OrthographicCamera.h"
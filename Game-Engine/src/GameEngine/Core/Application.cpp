@@ -11,16 +11,60 @@
 #include "GameEngine/Core/Log.h"
 
 #include "GameEngine/Renderer/Renderer.h"
+#include "GameEngine/Renderer/AssetManager.h"
+#include "GameEngine/Renderer/TextureCache.h"
+#include "GameEngine/Renderer/TextureStreamer.h"
+
+#include "Platform/Headless/HeadlessWindow.h"
+#include "Platform/Software/SoftwareRendererAPI.h"
 
 #include "Input.h"
 
 #include <glfw/glfw3.h>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 
 namespace ge {
 
 #define BIND_EVENT_FN(x) std::bind(&Application::x, this, std::placeholders::_1)
 
 	Application* Application::s_Instance = nullptr;
+	HeadlessSettings Application::s_Headless;
+
+	// A frame count, 0 or anything that is not a number turns headless off
+	static uint32_t ParseFrameCount(const char* value)
+	{
+		return (uint32_t)std::strtoul(value, nullptr, 10);
+	}
+
+	void Application::ParseCommandLine(int argc, char** argv)
+	{
+		// The command line wins over the environment
+		if (const char* frames = std::getenv("GE_HEADLESS"))
+		{
+			s_Headless.Frames = ParseFrameCount(frames);
+			s_Headless.Enabled = s_Headless.Frames > 0;
+		}
+
+		for (int i = 1; i < argc; i++)
+		{
+			if (std::strcmp(argv[i], "--headless") != 0)
+				continue;
+
+			s_Headless.Enabled = true;
+			s_Headless.Frames = 1;
+			if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+				s_Headless.Frames = std::max(ParseFrameCount(argv[++i]), 1u);
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+				s_Headless.OutputDirectory = argv[++i];
+		}
+
+		// Before anything creates a resource of the default API
+		if (s_Headless.Enabled)
+			RenderCommand::SetAPI(RendererAPI::API::Software);
+	}
 
 	Application::Application()
 	{
@@ -28,13 +72,30 @@ namespace ge {
 		GE_CORE_ASSERT(!s_Instance, "Application already exists!");
 		s_Instance = this;
 
-		m_Window = std::unique_ptr<Window>(Window::Create());
-		m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
+		if (s_Headless.Enabled)
+		{
+			// Nothing is shown, the window only gives the back buffer its size
+			m_Window = std::make_unique<HeadlessWindow>(WindowProps());
+			m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
+
+			Renderer::Init();
+			Renderer::OnWindowResize(m_Window->GetWidth(), m_Window->GetHeight());
+		}
+		else
+		{
+			m_Window = std::unique_ptr<Window>(Window::Create());
+			m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
+		}
 
 		//Renderer::Init();
+		AssetManager::Init();
 
-		m_ImGuiLayer = new ImGuiLayer();
-		PushOverlay(m_ImGuiLayer);
+		// ImGui draws through OpenGL and reads the native window
+		if (!s_Headless.Enabled)
+		{
+			m_ImGuiLayer = new ImGuiLayer();
+			PushOverlay(m_ImGuiLayer);
+		}
 	}
 
 	// Essentially a wrapper
@@ -67,20 +128,42 @@ namespace ge {
 		}
 	}
 
+	Application::~Application()
+	{
+		// Before the window, the placeholders need the graphics context
+		AssetManager::Shutdown();
+		TextureCache::Clear();
+	}
+
 	void Application::Run() 
 	{
+		if (s_Headless.Enabled)
+		{
+			RunHeadless();
+			return;
+		}
+
 		while (m_Running) 
 		{
 			float time = (float)glfwGetTime();			// Will be in Platform GetTime() in the future
 			DeltaTime deltaTime = time - m_LastFrameTime;
 			m_LastFrameTime = time;
 
+			// State statistics are per frame
+			RenderCommand::ResetStateStatistics();
+
+			// Finished background loads become visible at the start of a frame
+			AssetManager::Update();
+
 			if (!m_Minimised)
 			{
 				for (Layer* layer : m_LayerStack)
 					layer->OnUpdate(deltaTime);
 			}
 
+			// Mip requests made while updating the layers are served for the next frame
+			TextureStreamer::Update();
+
 			// Render ImGui
 			m_ImGuiLayer->Begin();
 			for (Layer* layer : m_LayerStack)
@@ -91,6 +174,35 @@ namespace ge {
 		}
 	}
 
+	void Application::RunHeadless()
+	{
+		std::error_code error;
+		std::filesystem::create_directories(s_Headless.OutputDirectory, error);
+
+		// A fixed step, so a run renders the same frames whatever the machine
+		const DeltaTime deltaTime = 1.0f / 60.0f;
+		for (uint32_t frame = 0; frame < s_Headless.Frames; frame++)
+		{
+			RenderCommand::ResetStateStatistics();
+
+			// Every load finishes before the frame, so the images do not depend on how fast they decode
+			AssetManager::Flush();
+
+			for (Layer* layer : m_LayerStack)
+				layer->OnUpdate(deltaTime);
+
+			TextureStreamer::Update();
+
+			char name[32];
+			snprintf(name, sizeof(name), "frame_%04u.ppm", frame);
+			const std::string path = s_Headless.OutputDirectory + "/" + name;
+			if (SoftwareRendererAPI::GetBackBuffer().WriteImage(path))
+				GE_CORE_INFO("Wrote {0}", path);
+			else
+				GE_CORE_ERROR("Could not write {0}", path);
+		}
+	}
+
 	// Window Events
 
 	bool Application::OnWindowClose(WindowCloseEvent& e)
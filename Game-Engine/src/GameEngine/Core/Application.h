@@ -20,11 +20,20 @@
 
 namespace ge {
 
+	// Runs without a window or ImGui on the software renderer, writing every frame to an image.
+	// Selected with --headless [frames] [directory] on the command line or GE_HEADLESS=frames in the environment.
+	struct HeadlessSettings
+	{
+		bool Enabled = false;
+		uint32_t Frames = 1;
+		std::string OutputDirectory = "headless";
+	};
+
 	class Application
 	{
 	public:
 		Application();
-		virtual ~Application() = default;
+		virtual ~Application();
 
 		void Run();
 
@@ -36,18 +45,26 @@ namespace ge {
 		inline Window& GetWindow() { return *m_Window; }
 
 		inline static Application& Get() { return *s_Instance; }
+
+		// Reads the headless settings and picks the software renderer for them, before the application is created
+		static void ParseCommandLine(int argc, char** argv);
+		static const HeadlessSettings& GetHeadlessSettings() { return s_Headless; }
 	private:
+		// Updates the layers for the headless frames with a fixed time step and writes the back buffer after each
+		void RunHeadless();
+
 		bool OnWindowClose(WindowCloseEvent& e);
 		bool OnWindowResize(WindowResizeEvent& e);
 	private:
 		std::unique_ptr<Window> m_Window;
-		ImGuiLayer* m_ImGuiLayer;
+		ImGuiLayer* m_ImGuiLayer = nullptr;
 		bool m_Running = true;
 		bool m_Minimised = false;
 		LayerStack m_LayerStack;
 		float m_LastFrameTime = 0.0f;
 	private:
 		static Application* s_Instance;
+		static HeadlessSettings s_Headless;
 	};
 
 	// To be defined in CLIENT
@@ -21,6 +21,9 @@
 	#define GE_API
 #endif
 
+#elif defined(GE_PLATFORM_LINUX)
+	// Only the platform independent parts (math, tools and tests) build on Linux
+	#define GE_API
 #else 
 	#error Game Engine only support Windows (for now)
 #endif
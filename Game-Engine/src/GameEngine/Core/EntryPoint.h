@@ -20,6 +20,7 @@ int main(int argc, char** argv) {
 	GE_INFO("Hello! Var={0}", a);
 
 	//printf("Game Engine\n");
+	ge::Application::ParseCommandLine(argc, argv);
 	auto app = ge::CreateApplication();
 	app->Run();
 	delete app;
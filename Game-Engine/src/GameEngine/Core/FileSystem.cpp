@@ -0,0 +1,54 @@
+/*
+	File System
+
+	Small helpers for reading files and telling when they changed
+*/
+
+#include "gepch.h"
+#include "FileSystem.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace ge {
+
+	bool FileSystem::GetStamp(const std::string& path, FileStamp& stamp)
+	{
+		std::error_code error;
+		const uint64_t size = std::filesystem::file_size(path, error);
+		if (error)
+			return false;
+
+		const auto time = std::filesystem::last_write_time(path, error);
+		if (error)
+			return false;
+
+		stamp.Size = size;
+		stamp.Time = (int64_t)time.time_since_epoch().count();
+		return true;
+	}
+
+	bool FileSystem::ReadFile(const std::string& path, std::vector<uint8_t>& bytes)
+	{
+		std::ifstream in(path, std::ios::in | std::ios::binary | std::ios::ate);
+		if (!in)
+			return false;
+
+		bytes.resize((size_t)in.tellg());
+		in.seekg(0, std::ios::beg);
+		in.read((char*)bytes.data(), (std::streamsize)bytes.size());
+		return (bool)in;
+	}
+
+	uint64_t FileSystem::Hash(const void* data, size_t size)
+	{
+		const uint8_t* bytes = (const uint8_t*)data;
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
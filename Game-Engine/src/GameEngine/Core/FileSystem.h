@@ -0,0 +1,34 @@
+/*
+	File System
+
+	Small helpers for reading files and telling when they changed
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Core.h"
+
+namespace ge {
+
+	// Size and last write time of a file, a change in either means the file changed
+	struct FileStamp
+	{
+		uint64_t Size = 0;
+		int64_t Time = 0;
+
+		bool operator==(const FileStamp& other) const { return Size == other.Size && Time == other.Time; }
+		bool operator!=(const FileStamp& other) const { return !(*this == other); }
+	};
+
+	class FileSystem
+	{
+	public:
+		// False if the file doesn't exist
+		static bool GetStamp(const std::string& path, FileStamp& stamp);
+		// Reads the whole file
+		static bool ReadFile(const std::string& path, std::vector<uint8_t>& bytes);
+
+		// 64 bit FNV-1a of the bytes, for telling file contents apart
+		static uint64_t Hash(const void* data, size_t size);
+	};
+}
@@ -0,0 +1,38 @@
+/*
+	Mapped File
+
+	Read only view of a whole file mapped into memory. The pages are loaded by the OS as they are
+	touched, so nothing is copied until the data is used. The implementation is per platform
+	(Platform/Windows/WindowsMappedFile.cpp and Platform/Posix/PosixMappedFile.cpp).
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Core.h"
+
+namespace ge {
+
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// Maps the file, closing whatever was open before. Returns false if it can't be opened or is empty.
+		bool Open(const std::string& path);
+		void Close();
+
+		bool IsOpen() const { return m_Data != nullptr; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+	private:
+		// Only used on Windows, POSIX closes the file once it is mapped
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+	};
+}
@@ -0,0 +1,82 @@
+/*
+	Thread Pool
+
+	Fixed set of worker threads running jobs from a shared first in first out queue
+*/
+
+#include "gepch.h"
+#include "ThreadPool.h"
+
+namespace ge {
+
+	ThreadPool::ThreadPool(uint32_t threadCount)
+	{
+		if (threadCount == 0)
+			threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+		m_Threads.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++)
+			m_Threads.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stopping = true;
+			m_Jobs.clear();
+		}
+		m_JobAvailable.notify_all();
+
+		for (std::thread& thread : m_Threads)
+			thread.join();
+	}
+
+	void ThreadPool::Submit(std::function<void()> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Jobs.push_back(std::move(job));
+		}
+		m_JobAvailable.notify_one();
+	}
+
+	void ThreadPool::WaitIdle()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Idle.wait(lock, [this] { return m_Jobs.empty() && m_RunningCount == 0; });
+	}
+
+	uint32_t ThreadPool::GetPendingCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return (uint32_t)m_Jobs.size() + m_RunningCount;
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_JobAvailable.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+				if (m_Stopping)
+					return;
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop_front();
+				m_RunningCount++;
+			}
+
+			job();
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_RunningCount--;
+				if (m_Jobs.empty() && m_RunningCount == 0)
+					m_Idle.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,48 @@
+/*
+	Thread Pool
+
+	Fixed set of worker threads running jobs from a shared first in first out queue
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Core.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace ge {
+
+	class ThreadPool
+	{
+	public:
+		// With 0 threads one thread per core is started, leaving a core for the main thread
+		explicit ThreadPool(uint32_t threadCount = 0);
+		// Jobs that haven't started are dropped, running ones are waited for
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		void Submit(std::function<void()> job);
+
+		// Blocks until the queue is empty and no job is running
+		void WaitIdle();
+
+		uint32_t GetThreadCount() const { return (uint32_t)m_Threads.size(); }
+		// Jobs queued or running
+		uint32_t GetPendingCount() const;
+	private:
+		void WorkerLoop();
+
+		std::vector<std::thread> m_Threads;
+		std::deque<std::function<void()>> m_Jobs;
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_JobAvailable;
+		std::condition_variable m_Idle;
+		uint32_t m_RunningCount = 0;
+		bool m_Stopping = false;
+	};
+}
@@ -225,7 +225,7 @@ namespace ge
 	inline float Mat3::Cofactor(const int i, const int j) const 
 	{
 		const Mat2 minor = Minor(i, j);
-		const float C = float(pow(-1, i + 1 + j + 1)) * minor.Determinant();
+		const float C = (((i + j) & 1) ? -1.0f : 1.0f) * minor.Determinant();
 		return C;
 	}
 
@@ -306,6 +306,8 @@ namespace ge
 		Mat4 operator * (const Mat4& rhs) const;
 		const Mat4& operator *= (const float rhs);
 
+		operator glm::mat4() const;
+
 	public:
 		Vec4 rows[4];
 	};
@@ -352,6 +354,18 @@ namespace ge
 		return *this;
 	}
 
+	// glm matrices are column-major so the rows are written out as columns
+	inline Mat4::operator glm::mat4() const
+	{
+		glm::mat4 m;
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				m[j][i] = rows[i][j];
+			}
+		}
+		return m;
+	}
+
 	inline void Mat4::Zero() 
 	{
 		rows[0].Zero();
@@ -439,7 +453,7 @@ namespace ge
 	inline float Mat4::Cofactor(const int i, const int j) const 
 	{
 		const Mat3 minor = Minor(i, j);
-		const float C = float(pow(-1, i + 1 + j + 1)) * minor.Determinant();
+		const float C = (((i + j) & 1) ? -1.0f : 1.0f) * minor.Determinant();
 		return C;
 	}
 
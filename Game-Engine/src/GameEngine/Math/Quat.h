@@ -201,14 +201,21 @@ namespace ge
 		return mat;
 	}
 
+	// Closed form rotation matrix, so that ToMat3() * v == RotatePoint(v)
+	// Dividing by the squared magnitude keeps this valid for quaternions that have drifted from unit length
 	inline Mat3 Quat::ToMat3() const 
 	{
-		Mat3 mat;
-		mat.Identity();
+		const float mag2 = Mag2();
+		const float s = mag2 > 0.0f ? 2.0f / mag2 : 0.0f;
+
+		const float xx = x * x * s, yy = y * y * s, zz = z * z * s;
+		const float xy = x * y * s, xz = x * z * s, yz = y * z * s;
+		const float wx = w * x * s, wy = w * y * s, wz = w * z * s;
 
-		mat.rows[0] = RotatePoint(mat.rows[0]);
-		mat.rows[1] = RotatePoint(mat.rows[1]);
-		mat.rows[2] = RotatePoint(mat.rows[2]);
+		Mat3 mat;
+		mat.rows[0] = Vec3(1.0f - (yy + zz), xy - wz, xz + wy);
+		mat.rows[1] = Vec3(xy + wz, 1.0f - (xx + zz), yz - wx);
+		mat.rows[2] = Vec3(xz - wy, yz + wx, 1.0f - (xx + yy));
 		return mat;
 	}
 }
\ No newline at end of file
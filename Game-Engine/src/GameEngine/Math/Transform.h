@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Vector.h"
+#include "Matrix.h"
+#include "Quat.h"
+
+namespace ge
+{
+	/*
+	===============================
+	Transform
+
+	Position, rotation and scale applied in the order scale -> rotate -> translate.
+	The rotation is kept as a quaternion and converted straight to a matrix, so there is
+	no round trip through an angle and axis.
+	===============================
+	*/
+	class Transform
+	{
+	public:
+		Transform();
+		Transform(const Transform& rhs);
+		Transform(const Vec3& pos, const Quat& rot, const Vec3& scl = Vec3(1.0f));
+		Transform& operator = (const Transform& rhs);
+
+		// Composition: (a * b).TransformPoint(p) == a.TransformPoint(b.TransformPoint(p))
+		// This is exact as long as the scale of the parent (a) is uniform
+		Transform operator * (const Transform& rhs) const;
+		const Transform& operator *= (const Transform& rhs);
+
+		void		Identity();
+		Transform	Inverse() const;
+
+		Vec3	TransformPoint(const Vec3& rhs) const;
+		Vec3	TransformVector(const Vec3& rhs) const;
+
+		Mat3	GetRotationMatrix() const;
+		Mat4	ToMat4() const;
+
+	public:
+		Vec3 position;
+		Quat rotation;
+		Vec3 scale;
+	};
+
+	inline Transform::Transform() :
+		position(0.0f),
+		rotation(),
+		scale(1.0f)
+	{
+	}
+
+	inline Transform::Transform(const Transform& rhs) :
+		position(rhs.position),
+		rotation(rhs.rotation),
+		scale(rhs.scale)
+	{
+	}
+
+	inline Transform::Transform(const Vec3& pos, const Quat& rot, const Vec3& scl) :
+		position(pos),
+		rotation(rot),
+		scale(scl)
+	{
+	}
+
+	inline Transform& Transform::operator = (const Transform& rhs)
+	{
+		position = rhs.position;
+		rotation = rhs.rotation;
+		scale = rhs.scale;
+		return *this;
+	}
+
+	inline Transform Transform::operator * (const Transform& rhs) const
+	{
+		Transform temp;
+		temp.position = TransformPoint(rhs.position);
+		temp.rotation = rotation * rhs.rotation;
+		temp.scale = Vec3(scale.x * rhs.scale.x, scale.y * rhs.scale.y, scale.z * rhs.scale.z);
+		return temp;
+	}
+
+	inline const Transform& Transform::operator *= (const Transform& rhs)
+	{
+		*this = *this * rhs;
+		return *this;
+	}
+
+	inline void Transform::Identity()
+	{
+		position.Zero();
+		rotation = Quat();
+		scale = Vec3(1.0f);
+	}
+
+	// Exact for uniform scale. With a non-uniform scale the result is the closest transform
+	// that can be expressed as scale -> rotate -> translate.
+	inline Transform Transform::Inverse() const
+	{
+		Transform inv;
+		inv.rotation = rotation.Inverse();
+		inv.scale = Vec3(1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z);
+
+		const Vec3 pos = inv.rotation.RotatePoint(position);
+		inv.position = Vec3(-pos.x * inv.scale.x, -pos.y * inv.scale.y, -pos.z * inv.scale.z);
+		return inv;
+	}
+
+	inline Vec3 Transform::TransformPoint(const Vec3& rhs) const
+	{
+		return position + TransformVector(rhs);
+	}
+
+	inline Vec3 Transform::TransformVector(const Vec3& rhs) const
+	{
+		const Vec3 scaled(rhs.x * scale.x, rhs.y * scale.y, rhs.z * scale.z);
+		return GetRotationMatrix() * scaled;
+	}
+
+	inline Mat3 Transform::GetRotationMatrix() const
+	{
+		return rotation.ToMat3();
+	}
+
+	// Translation * Rotation * Scale
+	inline Mat4 Transform::ToMat4() const
+	{
+		const Mat3 rot = GetRotationMatrix();
+
+		Mat4 mat;
+		for (int i = 0; i < 3; i++) {
+			mat.rows[i] = Vec4(rot.rows[i].x * scale.x, rot.rows[i].y * scale.y, rot.rows[i].z * scale.z, position[i]);
+		}
+		mat.rows[3] = Vec4(0, 0, 0, 1);
+		return mat;
+	}
+}
@@ -806,4 +806,127 @@ namespace ge
 
 		return true;
 	}
-}
+
+	/*
+	===============================
+	RVec3
+
+	World space position with a compile-time selectable precision.
+	Define GE_DOUBLE_PRECISION to store positions as doubles so that worlds far larger than
+	float precision allows can be simulated. Differences of two positions are small and are
+	converted back to a float Vec3 for everything else.
+	===============================
+	*/
+#ifdef GE_DOUBLE_PRECISION
+	typedef double Real;
+#else
+	typedef float Real;
+#endif
+
+	class RVec3
+	{
+	public:
+		RVec3();
+		RVec3(const RVec3& rhs);
+		RVec3(Real X, Real Y, Real Z);
+		RVec3(const Vec3& rhs);
+		RVec3& operator = (const RVec3& rhs);
+
+		bool operator == (const RVec3& rhs) const;
+		bool operator != (const RVec3& rhs) const;
+		RVec3 operator + (const RVec3& rhs) const;
+		const RVec3& operator += (const RVec3& rhs);
+		const RVec3& operator -= (const RVec3& rhs);
+		RVec3 operator - (const RVec3& rhs) const;
+		RVec3 operator * (const Real rhs) const;
+
+		void Zero() { x = 0; y = 0; z = 0; }
+
+		Real GetMag2() const { return x * x + y * y + z * z; }
+
+		// Only call this on small values such as the difference between two positions
+		Vec3 ToVec3() const { return Vec3((float)x, (float)y, (float)z); }
+
+	public:
+		Real x;
+		Real y;
+		Real z;
+	};
+
+	inline RVec3::RVec3() :
+		x(0),
+		y(0),
+		z(0)
+	{
+	}
+
+	inline RVec3::RVec3(const RVec3& rhs) :
+		x(rhs.x),
+		y(rhs.y),
+		z(rhs.z)
+	{
+	}
+
+	inline RVec3::RVec3(Real X, Real Y, Real Z) :
+		x(X),
+		y(Y),
+		z(Z)
+	{
+	}
+
+	inline RVec3::RVec3(const Vec3& rhs) :
+		x(rhs.x),
+		y(rhs.y),
+		z(rhs.z)
+	{
+	}
+
+	inline RVec3& RVec3::operator = (const RVec3& rhs)
+	{
+		x = rhs.x;
+		y = rhs.y;
+		z = rhs.z;
+		return *this;
+	}
+
+	inline bool RVec3::operator == (const RVec3& rhs) const
+	{
+		return x == rhs.x && y == rhs.y && z == rhs.z;
+	}
+
+	inline bool RVec3::operator != (const RVec3& rhs) const
+	{
+		return !(*this == rhs);
+	}
+
+	inline RVec3 RVec3::operator + (const RVec3& rhs) const
+	{
+		return RVec3(x + rhs.x, y + rhs.y, z + rhs.z);
+	}
+
+	inline const RVec3& RVec3::operator += (const RVec3& rhs)
+	{
+		x += rhs.x;
+		y += rhs.y;
+		z += rhs.z;
+		return *this;
+	}
+
+	inline const RVec3& RVec3::operator -= (const RVec3& rhs)
+	{
+		x -= rhs.x;
+		y -= rhs.y;
+		z -= rhs.z;
+		return *this;
+	}
+
+	inline RVec3 RVec3::operator - (const RVec3& rhs) const
+	{
+		return RVec3(x - rhs.x, y - rhs.y, z - rhs.z);
+	}
+
+	inline RVec3 RVec3::operator * (const Real rhs) const
+	{
+		return RVec3(x * rhs, y * rhs, z * rhs);
+	}
+}
\ No newline at end of file
@@ -1,14 +1,12 @@
 #include "gepch.h"
 #include "Body.h"
 
-#include <glm/gtc/matrix_transform.hpp>
-
 namespace ge
 {
-	Vec3 Body::GetCenterOfMassWorldSpace() const
+	RVec3 Body::GetCenterOfMassWorldSpace() const
 	{
 		const Vec3 centerOfMass = m_shape->GetCenterOfMass();
-		const Vec3 pos = m_position + m_orientation.RotatePoint(centerOfMass);
+		const RVec3 pos = m_position + m_orientation.RotatePoint(centerOfMass);
 		return pos;
 	}
 
@@ -18,17 +16,17 @@ namespace ge
 		return centerOfMass;
 	}
 
-	Vec3 Body::WorldSpaceToBodySpace(const Vec3& worldPt) const
+	Vec3 Body::WorldSpaceToBodySpace(const RVec3& worldPt) const
 	{
-		Vec3 temp = worldPt - GetCenterOfMassWorldSpace();
+		Vec3 temp = (worldPt - GetCenterOfMassWorldSpace()).ToVec3();
 		Quat inverseOrient = m_orientation.Inverse();
 		Vec3 bodySpace = inverseOrient.RotatePoint(temp);
 		return bodySpace;
 	}
 
-	Vec3 Body::BodySpaceToWorldSpace(const Vec3& bodyPt) const
+	RVec3 Body::BodySpaceToWorldSpace(const Vec3& bodyPt) const
 	{
-		Vec3 worldSpace = GetCenterOfMassWorldSpace() + m_orientation.RotatePoint(bodyPt);
+		RVec3 worldSpace = GetCenterOfMassWorldSpace() + m_orientation.RotatePoint(bodyPt);
 		return worldSpace;
 	}
 
@@ -45,16 +43,22 @@ namespace ge
 		m_linearVelocity += impulse * m_invMass;
 	}
 
-	glm::mat4 Body::GetRenderTransform()
+	Transform Body::GetTransform(const RVec3& origin) const
 	{
-		glm::mat4 transform = glm::mat4(1.0f);
-		glm::vec3 pos = glm::vec3(m_position.x, m_position.z, -m_position.y);
-		transform = glm::translate(transform, pos);
-		float angle = m_orientation.GetAngle();
-		Vec3 normal = m_orientation.GetNormal();
-		normal = Vec3(normal.x, normal.z, -normal.y);
-		transform = glm::rotate(transform, angle, (glm::vec3)normal);
-		transform = glm::scale(transform, glm::vec3(m_shape->GetScale()));
-		return transform;
+		return Transform((m_position - origin).ToVec3(), m_orientation, Vec3(m_shape->GetScale()));
+	}
+
+	glm::mat4 Body::GetRenderTransform(const RVec3& renderOrigin) const
+	{
+		// Physics space is z-up and render space is y-up: (x, y, z) -> (x, z, -y)
+		// This is a proper rotation so the quaternion's vector part is swizzled the same way
+		const RVec3 physicsOrigin(renderOrigin.x, -renderOrigin.z, renderOrigin.y);
+		const Transform transform = GetTransform(physicsOrigin);
+
+		const Transform renderTransform(
+			Vec3(transform.position.x, transform.position.z, -transform.position.y),
+			Quat(transform.rotation.x, transform.rotation.z, -transform.rotation.y, transform.rotation.w),
+			Vec3(transform.scale.x, transform.scale.z, transform.scale.y));
+		return renderTransform.ToMat4();
 	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "GameEngine/Math/Vector.h"
 #include "GameEngine/Math/Quat.h"
+#include "GameEngine/Math/Transform.h"
 #include "Shape.h"
 
 #include <glm/glm.hpp>
@@ -11,7 +12,7 @@ namespace ge
 	class Body
 	{
 	public:
-		Vec3 m_position;
+		RVec3 m_position;
 		Quat m_orientation;
 		Vec3 m_linearVelocity;
 		float m_invMass;
@@ -20,14 +21,18 @@ namespace ge
 		// Body Space - Origin an COM
 		// Object Space - Origin at geomatrix center
 
-		Vec3 GetCenterOfMassWorldSpace() const;
+		RVec3 GetCenterOfMassWorldSpace() const;
 		Vec3 GetCenterOfMassObjectSpace() const;
 
-		Vec3 WorldSpaceToBodySpace(const Vec3& worldPt) const;
-		Vec3 BodySpaceToWorldSpace(const Vec3& bodyPt) const;
+		Vec3 WorldSpaceToBodySpace(const RVec3& worldPt) const;
+		RVec3 BodySpaceToWorldSpace(const Vec3& bodyPt) const;
 
 		void ApplyImpulseLinear(const Vec3& impulse);
 
-		glm::mat4 GetRenderTransform();
+		// Transform in physics space (z-up), relative to origin
+		Transform GetTransform(const RVec3& origin = RVec3()) const;
+		// Transform converted to render space (y-up), relative to the render origin (also in render space)
+		// The subtraction is done at full precision before the result is converted to floats
+		glm::mat4 GetRenderTransform(const RVec3& renderOrigin = RVec3()) const;
 	};
 }
@@ -5,7 +5,8 @@ namespace ge
 {
 	bool Intersect(const Body* bodyA, const Body* bodyB)
 	{
-		const Vec3 ab = bodyB->m_position - bodyA->m_position;
+		// Positions may be stored at double precision, the separation is small enough for floats
+		const Vec3 ab = (bodyB->m_position - bodyA->m_position).ToVec3();
 
 		const ShapeSphere* sphereA = (const ShapeSphere*)bodyA->m_shape;
 		const ShapeSphere* sphereB = (const ShapeSphere*)bodyB->m_shape;
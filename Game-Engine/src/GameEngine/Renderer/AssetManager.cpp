@@ -0,0 +1,346 @@
+/*
+	Asset Manager
+
+	Loads models and textures in the background. Reading and decoding the files runs on a pool of worker
+	threads, the GPU uploads are queued for the main thread and run in Update within a byte budget per frame.
+	Loading returns a handle straight away, which gives a placeholder until the asset is ready.
+*/
+
+#include "gepch.h"
+#include "AssetManager.h"
+
+#include "GameEngine/Renderer/ImageData.h"
+#include "GameEngine/Renderer/CookedTexture.h"
+
+#include <chrono>
+#include <deque>
+
+namespace ge {
+
+	struct UploadJob
+	{
+		size_t Size = 0;
+		std::function<void()> Upload;
+	};
+
+	struct AssetManagerData
+	{
+		Scope<ThreadPool> Workers;
+
+		std::mutex UploadMutex;
+		std::deque<UploadJob> Uploads;
+		size_t UploadBudget = 32 * 1024 * 1024;
+
+		Ref<Texture2D> Texture2DPlaceholder;
+		Ref<Texture3D> Texture3DPlaceholder;
+		Ref<Cubemap> CubemapPlaceholder;
+		Ref<HDREnvironmentMap> HDREnvironmentMapPlaceholder;
+		Ref<Model> ModelPlaceholder;
+
+		AssetManager::Statistics Stats;
+		std::atomic<uint32_t> FailedCount{ 0 };
+	};
+
+	static AssetManagerData* s_Data = nullptr;
+
+	// The state is set after the asset so a handle that reads ready always sees it
+	template<typename D, typename T>
+	static void FinishLoad(const Ref<D>& data, const Ref<T>& asset)
+	{
+		data->Asset = asset;
+		data->State.store(AssetState::Ready, std::memory_order_release);
+		s_Data->Stats.Loaded++;
+	}
+
+	template<typename D>
+	static void FailLoad(const Ref<D>& data)
+	{
+		GE_CORE_ERROR("Failed to load {0}", data->Path);
+		data->State.store(AssetState::Failed, std::memory_order_release);
+		s_Data->FailedCount++;
+	}
+
+	// Only the upload job still holds the load, every handle to it is gone
+	template<typename D>
+	static bool IsAbandoned(const Ref<D>& data)
+	{
+		return data.use_count() == 1;
+	}
+
+	void AssetManager::Init(uint32_t workerCount)
+	{
+		GE_CORE_ASSERT(!s_Data, "AssetManager already initialised!");
+		s_Data = new AssetManagerData();
+		s_Data->Workers = std::make_unique<ThreadPool>(workerCount);
+
+		// Neutral stand ins: white for surface textures, black for the environment so it adds no light
+		const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		s_Data->Texture2DPlaceholder = Texture2D::Create(ImageData::Fill(1, 1, 4, false, white));
+		s_Data->Texture3DPlaceholder = Texture3D::Create(ImageData::Fill(1, 1, 4, false, white), "");
+		std::vector<ImageData> faces;
+		for (int i = 0; i < 6; i++)
+			faces.push_back(ImageData::Fill(1, 1, 3, false, black));
+		s_Data->CubemapPlaceholder = Cubemap::Create(faces);
+		s_Data->HDREnvironmentMapPlaceholder = HDREnvironmentMap::Create(ImageData::Fill(1, 1, 3, true, black));
+		s_Data->ModelPlaceholder = std::make_shared<Model>(ModelData());
+
+		GE_CORE_INFO("Asset manager started with {0} worker threads", s_Data->Workers->GetThreadCount());
+	}
+
+	void AssetManager::Shutdown()
+	{
+		if (!s_Data)
+			return;
+
+		// Joining the workers first means nothing queues an upload after this
+		s_Data->Workers.reset();
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void AssetManager::Update()
+	{
+		auto start = std::chrono::steady_clock::now();
+		uint32_t uploads = 0;
+		size_t uploadedBytes = 0;
+
+		while (true)
+		{
+			UploadJob job;
+			{
+				std::lock_guard<std::mutex> lock(s_Data->UploadMutex);
+				if (s_Data->Uploads.empty())
+					break;
+				if (uploads > 0 && uploadedBytes + s_Data->Uploads.front().Size > s_Data->UploadBudget)
+					break;
+
+				job = std::move(s_Data->Uploads.front());
+				s_Data->Uploads.pop_front();
+			}
+
+			job.Upload();
+			uploads++;
+			uploadedBytes += job.Size;
+		}
+
+		s_Data->Stats.Uploads = uploads;
+		s_Data->Stats.UploadedBytes = uploadedBytes;
+		s_Data->Stats.UploadTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void AssetManager::SetUploadBudget(size_t bytesPerFrame)
+	{
+		s_Data->UploadBudget = bytesPerFrame;
+	}
+
+	size_t AssetManager::GetUploadBudget()
+	{
+		return s_Data->UploadBudget;
+	}
+
+	void AssetManager::Flush()
+	{
+		// Workers only ever queue uploads, so once they are idle every upload is in the queue
+		s_Data->Workers->WaitIdle();
+
+		std::deque<UploadJob> uploads;
+		{
+			std::lock_guard<std::mutex> lock(s_Data->UploadMutex);
+			uploads.swap(s_Data->Uploads);
+		}
+
+		for (UploadJob& job : uploads)
+			job.Upload();
+	}
+
+	template<typename T>
+	AssetHandle<T> AssetManager::CreateHandle(const std::string& path, const Ref<T>& placeholder)
+	{
+		AssetHandle<T> handle;
+		handle.m_Data = std::make_shared<typename AssetHandle<T>::Data>();
+		handle.m_Data->Placeholder = placeholder;
+		handle.m_Data->Path = path;
+		return handle;
+	}
+
+	void AssetManager::QueueUpload(size_t size, std::function<void()> upload)
+	{
+		std::lock_guard<std::mutex> lock(s_Data->UploadMutex);
+		s_Data->Uploads.push_back({ size, std::move(upload) });
+	}
+
+	AssetHandle<Texture2D> AssetManager::LoadTexture2D(const std::string& path, bool gammaCorrection)
+	{
+		AssetHandle<Texture2D> handle = CreateHandle(path, s_Data->Texture2DPlaceholder);
+		auto data = handle.m_Data;
+		s_Data->Workers->Submit([data, gammaCorrection]()
+		{
+			auto cooked = std::make_shared<CookedTexture>();
+			if (cooked->OpenForSource(data->Path, gammaCorrection))
+			{
+				QueueUpload(cooked->GetDataSize(), [data, cooked]()
+				{
+					if (!IsAbandoned(data))
+						FinishLoad(data, Texture2D::Create(*cooked));
+				});
+				return;
+			}
+
+			auto image = std::make_shared<ImageData>();
+			if (!ImageData::Load(data->Path, *image))
+			{
+				FailLoad(data);
+				return;
+			}
+
+			QueueUpload(image->GetSize(), [data, image, gammaCorrection]()
+			{
+				if (!IsAbandoned(data))
+					FinishLoad(data, Texture2D::Create(*image, gammaCorrection));
+			});
+		});
+		return handle;
+	}
+
+	AssetHandle<Texture3D> AssetManager::LoadTexture3D(const std::string& path, const std::string& directory)
+	{
+		AssetHandle<Texture3D> handle = CreateHandle(path, s_Data->Texture3DPlaceholder);
+		auto data = handle.m_Data;
+		s_Data->Workers->Submit([data, directory]()
+		{
+			const std::string filename = directory + '/' + data->Path;
+			auto cooked = std::make_shared<CookedTexture>();
+			if (cooked->OpenForSource(filename, false))
+			{
+				QueueUpload(cooked->GetDataSize(), [data, cooked]()
+				{
+					if (!IsAbandoned(data))
+						FinishLoad(data, Texture3D::Create(*cooked, data->Path));
+				});
+				return;
+			}
+
+			auto image = std::make_shared<ImageData>();
+			if (!ImageData::Load(filename, *image))
+			{
+				FailLoad(data);
+				return;
+			}
+
+			QueueUpload(image->GetSize(), [data, image]()
+			{
+				if (!IsAbandoned(data))
+					FinishLoad(data, Texture3D::Create(*image, data->Path));
+			});
+		});
+		return handle;
+	}
+
+	AssetHandle<Cubemap> AssetManager::LoadCubemap(const std::vector<std::string>& faces)
+	{
+		AssetHandle<Cubemap> handle = CreateHandle(faces.empty() ? std::string() : faces[0], s_Data->CubemapPlaceholder);
+		auto data = handle.m_Data;
+		s_Data->Workers->Submit([data, faces]()
+		{
+			auto images = std::make_shared<std::vector<ImageData>>(faces.size());
+			size_t size = 0;
+			for (size_t i = 0; i < faces.size(); i++)
+			{
+				if (!ImageData::Load(faces[i], (*images)[i]))
+				{
+					FailLoad(data);
+					return;
+				}
+				size += (*images)[i].GetSize();
+			}
+
+			QueueUpload(size, [data, images]()
+			{
+				if (!IsAbandoned(data))
+					FinishLoad(data, Cubemap::Create(*images));
+			});
+		});
+		return handle;
+	}
+
+	AssetHandle<HDREnvironmentMap> AssetManager::LoadHDREnvironmentMap(const std::string& path)
+	{
+		AssetHandle<HDREnvironmentMap> handle = CreateHandle(path, s_Data->HDREnvironmentMapPlaceholder);
+		auto data = handle.m_Data;
+		s_Data->Workers->Submit([data]()
+		{
+			auto image = std::make_shared<ImageData>();
+			if (!ImageData::LoadHDR(data->Path, *image, true))
+			{
+				FailLoad(data);
+				return;
+			}
+
+			QueueUpload(image->GetSize(), [data, image]()
+			{
+				if (!IsAbandoned(data))
+					FinishLoad(data, HDREnvironmentMap::Create(*image));
+			});
+		});
+		return handle;
+	}
+
+	AssetHandle<HDREnvironmentMap> AssetManager::LoadHDREnvironmentMap(const std::string& path, const IBLBakeSettings& settings)
+	{
+		AssetHandle<HDREnvironmentMap> handle = CreateHandle(path, s_Data->HDREnvironmentMapPlaceholder);
+		auto data = handle.m_Data;
+		s_Data->Workers->Submit([data, settings]()
+		{
+			auto ibl = std::make_shared<IBLData>();
+			if (!IBLBaker::LoadOrBake(data->Path, settings, *ibl))
+			{
+				FailLoad(data);
+				return;
+			}
+
+			const size_t size = (ibl->Environment.Pixels.size() + ibl->Irradiance.Pixels.size()
+				+ ibl->Prefilter.Pixels.size() + ibl->BrdfLUT.size()) * sizeof(float);
+			QueueUpload(size, [data, ibl]()
+			{
+				if (!IsAbandoned(data))
+					FinishLoad(data, HDREnvironmentMap::Create(*ibl));
+			});
+		});
+		return handle;
+	}
+
+	AssetHandle<Model> AssetManager::LoadModel(const std::string& path, const ModelSettings& settings)
+	{
+		AssetHandle<Model> handle = CreateHandle(path, s_Data->ModelPlaceholder);
+		auto data = handle.m_Data;
+		s_Data->Workers->Submit([data, settings]()
+		{
+			auto model = std::make_shared<ModelData>();
+			if (!Model::Import(data->Path, settings, *model))
+			{
+				FailLoad(data);
+				return;
+			}
+
+			QueueUpload(model->GetUploadSize(), [data, model]()
+			{
+				if (!IsAbandoned(data))
+					FinishLoad(data, std::make_shared<Model>(std::move(*model)));
+			});
+		});
+		return handle;
+	}
+
+	AssetManager::Statistics AssetManager::GetStatistics()
+	{
+		Statistics stats = s_Data->Stats;
+		stats.Decoding = s_Data->Workers->GetPendingCount();
+		stats.Failed = s_Data->FailedCount.load();
+		{
+			std::lock_guard<std::mutex> lock(s_Data->UploadMutex);
+			stats.WaitingForUpload = (uint32_t)s_Data->Uploads.size();
+		}
+		return stats;
+	}
+}
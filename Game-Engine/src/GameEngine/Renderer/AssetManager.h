@@ -0,0 +1,106 @@
+/*
+	Asset Manager
+
+	Loads models and textures in the background. Reading and decoding the files runs on a pool of worker
+	threads, the GPU uploads are queued for the main thread and run in Update within a byte budget per frame.
+	Loading returns a handle straight away, which gives a placeholder until the asset is ready.
+*/
+
+#pragma once
+
+#include "GameEngine/Core/ThreadPool.h"
+#include "GameEngine/Renderer/Texture.h"
+#include "GameEngine/Renderer/Model.h"
+#include "GameEngine/Renderer/IBLBaker.h"
+
+#include <atomic>
+
+namespace ge {
+
+	enum class AssetState
+	{
+		Pending = 0,	// Being decoded or waiting for its upload
+		Ready = 1,
+		Failed = 2		// The file could not be read, the handle keeps giving the placeholder
+	};
+
+	template<typename T>
+	class AssetHandle
+	{
+	public:
+		AssetHandle() = default;
+
+		AssetState GetState() const { return m_Data ? m_Data->State.load(std::memory_order_acquire) : AssetState::Failed; }
+		bool IsReady() const { return GetState() == AssetState::Ready; }
+		bool IsPending() const { return GetState() == AssetState::Pending; }
+		bool IsFailed() const { return GetState() == AssetState::Failed; }
+
+		// The asset once it is ready, the placeholder until then. Only valid on handles from the AssetManager.
+		const Ref<T>& Get() const { return IsReady() ? m_Data->Asset : m_Data->Placeholder; }
+		T* operator->() const { return Get().get(); }
+
+		const std::string& GetPath() const { return m_Data->Path; }
+
+		explicit operator bool() const { return m_Data != nullptr; }
+	private:
+		struct Data
+		{
+			std::atomic<AssetState> State{ AssetState::Pending };
+			Ref<T> Asset;			// Only written by the upload on the main thread, before the state turns ready
+			Ref<T> Placeholder;
+			std::string Path;
+		};
+
+		Ref<Data> m_Data;
+
+		friend class AssetManager;
+	};
+
+	class AssetManager
+	{
+	public:
+		// Starts the workers (0 picks one per core) and creates the placeholders, needs the graphics context
+		static void Init(uint32_t workerCount = 0);
+		// Waits for the decodes that are running and drops everything still queued
+		static void Shutdown();
+
+		// Runs the uploads of finished decodes, oldest first, until the budget of the frame is spent.
+		// Called once per frame on the main thread.
+		static void Update();
+
+		// Bytes of decoded data uploaded per frame. One upload always runs, however large it is.
+		static void SetUploadBudget(size_t bytesPerFrame);
+		static size_t GetUploadBudget();
+
+		// Blocks until every load so far is decoded and uploaded, ignoring the budget (for loading screens)
+		static void Flush();
+
+		static AssetHandle<Texture2D> LoadTexture2D(const std::string& path, bool gammaCorrection = false);
+		static AssetHandle<Texture3D> LoadTexture3D(const std::string& path, const std::string& directory);
+		static AssetHandle<Cubemap> LoadCubemap(const std::vector<std::string>& faces);
+		// The environment maps (SetupCubemap and the others) are for the caller to set up once the handle is ready
+		static AssetHandle<HDREnvironmentMap> LoadHDREnvironmentMap(const std::string& path);
+		// Environment maps baked on the worker, or read from the bake cache next to the image, ready to use
+		static AssetHandle<HDREnvironmentMap> LoadHDREnvironmentMap(const std::string& path, const IBLBakeSettings& settings);
+		static AssetHandle<Model> LoadModel(const std::string& path, const ModelSettings& settings = ModelSettings());
+
+		struct Statistics
+		{
+			uint32_t Decoding = 0;			// Loads queued or running on the workers
+			uint32_t WaitingForUpload = 0;	// Decoded loads waiting for their frame
+			uint32_t Uploads = 0;			// Uploads run by the last Update
+			size_t UploadedBytes = 0;		// Bytes uploaded by the last Update
+			float UploadTime = 0.0f;		// Milliseconds spent in the last Update
+			uint32_t Loaded = 0;			// Since Init
+			uint32_t Failed = 0;
+		};
+
+		static Statistics GetStatistics();
+	private:
+		template<typename T>
+		static AssetHandle<T> CreateHandle(const std::string& path, const Ref<T>& placeholder);
+
+		// Called by the workers once a decode is done, the upload runs on the main thread
+		static void QueueUpload(size_t size, std::function<void()> upload);
+	};
+}
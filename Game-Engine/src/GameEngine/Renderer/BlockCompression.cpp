@@ -0,0 +1,507 @@
+/*
+	Block Compression
+
+	CPU encoders for the BC texture formats. Every format works on 4x4 blocks of pixels:
+	BC1 (RGB, 8 bytes), BC3 (RGBA, 16 bytes), BC5 (two channels for normal maps, 16 bytes),
+	BC7 (RGBA, 16 bytes) and BC6H (unsigned half float RGB, 16 bytes).
+	BC7 only writes mode 6 and BC6H only mode 11, the single subset modes, which keeps the encoders
+	small and fast at some quality cost on blocks with two distinct colour groups.
+	Nothing here touches the renderer, so it runs anywhere.
+*/
+
+#include "gepch.h"
+#include "BlockCompression.h"
+
+#include "GameEngine/Renderer/VertexFormat.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace ge {
+
+	// Interpolation weights of the 4 bit index BC7 and BC6H modes, out of 64
+	static const int s_Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Writes fields least significant bit first, the order of the BC6H and BC7 layouts
+	class BlockBitWriter
+	{
+	public:
+		explicit BlockBitWriter(uint8_t* block)
+			: m_Block(block)
+		{
+			std::memset(m_Block, 0, 16);
+		}
+
+		void Write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t i = 0; i < bitCount; i++, m_Position++)
+			{
+				if ((value >> i) & 1)
+					m_Block[m_Position >> 3] |= (uint8_t)(1 << (m_Position & 7));
+			}
+		}
+	private:
+		uint8_t* m_Block;
+		uint32_t m_Position = 0;
+	};
+
+	// Line through the points along their principal axis, from the lowest to the highest projection.
+	// The ends are pulled in by inset times the length, which lowers the error of the points in between.
+	template<int N>
+	static void FitEndpoints(const float points[16][N], float inset, float start[N], float end[N])
+	{
+		float mean[N] = {};
+		for (int i = 0; i < 16; i++)
+			for (int c = 0; c < N; c++)
+				mean[c] += points[i][c] / 16.0f;
+
+		float covariance[N][N] = {};
+		for (int i = 0; i < 16; i++)
+			for (int a = 0; a < N; a++)
+				for (int b = 0; b < N; b++)
+					covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+
+		// Power iteration, starting from the channel that varies the most
+		float axis[N] = {};
+		int widest = 0;
+		for (int c = 1; c < N; c++)
+			if (covariance[c][c] > covariance[widest][widest])
+				widest = c;
+		axis[widest] = 1.0f;
+
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[N] = {};
+			float length = 0.0f;
+			for (int a = 0; a < N; a++)
+			{
+				for (int b = 0; b < N; b++)
+					next[a] += covariance[a][b] * axis[b];
+				length += next[a] * next[a];
+			}
+
+			// Every point is the same, any axis works
+			if (length < 1e-12f)
+				break;
+
+			length = std::sqrt(length);
+			for (int c = 0; c < N; c++)
+				axis[c] = next[c] / length;
+		}
+
+		float lowest = 0.0f, highest = 0.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			float t = 0.0f;
+			for (int c = 0; c < N; c++)
+				t += (points[i][c] - mean[c]) * axis[c];
+			lowest = std::min(lowest, t);
+			highest = std::max(highest, t);
+		}
+
+		const float pull = (highest - lowest) * inset;
+		lowest += pull;
+		highest -= pull;
+		for (int c = 0; c < N; c++)
+		{
+			start[c] = mean[c] + axis[c] * lowest;
+			end[c] = mean[c] + axis[c] * highest;
+		}
+	}
+
+	////// BC1 //////
+
+	static uint16_t PackRGB565(const float color[3])
+	{
+		const uint32_t r = (uint32_t)std::lround(glm::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f);
+		const uint32_t g = (uint32_t)std::lround(glm::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f);
+		const uint32_t b = (uint32_t)std::lround(glm::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f);
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	static void UnpackRGB565(uint16_t packed, int color[3])
+	{
+		const int r = (packed >> 11) & 31;
+		const int g = (packed >> 5) & 63;
+		const int b = packed & 31;
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+
+	// Colour half of BC1 and BC3, always in four colour mode
+	static void EncodeColorBlock(const uint8_t pixels[16][4], uint8_t* block)
+	{
+		float points[16][3];
+		for (int i = 0; i < 16; i++)
+			for (int c = 0; c < 3; c++)
+				points[i][c] = pixels[i][c];
+
+		float start[3], end[3];
+		FitEndpoints<3>(points, 1.0f / 16.0f, start, end);
+
+		// The first colour has to be the larger one for four colour mode
+		uint16_t color0 = PackRGB565(end);
+		uint16_t color1 = PackRGB565(start);
+		if (color0 < color1)
+			std::swap(color0, color1);
+
+		uint32_t indices = 0;
+		if (color0 != color1)
+		{
+			int palette[4][3];
+			UnpackRGB565(color0, palette[0]);
+			UnpackRGB565(color1, palette[1]);
+			for (int c = 0; c < 3; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			for (int i = 0; i < 16; i++)
+			{
+				int best = 0, bestError = INT32_MAX;
+				for (int p = 0; p < 4; p++)
+				{
+					int error = 0;
+					for (int c = 0; c < 3; c++)
+						error += (pixels[i][c] - palette[p][c]) * (pixels[i][c] - palette[p][c]);
+					if (error < bestError)
+					{
+						bestError = error;
+						best = p;
+					}
+				}
+				indices |= (uint32_t)best << (2 * i);
+			}
+		}
+
+		block[0] = (uint8_t)(color0 & 0xFF);
+		block[1] = (uint8_t)(color0 >> 8);
+		block[2] = (uint8_t)(color1 & 0xFF);
+		block[3] = (uint8_t)(color1 >> 8);
+		std::memcpy(block + 4, &indices, 4);
+	}
+
+	////// BC4 //////
+
+	// One channel with eight levels between its extremes, the alpha of BC3 and each channel of BC5
+	static void EncodeSingleChannelBlock(const uint8_t values[16], uint8_t* block)
+	{
+		uint8_t highest = values[0], lowest = values[0];
+		for (int i = 1; i < 16; i++)
+		{
+			highest = std::max(highest, values[i]);
+			lowest = std::min(lowest, values[i]);
+		}
+
+		block[0] = highest;
+		block[1] = lowest;
+
+		uint64_t indices = 0;
+		if (highest != lowest)
+		{
+			int palette[8];
+			palette[0] = highest;
+			palette[1] = lowest;
+			for (int p = 2; p < 8; p++)
+				palette[p] = ((8 - p) * highest + (p - 1) * lowest + 3) / 7;
+
+			for (int i = 0; i < 16; i++)
+			{
+				int best = 0, bestError = INT32_MAX;
+				for (int p = 0; p < 8; p++)
+				{
+					const int error = std::abs(values[i] - palette[p]);
+					if (error < bestError)
+					{
+						bestError = error;
+						best = p;
+					}
+				}
+				indices |= (uint64_t)best << (3 * i);
+			}
+		}
+
+		for (int i = 0; i < 6; i++)
+			block[2 + i] = (uint8_t)(indices >> (8 * i));
+	}
+
+	uint32_t BlockCompression::GetBlockSize(TextureCompression compression)
+	{
+		switch (compression)
+		{
+			case TextureCompression::BC1:	return 8;
+			case TextureCompression::BC3:
+			case TextureCompression::BC5:
+			case TextureCompression::BC6H:
+			case TextureCompression::BC7:	return 16;
+			case TextureCompression::None:	break;
+		}
+
+		GE_CORE_ASSERT(false, "Not a block compressed format!");
+		return 0;
+	}
+
+	void BlockCompression::EncodeBC1(const uint8_t pixels[16][4], uint8_t* block)
+	{
+		EncodeColorBlock(pixels, block);
+	}
+
+	void BlockCompression::EncodeBC3(const uint8_t pixels[16][4], uint8_t* block)
+	{
+		uint8_t alpha[16];
+		for (int i = 0; i < 16; i++)
+			alpha[i] = pixels[i][3];
+
+		EncodeSingleChannelBlock(alpha, block);
+		EncodeColorBlock(pixels, block + 8);
+	}
+
+	void BlockCompression::EncodeBC5(const uint8_t pixels[16][4], uint8_t* block)
+	{
+		uint8_t red[16], green[16];
+		for (int i = 0; i < 16; i++)
+		{
+			red[i] = pixels[i][0];
+			green[i] = pixels[i][1];
+		}
+
+		EncodeSingleChannelBlock(red, block);
+		EncodeSingleChannelBlock(green, block + 8);
+	}
+
+	////// BC7 //////
+
+	// Mode 6: one subset, 7 bit RGBA endpoints with a shared lowest bit each (p bit), 4 bit indices
+	void BlockCompression::EncodeBC7(const uint8_t pixels[16][4], uint8_t* block)
+	{
+		float points[16][4];
+		for (int i = 0; i < 16; i++)
+			for (int c = 0; c < 4; c++)
+				points[i][c] = pixels[i][c];
+
+		float ends[2][4];
+		FitEndpoints<4>(points, 1.0f / 64.0f, ends[0], ends[1]);
+
+		// Each endpoint takes the p bit that lands its channels closest
+		uint32_t quantized[2][4];
+		uint32_t pbits[2];
+		int endpoints[2][4];
+		for (int e = 0; e < 2; e++)
+		{
+			float bestError = FLT_MAX;
+			for (uint32_t p = 0; p < 2; p++)
+			{
+				uint32_t candidate[4];
+				float error = 0.0f;
+				for (int c = 0; c < 4; c++)
+				{
+					candidate[c] = (uint32_t)glm::clamp((int)std::lround((ends[e][c] - (float)p) / 2.0f), 0, 127);
+					const float value = (float)((candidate[c] << 1) | p);
+					error += (value - ends[e][c]) * (value - ends[e][c]);
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					pbits[e] = p;
+					std::memcpy(quantized[e], candidate, sizeof(candidate));
+				}
+			}
+
+			for (int c = 0; c < 4; c++)
+				endpoints[e][c] = (int)((quantized[e][c] << 1) | pbits[e]);
+		}
+
+		int palette[16][4];
+		for (int p = 0; p < 16; p++)
+			for (int c = 0; c < 4; c++)
+				palette[p][c] = ((64 - s_Weights4[p]) * endpoints[0][c] + s_Weights4[p] * endpoints[1][c] + 32) >> 6;
+
+		uint32_t indices[16];
+		for (int i = 0; i < 16; i++)
+		{
+			int bestError = INT32_MAX;
+			for (uint32_t p = 0; p < 16; p++)
+			{
+				int error = 0;
+				for (int c = 0; c < 4; c++)
+					error += (pixels[i][c] - palette[p][c]) * (pixels[i][c] - palette[p][c]);
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[i] = p;
+				}
+			}
+		}
+
+		// The first index is stored without its top bit, so it has to be below 8
+		if (indices[0] >= 8)
+		{
+			std::swap(quantized[0], quantized[1]);
+			std::swap(pbits[0], pbits[1]);
+			for (int i = 0; i < 16; i++)
+				indices[i] = 15 - indices[i];
+		}
+
+		BlockBitWriter writer(block);
+		writer.Write(1 << 6, 7);
+		for (int c = 0; c < 4; c++)
+		{
+			writer.Write(quantized[0][c], 7);
+			writer.Write(quantized[1][c], 7);
+		}
+		writer.Write(pbits[0], 1);
+		writer.Write(pbits[1], 1);
+		writer.Write(indices[0], 3);
+		for (int i = 1; i < 16; i++)
+			writer.Write(indices[i], 4);
+	}
+
+	////// BC6H //////
+
+	// Endpoints are interpolated as integers and the result scaled by 31/64 into the bits of a half float,
+	// so fitting happens on the half bits scaled by 64/31
+	static const float s_HalfToInterpolated = 64.0f / 31.0f;
+
+	static int UnquantizeBC6H(int value)
+	{
+		if (value == 0)
+			return 0;
+		if (value == 1023)
+			return 0xFFFF;
+		return ((value << 16) + 0x8000) >> 10;
+	}
+
+	// Mode 11: one region, 10 bit endpoints stored directly, 4 bit indices
+	void BlockCompression::EncodeBC6H(const float pixels[16][3], uint8_t* block)
+	{
+		float halves[16][3];
+		float points[16][3];
+		for (int i = 0; i < 16; i++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				// Largest finite half, the format has no infinity
+				const uint16_t half = std::min<uint16_t>(VertexFormat::FloatToHalf(std::max(pixels[i][c], 0.0f)), 0x7BFF);
+				halves[i][c] = (float)half;
+				points[i][c] = (float)half * s_HalfToInterpolated;
+			}
+		}
+
+		float ends[2][3];
+		FitEndpoints<3>(points, 1.0f / 64.0f, ends[0], ends[1]);
+
+		uint32_t quantized[2][3];
+		int endpoints[2][3];
+		for (int e = 0; e < 2; e++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				quantized[e][c] = (uint32_t)glm::clamp((int)std::lround((ends[e][c] - 32.0f) / 64.0f), 0, 1023);
+				endpoints[e][c] = UnquantizeBC6H((int)quantized[e][c]);
+			}
+		}
+
+		int palette[16][3];
+		for (int p = 0; p < 16; p++)
+			for (int c = 0; c < 3; c++)
+				palette[p][c] = ((((64 - s_Weights4[p]) * endpoints[0][c] + s_Weights4[p] * endpoints[1][c] + 32) >> 6) * 31) >> 6;
+
+		uint32_t indices[16];
+		for (int i = 0; i < 16; i++)
+		{
+			float bestError = FLT_MAX;
+			for (uint32_t p = 0; p < 16; p++)
+			{
+				float error = 0.0f;
+				for (int c = 0; c < 3; c++)
+					error += (halves[i][c] - palette[p][c]) * (halves[i][c] - palette[p][c]);
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[i] = p;
+				}
+			}
+		}
+
+		if (indices[0] >= 8)
+		{
+			std::swap(quantized[0], quantized[1]);
+			for (int i = 0; i < 16; i++)
+				indices[i] = 15 - indices[i];
+		}
+
+		BlockBitWriter writer(block);
+		writer.Write(0x03, 5);
+		for (int e = 0; e < 2; e++)
+			for (int c = 0; c < 3; c++)
+				writer.Write(quantized[e][c], 10);
+		writer.Write(indices[0], 3);
+		for (int i = 1; i < 16; i++)
+			writer.Write(indices[i], 4);
+	}
+
+	////// Images //////
+
+	void BlockCompression::Encode(TextureCompression compression, const uint8_t* rgba, uint32_t width, uint32_t height, std::vector<uint8_t>& data)
+	{
+		GE_CORE_ASSERT(!IsHDR(compression), "BC6H compresses float images!");
+
+		const uint32_t blocksX = (width + 3) / 4;
+		const uint32_t blocksY = (height + 3) / 4;
+		const uint32_t blockSize = GetBlockSize(compression);
+		data.resize((size_t)blocksX * blocksY * blockSize);
+
+		uint8_t pixels[16][4];
+		uint8_t* block = data.data();
+		for (uint32_t by = 0; by < blocksY; by++)
+		{
+			for (uint32_t bx = 0; bx < blocksX; bx++, block += blockSize)
+			{
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					const uint32_t x = std::min(bx * 4 + (i & 3), width - 1);
+					const uint32_t y = std::min(by * 4 + (i >> 2), height - 1);
+					std::memcpy(pixels[i], rgba + ((size_t)y * width + x) * 4, 4);
+				}
+
+				switch (compression)
+				{
+					case TextureCompression::BC1:	EncodeBC1(pixels, block); break;
+					case TextureCompression::BC3:	EncodeBC3(pixels, block); break;
+					case TextureCompression::BC5:	EncodeBC5(pixels, block); break;
+					case TextureCompression::BC7:	EncodeBC7(pixels, block); break;
+					default:						break;
+				}
+			}
+		}
+	}
+
+	void BlockCompression::Encode(TextureCompression compression, const float* rgb, uint32_t width, uint32_t height, std::vector<uint8_t>& data)
+	{
+		GE_CORE_ASSERT(IsHDR(compression), "Only BC6H compresses float images!");
+
+		const uint32_t blocksX = (width + 3) / 4;
+		const uint32_t blocksY = (height + 3) / 4;
+		data.resize((size_t)blocksX * blocksY * GetBlockSize(compression));
+
+		float pixels[16][3];
+		uint8_t* block = data.data();
+		for (uint32_t by = 0; by < blocksY; by++)
+		{
+			for (uint32_t bx = 0; bx < blocksX; bx++, block += 16)
+			{
+				for (uint32_t i = 0; i < 16; i++)
+				{
+					const uint32_t x = std::min(bx * 4 + (i & 3), width - 1);
+					const uint32_t y = std::min(by * 4 + (i >> 2), height - 1);
+					std::memcpy(pixels[i], rgb + ((size_t)y * width + x) * 3, sizeof(pixels[i]));
+				}
+
+				EncodeBC6H(pixels, block);
+			}
+		}
+	}
+}
@@ -0,0 +1,48 @@
+/*
+	Block Compression
+
+	CPU encoders for the BC texture formats. Every format works on 4x4 blocks of pixels:
+	BC1 (RGB, 8 bytes), BC3 (RGBA, 16 bytes), BC5 (two channels for normal maps, 16 bytes),
+	BC7 (RGBA, 16 bytes) and BC6H (unsigned half float RGB, 16 bytes).
+	BC7 only writes mode 6 and BC6H only mode 11, the single subset modes, which keeps the encoders
+	small and fast at some quality cost on blocks with two distinct colour groups.
+	Nothing here touches the renderer, so it runs anywhere.
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Core.h"
+
+namespace ge {
+
+	enum class TextureCompression : uint32_t
+	{
+		None = 0,
+		BC1 = 1,
+		BC3 = 2,
+		BC5 = 3,
+		BC6H = 4,
+		BC7 = 5
+	};
+
+	class BlockCompression
+	{
+	public:
+		// Bytes per 4x4 block
+		static uint32_t GetBlockSize(TextureCompression compression);
+		static bool IsHDR(TextureCompression compression) { return compression == TextureCompression::BC6H; }
+
+		// Blocks are 16 pixels in rows, RGBA with 8 bits per channel
+		static void EncodeBC1(const uint8_t pixels[16][4], uint8_t* block);
+		static void EncodeBC3(const uint8_t pixels[16][4], uint8_t* block);
+		static void EncodeBC5(const uint8_t pixels[16][4], uint8_t* block);		// Red and green
+		static void EncodeBC7(const uint8_t pixels[16][4], uint8_t* block);
+		// RGB floats, negative values are clamped to 0
+		static void EncodeBC6H(const float pixels[16][3], uint8_t* block);
+
+		// Compresses a whole image in rows of blocks, edge blocks repeat the last row and column.
+		// 8 bit images are RGBA, float images RGB.
+		static void Encode(TextureCompression compression, const uint8_t* rgba, uint32_t width, uint32_t height, std::vector<uint8_t>& data);
+		static void Encode(TextureCompression compression, const float* rgb, uint32_t width, uint32_t height, std::vector<uint8_t>& data);
+	};
+}
@@ -9,6 +9,7 @@
 #include "Renderer.h"
 
 #include "Platform/OpenGL/OpenGLBuffer.h"
+#include "Platform/Software/SoftwareBuffer.h"
 
 namespace ge {
 
@@ -19,6 +20,21 @@ namespace ge {
 			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
 
 			case RendererAPI::API::OpenGL:	return new OpenGLVertexBuffer(vertices, size);
+			case RendererAPI::API::Software:	return new SoftwareVertexBuffer(vertices, size);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
+	VertexBuffer* VertexBuffer::Create(uint32_t size)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+			case RendererAPI::API::OpenGL:	return new OpenGLVertexBuffer(size);
+			case RendererAPI::API::Software:	return new SoftwareVertexBuffer(size);
 		}
 
 		GE_CORE_ASSERT(false, "Unknown RendererAPI");
@@ -32,6 +48,21 @@ namespace ge {
 			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
 
 			case RendererAPI::API::OpenGL:	return new OpenGLIndexBuffer(indices, count);
+			case RendererAPI::API::Software:	return new SoftwareIndexBuffer(indices, count);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
+	IndirectBuffer* IndirectBuffer::Create(const DrawIndirectCommand* commands, uint32_t count)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+			case RendererAPI::API::OpenGL:	return new OpenGLIndirectBuffer(commands, count);
+			case RendererAPI::API::Software:	return new SoftwareIndirectBuffer(commands, count);
 		}
 
 		GE_CORE_ASSERT(false, "Unknown RendererAPI");
@@ -10,7 +10,9 @@ namespace ge {
 
 	enum class ShaderDataType 
 	{
-		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool,
+		// Compact vertex formats, the short types are usually normalized to [-1, 1] or [0, 1]
+		Half2, Half4, Short2, Short4, UShort2, UShort4
 	};
 
 	static uint32_t ShaderDateTypeSize(ShaderDataType type) 
@@ -28,6 +30,12 @@ namespace ge {
 			case ShaderDataType::Int3:		return 4 * 3;
 			case ShaderDataType::Int4:		return 4 * 4;
 			case ShaderDataType::Bool:		return 1;
+			case ShaderDataType::Half2:		return 2 * 2;
+			case ShaderDataType::Half4:		return 2 * 4;
+			case ShaderDataType::Short2:	return 2 * 2;
+			case ShaderDataType::Short4:	return 2 * 4;
+			case ShaderDataType::UShort2:	return 2 * 2;
+			case ShaderDataType::UShort4:	return 2 * 4;
 		}
 
 		GE_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -41,11 +49,12 @@ namespace ge {
 		size_t Offset = 0;
 		uint32_t Size = 0;
 		bool Normalized = false;
+		uint32_t Divisor = 0;			// 0 advances per vertex, N advances once every N instances
 
 		BufferElement() = default;
 
-		BufferElement(ShaderDataType type, const std::string& name, bool normalized = false)
-			: Name(name), Type(type), Size(ShaderDateTypeSize(type)), Offset(0), Normalized(normalized)
+		BufferElement(ShaderDataType type, const std::string& name, bool normalized = false, uint32_t divisor = 0)
+			: Name(name), Type(type), Size(ShaderDateTypeSize(type)), Offset(0), Normalized(normalized), Divisor(divisor)
 		{
 
 		}
@@ -65,11 +74,28 @@ namespace ge {
 				case ShaderDataType::Int3:		return 3;
 				case ShaderDataType::Int4:		return 4;
 				case ShaderDataType::Bool:		return 1;
+				case ShaderDataType::Half2:		return 2;
+				case ShaderDataType::Half4:		return 4;
+				case ShaderDataType::Short2:	return 2;
+				case ShaderDataType::Short4:	return 4;
+				case ShaderDataType::UShort2:	return 2;
+				case ShaderDataType::UShort4:	return 4;
 			}
 
 			GE_CORE_ASSERT(false, "Unknown ShaderDataType!");
 			return 0;
 		}
+
+		// Matrices take up one attribute location per column
+		uint32_t GetLocationCount() const
+		{
+			switch (Type)
+			{
+				case ShaderDataType::Mat3:		return 3;
+				case ShaderDataType::Mat4:		return 4;
+				default:						return 1;
+			}
+		}
 	};
 
 	class BufferLayout 
@@ -123,8 +149,12 @@ namespace ge {
 		virtual void SetLayout(const BufferLayout& layout) = 0;
 		virtual const BufferLayout& GetLayout() const = 0;
 
+		// Only for buffers created with a size, data must fit in that size
+		virtual void SetData(const void* data, uint32_t size) = 0;
+
 		// Use this instead of constructor
 		static VertexBuffer* Create(void* vertices, uint32_t size);
+		static VertexBuffer* Create(uint32_t size);		// Dynamic buffer filled later through SetData
 	};
 
 	class IndexBuffer 
@@ -141,4 +171,29 @@ namespace ge {
 		static IndexBuffer* Create(void* indices, uint32_t count);
 	};
 
+	// Arguments of one indexed draw read by the GPU, laid out the way indirect draw calls expect them
+	struct DrawIndirectCommand
+	{
+		uint32_t Count;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;
+		uint32_t BaseInstance;
+	};
+
+	class IndirectBuffer
+	{
+	public:
+		virtual ~IndirectBuffer() = default;
+
+		virtual void Bind() const = 0;
+
+		// Replaces the commands, count must not be more than the buffer was created with
+		virtual void SetData(const DrawIndirectCommand* commands, uint32_t count) = 0;
+		virtual uint32_t GetCount() const = 0;
+
+		// Use this instead of constructor
+		static IndirectBuffer* Create(const DrawIndirectCommand* commands, uint32_t count);
+	};
+
 }
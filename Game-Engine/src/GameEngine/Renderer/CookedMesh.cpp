@@ -0,0 +1,132 @@
+/*
+	Cooked Mesh
+
+	Binary mesh file written offline from an imported model. Vertices are stored already in their
+	upload format and indices as 32 bit, each blob aligned so it can be handed to the GPU straight
+	from the memory mapped file. A submesh table gives the draw range and bounds of every mesh and a
+	texture table the material textures of the submeshes.
+*/
+
+#include "gepch.h"
+#include "CookedMesh.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace ge {
+
+	static_assert(sizeof(CookedMeshHeader) == 128, "Cooked mesh header layout changed, bump CookedMesh::Version!");
+	static_assert(sizeof(CookedSubmesh) == 40, "Cooked submesh layout changed, bump CookedMesh::Version!");
+	static_assert(sizeof(CookedMeshTexture) == 256, "Cooked mesh texture layout changed, bump CookedMesh::Version!");
+
+	static uint64_t AlignOffset(uint64_t offset)
+	{
+		return (offset + CookedMesh::Alignment - 1) & ~(uint64_t)(CookedMesh::Alignment - 1);
+	}
+
+	bool CookedMesh::Write(const std::string& path, CookedMeshHeader header, const std::vector<CookedSubmesh>& submeshes,
+		const std::vector<CookedMeshTexture>& textures, const void* vertexData, const unsigned int* indices)
+	{
+		header.Magic = Magic;
+		header.Version = Version;
+		header.SubmeshCount = (uint32_t)submeshes.size();
+		header.TextureCount = (uint32_t)textures.size();
+		header.SubmeshOffset = AlignOffset(sizeof(CookedMeshHeader));
+		header.TextureOffset = AlignOffset(header.SubmeshOffset + submeshes.size() * sizeof(CookedSubmesh));
+		header.VertexOffset = AlignOffset(header.TextureOffset + textures.size() * sizeof(CookedMeshTexture));
+		header.IndexOffset = AlignOffset(header.VertexOffset + (uint64_t)header.VertexCount * header.VertexStride);
+		header.FileSize = header.IndexOffset + (uint64_t)header.IndexCount * sizeof(unsigned int);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!out)
+			{
+				GE_CORE_ERROR("Could not open {0} for writing", tempPath);
+				return false;
+			}
+
+			static const char s_Padding[Alignment] = {};
+			auto writeAt = [&out](uint64_t offset, const void* data, uint64_t size)
+			{
+				const uint64_t position = (uint64_t)out.tellp();
+				out.write(s_Padding, (std::streamsize)(offset - position));
+				out.write((const char*)data, (std::streamsize)size);
+			};
+
+			writeAt(0, &header, sizeof(header));
+			writeAt(header.SubmeshOffset, submeshes.data(), submeshes.size() * sizeof(CookedSubmesh));
+			writeAt(header.TextureOffset, textures.data(), textures.size() * sizeof(CookedMeshTexture));
+			writeAt(header.VertexOffset, vertexData, (uint64_t)header.VertexCount * header.VertexStride);
+			writeAt(header.IndexOffset, indices, (uint64_t)header.IndexCount * sizeof(unsigned int));
+
+			if (!out)
+			{
+				GE_CORE_ERROR("Failed writing {0}", tempPath);
+				return false;
+			}
+		}
+
+		// Replaces the old file in one step
+		std::error_code error;
+		std::filesystem::rename(tempPath, path, error);
+		if (error)
+		{
+			GE_CORE_ERROR("Could not replace {0}: {1}", path, error.message());
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CookedMesh::Open(const std::string& path)
+	{
+		if (!m_File.Open(path))
+			return false;
+
+		const uint64_t fileSize = m_File.GetSize();
+		bool valid = fileSize >= sizeof(CookedMeshHeader);
+		if (valid)
+		{
+			const CookedMeshHeader& header = GetHeader();
+			valid = header.Magic == Magic && header.Version == Version && header.FileSize == fileSize
+				&& header.VertexFormat <= (uint32_t)MeshVertexFormat::PackedQuantized
+				&& header.VertexStride == VertexFormat::GetStride((MeshVertexFormat)header.VertexFormat)
+				&& header.SubmeshOffset % Alignment == 0 && header.TextureOffset % Alignment == 0 && header.VertexOffset % Alignment == 0 && header.IndexOffset % Alignment == 0
+				&& header.SubmeshOffset + (uint64_t)header.SubmeshCount * sizeof(CookedSubmesh) <= header.TextureOffset
+				&& header.TextureOffset + (uint64_t)header.TextureCount * sizeof(CookedMeshTexture) <= header.VertexOffset
+				&& header.VertexOffset + (uint64_t)header.VertexCount * header.VertexStride <= header.IndexOffset
+				&& header.IndexOffset + (uint64_t)header.IndexCount * sizeof(unsigned int) <= fileSize;
+		}
+
+		// The ranges are checked once here so the loader can use them without looking
+		for (uint32_t i = 0; valid && i < GetHeader().SubmeshCount; i++)
+		{
+			const CookedSubmesh& submesh = GetSubmeshes()[i];
+			valid = submesh.BaseVertex >= 0
+				&& (uint64_t)submesh.BaseVertex + submesh.VertexCount <= GetHeader().VertexCount
+				&& (uint64_t)submesh.FirstIndex + submesh.IndexCount <= GetHeader().IndexCount;
+		}
+		for (uint32_t i = 0; valid && i < GetHeader().TextureCount; i++)
+		{
+			const CookedMeshTexture& texture = GetTextures()[i];
+			valid = texture.Submesh < GetHeader().SubmeshCount && texture.Path[CookedMeshTexture::MaxPath - 1] == '\0';
+		}
+
+		if (!valid)
+		{
+			GE_CORE_WARN("{0} is not a valid cooked mesh", path);
+			m_File.Close();
+		}
+		return valid;
+	}
+
+	bool CookedMesh::IsCurrent(const CookedMeshHeader& expected) const
+	{
+		const CookedMeshHeader& header = GetHeader();
+		return header.Storage == expected.Storage && header.VertexFormat == expected.VertexFormat
+			&& header.FullVertexStride == expected.FullVertexStride && header.Flags == expected.Flags
+			&& header.SourceSize == expected.SourceSize && header.SourceTime == expected.SourceTime;
+	}
+}
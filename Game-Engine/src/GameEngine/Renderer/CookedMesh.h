@@ -0,0 +1,110 @@
+/*
+	Cooked Mesh
+
+	Binary mesh file written offline from an imported model. Vertices are stored already in their
+	upload format and indices as 32 bit, each blob aligned so it can be handed to the GPU straight
+	from the memory mapped file. A submesh table gives the draw range and bounds of every mesh and a
+	texture table the material textures of the submeshes.
+
+	Layout: CookedMeshHeader, CookedSubmesh[SubmeshCount], CookedMeshTexture[TextureCount], vertex blob, index blob.
+*/
+
+#pragma once
+
+#include "GameEngine/Core/MappedFile.h"
+#include "GameEngine/Core/FileSystem.h"
+#include "GameEngine/Renderer/VertexFormat.h"
+
+#include <glm/glm.hpp>
+
+namespace ge {
+
+	enum CookedMeshFlags
+	{
+		CookedMeshFlags_None = 0,
+		CookedMeshFlags_Optimized = 1 << 0		// MeshOptimizer ran on every mesh
+	};
+
+	struct CookedMeshHeader
+	{
+		uint32_t Magic = 0;
+		uint32_t Version = 0;
+		uint32_t Storage = 0;				// ModelStorage the vertices were packed for
+		uint32_t VertexFormat = 0;			// MeshVertexFormat of the vertex blob
+		uint32_t VertexStride = 0;
+		uint32_t FullVertexStride = 0;		// sizeof(MeshVertex) when cooked, a change in it means the importer changed
+		uint32_t Flags = CookedMeshFlags_None;
+		uint32_t SubmeshCount = 0;
+		uint32_t VertexCount = 0;
+		uint32_t IndexCount = 0;
+		uint32_t TextureCount = 0;
+		uint32_t Reserved = 0;
+
+		// Size and write time of the source file, the cooked file is stale when either changes
+		uint64_t SourceSize = 0;
+		int64_t SourceTime = 0;
+
+		// Byte offsets from the start of the file
+		uint64_t SubmeshOffset = 0;
+		uint64_t TextureOffset = 0;
+		uint64_t VertexOffset = 0;
+		uint64_t IndexOffset = 0;
+		uint64_t FileSize = 0;
+
+		// Bounds of the whole model, the quantization bounds when packed storage is quantized
+		glm::vec3 BoundsMin = glm::vec3(0.0f);
+		glm::vec3 BoundsExtent = glm::vec3(1.0f);
+	};
+
+	struct CookedSubmesh
+	{
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+		int32_t BaseVertex = 0;
+		uint32_t VertexCount = 0;
+
+		// Bounds of the mesh, the quantization bounds when per mesh storage is quantized
+		glm::vec3 BoundsMin = glm::vec3(0.0f);
+		glm::vec3 BoundsExtent = glm::vec3(1.0f);
+	};
+
+	// A material texture of a submesh, the path is the one in the material, relative to the model's directory
+	struct CookedMeshTexture
+	{
+		static constexpr uint32_t MaxPath = 248;
+
+		uint32_t Submesh = 0;
+		uint32_t Slot = 0;					// Index of the material slot the model binds it as
+		char Path[MaxPath] = {};			// Null terminated
+	};
+
+	class CookedMesh
+	{
+	public:
+		static constexpr uint32_t Magic = 0x534D4547;	// "GEMS"
+		static constexpr uint32_t Version = 2;
+		static constexpr uint32_t Alignment = 16;
+
+		// Writes the file, filling in the magic, version, offsets and counts of the header.
+		// Goes through a temporary file so a failed cook never leaves a half written file behind.
+		static bool Write(const std::string& path, CookedMeshHeader header, const std::vector<CookedSubmesh>& submeshes,
+			const std::vector<CookedMeshTexture>& textures, const void* vertexData, const unsigned int* indices);
+
+		// Maps the file and checks its header and that every table and blob is inside it
+		bool Open(const std::string& path);
+		void Close() { m_File.Close(); }
+		bool IsOpen() const { return m_File.IsOpen(); }
+
+		// True when the file was cooked with the same settings, the same vertex layout and from the same source
+		bool IsCurrent(const CookedMeshHeader& expected) const;
+
+		// Pointers into the mapping, valid until the file is closed
+		const CookedMeshHeader& GetHeader() const { return *(const CookedMeshHeader*)m_File.GetData(); }
+		const CookedSubmesh* GetSubmeshes() const { return (const CookedSubmesh*)(m_File.GetData() + GetHeader().SubmeshOffset); }
+		const CookedMeshTexture* GetTextures() const { return (const CookedMeshTexture*)(m_File.GetData() + GetHeader().TextureOffset); }
+		const uint8_t* GetVertexData() const { return m_File.GetData() + GetHeader().VertexOffset; }
+		const unsigned int* GetIndexData() const { return (const unsigned int*)(m_File.GetData() + GetHeader().IndexOffset); }
+	private:
+		MappedFile m_File;
+	};
+}
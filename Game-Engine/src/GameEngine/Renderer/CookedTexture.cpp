@@ -0,0 +1,159 @@
+/*
+	Cooked Texture
+
+	Binary texture file written offline: a whole mip chain already block compressed, in the spirit of KTX2.
+	Every level is aligned so it can be handed to the GPU straight from the memory mapped file,
+	with no decoding or mip generation at load time.
+*/
+
+#include "gepch.h"
+#include "CookedTexture.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace ge {
+
+	static_assert(sizeof(CookedTextureHeader) == 64, "Cooked texture header layout changed, bump CookedTexture::Version!");
+	static_assert(sizeof(CookedTextureLevel) == 24, "Cooked texture level layout changed, bump CookedTexture::Version!");
+
+	static uint64_t AlignOffset(uint64_t offset)
+	{
+		return (offset + CookedTexture::Alignment - 1) & ~(uint64_t)(CookedTexture::Alignment - 1);
+	}
+
+	static uint64_t GetLevelSize(TextureCompression compression, uint32_t width, uint32_t height)
+	{
+		return (uint64_t)((width + 3) / 4) * ((height + 3) / 4) * BlockCompression::GetBlockSize(compression);
+	}
+
+	bool CookedTexture::Write(const std::string& path, CookedTextureHeader header, const std::vector<std::vector<uint8_t>>& levels)
+	{
+		header.Magic = Magic;
+		header.Version = Version;
+		header.LevelCount = (uint32_t)levels.size();
+		header.LevelOffset = AlignOffset(sizeof(CookedTextureHeader));
+
+		std::vector<CookedTextureLevel> table(levels.size());
+		uint64_t offset = AlignOffset(header.LevelOffset + table.size() * sizeof(CookedTextureLevel));
+		for (uint32_t i = 0; i < header.LevelCount; i++)
+		{
+			table[i].Width = std::max(header.Width >> i, 1u);
+			table[i].Height = std::max(header.Height >> i, 1u);
+			table[i].Offset = offset;
+			table[i].Size = levels[i].size();
+			offset = AlignOffset(offset + table[i].Size);
+		}
+		header.FileSize = header.LevelCount > 0 ? table.back().Offset + table.back().Size : header.LevelOffset;
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!out)
+			{
+				GE_CORE_ERROR("Could not open {0} for writing", tempPath);
+				return false;
+			}
+
+			static const char s_Padding[Alignment] = {};
+			auto writeAt = [&out](uint64_t offset, const void* data, uint64_t size)
+			{
+				const uint64_t position = (uint64_t)out.tellp();
+				out.write(s_Padding, (std::streamsize)(offset - position));
+				out.write((const char*)data, (std::streamsize)size);
+			};
+
+			writeAt(0, &header, sizeof(header));
+			writeAt(header.LevelOffset, table.data(), table.size() * sizeof(CookedTextureLevel));
+			for (uint32_t i = 0; i < header.LevelCount; i++)
+				writeAt(table[i].Offset, levels[i].data(), table[i].Size);
+
+			if (!out)
+			{
+				GE_CORE_ERROR("Failed writing {0}", tempPath);
+				return false;
+			}
+		}
+
+		// Replaces the old file in one step
+		std::error_code error;
+		std::filesystem::rename(tempPath, path, error);
+		if (error)
+		{
+			GE_CORE_ERROR("Could not replace {0}: {1}", path, error.message());
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CookedTexture::Open(const std::string& path)
+	{
+		if (!m_File.Open(path))
+			return false;
+
+		m_Path = path;
+		const uint64_t fileSize = m_File.GetSize();
+		bool valid = fileSize >= sizeof(CookedTextureHeader);
+		if (valid)
+		{
+			const CookedTextureHeader& header = GetHeader();
+			valid = header.Magic == Magic && header.Version == Version && header.FileSize == fileSize
+				&& header.Compression >= (uint32_t)TextureCompression::BC1 && header.Compression <= (uint32_t)TextureCompression::BC7
+				&& header.Width > 0 && header.Height > 0 && header.LevelCount > 0 && header.LevelCount <= 32
+				&& header.LevelOffset % Alignment == 0
+				&& header.LevelOffset + (uint64_t)header.LevelCount * sizeof(CookedTextureLevel) <= fileSize;
+		}
+
+		// The levels are checked once here so the upload can use them without looking
+		for (uint32_t i = 0; valid && i < GetHeader().LevelCount; i++)
+		{
+			const CookedTextureHeader& header = GetHeader();
+			const CookedTextureLevel& level = GetLevels()[i];
+			valid = level.Width == std::max(header.Width >> i, 1u) && level.Height == std::max(header.Height >> i, 1u)
+				&& level.Size == GetLevelSize((TextureCompression)header.Compression, level.Width, level.Height)
+				&& level.Offset % Alignment == 0 && level.Offset + level.Size <= fileSize;
+		}
+
+		if (!valid)
+		{
+			GE_CORE_WARN("{0} is not a valid cooked texture", path);
+			m_File.Close();
+		}
+		return valid;
+	}
+
+	bool CookedTexture::OpenForSource(const std::string& sourcePath, bool sRGB)
+	{
+		const std::string cookedPath = GetCookedPath(sourcePath);
+		FileStamp source, cooked;
+		if (!FileSystem::GetStamp(sourcePath, source) || !FileSystem::GetStamp(cookedPath, cooked))
+			return false;
+
+		if (!Open(cookedPath))
+			return false;
+
+		if (!IsCurrent(source, sRGB))
+		{
+			GE_CORE_INFO("{0} is out of date or cooked for the other colour space, loading {1}", cookedPath, sourcePath);
+			m_File.Close();
+			return false;
+		}
+		return true;
+	}
+
+	bool CookedTexture::IsCurrent(const FileStamp& source, bool sRGB) const
+	{
+		const CookedTextureHeader& header = GetHeader();
+		return header.SourceSize == source.Size && header.SourceTime == source.Time && IsSRGB() == sRGB;
+	}
+
+	size_t CookedTexture::GetDataSize() const
+	{
+		size_t size = 0;
+		for (uint32_t i = 0; i < GetHeader().LevelCount; i++)
+			size += (size_t)GetLevels()[i].Size;
+		return size;
+	}
+}
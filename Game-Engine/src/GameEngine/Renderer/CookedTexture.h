@@ -0,0 +1,90 @@
+/*
+	Cooked Texture
+
+	Binary texture file written offline: a whole mip chain already block compressed, in the spirit of KTX2.
+	Every level is aligned so it can be handed to the GPU straight from the memory mapped file,
+	with no decoding or mip generation at load time.
+
+	Layout: CookedTextureHeader, CookedTextureLevel[LevelCount], level data from the largest to the smallest.
+*/
+
+#pragma once
+
+#include "GameEngine/Core/MappedFile.h"
+#include "GameEngine/Core/FileSystem.h"
+#include "GameEngine/Renderer/BlockCompression.h"
+
+namespace ge {
+
+	enum CookedTextureFlags
+	{
+		CookedTextureFlags_None = 0,
+		CookedTextureFlags_sRGB = 1 << 0		// Colour data, mips were filtered in linear space and the GPU decodes it as sRGB
+	};
+
+	struct CookedTextureHeader
+	{
+		uint32_t Magic = 0;
+		uint32_t Version = 0;
+		uint32_t Compression = 0;			// TextureCompression of every level
+		uint32_t Flags = CookedTextureFlags_None;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		uint32_t LevelCount = 0;
+		uint32_t Reserved = 0;
+
+		// Size and write time of the source image, the cooked file is stale when either changes
+		uint64_t SourceSize = 0;
+		int64_t SourceTime = 0;
+
+		// Byte offsets from the start of the file
+		uint64_t LevelOffset = 0;
+		uint64_t FileSize = 0;
+	};
+
+	struct CookedTextureLevel
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+	};
+
+	class CookedTexture
+	{
+	public:
+		static constexpr uint32_t Magic = 0x58544547;	// "GETX"
+		static constexpr uint32_t Version = 1;
+		static constexpr uint32_t Alignment = 16;
+
+		static std::string GetCookedPath(const std::string& path) { return path + ".getex"; }
+
+		// Writes the file with one entry of levels per mip, filling in the magic, version, offsets and level table.
+		// Goes through a temporary file so a failed cook never leaves a half written file behind.
+		static bool Write(const std::string& path, CookedTextureHeader header, const std::vector<std::vector<uint8_t>>& levels);
+
+		// Maps the file and checks its header and that every level is inside it and has the size its format needs
+		bool Open(const std::string& path);
+		// Opens the cooked file next to the source image, only if it was cooked from the file as it is now
+		// and for the same colour space. Missing files are not an error.
+		bool OpenForSource(const std::string& sourcePath, bool sRGB);
+		void Close() { m_File.Close(); }
+		bool IsOpen() const { return m_File.IsOpen(); }
+		const std::string& GetPath() const { return m_Path; }
+
+		bool IsCurrent(const FileStamp& source, bool sRGB) const;
+
+		TextureCompression GetCompression() const { return (TextureCompression)GetHeader().Compression; }
+		bool IsSRGB() const { return (GetHeader().Flags & CookedTextureFlags_sRGB) != 0; }
+
+		// Pointers into the mapping, valid until the file is closed
+		const CookedTextureHeader& GetHeader() const { return *(const CookedTextureHeader*)m_File.GetData(); }
+		const CookedTextureLevel* GetLevels() const { return (const CookedTextureLevel*)(m_File.GetData() + GetHeader().LevelOffset); }
+		const uint8_t* GetLevelData(uint32_t level) const { return m_File.GetData() + GetLevels()[level].Offset; }
+		// Bytes of every level together, what the upload costs
+		size_t GetDataSize() const;
+	private:
+		MappedFile m_File;
+		std::string m_Path;
+	};
+}
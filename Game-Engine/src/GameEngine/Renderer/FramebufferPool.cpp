@@ -0,0 +1,103 @@
+/*
+	Framebuffer Pool
+
+	Keeps framebuffers alive between frames so transient ones (render graph attachments) are reused
+	instead of created every frame. A released framebuffer goes back to the pool and is handed out again
+	for the next request with the same description, ones left unused for a few frames are destroyed.
+*/
+
+#include "gepch.h"
+#include "FramebufferPool.h"
+
+namespace ge {
+
+	size_t FramebufferDesc::GetMemorySize() const
+	{
+		const size_t bytesPerPixel = IsEnvironment ? 4 : 8 + 4;
+		return (size_t)Width * Height * bytesPerPixel;
+	}
+
+	Ref<Framebuffer> FramebufferPool::Acquire(const FramebufferDesc& desc)
+	{
+		for (Entry& entry : m_Entries)
+		{
+			if (!entry.InUse && entry.Desc == desc)
+			{
+				entry.InUse = true;
+				entry.LastUsedFrame = m_Frame;
+				m_Statistics.InUse++;
+				m_Statistics.Reused++;
+				return entry.FramebufferPtr;
+			}
+		}
+
+		Entry entry;
+		entry.FramebufferPtr.reset(Framebuffer::Create(desc.Width, desc.Height, desc.IsEnvironment));
+		entry.Desc = desc;
+		entry.LastUsedFrame = m_Frame;
+		entry.InUse = true;
+		m_Entries.push_back(entry);
+
+		m_Statistics.Framebuffers++;
+		m_Statistics.InUse++;
+		m_Statistics.Created++;
+		m_Statistics.Memory += desc.GetMemorySize();
+		return entry.FramebufferPtr;
+	}
+
+	void FramebufferPool::Release(const Ref<Framebuffer>& framebuffer)
+	{
+		for (Entry& entry : m_Entries)
+		{
+			if (entry.FramebufferPtr == framebuffer)
+			{
+				GE_CORE_ASSERT(entry.InUse, "Framebuffer released twice!");
+				entry.InUse = false;
+				entry.LastUsedFrame = m_Frame;
+				m_Statistics.InUse--;
+				return;
+			}
+		}
+
+		GE_CORE_ASSERT(false, "Framebuffer was not acquired from this pool!");
+	}
+
+	void FramebufferPool::EndFrame()
+	{
+		m_Frame++;
+
+		for (size_t i = 0; i < m_Entries.size();)
+		{
+			const Entry& entry = m_Entries[i];
+			if (!entry.InUse && m_Frame - entry.LastUsedFrame > m_MaxUnusedFrames)
+			{
+				m_Statistics.Framebuffers--;
+				m_Statistics.Memory -= entry.Desc.GetMemorySize();
+				m_Entries[i] = m_Entries.back();
+				m_Entries.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	void FramebufferPool::Trim()
+	{
+		for (size_t i = 0; i < m_Entries.size();)
+		{
+			if (!m_Entries[i].InUse)
+			{
+				m_Statistics.Framebuffers--;
+				m_Statistics.Memory -= m_Entries[i].Desc.GetMemorySize();
+				m_Entries[i] = m_Entries.back();
+				m_Entries.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+}
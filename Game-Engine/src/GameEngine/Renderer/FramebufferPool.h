@@ -0,0 +1,69 @@
+/*
+	Framebuffer Pool
+
+	Keeps framebuffers alive between frames so transient ones (render graph attachments) are reused
+	instead of created every frame. A released framebuffer goes back to the pool and is handed out again
+	for the next request with the same description, ones left unused for a few frames are destroyed.
+*/
+
+#pragma once
+
+#include "Framebuffer.h"
+
+namespace ge {
+
+	struct FramebufferDesc
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		bool IsEnvironment = false;		// Depth only, the colour comes from attached textures
+
+		bool operator==(const FramebufferDesc& other) const
+		{
+			return Width == other.Width && Height == other.Height && IsEnvironment == other.IsEnvironment;
+		}
+		bool operator!=(const FramebufferDesc& other) const { return !(*this == other); }
+
+		// Estimated GPU memory, an RGBA16F colour texture and a 24 bit depth buffer padded to 32 bits
+		size_t GetMemorySize() const;
+	};
+
+	class FramebufferPool
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t Framebuffers = 0;		// Alive, in use or free
+			uint32_t InUse = 0;
+			uint32_t Created = 0;			// Since the pool was created
+			uint32_t Reused = 0;
+			size_t Memory = 0;				// Of the alive framebuffers
+		};
+
+		// Free framebuffers unused for more frames than this are destroyed
+		FramebufferPool(uint32_t maxUnusedFrames = 3) : m_MaxUnusedFrames(maxUnusedFrames) {}
+
+		Ref<Framebuffer> Acquire(const FramebufferDesc& desc);
+		void Release(const Ref<Framebuffer>& framebuffer);
+
+		// Destroys the framebuffers that have been free for too long
+		void EndFrame();
+		// Destroys every free framebuffer
+		void Trim();
+
+		const Statistics& GetStatistics() const { return m_Statistics; }
+	private:
+		struct Entry
+		{
+			Ref<Framebuffer> FramebufferPtr;
+			FramebufferDesc Desc;
+			uint64_t LastUsedFrame = 0;
+			bool InUse = false;
+		};
+	private:
+		std::vector<Entry> m_Entries;
+		uint64_t m_Frame = 0;
+		uint32_t m_MaxUnusedFrames;
+		Statistics m_Statistics;
+	};
+}
@@ -0,0 +1,91 @@
+/*
+	Frustum
+
+	Planes of a camera's view volume taken from its view projection matrix, with tests against
+	bounding spheres and axis aligned boxes. A shape is only rejected when it is fully outside one
+	plane, so a few shapes near the corners pass even though they are not visible.
+*/
+
+#include "gepch.h"
+#include "Frustum.h"
+
+namespace ge {
+
+	BoundingSphere BoundingSphere::Transform(const glm::mat4& transform) const
+	{
+		const float scale = std::sqrt(std::max({ glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+			glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])), glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2])) }));
+
+		BoundingSphere result;
+		result.Center = glm::vec3(transform * glm::vec4(Center, 1.0f));
+		result.Radius = Radius * scale;
+		return result;
+	}
+
+	// Each axis of the result spans the absolute values of the matrix times the extents (Arvo)
+	BoundingBox BoundingBox::Transform(const glm::mat4& transform) const
+	{
+		const glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+		const glm::vec3 extents = GetExtents();
+
+		glm::vec3 newExtents(0.0f);
+		for (int column = 0; column < 3; column++)
+		{
+			for (int row = 0; row < 3; row++)
+				newExtents[row] += std::abs(transform[column][row]) * extents[column];
+		}
+
+		BoundingBox result;
+		result.Min = center - newExtents;
+		result.Max = center + newExtents;
+		return result;
+	}
+
+	// Gribb and Hartmann: each plane is the last row of the matrix plus or minus one of the others
+	Frustum::Frustum(const glm::mat4& viewProjection)
+	{
+		auto row = [&viewProjection](int i)
+		{
+			return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+		};
+
+		const glm::vec4 w = row(3);
+		m_Planes[Left] = w + row(0);
+		m_Planes[Right] = w - row(0);
+		m_Planes[Bottom] = w + row(1);
+		m_Planes[Top] = w - row(1);
+		m_Planes[Near] = w + row(2);
+		m_Planes[Far] = w - row(2);
+
+		for (glm::vec4& plane : m_Planes)
+		{
+			const float length = glm::length(glm::vec3(plane));
+			if (length > 0.0f)
+				plane = plane / length;
+		}
+	}
+
+	bool Frustum::Intersects(const BoundingSphere& sphere) const
+	{
+		for (const glm::vec4& plane : m_Planes)
+		{
+			if (glm::dot(glm::vec3(plane), sphere.Center) + plane.w < -sphere.Radius)
+				return false;
+		}
+		return true;
+	}
+
+	bool Frustum::Intersects(const BoundingBox& box) const
+	{
+		const glm::vec3 center = box.GetCenter();
+		const glm::vec3 extents = box.GetExtents();
+		for (const glm::vec4& plane : m_Planes)
+		{
+			// Distance from the centre to the corner furthest along the normal
+			const float radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+				return false;
+		}
+		return true;
+	}
+}
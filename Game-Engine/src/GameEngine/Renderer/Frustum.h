@@ -0,0 +1,53 @@
+/*
+	Frustum
+
+	Planes of a camera's view volume taken from its view projection matrix, with tests against
+	bounding spheres and axis aligned boxes. A shape is only rejected when it is fully outside one
+	plane, so a few shapes near the corners pass even though they are not visible.
+*/
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace ge {
+
+	struct BoundingSphere
+	{
+		glm::vec3 Center = glm::vec3(0.0f);
+		float Radius = 0.0f;
+
+		// Bounds after the transform, the radius grows with the largest scale
+		BoundingSphere Transform(const glm::mat4& transform) const;
+	};
+
+	struct BoundingBox
+	{
+		glm::vec3 Min = glm::vec3(0.0f);
+		glm::vec3 Max = glm::vec3(0.0f);
+
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+		// Axis aligned box around the transformed box
+		BoundingBox Transform(const glm::mat4& transform) const;
+	};
+
+	class Frustum
+	{
+	public:
+		enum Plane { Left = 0, Right, Bottom, Top, Near, Far, PlaneCount };
+
+		Frustum() = default;
+		// Clip space with z from -w to w, as OpenGL projections produce
+		explicit Frustum(const glm::mat4& viewProjection);
+
+		// Normal in xyz pointing inwards and distance in w, normalized so dot(normal, point) + w is a distance
+		const glm::vec4& GetPlane(uint32_t plane) const { return m_Planes[plane]; }
+
+		bool Intersects(const BoundingSphere& sphere) const;
+		bool Intersects(const BoundingBox& box) const;
+	private:
+		glm::vec4 m_Planes[PlaneCount];
+	};
+}
@@ -0,0 +1,145 @@
+/*
+	Frustum Culler
+
+	Tests many bounding volumes against a frustum at once. Bounds are kept as separate arrays of each
+	component so the plane tests run over blocks of them in plain loops the compiler vectorizes.
+	Large sets are split over a thread pool. The result is the list of indices that passed, in the
+	order they were added.
+*/
+
+#include "gepch.h"
+#include "FrustumCuller.h"
+
+#include "GameEngine/Core/ThreadPool.h"
+
+namespace ge {
+
+	// Bounds tested together, the masks of a block stay in registers or at least in the cache
+	static constexpr uint32_t s_BlockSize = 64;
+	// Bounds per job of a parallel cull
+	static constexpr uint32_t s_RangeSize = 2048;
+
+	uint32_t FrustumCuller::Add(const BoundingSphere& sphere)
+	{
+		m_CenterX.push_back(sphere.Center.x);
+		m_CenterY.push_back(sphere.Center.y);
+		m_CenterZ.push_back(sphere.Center.z);
+		m_ExtentX.push_back(0.0f);
+		m_ExtentY.push_back(0.0f);
+		m_ExtentZ.push_back(0.0f);
+		m_Radius.push_back(sphere.Radius);
+		return (uint32_t)m_Radius.size() - 1;
+	}
+
+	uint32_t FrustumCuller::Add(const BoundingBox& box)
+	{
+		const glm::vec3 center = box.GetCenter();
+		const glm::vec3 extents = box.GetExtents();
+		m_CenterX.push_back(center.x);
+		m_CenterY.push_back(center.y);
+		m_CenterZ.push_back(center.z);
+		m_ExtentX.push_back(extents.x);
+		m_ExtentY.push_back(extents.y);
+		m_ExtentZ.push_back(extents.z);
+		m_Radius.push_back(0.0f);
+		return (uint32_t)m_Radius.size() - 1;
+	}
+
+	BoundingBox FrustumCuller::GetBox(uint32_t index) const
+	{
+		const glm::vec3 center(m_CenterX[index], m_CenterY[index], m_CenterZ[index]);
+		const glm::vec3 extents = glm::vec3(m_ExtentX[index], m_ExtentY[index], m_ExtentZ[index]) + glm::vec3(m_Radius[index]);
+		return { center - extents, center + extents };
+	}
+
+	void FrustumCuller::Reserve(uint32_t count)
+	{
+		for (std::vector<float>* component : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ, &m_Radius })
+			component->reserve(count);
+		m_Visible.reserve(count);
+	}
+
+	void FrustumCuller::Clear()
+	{
+		for (std::vector<float>* component : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ, &m_Radius })
+			component->clear();
+		m_Visible.clear();
+	}
+
+	void FrustumCuller::CullRange(const Frustum& frustum, uint32_t begin, uint32_t end, std::vector<uint32_t>& visible) const
+	{
+		const float* centerX = m_CenterX.data();
+		const float* centerY = m_CenterY.data();
+		const float* centerZ = m_CenterZ.data();
+		const float* extentX = m_ExtentX.data();
+		const float* extentY = m_ExtentY.data();
+		const float* extentZ = m_ExtentZ.data();
+		const float* radius = m_Radius.data();
+
+		for (uint32_t block = begin; block < end; block += s_BlockSize)
+		{
+			const uint32_t count = std::min(s_BlockSize, end - block);
+
+			// One plane at a time over the whole block, without branches, so each loop is a straight run of vector math
+			uint32_t inside[s_BlockSize];
+			for (uint32_t i = 0; i < count; i++)
+				inside[i] = 1;
+
+			for (uint32_t p = 0; p < Frustum::PlaneCount; p++)
+			{
+				const glm::vec4& plane = frustum.GetPlane(p);
+				const float nx = plane.x, ny = plane.y, nz = plane.z, d = plane.w;
+				const float ax = std::abs(nx), ay = std::abs(ny), az = std::abs(nz);
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const uint32_t j = block + i;
+					const float distance = nx * centerX[j] + ny * centerY[j] + nz * centerZ[j] + d;
+					const float reach = ax * extentX[j] + ay * extentY[j] + az * extentZ[j] + radius[j];
+					inside[i] &= (uint32_t)(distance + reach >= 0.0f);
+				}
+			}
+
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (inside[i])
+					visible.push_back(block + i);
+			}
+		}
+	}
+
+	void FrustumCuller::Cull(const Frustum& frustum, ThreadPool* pool)
+	{
+		const uint32_t count = GetCount();
+		m_Visible.clear();
+
+		if (!pool || count < ParallelThreshold)
+		{
+			CullRange(frustum, 0, count, m_Visible);
+		}
+		else
+		{
+			// Each range writes its own list, joined in order afterwards so the result doesn't depend on timing
+			const uint32_t rangeCount = (count + s_RangeSize - 1) / s_RangeSize;
+			if (m_RangeVisible.size() < rangeCount)
+				m_RangeVisible.resize(rangeCount);
+
+			for (uint32_t range = 0; range < rangeCount; range++)
+			{
+				pool->Submit([this, &frustum, range, count]()
+				{
+					std::vector<uint32_t>& visible = m_RangeVisible[range];
+					visible.clear();
+					CullRange(frustum, range * s_RangeSize, std::min((range + 1) * s_RangeSize, count), visible);
+				});
+			}
+			pool->WaitIdle();
+
+			for (uint32_t range = 0; range < rangeCount; range++)
+				m_Visible.insert(m_Visible.end(), m_RangeVisible[range].begin(), m_RangeVisible[range].end());
+		}
+
+		m_Statistics.Tested = count;
+		m_Statistics.Visible = (uint32_t)m_Visible.size();
+		m_Statistics.Culled = count - m_Statistics.Visible;
+	}
+}
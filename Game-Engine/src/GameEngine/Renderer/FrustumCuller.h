@@ -0,0 +1,59 @@
+/*
+	Frustum Culler
+
+	Tests many bounding volumes against a frustum at once. Bounds are kept as separate arrays of each
+	component so the plane tests run over blocks of them in plain loops the compiler vectorizes.
+	Large sets are split over a thread pool. The result is the list of indices that passed, in the
+	order they were added.
+*/
+
+#pragma once
+
+#include "Frustum.h"
+
+#include "GameEngine/Core/Core.h"
+
+namespace ge {
+
+	class ThreadPool;
+
+	class FrustumCuller
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t Tested = 0;
+			uint32_t Visible = 0;
+			uint32_t Culled = 0;
+		};
+
+		// Sets smaller than this are culled on the calling thread
+		static constexpr uint32_t ParallelThreshold = 4096;
+
+		// Both return the index used in the visible list
+		uint32_t Add(const BoundingSphere& sphere);
+		uint32_t Add(const BoundingBox& box);
+		void Reserve(uint32_t count);
+		void Clear();
+
+		// With a pool, large sets are split into ranges that are culled on its threads
+		void Cull(const Frustum& frustum, ThreadPool* pool = nullptr);
+
+		uint32_t GetCount() const { return (uint32_t)m_Radius.size(); }
+		// Box around the bounds added at the index, spheres give the box around them
+		BoundingBox GetBox(uint32_t index) const;
+		const std::vector<uint32_t>& GetVisible() const { return m_Visible; }
+		const Statistics& GetStatistics() const { return m_Statistics; }
+	private:
+		void CullRange(const Frustum& frustum, uint32_t begin, uint32_t end, std::vector<uint32_t>& visible) const;
+	private:
+		// A sphere has zero extents, a box has zero radius
+		std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+		std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+		std::vector<float> m_Radius;
+
+		std::vector<uint32_t> m_Visible;
+		std::vector<std::vector<uint32_t>> m_RangeVisible;		// Per range results of a parallel cull
+		Statistics m_Statistics;
+	};
+}
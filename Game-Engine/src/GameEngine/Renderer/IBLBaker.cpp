@@ -0,0 +1,700 @@
+/*
+	IBL Baker
+
+	Bakes everything image based lighting needs from an equirectangular HDR image on the CPU: the environment
+	cubemap with its mips, the diffuse irradiance map from spherical harmonics, the GGX prefiltered specular map
+	and the split sum BRDF lookup table. The work is spread over a thread pool. Results are cached in a file
+	next to the image keyed by a hash of its contents, so later loads only read and upload.
+	Nothing here touches the renderer, so the output can also be checked without a GPU.
+*/
+
+#include "gepch.h"
+#include "IBLBaker.h"
+
+#include "GameEngine/Core/FileSystem.h"
+#include "GameEngine/Core/ThreadPool.h"
+#include "GameEngine/Renderer/ImageData.h"
+#include "GameEngine/Renderer/VertexFormat.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace ge {
+
+	static constexpr float s_Pi = 3.14159265359f;
+
+	// Runs body(i) for every i below count on the pool and waits for all of them
+	template<typename Body>
+	static void ParallelFor(ThreadPool& pool, uint32_t count, const Body& body)
+	{
+		for (uint32_t i = 0; i < count; i++)
+			pool.Submit([&body, i]() { body(i); });
+		pool.WaitIdle();
+	}
+
+	////// Cubemaps //////
+
+	void CubemapData::Allocate(uint32_t size, uint32_t levels)
+	{
+		Size = size;
+		Levels = levels;
+		Pixels.assign(GetOffset(levels, 0), 0.0f);
+	}
+
+	size_t CubemapData::GetOffset(uint32_t level, uint32_t face) const
+	{
+		size_t offset = 0;
+		for (uint32_t i = 0; i < level; i++)
+			offset += (size_t)6 * GetLevelSize(i) * GetLevelSize(i) * 3;
+		return offset + (size_t)face * GetLevelSize(level) * GetLevelSize(level) * 3;
+	}
+
+	// Face coordinates in [-1, 1], in the orientation OpenGL reads cubemap faces with
+	static glm::vec3 FaceToDirection(uint32_t face, float sc, float tc)
+	{
+		switch (face)
+		{
+			case 0:		return glm::vec3(1.0f, -tc, -sc);
+			case 1:		return glm::vec3(-1.0f, -tc, sc);
+			case 2:		return glm::vec3(sc, 1.0f, tc);
+			case 3:		return glm::vec3(sc, -1.0f, -tc);
+			case 4:		return glm::vec3(sc, -tc, 1.0f);
+			default:	return glm::vec3(-sc, -tc, -1.0f);
+		}
+	}
+
+	// Face and coordinates in [0, 1] of a direction
+	static uint32_t DirectionToFace(const glm::vec3& direction, float& s, float& t)
+	{
+		const glm::vec3 a = glm::abs(direction);
+		uint32_t face;
+		float sc, tc, major;
+		if (a.x >= a.y && a.x >= a.z)
+		{
+			face = direction.x > 0.0f ? 0 : 1;
+			sc = direction.x > 0.0f ? -direction.z : direction.z;
+			tc = -direction.y;
+			major = a.x;
+		}
+		else if (a.y >= a.z)
+		{
+			face = direction.y > 0.0f ? 2 : 3;
+			sc = direction.x;
+			tc = direction.y > 0.0f ? direction.z : -direction.z;
+			major = a.y;
+		}
+		else
+		{
+			face = direction.z > 0.0f ? 4 : 5;
+			sc = direction.z > 0.0f ? direction.x : -direction.x;
+			tc = -direction.y;
+			major = a.z;
+		}
+
+		s = (sc / major + 1.0f) * 0.5f;
+		t = (tc / major + 1.0f) * 0.5f;
+		return face;
+	}
+
+	glm::vec3 CubemapData::GetDirection(uint32_t face, uint32_t x, uint32_t y, uint32_t size)
+	{
+		const float sc = 2.0f * ((float)x + 0.5f) / (float)size - 1.0f;
+		const float tc = 2.0f * ((float)y + 0.5f) / (float)size - 1.0f;
+		return glm::normalize(FaceToDirection(face, sc, tc));
+	}
+
+	// Bilinear inside one face, edges are clamped rather than filtered across faces
+	static glm::vec3 SampleFace(const CubemapData& cubemap, uint32_t level, uint32_t face, float s, float t)
+	{
+		const uint32_t size = cubemap.GetLevelSize(level);
+		const float* pixels = cubemap.GetFace(level, face);
+
+		const float x = glm::clamp(s * size - 0.5f, 0.0f, (float)(size - 1));
+		const float y = glm::clamp(t * size - 0.5f, 0.0f, (float)(size - 1));
+		const uint32_t x0 = (uint32_t)x, y0 = (uint32_t)y;
+		const uint32_t x1 = std::min(x0 + 1, size - 1), y1 = std::min(y0 + 1, size - 1);
+		const float fx = x - (float)x0, fy = y - (float)y0;
+
+		auto fetch = [pixels, size](uint32_t px, uint32_t py)
+		{
+			const float* p = pixels + ((size_t)py * size + px) * 3;
+			return glm::vec3(p[0], p[1], p[2]);
+		};
+
+		return glm::mix(glm::mix(fetch(x0, y0), fetch(x1, y0), fx), glm::mix(fetch(x0, y1), fetch(x1, y1), fx), fy);
+	}
+
+	glm::vec3 CubemapData::Sample(const glm::vec3& direction, float level) const
+	{
+		float s, t;
+		const uint32_t face = DirectionToFace(direction, s, t);
+
+		level = glm::clamp(level, 0.0f, (float)(Levels - 1));
+		const uint32_t level0 = (uint32_t)level;
+		const uint32_t level1 = std::min(level0 + 1, Levels - 1);
+		const glm::vec3 color = SampleFace(*this, level0, face, s, t);
+		if (level1 == level0)
+			return color;
+		return glm::mix(color, SampleFace(*this, level1, face, s, t), level - (float)level0);
+	}
+
+	////// Environment //////
+
+	// Same mapping as EquirectangularToCubemap.glsl, the image is stored bottom row first
+	static glm::vec3 SampleEquirectangular(const ImageData& image, const glm::vec3& direction)
+	{
+		const uint32_t width = image.GetWidth();
+		const uint32_t height = image.GetHeight();
+		const uint32_t channels = image.GetChannels();
+		const float* pixels = (const float*)image.GetData();
+
+		const float u = std::atan2(direction.z, direction.x) / (2.0f * s_Pi) + 0.5f;
+		const float v = std::asin(glm::clamp(direction.y, -1.0f, 1.0f)) / s_Pi + 0.5f;
+		const float x = u * width - 0.5f;
+		const float y = glm::clamp(v * height - 0.5f, 0.0f, (float)(height - 1));
+
+		// Wraps around horizontally, clamps at the poles
+		const float fx = x - std::floor(x);
+		const uint32_t x0 = (uint32_t)(((int64_t)std::floor(x) % width + width) % width);
+		const uint32_t x1 = (x0 + 1) % width;
+		const uint32_t y0 = (uint32_t)y;
+		const uint32_t y1 = std::min(y0 + 1, height - 1);
+		const float fy = y - (float)y0;
+
+		auto fetch = [pixels, width, channels](uint32_t px, uint32_t py)
+		{
+			const float* p = pixels + ((size_t)py * width + px) * channels;
+			return channels >= 3 ? glm::vec3(p[0], p[1], p[2]) : glm::vec3(p[0]);
+		};
+
+		return glm::mix(glm::mix(fetch(x0, y0), fetch(x1, y0), fx), glm::mix(fetch(x0, y1), fetch(x1, y1), fx), fy);
+	}
+
+	static uint32_t GetMipCount(uint32_t size)
+	{
+		uint32_t count = 1;
+		for (; size > 1; size /= 2)
+			count++;
+		return count;
+	}
+
+	static void BakeEnvironment(ThreadPool& pool, const ImageData& image, uint32_t size, CubemapData& environment)
+	{
+		environment.Allocate(size, GetMipCount(size));
+
+		ParallelFor(pool, 6 * size, [&](uint32_t row)
+		{
+			const uint32_t face = row / size, y = row % size;
+			float* pixels = environment.GetFace(0, face) + (size_t)y * size * 3;
+			for (uint32_t x = 0; x < size; x++)
+			{
+				const glm::vec3 color = SampleEquirectangular(image, CubemapData::GetDirection(face, x, y, size));
+				pixels[x * 3 + 0] = color.r;
+				pixels[x * 3 + 1] = color.g;
+				pixels[x * 3 + 2] = color.b;
+			}
+		});
+
+		// 2x2 box filter per face
+		for (uint32_t level = 1; level < environment.Levels; level++)
+		{
+			const uint32_t levelSize = environment.GetLevelSize(level);
+			const uint32_t sourceSize = environment.GetLevelSize(level - 1);
+			ParallelFor(pool, 6 * levelSize, [&](uint32_t row)
+			{
+				const uint32_t face = row / levelSize, y = row % levelSize;
+				const float* source = environment.GetFace(level - 1, face);
+				float* pixels = environment.GetFace(level, face) + (size_t)y * levelSize * 3;
+				const uint32_t y0 = std::min(y * 2, sourceSize - 1), y1 = std::min(y * 2 + 1, sourceSize - 1);
+				for (uint32_t x = 0; x < levelSize; x++)
+				{
+					const uint32_t x0 = std::min(x * 2, sourceSize - 1), x1 = std::min(x * 2 + 1, sourceSize - 1);
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						pixels[x * 3 + c] = 0.25f * (source[((size_t)y0 * sourceSize + x0) * 3 + c] + source[((size_t)y0 * sourceSize + x1) * 3 + c]
+							+ source[((size_t)y1 * sourceSize + x0) * 3 + c] + source[((size_t)y1 * sourceSize + x1) * 3 + c]);
+					}
+				}
+			});
+		}
+	}
+
+	////// Irradiance //////
+
+	static void EvaluateSHBasis(const glm::vec3& d, float basis[9])
+	{
+		basis[0] = 0.282095f;
+		basis[1] = 0.488603f * d.y;
+		basis[2] = 0.488603f * d.z;
+		basis[3] = 0.488603f * d.x;
+		basis[4] = 1.092548f * d.x * d.y;
+		basis[5] = 1.092548f * d.y * d.z;
+		basis[6] = 0.315392f * (3.0f * d.z * d.z - 1.0f);
+		basis[7] = 1.092548f * d.x * d.z;
+		basis[8] = 0.546274f * (d.x * d.x - d.y * d.y);
+	}
+
+	void IBLBaker::ProjectSH(const CubemapData& cubemap, uint32_t level, glm::vec3 sh[9])
+	{
+		for (uint32_t i = 0; i < 9; i++)
+			sh[i] = glm::vec3(0.0f);
+
+		const uint32_t size = cubemap.GetLevelSize(level);
+		float totalWeight = 0.0f;
+		float basis[9];
+		for (uint32_t face = 0; face < 6; face++)
+		{
+			const float* pixels = cubemap.GetFace(level, face);
+			for (uint32_t y = 0; y < size; y++)
+			{
+				for (uint32_t x = 0; x < size; x++)
+				{
+					// Solid angle of the texel, smaller towards the corners of the face
+					const float sc = 2.0f * ((float)x + 0.5f) / (float)size - 1.0f;
+					const float tc = 2.0f * ((float)y + 0.5f) / (float)size - 1.0f;
+					const float weight = 4.0f / ((float)size * size * std::pow(1.0f + sc * sc + tc * tc, 1.5f));
+
+					const float* p = pixels + ((size_t)y * size + x) * 3;
+					const glm::vec3 color(p[0], p[1], p[2]);
+					EvaluateSHBasis(glm::normalize(FaceToDirection(face, sc, tc)), basis);
+					for (uint32_t i = 0; i < 9; i++)
+						sh[i] += color * (basis[i] * weight);
+					totalWeight += weight;
+				}
+			}
+		}
+
+		// The texel solid angles only approximately add up to the sphere
+		for (uint32_t i = 0; i < 9; i++)
+			sh[i] *= 4.0f * s_Pi / totalWeight;
+	}
+
+	// Convolution with the clamped cosine is a per band scale (Ramamoorthi and Hanrahan)
+	glm::vec3 IBLBaker::EvaluateIrradiance(const glm::vec3 sh[9], const glm::vec3& normal)
+	{
+		static const float s_BandScale[9] = { s_Pi, 2.0f * s_Pi / 3.0f, 2.0f * s_Pi / 3.0f, 2.0f * s_Pi / 3.0f,
+			s_Pi / 4.0f, s_Pi / 4.0f, s_Pi / 4.0f, s_Pi / 4.0f, s_Pi / 4.0f };
+
+		float basis[9];
+		EvaluateSHBasis(normal, basis);
+		glm::vec3 irradiance(0.0f);
+		for (uint32_t i = 0; i < 9; i++)
+			irradiance += sh[i] * (s_BandScale[i] * basis[i]);
+		return glm::max(irradiance / s_Pi, glm::vec3(0.0f));
+	}
+
+	////// Specular //////
+
+	static float RadicalInverse(uint32_t bits)
+	{
+		bits = (bits << 16u) | (bits >> 16u);
+		bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+		bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+		bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+		bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+		return (float)bits * 2.3283064365386963e-10f;
+	}
+
+	// Half vector around +Z for the i-th Hammersley point, distributed like the GGX normal distribution
+	static glm::vec3 ImportanceSampleGGX(uint32_t i, uint32_t count, float roughness)
+	{
+		const float a = roughness * roughness;
+		const float phi = 2.0f * s_Pi * (float)i / (float)count;
+		const float v = RadicalInverse(i);
+		const float cosTheta = std::sqrt((1.0f - v) / (1.0f + (a * a - 1.0f) * v));
+		const float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+		return glm::vec3(std::cos(phi) * sinTheta, std::sin(phi) * sinTheta, cosTheta);
+	}
+
+	static float DistributionGGX(float NdotH, float roughness)
+	{
+		const float a = roughness * roughness;
+		const float a2 = a * a;
+		const float denominator = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+		return a2 / (s_Pi * denominator * denominator);
+	}
+
+	// With N = V = R every texel uses the same samples around its normal, so the directions, weights and
+	// source levels are worked out once per roughness and only rotated per texel
+	struct PrefilterSample
+	{
+		glm::vec3 Direction;
+		float Weight;
+		float Level;
+	};
+
+	static std::vector<PrefilterSample> MakePrefilterSamples(float roughness, uint32_t count, const CubemapData& environment)
+	{
+		std::vector<PrefilterSample> samples;
+		samples.reserve(count);
+
+		const float texelSolidAngle = 4.0f * s_Pi / (6.0f * environment.Size * environment.Size);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const glm::vec3 H = ImportanceSampleGGX(i, count, roughness);
+			const glm::vec3 L = 2.0f * H.z * H - glm::vec3(0.0f, 0.0f, 1.0f);
+			if (L.z <= 0.0f)
+				continue;
+
+			// Filtered importance sampling: each sample reads the level whose texels cover its share of the lobe
+			const float pdf = DistributionGGX(H.z, roughness) * 0.25f + 0.0001f;
+			const float sampleSolidAngle = 1.0f / ((float)count * pdf + 0.0001f);
+			const float level = 0.5f * std::log2(sampleSolidAngle / texelSolidAngle);
+			samples.push_back({ L, L.z, glm::clamp(level, 0.0f, (float)(environment.Levels - 1)) });
+		}
+
+		return samples;
+	}
+
+	static void BakePrefilter(ThreadPool& pool, const IBLBakeSettings& settings, const CubemapData& environment, CubemapData& prefilter)
+	{
+		prefilter.Allocate(settings.PrefilterSize, std::min(settings.PrefilterLevels, GetMipCount(settings.PrefilterSize)));
+
+		for (uint32_t level = 0; level < prefilter.Levels; level++)
+		{
+			const uint32_t size = prefilter.GetLevelSize(level);
+			const float roughness = prefilter.Levels > 1 ? (float)level / (float)(prefilter.Levels - 1) : 0.0f;
+			const std::vector<PrefilterSample> samples = roughness > 0.0f ? MakePrefilterSamples(roughness, settings.PrefilterSamples, environment)
+				: std::vector<PrefilterSample>();
+
+			// A mirror only needs the environment at the matching resolution
+			const float mirrorLevel = std::max(std::log2((float)environment.Size / (float)size), 0.0f);
+
+			ParallelFor(pool, 6 * size, [&](uint32_t row)
+			{
+				const uint32_t face = row / size, y = row % size;
+				float* pixels = prefilter.GetFace(level, face) + (size_t)y * size * 3;
+				for (uint32_t x = 0; x < size; x++)
+				{
+					const glm::vec3 N = CubemapData::GetDirection(face, x, y, size);
+					glm::vec3 color(0.0f);
+					if (samples.empty())
+					{
+						color = environment.Sample(N, mirrorLevel);
+					}
+					else
+					{
+						const glm::vec3 up = std::abs(N.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+						const glm::vec3 tangent = glm::normalize(glm::cross(up, N));
+						const glm::vec3 bitangent = glm::cross(N, tangent);
+
+						float totalWeight = 0.0f;
+						for (const PrefilterSample& sample : samples)
+						{
+							const glm::vec3 L = tangent * sample.Direction.x + bitangent * sample.Direction.y + N * sample.Direction.z;
+							color += environment.Sample(L, sample.Level) * sample.Weight;
+							totalWeight += sample.Weight;
+						}
+						color /= totalWeight;
+					}
+
+					pixels[x * 3 + 0] = color.r;
+					pixels[x * 3 + 1] = color.g;
+					pixels[x * 3 + 2] = color.b;
+				}
+			});
+		}
+	}
+
+	////// BRDF //////
+
+	// Half vectors of one roughness as separate arrays. V has no y component, so y is never needed.
+	struct BrdfSamples
+	{
+		std::vector<float> X;
+		std::vector<float> Z;
+	};
+
+	static BrdfSamples MakeBrdfSamples(float roughness, uint32_t count)
+	{
+		BrdfSamples samples;
+		samples.X.resize(count);
+		samples.Z.resize(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const glm::vec3 H = ImportanceSampleGGX(i, count, roughness);
+			samples.X[i] = H.x;
+			samples.Z[i] = H.z;
+		}
+		return samples;
+	}
+
+	// Branch free over plain arrays, so the compiler can run several samples at once in vector registers
+	static glm::vec2 IntegrateBRDFSamples(float NdotV, float roughness, const BrdfSamples& samples)
+	{
+		const float vx = std::sqrt(1.0f - NdotV * NdotV);
+		const float vz = NdotV;
+		// Schlick GGX with k = a^2 / 2 for image based lighting
+		const float k = roughness * roughness * 0.5f;
+		const float geometryV = NdotV / (NdotV * (1.0f - k) + k);
+
+		const uint32_t count = (uint32_t)samples.X.size();
+		const float* hx = samples.X.data();
+		const float* hz = samples.Z.data();
+		float scale = 0.0f, bias = 0.0f;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const float VdotH = std::max(vx * hx[i] + vz * hz[i], 0.0f);
+			const float NdotL = 2.0f * VdotH * hz[i] - vz;
+			const float clampedNdotL = std::max(NdotL, 0.0f);
+
+			const float geometry = geometryV * clampedNdotL / (clampedNdotL * (1.0f - k) + k);
+			const float visibility = geometry * VdotH / (hz[i] * NdotV);
+			const float t = 1.0f - VdotH;
+			const float fresnel = t * t * t * t * t;
+
+			const float mask = NdotL > 0.0f ? 1.0f : 0.0f;
+			scale += mask * (1.0f - fresnel) * visibility;
+			bias += mask * fresnel * visibility;
+		}
+
+		return glm::vec2(scale, bias) / (float)count;
+	}
+
+	glm::vec2 IBLBaker::IntegrateBRDF(float NdotV, float roughness, uint32_t sampleCount)
+	{
+		return IntegrateBRDFSamples(NdotV, roughness, MakeBrdfSamples(roughness, sampleCount));
+	}
+
+	static void BakeBrdfLUT(ThreadPool& pool, const IBLBakeSettings& settings, IBLData& data)
+	{
+		const uint32_t size = settings.BrdfLUTSize;
+		data.BrdfLUTSize = size;
+		data.BrdfLUT.assign((size_t)size * size * 2, 0.0f);
+
+		ParallelFor(pool, size, [&](uint32_t y)
+		{
+			const float roughness = ((float)y + 0.5f) / (float)size;
+			const BrdfSamples samples = MakeBrdfSamples(roughness, settings.BrdfSamples);
+			float* row = data.BrdfLUT.data() + (size_t)y * size * 2;
+			for (uint32_t x = 0; x < size; x++)
+			{
+				const glm::vec2 value = IntegrateBRDFSamples(((float)x + 0.5f) / (float)size, roughness, samples);
+				row[x * 2 + 0] = value.x;
+				row[x * 2 + 1] = value.y;
+			}
+		});
+	}
+
+	////// Bake //////
+
+	bool IBLBaker::Bake(const ImageData& equirectangular, const IBLBakeSettings& settings, IBLData& data)
+	{
+		if (!equirectangular.IsValid() || !equirectangular.IsHDR())
+		{
+			GE_CORE_ERROR("IBL baking needs an HDR image");
+			return false;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		ThreadPool pool(settings.ThreadCount);
+
+		data.SourceWidth = equirectangular.GetWidth();
+		data.SourceHeight = equirectangular.GetHeight();
+		BakeEnvironment(pool, equirectangular, settings.CubemapSize, data.Environment);
+
+		// Nine coefficients only hold low frequencies, a small level projects just as well
+		uint32_t shLevel = 0;
+		while (shLevel + 1 < data.Environment.Levels && data.Environment.GetLevelSize(shLevel) > 64)
+			shLevel++;
+		ProjectSH(data.Environment, shLevel, data.SH);
+
+		const uint32_t irradianceSize = settings.IrradianceSize;
+		data.Irradiance.Allocate(irradianceSize, 1);
+		ParallelFor(pool, 6 * irradianceSize, [&](uint32_t row)
+		{
+			const uint32_t face = row / irradianceSize, y = row % irradianceSize;
+			float* pixels = data.Irradiance.GetFace(0, face) + (size_t)y * irradianceSize * 3;
+			for (uint32_t x = 0; x < irradianceSize; x++)
+			{
+				const glm::vec3 irradiance = EvaluateIrradiance(data.SH, CubemapData::GetDirection(face, x, y, irradianceSize));
+				pixels[x * 3 + 0] = irradiance.r;
+				pixels[x * 3 + 1] = irradiance.g;
+				pixels[x * 3 + 2] = irradiance.b;
+			}
+		});
+
+		BakePrefilter(pool, settings, data.Environment, data.Prefilter);
+		BakeBrdfLUT(pool, settings, data);
+
+		GE_CORE_INFO("Baked IBL maps on {0} threads in {1} ms", pool.GetThreadCount(),
+			std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+		return true;
+	}
+
+	////// Cache //////
+
+	struct IBLCacheHeader
+	{
+		uint32_t Magic = 0;
+		uint32_t Version = 0;
+
+		// Settings the maps were baked with
+		uint32_t CubemapSize = 0;
+		uint32_t IrradianceSize = 0;
+		uint32_t PrefilterSize = 0;
+		uint32_t PrefilterLevels = 0;
+		uint32_t PrefilterSamples = 0;
+		uint32_t BrdfLUTSize = 0;
+		uint32_t BrdfSamples = 0;
+
+		uint32_t SourceWidth = 0;
+		uint32_t SourceHeight = 0;
+		uint32_t Reserved = 0;
+		uint64_t SourceHash = 0;
+
+		float SH[27] = {};
+		uint32_t Padding = 0;
+		// Header followed by the environment, irradiance, prefilter and BRDF pixels as half floats
+		uint64_t FileSize = 0;
+	};
+
+	static_assert(sizeof(IBLCacheHeader) == 176, "IBL cache header layout changed, bump s_IBLCacheVersion!");
+
+	static constexpr uint32_t s_IBLCacheMagic = 0x42494547;		// "GEIB"
+	static constexpr uint32_t s_IBLCacheVersion = 1;
+
+	static bool MatchesSettings(const IBLCacheHeader& header, const IBLBakeSettings& settings)
+	{
+		return header.CubemapSize == settings.CubemapSize && header.IrradianceSize == settings.IrradianceSize
+			&& header.PrefilterSize == settings.PrefilterSize && header.PrefilterLevels == settings.PrefilterLevels
+			&& header.PrefilterSamples == settings.PrefilterSamples && header.BrdfLUTSize == settings.BrdfLUTSize
+			&& header.BrdfSamples == settings.BrdfSamples;
+	}
+
+	bool IBLBaker::WriteCache(const std::string& path, uint64_t sourceHash, const IBLBakeSettings& settings, const IBLData& data)
+	{
+		IBLCacheHeader header;
+		header.Magic = s_IBLCacheMagic;
+		header.Version = s_IBLCacheVersion;
+		header.CubemapSize = settings.CubemapSize;
+		header.IrradianceSize = settings.IrradianceSize;
+		header.PrefilterSize = settings.PrefilterSize;
+		header.PrefilterLevels = settings.PrefilterLevels;
+		header.PrefilterSamples = settings.PrefilterSamples;
+		header.BrdfLUTSize = settings.BrdfLUTSize;
+		header.BrdfSamples = settings.BrdfSamples;
+		header.SourceWidth = data.SourceWidth;
+		header.SourceHeight = data.SourceHeight;
+		header.SourceHash = sourceHash;
+		std::memcpy(header.SH, data.SH, sizeof(header.SH));
+
+		std::vector<uint16_t> halves;
+		halves.reserve(data.Environment.Pixels.size() + data.Irradiance.Pixels.size() + data.Prefilter.Pixels.size() + data.BrdfLUT.size());
+		for (const std::vector<float>* pixels : { &data.Environment.Pixels, &data.Irradiance.Pixels, &data.Prefilter.Pixels, &data.BrdfLUT })
+		{
+			for (float value : *pixels)
+				halves.push_back(VertexFormat::FloatToHalf(value));
+		}
+		header.FileSize = sizeof(IBLCacheHeader) + halves.size() * sizeof(uint16_t);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!out)
+			{
+				GE_CORE_ERROR("Could not open {0} for writing", tempPath);
+				return false;
+			}
+
+			out.write((const char*)&header, sizeof(header));
+			out.write((const char*)halves.data(), (std::streamsize)(halves.size() * sizeof(uint16_t)));
+			if (!out)
+			{
+				GE_CORE_ERROR("Failed writing {0}", tempPath);
+				return false;
+			}
+		}
+
+		// Replaces the old file in one step
+		std::error_code error;
+		std::filesystem::rename(tempPath, path, error);
+		if (error)
+		{
+			GE_CORE_ERROR("Could not replace {0}: {1}", path, error.message());
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool IBLBaker::ReadCache(const std::string& path, uint64_t sourceHash, const IBLBakeSettings& settings, IBLData& data)
+	{
+		std::vector<uint8_t> bytes;
+		if (!FileSystem::ReadFile(path, bytes) || bytes.size() < sizeof(IBLCacheHeader))
+			return false;
+
+		IBLCacheHeader header;
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (header.Magic != s_IBLCacheMagic || header.Version != s_IBLCacheVersion || header.FileSize != bytes.size())
+		{
+			GE_CORE_WARN("{0} is not a valid IBL cache", path);
+			return false;
+		}
+
+		if (header.SourceHash != sourceHash || !MatchesSettings(header, settings))
+			return false;
+
+		data.SourceWidth = header.SourceWidth;
+		data.SourceHeight = header.SourceHeight;
+		std::memcpy(data.SH, header.SH, sizeof(header.SH));
+		data.Environment.Allocate(settings.CubemapSize, GetMipCount(settings.CubemapSize));
+		data.Irradiance.Allocate(settings.IrradianceSize, 1);
+		data.Prefilter.Allocate(settings.PrefilterSize, std::min(settings.PrefilterLevels, GetMipCount(settings.PrefilterSize)));
+		data.BrdfLUTSize = settings.BrdfLUTSize;
+		data.BrdfLUT.assign((size_t)settings.BrdfLUTSize * settings.BrdfLUTSize * 2, 0.0f);
+
+		const size_t halfCount = data.Environment.Pixels.size() + data.Irradiance.Pixels.size() + data.Prefilter.Pixels.size() + data.BrdfLUT.size();
+		if (sizeof(IBLCacheHeader) + halfCount * sizeof(uint16_t) != bytes.size())
+		{
+			GE_CORE_WARN("{0} does not hold the maps its header describes", path);
+			return false;
+		}
+
+		const uint16_t* halves = (const uint16_t*)(bytes.data() + sizeof(IBLCacheHeader));
+		for (std::vector<float>* pixels : { &data.Environment.Pixels, &data.Irradiance.Pixels, &data.Prefilter.Pixels, &data.BrdfLUT })
+		{
+			for (float& value : *pixels)
+				value = VertexFormat::HalfToFloat(*halves++);
+		}
+
+		return true;
+	}
+
+	bool IBLBaker::LoadOrBake(const std::string& path, const IBLBakeSettings& settings, IBLData& data)
+	{
+		std::vector<uint8_t> bytes;
+		if (!FileSystem::ReadFile(path, bytes))
+		{
+			GE_CORE_ERROR("Could not read {0}", path);
+			return false;
+		}
+
+		const uint64_t sourceHash = FileSystem::Hash(bytes.data(), bytes.size());
+		const std::string cachePath = GetCachePath(path);
+		if (ReadCache(cachePath, sourceHash, settings, data))
+		{
+			GE_CORE_INFO("{0} loaded", cachePath);
+			return true;
+		}
+
+		ImageData image;
+		if (!ImageData::LoadHDR(path, image, true))
+		{
+			GE_CORE_ERROR("Failed to load HDR image {0}", path);
+			return false;
+		}
+
+		if (!Bake(image, settings, data))
+			return false;
+
+		// A failed write only costs the next load another bake
+		if (!WriteCache(cachePath, sourceHash, settings, data))
+			GE_CORE_WARN("IBL maps of {0} were not cached", path);
+		return true;
+	}
+}
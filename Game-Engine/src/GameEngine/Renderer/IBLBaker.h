@@ -0,0 +1,95 @@
+/*
+	IBL Baker
+
+	Bakes everything image based lighting needs from an equirectangular HDR image on the CPU: the environment
+	cubemap with its mips, the diffuse irradiance map from spherical harmonics, the GGX prefiltered specular map
+	and the split sum BRDF lookup table. The work is spread over a thread pool. Results are cached in a file
+	next to the image keyed by a hash of its contents, so later loads only read and upload.
+	Nothing here touches the renderer, so the output can also be checked without a GPU.
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Core.h"
+
+#include <glm/glm.hpp>
+
+namespace ge {
+
+	class ImageData;
+
+	// Defaults match what the PBR shaders sample (MAX_REFLECTION_LOD 4 is five prefilter levels)
+	struct IBLBakeSettings
+	{
+		uint32_t CubemapSize = 512;
+		uint32_t IrradianceSize = 32;
+		uint32_t PrefilterSize = 128;
+		uint32_t PrefilterLevels = 5;		// Roughness 0 to 1 over the levels
+		uint32_t PrefilterSamples = 1024;	// GGX samples per texel
+		uint32_t BrdfLUTSize = 512;
+		uint32_t BrdfSamples = 1024;
+		uint32_t ThreadCount = 0;			// 0 uses every core but one
+	};
+
+	// Cubemap faces in the OpenGL order (+X, -X, +Y, -Y, +Z, -Z), rows of RGB floats.
+	// Level after level, each level holds its six faces.
+	struct CubemapData
+	{
+		uint32_t Size = 0;
+		uint32_t Levels = 0;
+		std::vector<float> Pixels;
+
+		void Allocate(uint32_t size, uint32_t levels);
+		uint32_t GetLevelSize(uint32_t level) const { return std::max(Size >> level, 1u); }
+		// Index of the first float of a face
+		size_t GetOffset(uint32_t level, uint32_t face) const;
+		float* GetFace(uint32_t level, uint32_t face) { return Pixels.data() + GetOffset(level, face); }
+		const float* GetFace(uint32_t level, uint32_t face) const { return Pixels.data() + GetOffset(level, face); }
+
+		// Bilinear within the face, linear between levels
+		glm::vec3 Sample(const glm::vec3& direction, float level) const;
+
+		// Direction through the centre of a texel
+		static glm::vec3 GetDirection(uint32_t face, uint32_t x, uint32_t y, uint32_t size);
+	};
+
+	struct IBLData
+	{
+		uint32_t SourceWidth = 0;
+		uint32_t SourceHeight = 0;
+
+		CubemapData Environment;
+		// Irradiance divided by pi, what the shaders multiply by the albedo
+		CubemapData Irradiance;
+		CubemapData Prefilter;
+		// Rows of (scale, bias) to the Fresnel term, NdotV along a row and roughness down the rows
+		uint32_t BrdfLUTSize = 0;
+		std::vector<float> BrdfLUT;
+
+		// Radiance projected on the first nine spherical harmonics, the irradiance map is built from these
+		glm::vec3 SH[9];
+	};
+
+	class IBLBaker
+	{
+	public:
+		// The image is an equirectangular HDR, loaded flipped the way HDREnvironmentMap loads it
+		static bool Bake(const ImageData& equirectangular, const IBLBakeSettings& settings, IBLData& data);
+
+		// Reads the cache next to the image when it was baked from the same contents with the same settings,
+		// otherwise bakes and writes it
+		static bool LoadOrBake(const std::string& path, const IBLBakeSettings& settings, IBLData& data);
+		static std::string GetCachePath(const std::string& path) { return path + ".geibl"; }
+
+		// Cache file, stored as half floats like the textures it ends up in
+		static bool WriteCache(const std::string& path, uint64_t sourceHash, const IBLBakeSettings& settings, const IBLData& data);
+		static bool ReadCache(const std::string& path, uint64_t sourceHash, const IBLBakeSettings& settings, IBLData& data);
+
+		// The pieces of the bake, exposed for checking the output
+		static void ProjectSH(const CubemapData& cubemap, uint32_t level, glm::vec3 sh[9]);
+		// Cosine weighted irradiance in a direction, divided by pi
+		static glm::vec3 EvaluateIrradiance(const glm::vec3 sh[9], const glm::vec3& normal);
+		// Split sum scale and bias for one NdotV and roughness
+		static glm::vec2 IntegrateBRDF(float NdotV, float roughness, uint32_t sampleCount);
+	};
+}
@@ -0,0 +1,141 @@
+/*
+	Image Data
+
+	Image decoded into system memory, ready to be uploaded to a texture. Decoding touches no renderer
+	state, so it can run on any thread. Channels are 8 bit, or 32 bit floats for HDR images.
+*/
+
+#include "gepch.h"
+#include "ImageData.h"
+
+#include "stb_image.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace ge {
+
+	ImageData::~ImageData()
+	{
+		Release();
+	}
+
+	ImageData::ImageData(ImageData&& other) noexcept
+		: m_Data(other.m_Data), m_Width(other.m_Width), m_Height(other.m_Height), m_Channels(other.m_Channels), m_HDR(other.m_HDR)
+	{
+		other.m_Data = nullptr;
+	}
+
+	ImageData& ImageData::operator=(ImageData&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Release();
+			m_Data = other.m_Data;
+			m_Width = other.m_Width;
+			m_Height = other.m_Height;
+			m_Channels = other.m_Channels;
+			m_HDR = other.m_HDR;
+			other.m_Data = nullptr;
+		}
+		return *this;
+	}
+
+	bool ImageData::Load(const std::string& path, ImageData& image, bool flipVertically)
+	{
+		int width, height, channels;
+		stbi_uc* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+		if (!data)
+			return false;
+
+		image.Release();
+		image.m_Data = data;
+		image.m_Width = (uint32_t)width;
+		image.m_Height = (uint32_t)height;
+		image.m_Channels = (uint32_t)channels;
+		image.m_HDR = false;
+		if (flipVertically)
+			image.FlipVertically();
+		return true;
+	}
+
+	bool ImageData::LoadHDR(const std::string& path, ImageData& image, bool flipVertically)
+	{
+		int width, height, channels;
+		float* data = stbi_loadf(path.c_str(), &width, &height, &channels, 0);
+		if (!data)
+			return false;
+
+		image.Release();
+		image.m_Data = data;
+		image.m_Width = (uint32_t)width;
+		image.m_Height = (uint32_t)height;
+		image.m_Channels = (uint32_t)channels;
+		image.m_HDR = true;
+		if (flipVertically)
+			image.FlipVertically();
+		return true;
+	}
+
+	bool ImageData::LoadFromMemory(const void* fileData, size_t fileSize, ImageData& image, bool flipVertically)
+	{
+		int width, height, channels;
+		stbi_uc* data = stbi_load_from_memory((const stbi_uc*)fileData, (int)fileSize, &width, &height, &channels, 0);
+		if (!data)
+			return false;
+
+		image.Release();
+		image.m_Data = data;
+		image.m_Width = (uint32_t)width;
+		image.m_Height = (uint32_t)height;
+		image.m_Channels = (uint32_t)channels;
+		image.m_HDR = false;
+		if (flipVertically)
+			image.FlipVertically();
+		return true;
+	}
+
+	ImageData ImageData::Fill(uint32_t width, uint32_t height, uint32_t channels, bool hdr, const float* value)
+	{
+		ImageData image;
+		image.m_Width = width;
+		image.m_Height = height;
+		image.m_Channels = channels;
+		image.m_HDR = hdr;
+		// stbi_image_free is a plain free, so this memory is released the same way as a decoded image
+		image.m_Data = std::malloc(image.GetSize());
+
+		const size_t pixelCount = (size_t)width * height;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			for (uint32_t c = 0; c < channels; c++)
+			{
+				if (hdr)
+					((float*)image.m_Data)[i * channels + c] = value[c];
+				else
+					((uint8_t*)image.m_Data)[i * channels + c] = (uint8_t)(std::min(std::max(value[c], 0.0f), 1.0f) * 255.0f + 0.5f);
+			}
+		}
+		return image;
+	}
+
+	void ImageData::Release()
+	{
+		if (m_Data)
+			stbi_image_free(m_Data);
+		m_Data = nullptr;
+	}
+
+	void ImageData::FlipVertically()
+	{
+		const size_t rowSize = GetSize() / m_Height;
+		std::vector<uint8_t> row(rowSize);
+		uint8_t* pixels = (uint8_t*)m_Data;
+		for (uint32_t top = 0, bottom = m_Height - 1; top < bottom; top++, bottom--)
+		{
+			std::memcpy(row.data(), pixels + top * rowSize, rowSize);
+			std::memcpy(pixels + top * rowSize, pixels + bottom * rowSize, rowSize);
+			std::memcpy(pixels + bottom * rowSize, row.data(), rowSize);
+		}
+	}
+}
@@ -0,0 +1,53 @@
+/*
+	Image Data
+
+	Image decoded into system memory, ready to be uploaded to a texture. Decoding touches no renderer
+	state, so it can run on any thread. Channels are 8 bit, or 32 bit floats for HDR images.
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Core.h"
+
+namespace ge {
+
+	class ImageData
+	{
+	public:
+		ImageData() = default;
+		~ImageData();
+
+		ImageData(ImageData&& other) noexcept;
+		ImageData& operator=(ImageData&& other) noexcept;
+		ImageData(const ImageData&) = delete;
+		ImageData& operator=(const ImageData&) = delete;
+
+		// Decodes the file with the channels it has. The image is flipped here rather than through the decoder's
+		// global flip setting, which would race with decodes on other threads.
+		static bool Load(const std::string& path, ImageData& image, bool flipVertically = false);
+		static bool LoadHDR(const std::string& path, ImageData& image, bool flipVertically = true);
+		// Decodes a file that is already in memory
+		static bool LoadFromMemory(const void* fileData, size_t fileSize, ImageData& image, bool flipVertically = false);
+
+		// Image with every pixel set to the given channel values (floats when hdr)
+		static ImageData Fill(uint32_t width, uint32_t height, uint32_t channels, bool hdr, const float* value);
+
+		bool IsValid() const { return m_Data != nullptr; }
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		uint32_t GetChannels() const { return m_Channels; }
+		bool IsHDR() const { return m_HDR; }
+
+		const void* GetData() const { return m_Data; }
+		size_t GetSize() const { return (size_t)m_Width * m_Height * m_Channels * (m_HDR ? sizeof(float) : 1); }
+	private:
+		void Release();
+		void FlipVertically();
+
+		void* m_Data = nullptr;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint32_t m_Channels = 0;
+		bool m_HDR = false;
+	};
+}
@@ -0,0 +1,129 @@
+/*
+	Material
+
+	A shader plus the values of its uniforms. Parameters are stored in one pre-baked block
+	and uploaded through the abstract Shader interface, so drawing a material needs no casts
+	to the API specific shader class.
+*/
+
+#include "gepch.h"
+#include "Material.h"
+
+#include <cstring>
+
+namespace ge {
+
+	static uint16_t s_NextMaterialSortKey = 0;
+
+	Material::Material(const Ref<Shader>& shader)
+		: m_Shader(shader), m_SortKey(s_NextMaterialSortKey++)
+	{
+		GE_CORE_ASSERT(shader, "Material needs a shader!");
+	}
+
+	Ref<Material> Material::Create(const Ref<Shader>& shader)
+	{
+		return std::make_shared<Material>(shader);
+	}
+
+	void Material::SetParameter(const UniformID& id, ParameterType type, const void* data, uint32_t size)
+	{
+		for (const Parameter& parameter : m_Parameters)
+		{
+			if (parameter.ID.Hash == id.Hash)
+			{
+				GE_CORE_ASSERT(parameter.Type == type, "Material parameter set with a different type!");
+				std::memcpy(&m_ParameterData[parameter.Offset], data, size);
+				return;
+			}
+		}
+
+		const uint32_t offset = (uint32_t)m_ParameterData.size();
+		m_ParameterData.resize(offset + size);
+		std::memcpy(&m_ParameterData[offset], data, size);
+		m_Parameters.push_back({ id, type, offset });
+	}
+
+	void Material::SetInt(const UniformID& id, int value)
+	{
+		SetParameter(id, ParameterType::Int, &value, sizeof(int));
+	}
+
+	void Material::SetFloat(const UniformID& id, float value)
+	{
+		SetParameter(id, ParameterType::Float, &value, sizeof(float));
+	}
+
+	void Material::SetFloat2(const UniformID& id, const glm::vec2& value)
+	{
+		SetParameter(id, ParameterType::Float2, &value, sizeof(glm::vec2));
+	}
+
+	void Material::SetFloat3(const UniformID& id, const glm::vec3& value)
+	{
+		SetParameter(id, ParameterType::Float3, &value, sizeof(glm::vec3));
+	}
+
+	void Material::SetFloat4(const UniformID& id, const glm::vec4& value)
+	{
+		SetParameter(id, ParameterType::Float4, &value, sizeof(glm::vec4));
+	}
+
+	void Material::SetMat3(const UniformID& id, const glm::mat3& value)
+	{
+		SetParameter(id, ParameterType::Mat3, &value, sizeof(glm::mat3));
+	}
+
+	void Material::SetMat4(const UniformID& id, const glm::mat4& value)
+	{
+		SetParameter(id, ParameterType::Mat4, &value, sizeof(glm::mat4));
+	}
+
+	void Material::SetTexture(const UniformID& id, const Ref<Texture>& texture, uint32_t slot)
+	{
+		for (TextureSlot& textureSlot : m_Textures)
+		{
+			if (textureSlot.ID.Hash == id.Hash)
+			{
+				textureSlot.TexturePtr = texture;
+				textureSlot.Slot = slot;
+				return;
+			}
+		}
+
+		m_Textures.push_back({ id, texture, slot });
+	}
+
+	void Material::Bind() const
+	{
+		m_Shader->Bind();
+		Upload();
+	}
+
+	void Material::Upload() const
+	{
+		Shader* shader = m_Shader.get();
+		const uint8_t* data = m_ParameterData.data();
+
+		for (const Parameter& parameter : m_Parameters)
+		{
+			const void* value = data + parameter.Offset;
+			switch (parameter.Type)
+			{
+				case ParameterType::Int:	shader->SetInt(parameter.ID, *(const int*)value); break;
+				case ParameterType::Float:	shader->SetFloat(parameter.ID, *(const float*)value); break;
+				case ParameterType::Float2:	shader->SetFloat2(parameter.ID, *(const glm::vec2*)value); break;
+				case ParameterType::Float3:	shader->SetFloat3(parameter.ID, *(const glm::vec3*)value); break;
+				case ParameterType::Float4:	shader->SetFloat4(parameter.ID, *(const glm::vec4*)value); break;
+				case ParameterType::Mat3:	shader->SetMat3(parameter.ID, *(const glm::mat3*)value); break;
+				case ParameterType::Mat4:	shader->SetMat4(parameter.ID, *(const glm::mat4*)value); break;
+			}
+		}
+
+		for (const TextureSlot& textureSlot : m_Textures)
+		{
+			textureSlot.TexturePtr->Bind(textureSlot.Slot);
+			shader->SetInt(textureSlot.ID, (int)textureSlot.Slot);
+		}
+	}
+}
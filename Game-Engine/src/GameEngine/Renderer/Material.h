@@ -0,0 +1,75 @@
+/*
+	Material
+
+	A shader plus the values of its uniforms. Parameters are stored in one pre-baked block
+	and uploaded through the abstract Shader interface, so drawing a material needs no casts
+	to the API specific shader class.
+*/
+
+#pragma once
+
+#include "Shader.h"
+#include "Texture.h"
+
+#include <glm/glm.hpp>
+
+namespace ge {
+
+	class Material
+	{
+	public:
+		Material(const Ref<Shader>& shader);
+
+		// Setting a parameter that already exists overwrites its value in place
+		void SetInt(const UniformID& id, int value);
+		void SetFloat(const UniformID& id, float value);
+		void SetFloat2(const UniformID& id, const glm::vec2& value);
+		void SetFloat3(const UniformID& id, const glm::vec3& value);
+		void SetFloat4(const UniformID& id, const glm::vec4& value);
+		void SetMat3(const UniformID& id, const glm::mat3& value);
+		void SetMat4(const UniformID& id, const glm::mat4& value);
+
+		// Binds the texture to the slot and points the sampler uniform at it
+		void SetTexture(const UniformID& id, const Ref<Texture>& texture, uint32_t slot = 0);
+
+		// Binds the shader and uploads every parameter
+		void Bind() const;
+		// Uploads every parameter to the shader, which has to be bound already
+		void Upload() const;
+
+		const Ref<Shader>& GetShader() const { return m_Shader; }
+
+		// Small id in creation order, used for the material bits of the render queue sort key
+		uint16_t GetSortKey() const { return m_SortKey; }
+
+		static Ref<Material> Create(const Ref<Shader>& shader);
+	private:
+		enum class ParameterType : uint8_t
+		{
+			Int, Float, Float2, Float3, Float4, Mat3, Mat4
+		};
+
+		struct Parameter
+		{
+			UniformID ID;
+			ParameterType Type;
+			uint32_t Offset;		// Into m_ParameterData
+		};
+
+		struct TextureSlot
+		{
+			UniformID ID;
+			Ref<Texture> TexturePtr;
+			uint32_t Slot;
+		};
+
+		void SetParameter(const UniformID& id, ParameterType type, const void* data, uint32_t size);
+	private:
+		Ref<Shader> m_Shader;
+		uint16_t m_SortKey;
+
+		std::vector<Parameter> m_Parameters;
+		std::vector<uint8_t> m_ParameterData;
+		std::vector<TextureSlot> m_Textures;
+	};
+}
@@ -9,22 +9,94 @@
 #include "GameEngine/Core/Log.h"
 
 #include <glm/glm.hpp>
-
-// Fix this
-#include "Platform/OpenGL/OpenGLShader.h"
+#include <chrono>
 
 #include "GameEngine/Renderer/RenderCommand.h"
 
 namespace ge {
 
-	Mesh::Mesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices, std::vector<Ref<Texture3D>> textures)
+	BufferLayout MeshVertex::GetLayout()
 	{
-		m_Vertices = vertices;
-		m_Indices = indices;
-		m_Textures = textures;
+		return {
+			{ ge::ShaderDataType::Float3, "a_Position" },
+			{ ge::ShaderDataType::Float3, "a_Normal" },
+			{ ge::ShaderDataType::Float2, "a_TexCoords" },
+			{ ge::ShaderDataType::Float3, "a_Tangent" },
+			{ ge::ShaderDataType::Float3, "a_Bitangent" }
+		};
+	}
 
+	MeshMaterial::MeshMaterial(std::vector<MeshTexture>&& textures)
+		: m_Textures(std::move(textures))
+	{
+		// the shaders follow the sampler names of the materials: texture_diffuseN, texture_specularN, texture_normalN
+		// and texture_heightN where N counts the textures of that type from 1
+		m_Samplers.reserve(m_Textures.size());
+		for (uint32_t i = 0; i < m_Textures.size(); i++)
+		{
+			const std::string& type = m_Textures[i].Type;
+			uint32_t number = 1;
+			for (uint32_t j = 0; j < i; j++)
+			{
+				if (m_Textures[j].Type == type)
+					number++;
+			}
+			m_Samplers.emplace_back(type + std::to_string(number));
+		}
+	}
+
+	void MeshMaterial::Bind(const std::shared_ptr<Shader>& shader) const
+	{
+		for (uint32_t i = 0; i < m_Textures.size(); i++)
+		{
+			shader->SetInt(m_Samplers[i], (int)i);
+			m_Textures[i].Texture->Bind(i);
+		}
+	}
+
+	bool MeshMaterial::operator==(const MeshMaterial& other) const
+	{
+		if (m_Textures.size() != other.m_Textures.size())
+			return false;
+
+		for (size_t i = 0; i < m_Textures.size(); i++)
+		{
+			if (m_Textures[i].Texture != other.m_Textures[i].Texture || m_Textures[i].Type != other.m_Textures[i].Type)
+				return false;
+		}
+		return true;
+	}
+
+	Mesh::Mesh(std::vector<MeshVertex>&& vertices, std::vector<unsigned int>&& indices, std::vector<MeshTexture>&& textures,
+		bool retainCPUData, MeshVertexFormat format)
+		: m_Vertices(std::move(vertices)), m_Indices(std::move(indices)), m_Material(std::move(textures)), m_VertexFormat(format)
+	{
 		// now that we have all the required data, set the vertex buffers and its attribute pointers.
 		SetupMesh();
+
+		// The GPU has its own copy now, swapping with empty vectors gives the memory back
+		if (!retainCPUData)
+		{
+			std::vector<MeshVertex>().swap(m_Vertices);
+			std::vector<unsigned int>().swap(m_Indices);
+		}
+	}
+
+	Mesh::Mesh(const void* vertexData, uint32_t vertexCount, const unsigned int* indices, uint32_t indexCount,
+		std::vector<MeshTexture>&& textures, MeshVertexFormat format, const glm::vec3& boundsMin, const glm::vec3& boundsExtent)
+		: m_Material(std::move(textures)), m_VertexCount(vertexCount), m_IndexCount(indexCount), m_VertexFormat(format)
+	{
+		m_AABBMin = boundsMin;
+		m_AABBMax = boundsMin + boundsExtent;
+		if (format == MeshVertexFormat::PackedQuantized)
+		{
+			m_BoundsMin = boundsMin;
+			m_BoundsExtent = boundsExtent;
+		}
+
+		auto uploadStart = std::chrono::steady_clock::now();
+		Upload(vertexData, indices);
+		m_UploadTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
 	}
 
 	Mesh::~Mesh()
@@ -37,57 +109,78 @@ namespace ge {
 	void Mesh::Draw(const std::shared_ptr<Shader>& shader)
 	{
 		// bind appropriate textures
-		/*unsigned int diffuseNr = 1;
-		unsigned int specularNr = 1;
-		unsigned int normalNr = 1;
-		unsigned int heightNr = 1;
-		for (uint32_t i = 0; i < m_Textures.size(); i++)
+		m_Material.Bind(shader);
+		// packed shaders place the position inside the bounds, they stay 0 and 1 when positions are not quantized
+		if (m_VertexFormat != MeshVertexFormat::Full)
 		{
-			// retrieve texture number (the N in diffuse_textureN)
-			std::string number;
-			std::string name = m_Textures[i]->GetType();
-			if (name == "texture_diffuse")
-				number = std::to_string(diffuseNr++);
-			else if (name == "texture_specular")
-				number = std::to_string(specularNr++);
-			else if (name == "texture_normal")
-				number = std::to_string(normalNr++);
-			else if (name == "texture_height")
-				number = std::to_string(heightNr++);
-			GE_CORE_INFO("{0}, {1}, {2}, {3}", diffuseNr, specularNr, normalNr, heightNr);
-			// now set the sampler to the correct texture unit
-			std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformInt((name + number).c_str(), i);
-			// and finally bind the texture
-			m_Textures[i]->Bind(i);
-		}*/
+			static const UniformID s_BoundsMinID("u_BoundsMin");
+			static const UniformID s_BoundsExtentID("u_BoundsExtent");
+			shader->SetFloat3(s_BoundsMinID, m_BoundsMin);
+			shader->SetFloat3(s_BoundsExtentID, m_BoundsExtent);
+		}
+
 		// draw mesh
-		m_VertexArray->Bind();
-		RenderCommand::DrawIndexed(m_Indices);	
+		RenderCommand::DrawIndexedRange(m_VertexArray, m_IndexCount);
+	}
+
+
+	size_t Mesh::GetCPUMemory() const
+	{
+		return m_Vertices.capacity() * sizeof(MeshVertex) + m_Indices.capacity() * sizeof(unsigned int);
 	}
 
+	size_t Mesh::GetGPUMemory() const
+	{
+		return (size_t)m_VertexCount * VertexFormat::GetStride(m_VertexFormat) + (size_t)m_IndexCount * sizeof(unsigned int);
+	}
 
 	void Mesh::SetupMesh()
+	{
+		// Convert the vertices to the upload format, the full format is uploaded straight from the vector
+		auto packStart = std::chrono::steady_clock::now();
+		m_VertexCount = (uint32_t)m_Vertices.size();
+
+		glm::vec3 boundsExtent;
+		VertexFormat::ComputeBounds(m_Vertices.data(), m_VertexCount, m_AABBMin, boundsExtent);
+		m_AABBMax = m_AABBMin + boundsExtent;
+
+		std::vector<uint8_t> packed;
+		void* vertexData = m_Vertices.data();
+		if (m_VertexFormat != MeshVertexFormat::Full)
+		{
+			if (m_VertexFormat == MeshVertexFormat::PackedQuantized)
+			{
+				m_BoundsMin = m_AABBMin;
+				m_BoundsExtent = boundsExtent;
+			}
+			VertexFormat::Pack(m_Vertices.data(), m_VertexCount, m_VertexFormat, m_BoundsMin, m_BoundsExtent, packed);
+			vertexData = packed.data();
+		}
+		auto uploadStart = std::chrono::steady_clock::now();
+		m_PackTime = std::chrono::duration<float, std::milli>(uploadStart - packStart).count();
+
+		m_IndexCount = (uint32_t)m_Indices.size();
+		Upload(vertexData, m_Indices.data());
+
+		m_UploadTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+	}
+
+	void Mesh::Upload(const void* vertexData, const unsigned int* indices)
 	{
 		// create vertex array
 		m_VertexArray.reset(ge::VertexArray::Create());
 
 		// Create a vertex buffer for the object
-		m_VertexBuffer.reset(ge::VertexBuffer::Create(&m_Vertices[0], m_Vertices.size() * sizeof(MeshVertex)));
+		m_VertexBuffer.reset(ge::VertexBuffer::Create((void*)vertexData, m_VertexCount * VertexFormat::GetStride(m_VertexFormat)));
 
 		// Set the layout of the buffer
-		m_VertexBuffer->SetLayout({
-			{ ge::ShaderDataType::Float3, "a_Position" },
-			{ ge::ShaderDataType::Float3, "a_Normal" },
-			{ ge::ShaderDataType::Float2, "a_TexCoords" },
-			{ ge::ShaderDataType::Float3, "a_Tangent" },
-			{ ge::ShaderDataType::Float3, "a_Bitangent" }
-		});
+		m_VertexBuffer->SetLayout(VertexFormat::GetLayout(m_VertexFormat));
 
 		// Add the vertex buffer to the vertex array
 		m_VertexArray->AddVertexBuffer(m_VertexBuffer);
 
 		// Add index buffer to vertex array
-		m_IndexBuffer.reset(ge::IndexBuffer::Create(m_Indices.data(), m_Indices.size()));
+		m_IndexBuffer.reset(ge::IndexBuffer::Create((void*)indices, m_IndexCount));
 		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
 	}
 
@@ -10,6 +10,7 @@
 #include <GameEngine/Renderer/VertexArray.h>
 #include <GameEngine/Renderer/Shader.h>
 #include <GameEngine/Renderer/Texture.h>
+#include <GameEngine/Renderer/VertexFormat.h>
 
 #include <GameEngine/Core/Core.h>
 
@@ -33,22 +34,98 @@ namespace ge {
 		glm::vec3 Tangent;
 		// bitangent
 		glm::vec3 Bitangent;
+
+		static BufferLayout GetLayout();
+	};
+
+	// A material texture and the sampler it is bound to. The textures come from the TextureCache and are shared
+	// between meshes and models, so the same image can be the diffuse map of one material and the specular map of another.
+	struct MeshTexture
+	{
+		Ref<Texture3D> Texture;
+		std::string Type;		// texture_diffuse, texture_specular, texture_normal or texture_height
+	};
+
+	// The material textures of a mesh, or of the meshes of a packed model that share them
+	class MeshMaterial
+	{
+	public:
+		MeshMaterial() = default;
+		explicit MeshMaterial(std::vector<MeshTexture>&& textures);
+
+		// Binds the textures to the samplers named after their type, texture_diffuse1, texture_diffuse2, ...
+		void Bind(const std::shared_ptr<Shader>& shader) const;
+
+		const std::vector<MeshTexture>& GetTextures() const { return m_Textures; }
+
+		// The same textures in the same samplers
+		bool operator==(const MeshMaterial& other) const;
+		bool operator!=(const MeshMaterial& other) const { return !(*this == other); }
+	private:
+		std::vector<MeshTexture> m_Textures;
+		// Sampler of each texture, worked out once instead of building the names every draw
+		std::vector<UniformID> m_Samplers;
 	};
 
 	class Mesh {
 	public: 
 		/* Functions */
-		// Constructor
-		Mesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices, std::vector<Ref<Texture3D>> textures);
+		// Constructor, takes over the vectors. The vertices and indices are freed once they are on the GPU
+		// unless retainCPUData is set (for picking, physics or anything else that reads them back).
+		// The vertices are uploaded in the given format, the CPU copy always stays a MeshVertex.
+		Mesh(std::vector<MeshVertex>&& vertices, std::vector<unsigned int>&& indices, std::vector<MeshTexture>&& textures,
+			bool retainCPUData = false, MeshVertexFormat format = MeshVertexFormat::Full);
+		// Creates the mesh from vertices already in the upload format (a cooked mesh), the data is only read during
+		// the upload and nothing is kept on the CPU. The bounds are the ones the positions were quantized against.
+		Mesh(const void* vertexData, uint32_t vertexCount, const unsigned int* indices, uint32_t indexCount,
+			std::vector<MeshTexture>&& textures, MeshVertexFormat format, const glm::vec3& boundsMin, const glm::vec3& boundsExtent);
 		~Mesh();
 
-		// render the mesh
+		// Move only, a copy would share the GPU buffers anyway
+		Mesh(Mesh&&) = default;
+		Mesh& operator=(Mesh&&) = default;
+		Mesh(const Mesh&) = delete;
+		Mesh& operator=(const Mesh&) = delete;
+
+		// render the mesh with its material
 		void Draw(const std::shared_ptr<Shader>& shader);
+
+		uint32_t GetVertexCount() const { return m_VertexCount; }
+		MeshVertexFormat GetVertexFormat() const { return m_VertexFormat; }
+		uint32_t GetIndexCount() const { return m_IndexCount; }
+		const std::vector<MeshTexture>& GetTextures() const { return m_Material.GetTextures(); }
+
+		// Object space bounds of the positions, whatever the vertex format
+		const glm::vec3& GetAABBMin() const { return m_AABBMin; }
+		const glm::vec3& GetAABBMax() const { return m_AABBMax; }
+
+		// Only available when the mesh was created with retainCPUData
+		bool HasCPUData() const { return !m_Vertices.empty(); }
+		const std::vector<MeshVertex>& GetVertices() const { return m_Vertices; }
+		const std::vector<unsigned int>& GetIndices() const { return m_Indices; }
+
+		// Bytes held in system memory by the vertex and index copies, and in the GPU buffers
+		size_t GetCPUMemory() const;
+		size_t GetGPUMemory() const;
+
+		// Time spent converting the vertices to the upload format and creating the buffers, in milliseconds
+		float GetPackTime() const { return m_PackTime; }
+		float GetUploadTime() const { return m_UploadTime; }
 	private:
 		/* Mesh Data */
 		std::vector<MeshVertex> m_Vertices;
 		std::vector<unsigned int> m_Indices;
-		std::vector<Ref<Texture3D>> m_Textures;
+		MeshMaterial m_Material;
+		uint32_t m_VertexCount = 0;
+		uint32_t m_IndexCount = 0;
+
+		MeshVertexFormat m_VertexFormat;
+		glm::vec3 m_BoundsMin = glm::vec3(0.0f);
+		glm::vec3 m_BoundsExtent = glm::vec3(1.0f);
+		glm::vec3 m_AABBMin = glm::vec3(0.0f);
+		glm::vec3 m_AABBMax = glm::vec3(0.0f);
+		float m_PackTime = 0.0f;
+		float m_UploadTime = 0.0f;
 
 		Ref<VertexArray> m_VertexArray;
 		Ref<VertexBuffer> m_VertexBuffer;
@@ -56,6 +133,8 @@ namespace ge {
 
 		// initializes all the buffer objects/arrays
 		void SetupMesh();
+		// creates the vertex array and buffers from data in the upload format
+		void Upload(const void* vertexData, const unsigned int* indices);
 	};
 
 }
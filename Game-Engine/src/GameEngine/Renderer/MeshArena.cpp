@@ -0,0 +1,62 @@
+/*
+	Mesh Arena
+
+	Packs the vertices and indices of many meshes into one shared vertex and index array, so they can
+	live in a single vertex and index buffer. Each mesh keeps its own 0 based indices and is drawn
+	through its range, whose base vertex points at the start of its vertices.
+	Everything here is on the CPU, the owner uploads the arrays.
+*/
+
+#include "gepch.h"
+#include "MeshArena.h"
+
+namespace ge {
+
+	IndexedDrawRange MeshArena::Add(const std::vector<MeshVertex>& vertices, const std::vector<unsigned int>& indices)
+	{
+		IndexedDrawRange range;
+		range.Count = (uint32_t)indices.size();
+		range.FirstIndex = m_IndexCount;
+		range.BaseVertex = (int32_t)m_VertexCount;
+
+		m_Vertices.insert(m_Vertices.end(), vertices.begin(), vertices.end());
+		m_Indices.insert(m_Indices.end(), indices.begin(), indices.end());
+		m_VertexCount += (uint32_t)vertices.size();
+		m_IndexCount += range.Count;
+
+		m_Ranges.push_back(range);
+		return range;
+	}
+
+	void MeshArena::AddRange(const IndexedDrawRange& range, uint32_t vertexCount)
+	{
+		m_VertexCount = std::max(m_VertexCount, (uint32_t)range.BaseVertex + vertexCount);
+		m_IndexCount = std::max(m_IndexCount, range.FirstIndex + range.Count);
+		m_Ranges.push_back(range);
+	}
+
+	void MeshArena::Reserve(uint32_t vertexCount, uint32_t indexCount)
+	{
+		m_Vertices.reserve(vertexCount);
+		m_Indices.reserve(indexCount);
+	}
+
+	void MeshArena::BuildDrawCommands(std::vector<DrawIndirectCommand>& commands, uint32_t instanceCount, uint32_t baseInstance) const
+	{
+		commands.clear();
+		commands.reserve(m_Ranges.size());
+		for (const IndexedDrawRange& range : m_Ranges)
+			commands.push_back({ range.Count, instanceCount, range.FirstIndex, range.BaseVertex, baseInstance });
+	}
+
+	void MeshArena::ReleaseCPUData()
+	{
+		std::vector<MeshVertex>().swap(m_Vertices);
+		std::vector<unsigned int>().swap(m_Indices);
+	}
+
+	size_t MeshArena::GetCPUMemory() const
+	{
+		return m_Vertices.capacity() * sizeof(MeshVertex) + m_Indices.capacity() * sizeof(unsigned int);
+	}
+}
@@ -0,0 +1,48 @@
+/*
+	Mesh Arena
+
+	Packs the vertices and indices of many meshes into one shared vertex and index array, so they can
+	live in a single vertex and index buffer. Each mesh keeps its own 0 based indices and is drawn
+	through its range, whose base vertex points at the start of its vertices.
+	Everything here is on the CPU, the owner uploads the arrays.
+*/
+
+#pragma once
+
+#include "Mesh.h"
+#include "Buffer.h"
+#include "RendererAPI.h"
+
+namespace ge {
+
+	class MeshArena
+	{
+	public:
+		// Appends a mesh and returns where it ended up
+		IndexedDrawRange Add(const std::vector<MeshVertex>& vertices, const std::vector<unsigned int>& indices);
+		// Records a mesh whose vertices and indices are already in the owner's buffers (a cooked mesh), nothing is copied
+		void AddRange(const IndexedDrawRange& range, uint32_t vertexCount);
+		void Reserve(uint32_t vertexCount, uint32_t indexCount);
+
+		// One command per mesh, in the order they were added
+		void BuildDrawCommands(std::vector<DrawIndirectCommand>& commands, uint32_t instanceCount = 1, uint32_t baseInstance = 0) const;
+
+		const std::vector<MeshVertex>& GetVertices() const { return m_Vertices; }
+		const std::vector<unsigned int>& GetIndices() const { return m_Indices; }
+		const std::vector<IndexedDrawRange>& GetRanges() const { return m_Ranges; }
+
+		uint32_t GetVertexCount() const { return m_VertexCount; }
+		uint32_t GetIndexCount() const { return m_IndexCount; }
+
+		// Frees the vertex and index arrays once they are uploaded, the ranges and counts are kept
+		void ReleaseCPUData();
+		size_t GetCPUMemory() const;
+	private:
+		std::vector<MeshVertex> m_Vertices;
+		std::vector<unsigned int> m_Indices;
+		std::vector<IndexedDrawRange> m_Ranges;
+
+		uint32_t m_VertexCount = 0;
+		uint32_t m_IndexCount = 0;
+	};
+}
@@ -0,0 +1,398 @@
+/*
+	Mesh Optimizer
+
+	Reorders imported meshes for the GPU: welds duplicate vertices, orders triangles for the
+	post transform vertex cache (Forsyth) and then for overdraw, and finally orders the vertices
+	in the order the triangles fetch them. Everything runs on the CPU on plain vertex and index
+	arrays, including the cache statistics used to report the result.
+*/
+
+#include "gepch.h"
+#include "MeshOptimizer.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace ge {
+
+	////// Welding //////
+
+	static constexpr uint32_t s_VertexFloats = sizeof(MeshVertex) / sizeof(float);
+	static_assert(sizeof(MeshVertex) == s_VertexFloats * sizeof(float), "MeshVertex is expected to be only floats!");
+
+	struct VertexKey
+	{
+		std::array<uint32_t, s_VertexFloats> Values;
+
+		bool operator==(const VertexKey& other) const { return Values == other.Values; }
+	};
+
+	struct VertexKeyHash
+	{
+		size_t operator()(const VertexKey& key) const
+		{
+			// FNV-1a over the attribute words
+			uint32_t hash = 2166136261u;
+			for (uint32_t value : key.Values)
+			{
+				hash ^= value;
+				hash *= 16777619u;
+			}
+			return hash;
+		}
+	};
+
+	static VertexKey MakeVertexKey(const MeshVertex& vertex, float tolerance)
+	{
+		float values[s_VertexFloats];
+		std::memcpy(values, &vertex, sizeof(MeshVertex));
+
+		VertexKey key;
+		for (uint32_t i = 0; i < s_VertexFloats; i++)
+		{
+			if (tolerance > 0.0f)
+			{
+				key.Values[i] = (uint32_t)(int32_t)std::floor(values[i] / tolerance + 0.5f);
+			}
+			else
+			{
+				// -0 and 0 are the same vertex
+				float value = values[i] == 0.0f ? 0.0f : values[i];
+				std::memcpy(&key.Values[i], &value, sizeof(float));
+			}
+		}
+		return key;
+	}
+
+	void MeshOptimizer::WeldVertices(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, float tolerance)
+	{
+		std::unordered_map<VertexKey, uint32_t, VertexKeyHash> unique;
+		unique.reserve(vertices.size());
+
+		std::vector<uint32_t> remap(vertices.size());
+		std::vector<MeshVertex> welded;
+		welded.reserve(vertices.size());
+
+		for (uint32_t i = 0; i < (uint32_t)vertices.size(); i++)
+		{
+			auto result = unique.emplace(MakeVertexKey(vertices[i], tolerance), (uint32_t)welded.size());
+			if (result.second)
+				welded.push_back(vertices[i]);
+			remap[i] = result.first->second;
+		}
+
+		for (unsigned int& index : indices)
+			index = remap[index];
+
+		vertices.swap(welded);
+	}
+
+	////// Vertex Cache //////
+
+	// Scores from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	static float ForsythVertexScore(int32_t cachePosition, uint32_t liveTriangles)
+	{
+		// Nothing left to draw with this vertex
+		if (liveTriangles == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			// The last triangle's vertices get a fixed score so the next triangle does not just reuse its edge
+			if (cachePosition < 3)
+				score = 0.75f;
+			else
+				score = std::pow(1.0f - (float)(cachePosition - 3) / (float)(MeshOptimizer::CacheSize - 3), 1.5f);
+		}
+
+		// Favour vertices with few triangles left, so they are finished off instead of being left as stragglers
+		score += 2.0f * std::pow((float)liveTriangles, -0.5f);
+		return score;
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, uint32_t vertexCount)
+	{
+		const uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		if (triangleCount == 0)
+			return;
+
+		// Triangles using each vertex, the first liveTriangles[v] entries are the ones not emitted yet
+		std::vector<uint32_t> liveTriangles(vertexCount, 0);
+		for (unsigned int index : indices)
+			liveTriangles[index]++;
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t i = 0; i < (uint32_t)indices.size(); i++)
+				adjacency[cursor[indices[i]]++] = i / 3;
+		}
+
+		std::vector<int32_t> cachePosition(vertexCount, -1);
+		std::vector<float> vertexScore(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++)
+			vertexScore[v] = ForsythVertexScore(-1, liveTriangles[v]);
+
+		std::vector<float> triangleScore(triangleCount);
+		std::vector<bool> emitted(triangleCount, false);
+		int32_t best = 0;
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+			if (triangleScore[t] > triangleScore[best])
+				best = (int32_t)t;
+		}
+
+		std::vector<unsigned int> output;
+		output.reserve(indices.size());
+
+		std::vector<uint32_t> cache, newCache;
+		cache.reserve(CacheSize + 3);
+		newCache.reserve(CacheSize + 3);
+
+		uint32_t nextUnemitted = 0;
+		for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+		{
+			// Nothing in the cache has triangles left, carry on with the next triangle in the input order
+			if (best < 0)
+			{
+				while (emitted[nextUnemitted])
+					nextUnemitted++;
+				best = (int32_t)nextUnemitted;
+			}
+
+			const uint32_t triangle = (uint32_t)best;
+			emitted[triangle] = true;
+
+			newCache.clear();
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				const uint32_t v = indices[triangle * 3 + k];
+				output.push_back(v);
+
+				// Move the triangle out of the live part of the vertex's list
+				const uint32_t first = adjacencyOffsets[v];
+				const uint32_t last = first + liveTriangles[v] - 1;
+				for (uint32_t j = first; j <= last; j++)
+				{
+					if (adjacency[j] == triangle)
+					{
+						std::swap(adjacency[j], adjacency[last]);
+						break;
+					}
+				}
+				liveTriangles[v]--;
+
+				if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+					newCache.push_back(v);
+			}
+
+			// The triangle's vertices go to the front, everything else moves back
+			for (uint32_t v : cache)
+			{
+				if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+					newCache.push_back(v);
+			}
+
+			// Vertices pushed past the end are evicted, their score still has to be updated
+			for (uint32_t i = 0; i < (uint32_t)newCache.size(); i++)
+			{
+				const uint32_t v = newCache[i];
+				cachePosition[v] = i < CacheSize ? (int32_t)i : -1;
+				vertexScore[v] = ForsythVertexScore(cachePosition[v], liveTriangles[v]);
+			}
+
+			// Only triangles touching the cache changed score, the best of them is drawn next
+			best = -1;
+			float bestScore = -1.0f;
+			for (uint32_t v : newCache)
+			{
+				for (uint32_t j = adjacencyOffsets[v]; j < adjacencyOffsets[v] + liveTriangles[v]; j++)
+				{
+					const uint32_t t = adjacency[j];
+					const float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+					triangleScore[t] = score;
+					if (score > bestScore)
+					{
+						bestScore = score;
+						best = (int32_t)t;
+					}
+				}
+			}
+
+			if (newCache.size() > CacheSize)
+				newCache.resize(CacheSize);
+			cache.swap(newCache);
+		}
+
+		indices.swap(output);
+	}
+
+	////// Overdraw //////
+
+	void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<MeshVertex>& vertices, float threshold)
+	{
+		const uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		const uint32_t vertexCount = (uint32_t)vertices.size();
+		if (triangleCount < 2)
+			return;
+
+		// A cluster starts wherever the cache order jumps to a new area, a triangle that misses on all three vertices
+		std::vector<uint32_t> clusterStarts;
+		{
+			std::vector<uint32_t> timestamps(vertexCount, 0);
+			uint32_t time = CacheSize + 1;
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				uint32_t misses = 0;
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					const uint32_t v = indices[t * 3 + k];
+					if (time - timestamps[v] > CacheSize)
+					{
+						timestamps[v] = time++;
+						misses++;
+					}
+				}
+
+				if (misses == 3 || t == 0)
+					clusterStarts.push_back(t);
+			}
+		}
+
+		if (clusterStarts.size() < 2)
+			return;
+
+		const uint32_t clusterCount = (uint32_t)clusterStarts.size();
+		clusterStarts.push_back(triangleCount);
+
+		// Area weighted centroid and normal of every cluster
+		std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.0f));
+		std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+		glm::vec3 meshCentroid(0.0f);
+		float meshArea = 0.0f;
+		for (uint32_t c = 0; c < clusterCount; c++)
+		{
+			float clusterArea = 0.0f;
+			for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+			{
+				const glm::vec3& a = vertices[indices[t * 3]].Position;
+				const glm::vec3& b = vertices[indices[t * 3 + 1]].Position;
+				const glm::vec3& p = vertices[indices[t * 3 + 2]].Position;
+
+				const glm::vec3 normal = glm::cross(b - a, p - a);
+				const float area = glm::length(normal);
+				const glm::vec3 centroid = (a + b + p) / 3.0f;
+
+				clusterNormals[c] = clusterNormals[c] + normal;
+				clusterCentroids[c] = clusterCentroids[c] + centroid * area;
+				clusterArea += area;
+			}
+
+			meshCentroid = meshCentroid + clusterCentroids[c];
+			meshArea += clusterArea;
+			if (clusterArea > 0.0f)
+				clusterCentroids[c] = clusterCentroids[c] / clusterArea;
+		}
+		if (meshArea > 0.0f)
+			meshCentroid = meshCentroid / meshArea;
+
+		// Clusters facing away from the centre are the ones most likely to be in front, draw them first
+		std::vector<float> clusterKeys(clusterCount);
+		for (uint32_t c = 0; c < clusterCount; c++)
+		{
+			const float length = glm::length(clusterNormals[c]);
+			clusterKeys[c] = length > 0.0f ? glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c] / length) : 0.0f;
+		}
+
+		std::vector<uint32_t> clusterOrder(clusterCount);
+		for (uint32_t c = 0; c < clusterCount; c++)
+			clusterOrder[c] = c;
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](uint32_t a, uint32_t b) { return clusterKeys[a] > clusterKeys[b]; });
+
+		std::vector<unsigned int> reordered;
+		reordered.reserve(indices.size());
+		for (uint32_t c : clusterOrder)
+			reordered.insert(reordered.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+
+		// Keep the cache order when the new one costs too many extra vertex transforms
+		const float before = AnalyzeVertexCache(indices, vertexCount).ACMR;
+		const float after = AnalyzeVertexCache(reordered, vertexCount).ACMR;
+		if (after <= before * threshold)
+			indices.swap(reordered);
+	}
+
+	////// Vertex Fetch //////
+
+	void MeshOptimizer::OptimizeVertexFetch(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		static constexpr uint32_t s_Unused = 0xFFFFFFFF;
+
+		std::vector<uint32_t> remap(vertices.size(), s_Unused);
+		std::vector<MeshVertex> reordered;
+		reordered.reserve(vertices.size());
+
+		for (unsigned int& index : indices)
+		{
+			if (remap[index] == s_Unused)
+			{
+				remap[index] = (uint32_t)reordered.size();
+				reordered.push_back(vertices[index]);
+			}
+			index = remap[index];
+		}
+
+		vertices.swap(reordered);
+	}
+
+	////// Statistics //////
+
+	// Simulates a FIFO post transform cache
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		VertexCacheStatistics statistics;
+		const uint32_t triangleCount = (uint32_t)indices.size() / 3;
+		if (triangleCount == 0)
+			return statistics;
+
+		std::vector<uint32_t> timestamps(vertexCount, 0);
+		uint32_t time = cacheSize + 1;
+		uint32_t uniqueVertices = 0;
+		for (unsigned int index : indices)
+		{
+			if (timestamps[index] == 0)
+				uniqueVertices++;
+
+			if (time - timestamps[index] > cacheSize)
+			{
+				timestamps[index] = time++;
+				statistics.VerticesTransformed++;
+			}
+		}
+
+		statistics.ACMR = (float)statistics.VerticesTransformed / (float)triangleCount;
+		statistics.ATVR = (float)statistics.VerticesTransformed / (float)uniqueVertices;
+		return statistics;
+	}
+
+	MeshOptimizer::Report MeshOptimizer::Optimize(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, float overdrawThreshold)
+	{
+		Report report;
+		report.VerticesBefore = (uint32_t)vertices.size();
+		report.Before = AnalyzeVertexCache(indices, (uint32_t)vertices.size());
+
+		WeldVertices(vertices, indices);
+		OptimizeVertexCache(indices, (uint32_t)vertices.size());
+		OptimizeOverdraw(indices, vertices, overdrawThreshold);
+		OptimizeVertexFetch(vertices, indices);
+
+		report.VerticesAfter = (uint32_t)vertices.size();
+		report.After = AnalyzeVertexCache(indices, (uint32_t)vertices.size());
+		return report;
+	}
+}
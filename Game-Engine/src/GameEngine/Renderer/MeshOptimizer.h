@@ -0,0 +1,55 @@
+/*
+	Mesh Optimizer
+
+	Reorders imported meshes for the GPU: welds duplicate vertices, orders triangles for the
+	post transform vertex cache (Forsyth) and then for overdraw, and finally orders the vertices
+	in the order the triangles fetch them. Everything runs on the CPU on plain vertex and index
+	arrays, including the cache statistics used to report the result.
+*/
+
+#pragma once
+
+#include "Mesh.h"
+
+namespace ge {
+
+	struct VertexCacheStatistics
+	{
+		uint32_t VerticesTransformed = 0;
+		float ACMR = 0.0f;		// Average cache miss ratio, transformed vertices per triangle (0.5 is ideal, 3 is the worst)
+		float ATVR = 0.0f;		// Average transform to vertex ratio, transformed vertices per unique vertex (1 is ideal)
+	};
+
+	class MeshOptimizer
+	{
+	public:
+		// Size of the FIFO cache the statistics simulate and the orderings aim for
+		static constexpr uint32_t CacheSize = 32;
+
+		struct Report
+		{
+			uint32_t VerticesBefore = 0;
+			uint32_t VerticesAfter = 0;
+			VertexCacheStatistics Before;
+			VertexCacheStatistics After;
+		};
+
+		// Runs every pass below in order and returns the statistics before and after
+		static Report Optimize(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, float overdrawThreshold = 1.05f);
+
+		// Merges vertices with the same attributes. With a tolerance above 0 attributes are compared after rounding to it.
+		static void WeldVertices(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, float tolerance = 0.0f);
+
+		// Orders triangles so vertices are reused while still in the post transform cache (Forsyth's linear speed algorithm)
+		static void OptimizeVertexCache(std::vector<unsigned int>& indices, uint32_t vertexCount);
+
+		// Splits the cache ordered triangles into clusters and draws the outward facing ones first, so more of the
+		// hidden surfaces are rejected by the depth test. The order is kept if it makes the ACMR worse than threshold times the input.
+		static void OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<MeshVertex>& vertices, float threshold = 1.05f);
+
+		// Orders the vertices by first use and drops the ones no triangle uses
+		static void OptimizeVertexFetch(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices);
+
+		static VertexCacheStatistics AnalyzeVertexCache(const std::vector<unsigned int>& indices, uint32_t vertexCount, uint32_t cacheSize = CacheSize);
+	};
+}
@@ -8,69 +8,77 @@
 #include "Model.h"
 
 #include <glm/glm.hpp>
+#include <chrono>
 
 #include "stb_image.h"
 
-namespace ge {
+#include "GameEngine/Renderer/MeshOptimizer.h"
 
-	Model::Model(const std::string& path)
-	{
-		LoadModel(path);
-	}
+#include "GameEngine/Renderer/RenderCommand.h"
+#include "GameEngine/Renderer/TextureCache.h"
+#include "GameEngine/Renderer/TextureStreamer.h"
 
-	Model::~Model()
-	{
+namespace ge {
 
-	}
+	static const unsigned int s_ImportFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
 
-	void Model::Draw(const std::shared_ptr<Shader>& shader)
+	// The material textures a mesh binds and the samplers they go to. ASSIMP reads the normal maps of OBJ
+	// materials as height maps and their height maps as ambient ones.
+	struct MaterialSlot
 	{
-		// Draw each mesh
-		for (unsigned int i = 0; i < m_Meshes.size(); i++)
-			m_Meshes[i].Draw(shader);
-	}
+		aiTextureType Type;
+		const char* Sampler;
+	};
 
-	void Model::LoadModel(const std::string& path)
-	{
-		// Read file via ASSIMP
-		Assimp::Importer importer;
-		const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+	static constexpr uint32_t s_MaterialSlotCount = 4;
+	static const MaterialSlot s_MaterialSlots[s_MaterialSlotCount] = {
+		{ aiTextureType_DIFFUSE, "texture_diffuse" },
+		{ aiTextureType_SPECULAR, "texture_specular" },
+		{ aiTextureType_HEIGHT, "texture_normal" },
+		{ aiTextureType_AMBIENT, "texture_height" }
+	};
 
-		// Check for errors
-		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+	// Only reads the paths, the images are loaded on upload
+	static void CollectMaterialTextures(const aiMaterial* material, std::vector<ModelTexture>& textures)
+	{
+		for (uint32_t slot = 0; slot < s_MaterialSlotCount; slot++)
 		{
-			return;
+			for (unsigned int i = 0; i < material->GetTextureCount(s_MaterialSlots[slot].Type); i++)
+			{
+				aiString path;
+				material->GetTexture(s_MaterialSlots[slot].Type, i, &path);
+				textures.push_back({ path.C_Str(), slot });
+			}
 		}
-		// retrieve the directory path of the filepath
-		m_Directory = path.substr(0, path.find_last_of('/'));
-
-		// Process ASSIMP's root nodes recursively
-		ProcessNode(scene->mRootNode, scene);
 	}
 
-	void Model::ProcessNode(aiNode* node, const aiScene* scene)
+	// Meshes in the order ProcessNode visits them
+	static void CollectMeshes(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& meshes)
 	{
-		// Process all the node's meshes
 		for (unsigned int i = 0; i < node->mNumMeshes; i++)
-		{
-			// the node object only contains indices to index the actual objects in the scene. 
-			// the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
-			aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-			m_Meshes.push_back(ProcessMesh(mesh, scene));
-		}
-		// Then do the same for each of its children
+			meshes.push_back(scene->mMeshes[node->mMeshes[i]]);
 		for (unsigned int i = 0; i < node->mNumChildren; i++)
-		{
-			ProcessNode(node->mChildren[i], scene);
-		}
+			CollectMeshes(node->mChildren[i], scene, meshes);
+	}
+
+	// What a cooked file made from the source with these settings has in its header
+	static CookedMeshHeader MakeCookedHeader(const ModelSettings& settings, const FileStamp& stamp)
+	{
+		CookedMeshHeader header;
+		header.Storage = (uint32_t)settings.Storage;
+		header.VertexFormat = (uint32_t)settings.VertexFormat;
+		header.VertexStride = VertexFormat::GetStride(settings.VertexFormat);
+		header.FullVertexStride = sizeof(MeshVertex);
+		header.Flags = settings.OptimizeMeshes ? CookedMeshFlags_Optimized : CookedMeshFlags_None;
+		header.SourceSize = stamp.Size;
+		header.SourceTime = stamp.Time;
+		return header;
 	}
 
-	Mesh Model::ProcessMesh(aiMesh* mesh, const aiScene* scene)
+	static void ExtractGeometry(aiMesh* mesh, bool optimize, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices)
 	{
-		// data to fill
-		std::vector<MeshVertex> vertices;
-		std::vector<unsigned int> indices;
-		std::vector<Ref<Texture3D>> textures;
+		vertices.reserve(mesh->mNumVertices);
+		indices.reserve(mesh->mNumFaces * 3);
 
 		// Walk through each of the meshes vertices
 		for (unsigned int i = 0; i < mesh->mNumVertices; i++)
@@ -125,59 +133,472 @@ namespace ge {
 			}
 		}
 
-		// Process Materials
-		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-		// we assume a convention for sampler names in the shaders. Each diffuse texture should be named
-		// as 'texture_diffuseN' where N is a sequential number ranging from 1 to MAX_SAMPLER_NUMBER. 
-		// Same applies to other texture as the following list summarizes:
-		// diffuse: texture_diffuseN
-		// specular: texture_specularN
-		// normal: texture_normalN
-
-		// 1. diffuse maps
-		/*std::vector<Ref<Texture3D>> diffuseMaps = LoadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-		textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-		// 2. specular maps
-		std::vector<Ref<Texture3D>> specularMaps = LoadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-		textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
-		// 3. normal maps
-		std::vector<Ref<Texture3D>> normalMaps = LoadMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal");
-		textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
-		// 4. height maps
-		std::vector<Ref<Texture3D>> heightMaps = LoadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
-		textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());*/
-
-		// return a mesh object created from the extracted mesh data
-		return Mesh(vertices, indices, textures);
-	}
-
-	std::vector<Ref<Texture3D>> Model::LoadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName)
-	{
-		std::vector<Ref<Texture3D>> textures;
-		for (unsigned int i = 0; i < mat->GetTextureCount(type); i++)
-		{
-			aiString str;
-			mat->GetTexture(type, i, &str);
-			GE_CORE_TRACE(str.C_Str());
-			// check if texture was loaded before and if so, continue to next iteration: skip loading a new texture
-			bool skip = false;
-			for (unsigned int j = 0; j < m_TexturesLoaded.size(); j++)
+		if (optimize)
+		{
+			MeshOptimizer::Report report = MeshOptimizer::Optimize(vertices, indices);
+			GE_CORE_TRACE("Optimized mesh {0}: {1} -> {2} vertices, ACMR {3} -> {4}, ATVR {5} -> {6}", mesh->mName.C_Str(),
+				report.VerticesBefore, report.VerticesAfter, report.Before.ACMR, report.After.ACMR, report.Before.ATVR, report.After.ATVR);
+		}
+	}
+
+	size_t ModelData::GetUploadSize() const
+	{
+		if (Cooked)
+			return Cooked->GetHeader().FileSize;
+
+		size_t size = (size_t)Arena.GetVertexCount() * sizeof(MeshVertex) + (size_t)Arena.GetIndexCount() * sizeof(unsigned int);
+		for (size_t i = 0; i < Vertices.size(); i++)
+			size += Vertices[i].size() * sizeof(MeshVertex) + Indices[i].size() * sizeof(unsigned int);
+		return size;
+	}
+
+	Model::Model(const std::string& path, const ModelSettings& settings)
+		: m_Settings(settings)
+	{
+		ModelData data;
+		Import(path, settings, data);
+		Upload(std::move(data));
+	}
+
+	Model::Model(ModelData&& data)
+		: m_Settings(data.Settings)
+	{
+		Upload(std::move(data));
+	}
+
+	Model::~Model()
+	{
+
+	}
+
+	void Model::Draw(const std::shared_ptr<Shader>& shader)
+	{
+		if (m_Settings.Storage == ModelStorage::Packed)
+		{
+			if (m_Settings.VertexFormat != MeshVertexFormat::Full)
+			{
+				static const UniformID s_BoundsMinID("u_BoundsMin");
+				static const UniformID s_BoundsExtentID("u_BoundsExtent");
+				shader->SetFloat3(s_BoundsMinID, m_BoundsMin);
+				shader->SetFloat3(s_BoundsExtentID, m_BoundsExtent);
+			}
+
+			for (const MaterialRun& run : m_MaterialRuns)
+			{
+				run.Material.Bind(shader);
+				RenderCommand::MultiDrawIndexedIndirect(m_VertexArray, m_IndirectBuffer, run.CommandCount, run.FirstCommand);
+			}
+			return;
+		}
+
+		// Draw each mesh
+		for (unsigned int i = 0; i < m_Meshes.size(); i++)
+			m_Meshes[i].Draw(shader);
+	}
+
+	void Model::RequestTextureMips(const PerspectiveCamera& camera, const glm::mat4& transform, float viewportHeight) const
+	{
+		// Bounding sphere of each mesh, the radius grows with the largest scale of the transform
+		const float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+		auto request = [&](const std::vector<MeshTexture>& textures, const glm::vec3& aabbMin, const glm::vec3& aabbMax)
+		{
+			if (textures.empty())
+				return;
+
+			const glm::vec3 center = glm::vec3(transform * glm::vec4((aabbMin + aabbMax) * 0.5f, 1.0f));
+			const float radius = glm::length(aabbMax - aabbMin) * 0.5f * scale;
+			const float screenSize = TextureStreamer::ComputeScreenSize(camera, center, radius, viewportHeight);
+			for (const MeshTexture& texture : textures)
+				TextureStreamer::RequestScreenSize(*texture.Texture, screenSize);
+		};
+
+		for (const Mesh& mesh : m_Meshes)
+			request(mesh.GetTextures(), mesh.GetAABBMin(), mesh.GetAABBMax());
+		// The meshes of a packed model don't keep their own bounds, the whole model stands in for them
+		for (const MaterialRun& run : m_MaterialRuns)
+			request(run.Material.GetTextures(), m_AABBMin, m_AABBMax);
+	}
+
+	void Model::SetupPackedBuffers(const std::vector<std::vector<ModelTexture>>& textures)
+	{
+		const MeshVertexFormat format = m_Settings.VertexFormat;
+		const uint32_t vertexCount = m_Arena.GetVertexCount();
+
+		glm::vec3 boundsExtent;
+		VertexFormat::ComputeBounds(m_Arena.GetVertices().data(), vertexCount, m_AABBMin, boundsExtent);
+		m_AABBMax = m_AABBMin + boundsExtent;
+
+		// Quantized positions are relative to the bounds of the whole model, the meshes share one buffer
+		auto packStart = std::chrono::steady_clock::now();
+		std::vector<uint8_t> packed;
+		void* vertexData = (void*)m_Arena.GetVertices().data();
+		if (format != MeshVertexFormat::Full)
+		{
+			if (format == MeshVertexFormat::PackedQuantized)
+			{
+				m_BoundsMin = m_AABBMin;
+				m_BoundsExtent = boundsExtent;
+			}
+			VertexFormat::Pack(m_Arena.GetVertices().data(), vertexCount, format, m_BoundsMin, m_BoundsExtent, packed);
+			vertexData = packed.data();
+		}
+		auto uploadStart = std::chrono::steady_clock::now();
+
+		UploadPackedBuffers(vertexData, m_Arena.GetIndices().data(), textures);
+
+		auto uploadEnd = std::chrono::steady_clock::now();
+		m_MemoryReport.PackTime = std::chrono::duration<float, std::milli>(uploadStart - packStart).count();
+		m_MemoryReport.UploadTime = std::chrono::duration<float, std::milli>(uploadEnd - uploadStart).count();
+
+		m_MemoryReport.CPUBytesAtLoad = m_Arena.GetCPUMemory();
+		if (!m_Settings.RetainCPUData)
+			m_Arena.ReleaseCPUData();
+
+		m_MemoryReport.CPUBytes = m_Arena.GetCPUMemory();
+	}
+
+	void Model::UploadPackedBuffers(const void* vertexData, const unsigned int* indices, const std::vector<std::vector<ModelTexture>>& textures)
+	{
+		const MeshVertexFormat format = m_Settings.VertexFormat;
+		const uint32_t vertexCount = m_Arena.GetVertexCount();
+
+		m_VertexArray.reset(VertexArray::Create());
+
+		m_VertexBuffer.reset(VertexBuffer::Create((void*)vertexData, vertexCount * VertexFormat::GetStride(format)));
+		m_VertexBuffer->SetLayout(VertexFormat::GetLayout(format));
+		m_VertexArray->AddVertexBuffer(m_VertexBuffer);
+
+		m_IndexBuffer.reset(IndexBuffer::Create((void*)indices, m_Arena.GetIndexCount()));
+		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
+
+		std::vector<DrawIndirectCommand> meshCommands;
+		m_Arena.BuildDrawCommands(meshCommands);
+		std::vector<DrawIndirectCommand> commands;
+		BuildMaterialRuns(textures, meshCommands, commands);
+		m_IndirectBuffer.reset(IndirectBuffer::Create(commands.data(), (uint32_t)commands.size()));
+
+		m_MemoryReport.VertexBytes = (size_t)vertexCount * VertexFormat::GetStride(format);
+		m_MemoryReport.FullVertexBytes = (size_t)vertexCount * sizeof(MeshVertex);
+		m_MemoryReport.GPUBytes = m_MemoryReport.VertexBytes + (size_t)m_Arena.GetIndexCount() * sizeof(unsigned int)
+			+ commands.size() * sizeof(DrawIndirectCommand);
+	}
+
+	void Model::BuildMaterialRuns(const std::vector<std::vector<ModelTexture>>& textures, const std::vector<DrawIndirectCommand>& meshCommands,
+		std::vector<DrawIndirectCommand>& commands)
+	{
+		// The cache hands back the same texture for every mesh using it, so equal materials compare equal
+		std::vector<std::vector<uint32_t>> runMeshes;
+		for (uint32_t i = 0; i < (uint32_t)meshCommands.size(); i++)
+		{
+			MeshMaterial material(i < textures.size() ? LoadMaterialTextures(textures[i]) : std::vector<MeshTexture>());
+
+			size_t run = 0;
+			while (run < m_MaterialRuns.size() && m_MaterialRuns[run].Material != material)
+				run++;
+			if (run == m_MaterialRuns.size())
+			{
+				m_MaterialRuns.push_back({ std::move(material), 0, 0 });
+				runMeshes.emplace_back();
+			}
+			runMeshes[run].push_back(i);
+		}
+
+		commands.clear();
+		commands.reserve(meshCommands.size());
+		for (size_t run = 0; run < m_MaterialRuns.size(); run++)
+		{
+			m_MaterialRuns[run].FirstCommand = (uint32_t)commands.size();
+			m_MaterialRuns[run].CommandCount = (uint32_t)runMeshes[run].size();
+			for (uint32_t mesh : runMeshes[run])
+				commands.push_back(meshCommands[mesh]);
+		}
+	}
+
+	bool Model::Cook(const std::string& path, const ModelSettings& settings)
+	{
+		FileStamp stamp;
+		if (!FileSystem::GetStamp(path, stamp))
+		{
+			GE_CORE_ERROR("Could not cook {0}, the file does not exist", path);
+			return false;
+		}
+
+		Assimp::Importer importer;
+		const aiScene* scene = importer.ReadFile(path, s_ImportFlags);
+		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		{
+			GE_CORE_ERROR("Could not cook {0}: {1}", path, importer.GetErrorString());
+			return false;
+		}
+
+		std::vector<aiMesh*> meshes;
+		CollectMeshes(scene->mRootNode, scene, meshes);
+
+		// The arena lays the meshes out back to back, which is the layout of the file
+		MeshArena arena;
+		std::vector<CookedSubmesh> submeshes;
+		std::vector<CookedMeshTexture> textures;
+		submeshes.reserve(meshes.size());
+		for (aiMesh* mesh : meshes)
+		{
+			std::vector<ModelTexture> materialTextures;
+			CollectMaterialTextures(scene->mMaterials[mesh->mMaterialIndex], materialTextures);
+			for (const ModelTexture& materialTexture : materialTextures)
 			{
-				if (std::strcmp(m_TexturesLoaded[j]->GetPath().data(), str.C_Str()) == 0)
+				if (materialTexture.Path.size() >= CookedMeshTexture::MaxPath)
 				{
-					textures.push_back(m_TexturesLoaded[j]);
-					skip = true;	// a texture with the same filepath has already been loaded, continue to next one. (optimization)
-					break;
+					GE_CORE_WARN("Could not cook {0}, the texture path {1} is too long", path, materialTexture.Path);
+					return false;
 				}
+
+				CookedMeshTexture texture;
+				texture.Submesh = (uint32_t)submeshes.size();
+				texture.Slot = materialTexture.Slot;
+				std::memcpy(texture.Path, materialTexture.Path.c_str(), materialTexture.Path.size());
+				textures.push_back(texture);
 			}
-			if (!skip)		// If the texture hasn't been already loaded, load it
+
+			std::vector<MeshVertex> vertices;
+			std::vector<unsigned int> indices;
+			ExtractGeometry(mesh, settings.OptimizeMeshes, vertices, indices);
+			const IndexedDrawRange range = arena.Add(vertices, indices);
+
+			CookedSubmesh submesh;
+			submesh.FirstIndex = range.FirstIndex;
+			submesh.IndexCount = range.Count;
+			submesh.BaseVertex = range.BaseVertex;
+			submesh.VertexCount = (uint32_t)vertices.size();
+			VertexFormat::ComputeBounds(vertices.data(), submesh.VertexCount, submesh.BoundsMin, submesh.BoundsExtent);
+			submeshes.push_back(submesh);
+		}
+
+		CookedMeshHeader header = MakeCookedHeader(settings, stamp);
+		header.VertexCount = arena.GetVertexCount();
+		header.IndexCount = arena.GetIndexCount();
+		VertexFormat::ComputeBounds(arena.GetVertices().data(), header.VertexCount, header.BoundsMin, header.BoundsExtent);
+
+		// Per mesh storage quantizes every mesh against its own bounds, packed storage against the bounds of the model
+		std::vector<uint8_t> vertexData;
+		if (settings.Storage == ModelStorage::Packed)
+		{
+			VertexFormat::Pack(arena.GetVertices().data(), header.VertexCount, settings.VertexFormat, header.BoundsMin, header.BoundsExtent, vertexData);
+		}
+		else
+		{
+			vertexData.reserve((size_t)header.VertexCount * header.VertexStride);
+			std::vector<uint8_t> packed;
+			for (const CookedSubmesh& submesh : submeshes)
 			{
-				Ref<Texture3D> texture = Texture3D::Create(str.C_Str(), this->m_Directory);
-				texture->SetType(typeName);
-				textures.push_back(texture);
-				m_TexturesLoaded.push_back(texture);	// add to loaded textures
+				VertexFormat::Pack(arena.GetVertices().data() + submesh.BaseVertex, submesh.VertexCount, settings.VertexFormat,
+					submesh.BoundsMin, submesh.BoundsExtent, packed);
+				vertexData.insert(vertexData.end(), packed.begin(), packed.end());
 			}
 		}
-		return textures;
+
+		const std::string cookedPath = GetCookedPath(path);
+		if (!CookedMesh::Write(cookedPath, header, submeshes, textures, vertexData.data(), arena.GetIndices().data()))
+			return false;
+
+		GE_CORE_INFO("Cooked {0}: {1} meshes, {2} vertices, {3} indices, {4} textures", cookedPath, submeshes.size(),
+			header.VertexCount, header.IndexCount, textures.size());
+		return true;
+	}
+
+	// Opens the cooked file of the model when it was cooked from the source with these settings
+	static bool OpenCookedMesh(const std::string& path, const ModelSettings& settings, CookedMesh& cooked)
+	{
+		if (!cooked.Open(Model::GetCookedPath(path)))
+			return false;
+
+		// Without the source (a build that only ships cooked files) the stamp in the file is trusted
+		const CookedMeshHeader& header = cooked.GetHeader();
+		FileStamp stamp = { header.SourceSize, header.SourceTime };
+		FileSystem::GetStamp(path, stamp);
+		if (!cooked.IsCurrent(MakeCookedHeader(settings, stamp)))
+		{
+			GE_CORE_INFO("{0} is out of date, importing {1}", Model::GetCookedPath(path), path);
+			cooked.Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool Model::Import(const std::string& path, const ModelSettings& settings, ModelData& data)
+	{
+		data.Path = path;
+		// retrieve the directory path of the filepath
+		data.Directory = path.substr(0, path.find_last_of('/'));
+		data.Settings = settings;
+
+		// The cooked file skips the import and every per vertex step after it
+		if (settings.UseCookedMesh)
+		{
+			data.Cooked = std::make_unique<CookedMesh>();
+			if (OpenCookedMesh(path, settings, *data.Cooked))
+				return true;
+			if (settings.CookOnImport && Cook(path, settings) && OpenCookedMesh(path, settings, *data.Cooked))
+				return true;
+			data.Cooked.reset();
+		}
+
+		// Read file via ASSIMP
+		Assimp::Importer importer;
+		const aiScene* scene = importer.ReadFile(path, s_ImportFlags);
+
+		// Check for errors
+		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		{
+			GE_CORE_ERROR("Could not load model {0}: {1}", path, importer.GetErrorString());
+			return false;
+		}
+
+		// Process ASSIMP's nodes recursively, the meshes keep the order of the nodes
+		std::vector<aiMesh*> meshes;
+		CollectMeshes(scene->mRootNode, scene, meshes);
+		for (aiMesh* mesh : meshes)
+		{
+			std::vector<MeshVertex> vertices;
+			std::vector<unsigned int> indices;
+			ExtractGeometry(mesh, settings.OptimizeMeshes, vertices, indices);
+
+
+			if (settings.Storage == ModelStorage::Packed)
+			{
+				// Only copied into the arena, the buffers are created once every mesh is in
+				data.Arena.Add(vertices, indices);
+			}
+			else
+			{
+				data.Vertices.push_back(std::move(vertices));
+				data.Indices.push_back(std::move(indices));
+			}
+
+			// Process Materials
+			data.Textures.emplace_back();
+			CollectMaterialTextures(scene->mMaterials[mesh->mMaterialIndex], data.Textures.back());
+		}
+
+		return true;
+	}
+
+	void Model::Upload(ModelData&& data)
+	{
+		m_Directory = std::move(data.Directory);
+
+		if (data.Cooked)
+		{
+			UploadCooked(*data.Cooked);
+		}
+		else if (m_Settings.Storage == ModelStorage::Packed)
+		{
+			m_Arena = std::move(data.Arena);
+			m_MemoryReport.MeshCount = (uint32_t)m_Arena.GetRanges().size();
+			if (!m_Arena.GetRanges().empty())
+				SetupPackedBuffers(data.Textures);
+		}
+		else
+		{
+			m_Meshes.reserve(data.Vertices.size());
+			for (size_t i = 0; i < data.Vertices.size(); i++)
+			{
+				// The copies exist until the mesh has uploaded them
+				m_MemoryReport.CPUBytesAtLoad += data.Vertices[i].capacity() * sizeof(MeshVertex) + data.Indices[i].capacity() * sizeof(unsigned int);
+
+				// the mesh takes over the vectors
+				m_Meshes.emplace_back(std::move(data.Vertices[i]), std::move(data.Indices[i]), LoadMaterialTextures(data.Textures[i]),
+					m_Settings.RetainCPUData, m_Settings.VertexFormat);
+				m_MemoryReport.MeshCount++;
+
+				const Mesh& added = m_Meshes.back();
+				m_MemoryReport.CPUBytes += added.GetCPUMemory();
+				m_MemoryReport.GPUBytes += added.GetGPUMemory();
+				m_MemoryReport.VertexBytes += (size_t)added.GetVertexCount() * VertexFormat::GetStride(added.GetVertexFormat());
+				m_MemoryReport.FullVertexBytes += (size_t)added.GetVertexCount() * sizeof(MeshVertex);
+				m_MemoryReport.PackTime += added.GetPackTime();
+				m_MemoryReport.UploadTime += added.GetUploadTime();
+			}
+		}
+
+		if (m_MemoryReport.MeshCount > 0)
+		{
+			GE_CORE_INFO("{0}: {1} meshes{2}, {3} KB CPU at load, {4} KB CPU after upload, {5} KB GPU", data.Path, m_MemoryReport.MeshCount,
+				m_MemoryReport.Cooked ? " (cooked)" : "",
+				m_MemoryReport.CPUBytesAtLoad / 1024, m_MemoryReport.CPUBytes / 1024, m_MemoryReport.GPUBytes / 1024);
+			GE_CORE_INFO("{0}: vertices {1} KB ({2} KB as MeshVertex), packing {3} ms, upload {4} ms", data.Path, m_MemoryReport.VertexBytes / 1024,
+				m_MemoryReport.FullVertexBytes / 1024, m_MemoryReport.PackTime, m_MemoryReport.UploadTime);
+		}
+	}
+
+	void Model::UploadCooked(const CookedMesh& cooked)
+	{
+		const CookedMeshHeader& header = cooked.GetHeader();
+		m_MemoryReport.Cooked = true;
+		m_MemoryReport.MeshCount = header.SubmeshCount;
+
+		// Every buffer is created straight from the mapping, the blobs are already in the upload format
+		auto uploadStart = std::chrono::steady_clock::now();
+		const MeshVertexFormat format = (MeshVertexFormat)header.VertexFormat;
+		const CookedSubmesh* submeshes = cooked.GetSubmeshes();
+
+		// Open checked every texture belongs to a submesh
+		std::vector<std::vector<ModelTexture>> textures(header.SubmeshCount);
+		for (uint32_t i = 0; i < header.TextureCount; i++)
+		{
+			const CookedMeshTexture& texture = cooked.GetTextures()[i];
+			textures[texture.Submesh].push_back({ texture.Path, texture.Slot });
+		}
+
+		if (m_Settings.Storage == ModelStorage::Packed)
+		{
+			m_AABBMin = header.BoundsMin;
+			m_AABBMax = header.BoundsMin + header.BoundsExtent;
+			if (format == MeshVertexFormat::PackedQuantized)
+			{
+				m_BoundsMin = header.BoundsMin;
+				m_BoundsExtent = header.BoundsExtent;
+			}
+
+			for (uint32_t i = 0; i < header.SubmeshCount; i++)
+				m_Arena.AddRange({ submeshes[i].IndexCount, submeshes[i].FirstIndex, submeshes[i].BaseVertex }, submeshes[i].VertexCount);
+
+			if (header.SubmeshCount > 0)
+				UploadPackedBuffers(cooked.GetVertexData(), cooked.GetIndexData(), textures);
+		}
+		else
+		{
+			m_Meshes.reserve(header.SubmeshCount);
+			for (uint32_t i = 0; i < header.SubmeshCount; i++)
+			{
+				const CookedSubmesh& submesh = submeshes[i];
+				m_Meshes.emplace_back(cooked.GetVertexData() + (size_t)submesh.BaseVertex * header.VertexStride, submesh.VertexCount,
+					cooked.GetIndexData() + submesh.FirstIndex, submesh.IndexCount, LoadMaterialTextures(textures[i]),
+					format, submesh.BoundsMin, submesh.BoundsExtent);
+
+				const Mesh& added = m_Meshes.back();
+				m_MemoryReport.GPUBytes += added.GetGPUMemory();
+				m_MemoryReport.VertexBytes += (size_t)added.GetVertexCount() * header.VertexStride;
+				m_MemoryReport.FullVertexBytes += (size_t)added.GetVertexCount() * sizeof(MeshVertex);
+			}
+		}
+		m_MemoryReport.UploadTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+	}
+
+	std::vector<MeshTexture> Model::LoadMaterialTextures(const std::vector<ModelTexture>& textures) const
+	{
+		std::vector<MeshTexture> loaded;
+		loaded.reserve(textures.size());
+		for (const ModelTexture& texture : textures)
+		{
+			// a slot this build does not know about comes from a newer cooked file
+			if (texture.Slot >= s_MaterialSlotCount)
+				continue;
+
+			GE_CORE_TRACE(texture.Path);
+			// the cache hands back the texture other meshes and models already loaded from the same file, which can
+			// use it in another slot, so the sampler stays with the mesh
+			loaded.push_back({ TextureCache::GetTexture3D(texture.Path, m_Directory), s_MaterialSlots[texture.Slot].Sampler });
+		}
+		return loaded;
 	}
 }
\ No newline at end of file
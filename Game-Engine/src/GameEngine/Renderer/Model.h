@@ -11,6 +11,9 @@
 
 #include <GameEngine/Renderer/Shader.h>
 #include <GameEngine/Renderer/Mesh.h>
+#include <GameEngine/Renderer/MeshArena.h>
+#include <GameEngine/Renderer/CookedMesh.h>
+#include <GameEngine/Renderer/PerspectiveCamera.h>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -18,35 +21,143 @@
 
 namespace ge {
 
+	enum class ModelStorage
+	{
+		PerMesh = 0,	// Every mesh has its own vertex array and buffers and is drawn on its own
+		Packed = 1		// All meshes share one vertex and index buffer, the meshes of each material are drawn with one indirect multi draw
+	};
+
+	struct ModelSettings
+	{
+		ModelStorage Storage = ModelStorage::PerMesh;
+		MeshVertexFormat VertexFormat = MeshVertexFormat::Full;
+		// Keeps the vertices and indices of the meshes in memory after they are uploaded
+		bool RetainCPUData = false;
+		// Runs the MeshOptimizer passes on every mesh after import
+		bool OptimizeMeshes = true;
+		// Loads the cooked file next to the model instead of importing it, when it was cooked from the same source with the same settings
+		bool UseCookedMesh = true;
+		// Cooks the model when the cooked file is missing or stale, so the next load skips the import
+		bool CookOnImport = false;
+	};
+
+	// A material texture of a mesh, only the reference is read on import, the image is loaded on upload through the TextureCache
+	struct ModelTexture
+	{
+		std::string Path;		// As written in the material, relative to the model's directory
+		uint32_t Slot = 0;		// Index of the material slot, which names the sampler it is bound to
+	};
+
+	// Everything a model needs before it touches the GPU, filled by Model::Import which can run on any thread
+	struct ModelData
+	{
+		std::string Path;
+		std::string Directory;
+		ModelSettings Settings;
+
+		// Open when the cooked file is used, the buffers are created straight from its mapping
+		Scope<CookedMesh> Cooked;
+		// Imported meshes, one entry per mesh with ModelStorage::PerMesh
+		std::vector<std::vector<MeshVertex>> Vertices;
+		std::vector<std::vector<unsigned int>> Indices;
+		// Every mesh back to back with ModelStorage::Packed
+		MeshArena Arena;
+		// Material textures of each mesh in either storage, the cooked file has its own table
+		std::vector<std::vector<ModelTexture>> Textures;
+
+		// Bytes of vertex and index data the upload reads
+		size_t GetUploadSize() const;
+	};
+
 	class Model {
 	public:
 		/* Functions */
 
 		// Constructor, expects path of 3D model
-		Model(const std::string& path);
+		Model(const std::string& path, const ModelSettings& settings = ModelSettings());
+		// Uploads a model imported ahead of time, on the thread with the graphics context
+		explicit Model(ModelData&& data);
 		~Model();
 
+		// Reads and decodes the model without touching the GPU, safe to call from any thread.
+		// Returns false when neither the cooked file nor the import could be read, data then holds an empty model.
+		static bool Import(const std::string& path, const ModelSettings& settings, ModelData& data);
+
 		// Draws the model and thus all the meshes
 		void Draw(const std::shared_ptr<Shader>& shader);
+		// Asks the TextureStreamer for the mips the material textures need at the model's size on screen.
+		// Call it each frame the model is visible, before TextureStreamer::Update. The transform is the one the model
+		// is drawn with, relative to the render origin like the view of the camera.
+		void RequestTextureMips(const PerspectiveCamera& camera, const glm::mat4& transform, float viewportHeight) const;
+
+		const ModelSettings& GetSettings() const { return m_Settings; }
+
+		// Imports the model and writes the cooked file for the settings next to it. Returns false if the import or the write fails.
+		static bool Cook(const std::string& path, const ModelSettings& settings = ModelSettings());
+		static std::string GetCookedPath(const std::string& path) { return path + ".gemesh"; }
+
+		// Only filled with ModelStorage::PerMesh
+		const std::vector<Mesh>& GetMeshes() const { return m_Meshes; }
+		// Only filled with ModelStorage::Packed
+		const MeshArena& GetArena() const { return m_Arena; }
+
+		struct MemoryReport
+		{
+			uint32_t MeshCount = 0;
+			size_t CPUBytesAtLoad = 0;		// Vertex and index copies while the meshes were being uploaded
+			size_t CPUBytes = 0;			// What is still held after the upload
+			size_t GPUBytes = 0;
+			size_t VertexBytes = 0;			// Vertex buffers in the upload format
+			size_t FullVertexBytes = 0;		// What the vertex buffers would take as MeshVertex
+			float PackTime = 0.0f;			// Milliseconds converting vertices to the upload format
+			float UploadTime = 0.0f;		// Milliseconds creating the vertex and index buffers
+			bool Cooked = false;			// Loaded from the cooked file, the vertices were never on the heap
+		};
+
+		const MemoryReport& GetMemoryReport() const { return m_MemoryReport; }
 	private:
 		/* Functions */
 
-		// loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
-		void LoadModel(const std::string& path);
-
-		// processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
-		void ProcessNode(aiNode* node, const aiScene* scene);
+		// Creates the meshes and their buffers from the imported data
+		void Upload(ModelData&& data);
+		// Creates the buffers straight from the mapping of the cooked file
+		void UploadCooked(const CookedMesh& cooked);
 
-		// Process the vertices, indices and textures
-		Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene);
+		// Uploads the arena and the draw commands of a packed model
+		void SetupPackedBuffers(const std::vector<std::vector<ModelTexture>>& textures);
+		void UploadPackedBuffers(const void* vertexData, const unsigned int* indices, const std::vector<std::vector<ModelTexture>>& textures);
+		// Groups the meshes of a packed model by material, the commands of a group end up next to each other
+		void BuildMaterialRuns(const std::vector<std::vector<ModelTexture>>& textures, const std::vector<DrawIndirectCommand>& meshCommands,
+			std::vector<DrawIndirectCommand>& commands);
 
-		// checks all material textures of a given type and loads the textures if they're not loaded yet.
-		// the required info is returned as a Texture struct.	
-		std::vector<Ref<Texture3D>> LoadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+		// loads the material textures of a mesh through the TextureCache, so textures are shared between meshes and models
+		std::vector<MeshTexture> LoadMaterialTextures(const std::vector<ModelTexture>& textures) const;
 
 		/* Model Data */
 		std::vector<Mesh> m_Meshes;
 		std::string m_Directory;
-		std::vector<Ref<Texture3D>> m_TexturesLoaded;
+		ModelSettings m_Settings;
+		MemoryReport m_MemoryReport;
+
+		/* Packed Storage */
+		// Meshes sharing a material, drawn with one multi draw of the commands from FirstCommand on
+		struct MaterialRun
+		{
+			MeshMaterial Material;
+			uint32_t FirstCommand = 0;
+			uint32_t CommandCount = 0;
+		};
+
+		MeshArena m_Arena;
+		std::vector<MaterialRun> m_MaterialRuns;
+		Ref<VertexArray> m_VertexArray;
+		Ref<VertexBuffer> m_VertexBuffer;
+		Ref<IndexBuffer> m_IndexBuffer;
+		Ref<IndirectBuffer> m_IndirectBuffer;
+		glm::vec3 m_BoundsMin = glm::vec3(0.0f);
+		glm::vec3 m_BoundsExtent = glm::vec3(1.0f);
+		// Bounds of every mesh together, whatever the vertex format
+		glm::vec3 m_AABBMin = glm::vec3(0.0f);
+		glm::vec3 m_AABBMax = glm::vec3(0.0f);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,315 @@
+/*
+	Occlusion Culler
+
+	Software occlusion culling on the CPU. A few large occluder meshes are rasterized into a small
+	depth buffer in screen tiles, which run on a thread pool, and a depth pyramid is built from it.
+	Bounds are then tested against the pyramid level where they cover only a few texels.
+	Only pixels a triangle covers entirely are written, with the furthest depth the triangle has on
+	them, so nothing that shows through a part of a pixel is reported hidden. Coverage is tested at
+	the pixel centre against the edges moved inwards by half a pixel along x and y, which gives the
+	same answer as testing the four corners for the cost of one test. Pixels on an edge shared by two
+	triangles are covered by neither and keep the far depth, which only costs some culling.
+*/
+
+#include "gepch.h"
+#include "OcclusionCuller.h"
+
+#include "GameEngine/Core/ThreadPool.h"
+
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+namespace ge {
+
+	OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height)
+	{
+		Resize(width, height);
+	}
+
+	void OcclusionCuller::Resize(uint32_t width, uint32_t height)
+	{
+		m_Width = std::max(width, 1u);
+		m_Height = std::max(height, 1u);
+		m_TilesX = (m_Width + TileWidth - 1) / TileWidth;
+		m_TilesY = (m_Height + TileHeight - 1) / TileHeight;
+		m_Bins.resize(m_TilesX * m_TilesY);
+
+		m_Levels.clear();
+		uint32_t levelWidth = m_Width, levelHeight = m_Height;
+		while (true)
+		{
+			Level level;
+			level.Width = levelWidth;
+			level.Height = levelHeight;
+			level.Depth.assign((size_t)levelWidth * levelHeight, 1.0f);
+			m_Levels.push_back(std::move(level));
+
+			if (levelWidth == 1 && levelHeight == 1)
+				break;
+			levelWidth = std::max((levelWidth + 1) / 2, 1u);
+			levelHeight = std::max((levelHeight + 1) / 2, 1u);
+		}
+
+		m_Triangles.clear();
+		m_RasterizedCount = 0;
+	}
+
+	void OcclusionCuller::Begin(const glm::mat4& viewProjection)
+	{
+		m_ViewProjection = viewProjection;
+		m_Triangles.clear();
+		m_RasterizedCount = 0;
+		m_Statistics = Statistics();
+
+		for (Level& level : m_Levels)
+			std::fill(level.Depth.begin(), level.Depth.end(), 1.0f);
+	}
+
+	void OcclusionCuller::AddOccluder(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices, const glm::mat4& transform)
+	{
+		const glm::mat4 toClip = m_ViewProjection * transform;
+		std::vector<glm::vec4> clip(positions.size());
+		for (size_t i = 0; i < positions.size(); i++)
+			clip[i] = toClip * glm::vec4(positions[i], 1.0f);
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const glm::vec4 triangle[3] = { clip[indices[i]], clip[indices[i + 1]], clip[indices[i + 2]] };
+			AddTriangle(triangle);
+		}
+
+		m_Statistics.Occluders++;
+	}
+
+	void OcclusionCuller::AddTriangle(const glm::vec4 clip[3])
+	{
+		// Clip against the near plane (z = -w), which leaves at most four corners
+		glm::vec4 polygon[4];
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			const glm::vec4& a = clip[i];
+			const glm::vec4& b = clip[(i + 1) % 3];
+			const float da = a.z + a.w, db = b.z + b.w;
+			if (da >= 0.0f)
+				polygon[count++] = a;
+			if ((da >= 0.0f) != (db >= 0.0f))
+				polygon[count++] = a + (b - a) * (da / (da - db));
+		}
+
+		if (count < 3)
+			return;
+
+		glm::vec3 screen[4];
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const float w = std::max(polygon[i].w, 1e-6f);
+			screen[i] = glm::vec3((polygon[i].x / w * 0.5f + 0.5f) * m_Width, (polygon[i].y / w * 0.5f + 0.5f) * m_Height, polygon[i].z / w);
+		}
+
+		for (uint32_t i = 1; i + 1 < count; i++)
+		{
+			Triangle triangle;
+			triangle.V[0] = screen[0];
+			triangle.V[1] = screen[i];
+			triangle.V[2] = screen[i + 1];
+
+			// Back faces and degenerate triangles
+			const glm::vec3 e1 = triangle.V[1] - triangle.V[0];
+			const glm::vec3 e2 = triangle.V[2] - triangle.V[0];
+			if (e1.x * e2.y - e1.y * e2.x <= 0.0f)
+				continue;
+
+			// Pixels that can be inside the triangle entirely, triangles too small to cover one are dropped
+			const float minX = std::min({ triangle.V[0].x, triangle.V[1].x, triangle.V[2].x });
+			const float maxX = std::max({ triangle.V[0].x, triangle.V[1].x, triangle.V[2].x });
+			const float minY = std::min({ triangle.V[0].y, triangle.V[1].y, triangle.V[2].y });
+			const float maxY = std::max({ triangle.V[0].y, triangle.V[1].y, triangle.V[2].y });
+			triangle.MinX = std::max((int32_t)std::ceil(minX), 0);
+			triangle.MinY = std::max((int32_t)std::ceil(minY), 0);
+			triangle.MaxX = std::min((int32_t)std::floor(maxX) - 1, (int32_t)m_Width - 1);
+			triangle.MaxY = std::min((int32_t)std::floor(maxY) - 1, (int32_t)m_Height - 1);
+			if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+				continue;
+
+			m_Triangles.push_back(triangle);
+			m_Statistics.Triangles++;
+		}
+	}
+
+	void OcclusionCuller::Rasterize(ThreadPool* pool)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (std::vector<uint32_t>& bin : m_Bins)
+			bin.clear();
+
+		uint32_t busyTiles = 0;
+		for (size_t i = m_RasterizedCount; i < m_Triangles.size(); i++)
+		{
+			const Triangle& triangle = m_Triangles[i];
+			for (int32_t ty = triangle.MinY / (int32_t)TileHeight; ty <= triangle.MaxY / (int32_t)TileHeight; ty++)
+			{
+				for (int32_t tx = triangle.MinX / (int32_t)TileWidth; tx <= triangle.MaxX / (int32_t)TileWidth; tx++)
+				{
+					std::vector<uint32_t>& bin = m_Bins[ty * m_TilesX + tx];
+					busyTiles += bin.empty() ? 1 : 0;
+					bin.push_back((uint32_t)i);
+				}
+			}
+		}
+
+		// Tiles cover separate pixels, so they need no locking
+		const uint32_t tileCount = m_TilesX * m_TilesY;
+		if (pool && busyTiles > 1)
+		{
+			for (uint32_t tile = 0; tile < tileCount; tile++)
+			{
+				if (!m_Bins[tile].empty())
+					pool->Submit([this, tile]() { RasterizeTile(tile); });
+			}
+			pool->WaitIdle();
+		}
+		else
+		{
+			for (uint32_t tile = 0; tile < tileCount; tile++)
+				RasterizeTile(tile);
+		}
+
+		m_RasterizedCount = m_Triangles.size();
+		BuildPyramid();
+
+		m_Statistics.RasterTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void OcclusionCuller::RasterizeTile(uint32_t tile)
+	{
+		const int32_t tileX0 = (int32_t)((tile % m_TilesX) * TileWidth);
+		const int32_t tileY0 = (int32_t)((tile / m_TilesX) * TileHeight);
+		const int32_t tileX1 = std::min(tileX0 + (int32_t)TileWidth, (int32_t)m_Width) - 1;
+		const int32_t tileY1 = std::min(tileY0 + (int32_t)TileHeight, (int32_t)m_Height) - 1;
+		float* depth = m_Levels[0].Depth.data();
+
+		for (uint32_t index : m_Bins[tile])
+		{
+			const Triangle& triangle = m_Triangles[index];
+			const int32_t x0 = std::max(triangle.MinX, tileX0), x1 = std::min(triangle.MaxX, tileX1);
+			const int32_t y0 = std::max(triangle.MinY, tileY0), y1 = std::min(triangle.MaxY, tileY1);
+			if (x0 > x1 || y0 > y1)
+				continue;
+
+			// Edge functions A x + B y + C, positive inside. Over a pixel an edge function is lowest at the corner
+			// furthest along -(A, B), half a pixel in x and y from the centre, so moving each edge inwards by
+			// (|A| + |B|) / 2 makes the centre test pass only for pixels whose four corners are inside.
+			float A[3], B[3], C[3];
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				const glm::vec3& a = triangle.V[i];
+				const glm::vec3& b = triangle.V[(i + 1) % 3];
+				A[i] = a.y - b.y;
+				B[i] = b.x - a.x;
+				C[i] = -(A[i] * a.x + B[i] * a.y) - (std::abs(A[i]) + std::abs(B[i])) * 0.5f;
+			}
+
+			// Depth is linear in screen space. Each pixel takes the furthest depth on its square.
+			const glm::vec3 normal = glm::cross(triangle.V[1] - triangle.V[0], triangle.V[2] - triangle.V[0]);
+			const float dzdx = -normal.x / normal.z;
+			const float dzdy = -normal.y / normal.z;
+			const float z0 = triangle.V[0].z - dzdx * triangle.V[0].x - dzdy * triangle.V[0].y + 0.5f * (std::abs(dzdx) + std::abs(dzdy));
+
+			const float startX = (float)x0 + 0.5f;
+			const int32_t count = x1 - x0 + 1;
+			for (int32_t y = y0; y <= y1; y++)
+			{
+				const float centerY = (float)y + 0.5f;
+				const float e0 = A[0] * startX + B[0] * centerY + C[0];
+				const float e1 = A[1] * startX + B[1] * centerY + C[1];
+				const float e2 = A[2] * startX + B[2] * centerY + C[2];
+				const float z = z0 + dzdx * startX + dzdy * centerY;
+
+				// Branch free so the compiler can run it over several pixels at once
+				float* row = depth + (size_t)y * m_Width + x0;
+				for (int32_t x = 0; x < count; x++)
+				{
+					const float fx = (float)x;
+					const bool inside = (e0 + A[0] * fx >= 0.0f) & (e1 + A[1] * fx >= 0.0f) & (e2 + A[2] * fx >= 0.0f);
+					const float pixelDepth = z + dzdx * fx;
+					row[x] = inside && pixelDepth < row[x] ? pixelDepth : row[x];
+				}
+			}
+		}
+	}
+
+	void OcclusionCuller::BuildPyramid()
+	{
+		for (size_t l = 1; l < m_Levels.size(); l++)
+		{
+			const Level& source = m_Levels[l - 1];
+			Level& level = m_Levels[l];
+			for (uint32_t y = 0; y < level.Height; y++)
+			{
+				const uint32_t y0 = std::min(y * 2, source.Height - 1), y1 = std::min(y * 2 + 1, source.Height - 1);
+				for (uint32_t x = 0; x < level.Width; x++)
+				{
+					const uint32_t x0 = std::min(x * 2, source.Width - 1), x1 = std::min(x * 2 + 1, source.Width - 1);
+					level.Depth[(size_t)y * level.Width + x] = std::max(
+						std::max(source.Depth[(size_t)y0 * source.Width + x0], source.Depth[(size_t)y0 * source.Width + x1]),
+						std::max(source.Depth[(size_t)y1 * source.Width + x0], source.Depth[(size_t)y1 * source.Width + x1]));
+				}
+			}
+		}
+	}
+
+	bool OcclusionCuller::IsVisible(const BoundingBox& box) const
+	{
+		glm::vec3 ndcMin(FLT_MAX), ndcMax(-FLT_MAX);
+		for (uint32_t corner = 0; corner < 8; corner++)
+		{
+			const glm::vec3 position((corner & 1) ? box.Max.x : box.Min.x, (corner & 2) ? box.Max.y : box.Min.y, (corner & 4) ? box.Max.z : box.Min.z);
+			const glm::vec4 clip = m_ViewProjection * glm::vec4(position, 1.0f);
+
+			// Reaches past the near plane, so it is right in front of the camera
+			if (clip.z + clip.w <= 0.0f || clip.w <= 0.0f)
+				return true;
+
+			const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			ndcMin = glm::min(ndcMin, ndc);
+			ndcMax = glm::max(ndcMax, ndc);
+		}
+
+		// Off screen is for the frustum culler to decide
+		if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f || ndcMin.z > 1.0f)
+			return true;
+
+		auto toPixel = [](float ndc, uint32_t size)
+		{
+			return glm::clamp((int32_t)std::floor((ndc * 0.5f + 0.5f) * size), 0, (int32_t)size - 1);
+		};
+		const int32_t x0 = toPixel(ndcMin.x, m_Width), x1 = toPixel(ndcMax.x, m_Width);
+		const int32_t y0 = toPixel(ndcMin.y, m_Height), y1 = toPixel(ndcMax.y, m_Height);
+
+		// Smallest level where the rectangle covers at most 2x2 texels
+		uint32_t level = 0;
+		while (level + 1 < m_Levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+			level++;
+
+		const Level& depth = m_Levels[level];
+		float occluderDepth = -1.0f;
+		for (int32_t y = y0 >> level; y <= (y1 >> level); y++)
+		{
+			for (int32_t x = x0 >> level; x <= (x1 >> level); x++)
+				occluderDepth = std::max(occluderDepth, depth.Depth[(size_t)y * depth.Width + x]);
+		}
+
+		return ndcMin.z <= occluderDepth;
+	}
+
+	bool OcclusionCuller::Test(const BoundingBox& box)
+	{
+		const bool visible = IsVisible(box);
+		m_Statistics.Tested++;
+		m_Statistics.Occluded += visible ? 0 : 1;
+		return visible;
+	}
+}
@@ -0,0 +1,97 @@
+/*
+	Occlusion Culler
+
+	Software occlusion culling on the CPU. A few large occluder meshes are rasterized into a small
+	depth buffer in screen tiles, which run on a thread pool, and a depth pyramid is built from it.
+	Bounds are then tested against the pyramid level where they cover only a few texels.
+	Only pixels a triangle covers entirely are written, with the furthest depth the triangle has on
+	them, so nothing that shows through a part of a pixel is reported hidden. Coverage is tested at
+	the pixel centre against the edges moved inwards by half a pixel along x and y, which gives the
+	same answer as testing the four corners for the cost of one test. Pixels on an edge shared by two
+	triangles are covered by neither and keep the far depth, which only costs some culling.
+*/
+
+#pragma once
+
+#include "Frustum.h"
+
+#include "GameEngine/Core/Core.h"
+
+namespace ge {
+
+	class ThreadPool;
+
+	class OcclusionCuller
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t Occluders = 0;
+			uint32_t Triangles = 0;			// Occluder triangles left after clipping, back face culling and dropping those smaller than a pixel
+			uint32_t Tested = 0;
+			uint32_t Occluded = 0;
+			float RasterTime = 0.0f;		// Milliseconds spent rasterizing and building the pyramid
+		};
+
+		static constexpr uint32_t TileWidth = 32;
+		static constexpr uint32_t TileHeight = 32;
+
+		OcclusionCuller(uint32_t width = 256, uint32_t height = 128);
+
+		void Resize(uint32_t width, uint32_t height);
+
+		// Clears the depth buffer and the occluders for a new view
+		void Begin(const glm::mat4& viewProjection);
+
+		// Triangle list with counter clockwise front faces, transformed to clip space straight away
+		void AddOccluder(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices, const glm::mat4& transform);
+
+		// Rasterizes the occluders added since the last call and rebuilds the pyramid
+		void Rasterize(ThreadPool* pool = nullptr);
+		bool NeedsRasterize() const { return m_RasterizedCount < m_Triangles.size(); }
+
+		// False when the box is behind the occluders everywhere it covers. Call Rasterize first.
+		bool IsVisible(const BoundingBox& box) const;
+		// IsVisible that also counts into the statistics
+		bool Test(const BoundingBox& box);
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		// Normalized device depth from -1 (near) to 1 (far), rows from the bottom of the screen.
+		// Level 0 is the depth buffer, each level after it holds the furthest depth of 2x2 texels of the one before.
+		uint32_t GetLevelCount() const { return (uint32_t)m_Levels.size(); }
+		const std::vector<float>& GetLevel(uint32_t level) const { return m_Levels[level].Depth; }
+		uint32_t GetLevelWidth(uint32_t level) const { return m_Levels[level].Width; }
+		uint32_t GetLevelHeight(uint32_t level) const { return m_Levels[level].Height; }
+
+		const Statistics& GetStatistics() const { return m_Statistics; }
+	private:
+		// Screen space triangle, x and y in pixels and z in normalized device depth
+		struct Triangle
+		{
+			glm::vec3 V[3];
+			int32_t MinX, MinY, MaxX, MaxY;		// Pixels the triangle can cover entirely, inclusive
+		};
+
+		struct Level
+		{
+			uint32_t Width = 0, Height = 0;
+			std::vector<float> Depth;
+		};
+
+		void AddTriangle(const glm::vec4 clip[3]);
+		void RasterizeTile(uint32_t tile);
+		void BuildPyramid();
+	private:
+		uint32_t m_Width = 0, m_Height = 0;
+		uint32_t m_TilesX = 0, m_TilesY = 0;
+		glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+
+		std::vector<Triangle> m_Triangles;
+		size_t m_RasterizedCount = 0;
+		std::vector<std::vector<uint32_t>> m_Bins;		// Triangles to rasterize per tile
+
+		std::vector<Level> m_Levels;
+		Statistics m_Statistics;
+	};
+}
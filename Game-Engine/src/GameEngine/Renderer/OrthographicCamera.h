@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "Frustum.h"
+
 #include <glm/glm.hpp>
 
 namespace ge {
@@ -25,6 +27,7 @@ namespace ge {
 		const glm::mat4 GetProjectionMatrix() const { return m_ProjectionMatrix; }
 		const glm::mat4 GetViewMatrix() const { return m_ViewMatrix; }
 		const glm::mat4 GetViewProjectionMatrix() const { return m_ViewProjectionMatrix; }
+		Frustum GetFrustum() const { return Frustum(m_ViewProjectionMatrix); }
 	private:
 		void RecalculateViewMatrix();
 	private:
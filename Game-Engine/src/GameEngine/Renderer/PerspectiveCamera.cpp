@@ -30,7 +30,22 @@ namespace ge {
 	}
 
 	void PerspectiveCamera::LookAt(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up) {
-		m_ViewMatrix = glm::lookAt(position, target, up);
+		LookAlong(RVec3(position.x, position.y, position.z), target - position, up);
+	}
+
+	void PerspectiveCamera::LookAlong(const RVec3& position, const glm::vec3& direction, const glm::vec3& up)
+	{
+		m_Position = position;
+		m_ViewMatrix = glm::lookAt(glm::vec3(0.0f), direction, up);
+		m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
+	}
+
+	// Splits a view matrix with a translation into the position and the rotation
+	void PerspectiveCamera::SetViewMatrix(const glm::mat4& view)
+	{
+		const glm::vec3 position = glm::vec3(glm::inverse(view)[3]);
+		m_Position = RVec3(position.x, position.y, position.z);
+		m_ViewMatrix = glm::mat4(glm::mat3(view));
 		m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
 	}
 }
\ No newline at end of file
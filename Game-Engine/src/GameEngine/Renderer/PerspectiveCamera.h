@@ -6,6 +6,10 @@
 
 #pragma once
 
+#include "Frustum.h"
+
+#include "GameEngine/Math/Vector.h"
+
 #include <glm/glm.hpp>
 
 namespace ge {
@@ -16,17 +20,25 @@ namespace ge {
 
 		void SetProjection(float fov, float aspectRatio, float nearPlane, float farPlane);
 
+		// The position is kept at full precision and left out of the view matrix, which only rotates.
+		// Everything drawn with this camera is given relative to its position (see Renderer::GetRenderOrigin),
+		// so the floats reaching the GPU stay small however far the camera is from the world origin.
 		void LookAt(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up);
-		void SetViewMatrix(const glm::mat4& view) { m_ViewMatrix = view; m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix; }
+		void LookAlong(const RVec3& position, const glm::vec3& direction, const glm::vec3& up);
+		void SetViewMatrix(const glm::mat4& view);
+
+		const RVec3& GetPosition() const { return m_Position; }
 
 		const glm::mat4 GetProjectionMatrix() const { return m_ProjectionMatrix; }
 		const glm::mat4 GetViewMatrix() const { return m_ViewMatrix; }
 		const glm::mat4 GetViewProjectionMatrix() const { return m_ViewProjectionMatrix; }
+		Frustum GetFrustum() const { return Frustum(m_ViewProjectionMatrix); }
 	private:
 		void RecalculateViewMatrix();
 	private:
 		glm::mat4 m_ProjectionMatrix;
 		glm::mat4 m_ViewMatrix;
 		glm::mat4 m_ViewProjectionMatrix;
+		RVec3 m_Position;
 	};
 }
@@ -19,20 +19,26 @@ namespace ge {
 
 	}
 
+	// Movement is small, so it is worked out in floats and added to the position at full precision
+	static RVec3 ToRVec3(const glm::vec3& v)
+	{
+		return RVec3(v.x, v.y, v.z);
+	}
+
 	void PerspectiveCameraController::OnUpdate(DeltaTime dt)
 	{
-		m_Camera.LookAt(m_CameraPosition, m_CameraPosition + m_CameraFront, m_CameraUp);
+		m_Camera.LookAlong(m_CameraPosition, m_CameraFront, m_CameraUp);
 
 		// Camera Movement
 		if (Input::IsKeyPressed(GE_KEY_W))
-			m_CameraPosition += (m_CameraTranslationSpeed * dt) * m_CameraFront;
+			m_CameraPosition += ToRVec3((m_CameraTranslationSpeed * dt) * m_CameraFront);
 		else if (Input::IsKeyPressed(GE_KEY_S))
-			m_CameraPosition -= (m_CameraTranslationSpeed * dt) * m_CameraFront;
+			m_CameraPosition -= ToRVec3((m_CameraTranslationSpeed * dt) * m_CameraFront);
 
 		if (Input::IsKeyPressed(GE_KEY_A))
-			m_CameraPosition -= (m_CameraTranslationSpeed * dt) * glm::normalize(glm::cross(m_CameraFront, m_CameraUp));
+			m_CameraPosition -= ToRVec3((m_CameraTranslationSpeed * dt) * glm::normalize(glm::cross(m_CameraFront, m_CameraUp)));
 		else if (Input::IsKeyPressed(GE_KEY_D))
-			m_CameraPosition += (m_CameraTranslationSpeed * dt) * glm::normalize(glm::cross(m_CameraFront, m_CameraUp));
+			m_CameraPosition += ToRVec3((m_CameraTranslationSpeed * dt) * glm::normalize(glm::cross(m_CameraFront, m_CameraUp)));
 
 		if (Input::IsMouseButtonPressed(GE_MOUSE_BUTTON_MIDDLE))
 		{
@@ -116,7 +122,7 @@ namespace ge {
 	void PerspectiveCameraController::MousePan(const glm::vec2& delta)
 	{
 		float panSpeed = 1.0f;
-		float distance = glm::length(m_CameraPosition);
+		float distance = (float)std::sqrt(m_CameraPosition.GetMag2());
 		m_Yaw += delta.x * panSpeed * distance;
 		m_Pitch -= delta.y * panSpeed * distance;
 
@@ -28,8 +28,8 @@ namespace ge {
 		float GetZoomLevel() const { return m_ZoomLevel; }
 		void SetZoomLevel(float level) { m_ZoomLevel = level; }
 
-		glm::vec3 GetCameraPosition() const { return m_CameraPosition; }
-		void SetCameraPosition(glm::vec3 pos) { m_CameraPosition = pos; }
+		const RVec3& GetCameraPosition() const { return m_CameraPosition; }
+		void SetCameraPosition(const RVec3& pos) { m_CameraPosition = pos; }
 
 		glm::vec3 GetCameraFront() const { return m_CameraFront; }
 		void SetCameraFront(glm::vec3 front) { m_CameraFront = front; }
@@ -51,7 +51,7 @@ namespace ge {
 		PerspectiveCamera m_Camera;
 
 		//glm::vec3 m_CameraPosition = { -2.0f, -2.0f, 4.0f };
-		glm::vec3 m_CameraPosition = { 0.0f, 0.0f, 16.0f };
+		RVec3 m_CameraPosition = { 0.0f, 0.0f, 16.0f };
 		glm::vec3 m_CameraFront = { 0.0f, 0.0f, -1.0f };
 		glm::vec3 m_CameraUp = { 0.0f, 1.0f, 0.0f };
 		glm::vec2 m_initialMousePosition = { 0.0f, 0.0f };
@@ -7,9 +7,17 @@
 #include "gepch.h"
 #include "RenderCommand.h"
 
-#include "Platform/OpenGL/OpenGLRendererAPI.h"
-
 namespace ge {
 
-	RendererAPI* RenderCommand::s_RendererAPI = new OpenGLRendererAPI();
+	RendererAPI* RenderCommand::s_RendererAPI = RendererAPI::Create();
+
+	void RenderCommand::SetAPI(RendererAPI::API api)
+	{
+		if (api == RendererAPI::GetAPI())
+			return;
+
+		RendererAPI::SetAPI(api);
+		delete s_RendererAPI;
+		s_RendererAPI = RendererAPI::Create();
+	}
 }
\ No newline at end of file
@@ -14,6 +14,9 @@ namespace ge {
 	class RenderCommand 
 	{
 	public:
+		// Switches the API commands go to, before Renderer::Init and before any resource is created
+		static void SetAPI(RendererAPI::API api);
+
 		inline static void Init()
 		{
 			s_RendererAPI->Init();
@@ -64,9 +67,26 @@ namespace ge {
 			s_RendererAPI->DrawIndexed(vertexArray);
 		}
 
-		inline static void DrawIndexed(const std::vector<unsigned int> indices)
+		inline static void DrawIndexed(uint32_t indexCount)
+		{
+			s_RendererAPI->DrawIndexed(indexCount);
+		}
+
+		// Triangle list, binds the vertex array
+		inline static void DrawIndexedRange(const std::shared_ptr<VertexArray>& vertexArray, uint32_t count, uint32_t firstIndex = 0, int32_t baseVertex = 0)
+		{
+			s_RendererAPI->DrawIndexedRange(vertexArray, count, firstIndex, baseVertex);
+		}
+
+		inline static void MultiDrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, const IndexedDrawRange* draws, uint32_t drawCount)
 		{
-			s_RendererAPI->DrawIndexed(indices);
+			s_RendererAPI->MultiDrawIndexed(vertexArray, draws, drawCount);
+		}
+
+		// Triangle lists, the draw arguments are read from the indirect buffer
+		inline static void MultiDrawIndexedIndirect(const std::shared_ptr<VertexArray>& vertexArray, const std::shared_ptr<IndirectBuffer>& commands, uint32_t drawCount, uint32_t firstCommand = 0)
+		{
+			s_RendererAPI->MultiDrawIndexedIndirect(vertexArray, commands, drawCount, firstCommand);
 		}
 
 		inline static void DrawVertices(int vertices)
@@ -78,6 +98,31 @@ namespace ge {
 		{
 			s_RendererAPI->DrawVerticesStrip(vertices);
 		}
+
+		inline static void DrawIndexedTriangles(uint32_t indexCount)
+		{
+			s_RendererAPI->DrawIndexedTriangles(indexCount);
+		}
+
+		inline static void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance = 0)
+		{
+			s_RendererAPI->DrawIndexedInstanced(indexCount, instanceCount, baseInstance);
+		}
+
+		inline static void DrawVerticesInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance = 0)
+		{
+			s_RendererAPI->DrawVerticesInstanced(vertexCount, instanceCount, baseInstance);
+		}
+
+		inline static const RendererAPI::StateStatistics& GetStateStatistics()
+		{
+			return s_RendererAPI->GetStateStatistics();
+		}
+
+		inline static void ResetStateStatistics()
+		{
+			s_RendererAPI->ResetStateStatistics();
+		}
 	private:
 		static RendererAPI* s_RendererAPI;
 	};
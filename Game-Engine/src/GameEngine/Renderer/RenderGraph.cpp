@@ -0,0 +1,429 @@
+/*
+	Render Graph
+
+	Describes a frame as passes that declare the framebuffers they read and write. Compiling the graph
+	culls the passes nothing needs, orders the rest by their dependencies and places the transient
+	framebuffers so ones whose lifetimes don't overlap share the same framebuffer. Compiling runs on the
+	CPU only, executing takes the framebuffers from a pool for just the passes using them.
+*/
+
+#include "gepch.h"
+#include "RenderGraph.h"
+
+#include "RenderCommand.h"
+
+namespace ge {
+
+	static void AddUnique(std::vector<uint32_t>& values, uint32_t value)
+	{
+		if (std::find(values.begin(), values.end(), value) == values.end())
+			values.push_back(value);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////
+	// Builder //////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+
+	RenderGraphResource RenderGraphBuilder::Create(const std::string& name, const FramebufferDesc& desc)
+	{
+		return m_Graph.Create(name, desc);
+	}
+
+	// Unknown resources are kept so Compile can report them
+	RenderGraphResource RenderGraphBuilder::Read(RenderGraphResource resource)
+	{
+		AddUnique(m_Graph.m_Passes[m_Pass].Reads, resource);
+		return resource;
+	}
+
+	RenderGraphResource RenderGraphBuilder::Write(RenderGraphResource resource)
+	{
+		AddUnique(m_Graph.m_Passes[m_Pass].Writes, resource);
+		return resource;
+	}
+
+	void RenderGraphBuilder::SetSideEffect()
+	{
+		m_Graph.m_Passes[m_Pass].SideEffect = true;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////
+	// Context //////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+
+	const Ref<Framebuffer>& RenderGraphContext::GetFramebuffer(RenderGraphResource resource) const
+	{
+		const RenderGraph::Resource& data = m_Graph.m_Resources[resource];
+		if (data.Imported)
+			return data.ImportedFramebuffer;
+
+		GE_CORE_ASSERT(data.Allocation != RenderGraph::Invalid, "Render graph resource is not used by any pass!");
+		return m_Graph.m_Allocations[data.Allocation].FramebufferPtr;
+	}
+
+	const FramebufferDesc& RenderGraphContext::GetDesc(RenderGraphResource resource) const
+	{
+		return m_Graph.m_Resources[resource].Desc;
+	}
+
+	void RenderGraphContext::BindTarget(RenderGraphResource resource) const
+	{
+		const Ref<Framebuffer>& framebuffer = GetFramebuffer(resource);
+		if (framebuffer)
+			framebuffer->Bind();
+		else if (m_BoundFramebuffer)
+			m_BoundFramebuffer->Unbind();
+		m_BoundFramebuffer = framebuffer.get();
+
+		const FramebufferDesc& desc = GetDesc(resource);
+		RenderCommand::SetViewport(0, 0, desc.Width, desc.Height);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////
+	// Graph ////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+
+	RenderGraphResource RenderGraph::Import(const std::string& name, const Ref<Framebuffer>& framebuffer, const FramebufferDesc& desc)
+	{
+		Resource resource;
+		resource.Name = name;
+		resource.Desc = desc;
+		resource.Imported = true;
+		resource.ImportedFramebuffer = framebuffer;
+		m_Resources.push_back(resource);
+		m_Compiled = false;
+		return (RenderGraphResource)m_Resources.size() - 1;
+	}
+
+	RenderGraphResource RenderGraph::Create(const std::string& name, const FramebufferDesc& desc)
+	{
+		Resource resource;
+		resource.Name = name;
+		resource.Desc = desc;
+		m_Resources.push_back(resource);
+		m_Compiled = false;
+		return (RenderGraphResource)m_Resources.size() - 1;
+	}
+
+	uint32_t RenderGraph::AddPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute)
+	{
+		const uint32_t index = (uint32_t)m_Passes.size();
+		m_Passes.emplace_back();
+		m_Passes.back().Name = name;
+		m_Passes.back().Execute = execute;
+
+		RenderGraphBuilder builder(*this, index);
+		setup(builder);
+
+		m_Compiled = false;
+		return index;
+	}
+
+	bool RenderGraph::Compile()
+	{
+		m_Compiled = false;
+		m_ExecutionOrder.clear();
+		m_Allocations.clear();
+		m_Statistics = Statistics();
+		m_Statistics.Passes = (uint32_t)m_Passes.size();
+
+		for (Resource& resource : m_Resources)
+		{
+			resource.Writers.clear();
+			resource.Allocation = Invalid;
+		}
+		for (Pass& pass : m_Passes)
+		{
+			pass.Dependencies.clear();
+			pass.RunsAfter.clear();
+			pass.Culled = true;
+		}
+
+		if (!BuildDependencies())
+			return false;
+
+		CullPasses();
+		if (!OrderPasses())
+			return false;
+		AllocateResources();
+
+		m_Compiled = true;
+		return true;
+	}
+
+	// Passes are walked in the order they were added and see a resource as the passes before them left it.
+	// A pass reading a resource runs after the last pass before it that wrote it, a pass writing it runs
+	// after that writer too and after every pass that read the previous contents, so it can't overwrite
+	// them while they are still needed.
+	bool RenderGraph::BuildDependencies()
+	{
+		bool valid = true;
+
+		for (const Resource& resource : m_Resources)
+		{
+			if (!resource.Imported && (resource.Desc.Width == 0 || resource.Desc.Height == 0))
+			{
+				GE_CORE_ERROR("Render graph resource '{0}' has no size", resource.Name);
+				valid = false;
+			}
+		}
+
+		// Per resource, the last pass so far that wrote it and the passes that read it since
+		std::vector<uint32_t> lastWriters(m_Resources.size(), Invalid);
+		std::vector<std::vector<uint32_t>> readers(m_Resources.size());
+
+		for (uint32_t p = 0; p < (uint32_t)m_Passes.size(); p++)
+		{
+			Pass& pass = m_Passes[p];
+			for (RenderGraphResource resource : pass.Reads)
+			{
+				if (!IsValid(resource))
+				{
+					GE_CORE_ERROR("Render graph pass '{0}' reads an unknown resource", pass.Name);
+					valid = false;
+					continue;
+				}
+
+				// Imported framebuffers already hold something, transient ones only what a pass wrote
+				const Resource& data = m_Resources[resource];
+				if (lastWriters[resource] == Invalid && !data.Imported)
+				{
+					GE_CORE_ERROR("Render graph pass '{0}' reads '{1}' before any pass writes it", pass.Name, data.Name);
+					valid = false;
+					continue;
+				}
+
+				if (lastWriters[resource] != Invalid)
+					AddUnique(pass.Dependencies, lastWriters[resource]);
+				// A pass that also writes the resource orders the later writers itself
+				if (std::find(pass.Writes.begin(), pass.Writes.end(), resource) == pass.Writes.end())
+					readers[resource].push_back(p);
+			}
+
+			for (RenderGraphResource resource : pass.Writes)
+			{
+				if (!IsValid(resource))
+				{
+					GE_CORE_ERROR("Render graph pass '{0}' writes an unknown resource", pass.Name);
+					valid = false;
+					continue;
+				}
+
+				if (lastWriters[resource] != Invalid)
+					AddUnique(pass.Dependencies, lastWriters[resource]);
+				for (uint32_t reader : readers[resource])
+					AddUnique(pass.RunsAfter, reader);
+
+				lastWriters[resource] = p;
+				readers[resource].clear();
+				m_Resources[resource].Writers.push_back(p);
+			}
+		}
+
+		return valid;
+	}
+
+	// Passes with side effects or writing imported resources are kept, with every pass they depend on
+	void RenderGraph::CullPasses()
+	{
+		std::vector<uint32_t> stack;
+		for (uint32_t p = 0; p < (uint32_t)m_Passes.size(); p++)
+		{
+			bool root = m_Passes[p].SideEffect;
+			for (RenderGraphResource resource : m_Passes[p].Writes)
+				root |= m_Resources[resource].Imported;
+
+			if (root)
+			{
+				m_Passes[p].Culled = false;
+				stack.push_back(p);
+			}
+		}
+
+		while (!stack.empty())
+		{
+			const uint32_t p = stack.back();
+			stack.pop_back();
+			for (uint32_t dependency : m_Passes[p].Dependencies)
+			{
+				if (m_Passes[dependency].Culled)
+				{
+					m_Passes[dependency].Culled = false;
+					stack.push_back(dependency);
+				}
+			}
+		}
+
+		for (const Pass& pass : m_Passes)
+			m_Statistics.CulledPasses += pass.Culled ? 1 : 0;
+	}
+
+	// Topological order of the kept passes, ties go to the pass added first. A pass also waits for
+	// the kept readers of what it overwrites.
+	bool RenderGraph::OrderPasses()
+	{
+		const uint32_t passCount = (uint32_t)m_Passes.size();
+		std::vector<uint32_t> waitingOn(passCount, 0);
+		std::vector<std::vector<uint32_t>> dependents(passCount);
+		uint32_t keptCount = 0;
+		for (uint32_t p = 0; p < passCount; p++)
+		{
+			if (m_Passes[p].Culled)
+				continue;
+
+			keptCount++;
+			waitingOn[p] = (uint32_t)m_Passes[p].Dependencies.size();
+			for (uint32_t dependency : m_Passes[p].Dependencies)
+				dependents[dependency].push_back(p);
+			// Readers that were culled don't run, there is nothing to wait for
+			for (uint32_t reader : m_Passes[p].RunsAfter)
+			{
+				if (!m_Passes[reader].Culled)
+				{
+					waitingOn[p]++;
+					dependents[reader].push_back(p);
+				}
+			}
+		}
+
+		std::vector<uint32_t> ready;
+		for (uint32_t p = 0; p < passCount; p++)
+		{
+			if (!m_Passes[p].Culled && waitingOn[p] == 0)
+				ready.push_back(p);
+		}
+
+		while (!ready.empty())
+		{
+			auto first = std::min_element(ready.begin(), ready.end());
+			const uint32_t p = *first;
+			ready.erase(first);
+			m_ExecutionOrder.push_back(p);
+
+			for (uint32_t dependent : dependents[p])
+			{
+				if (--waitingOn[dependent] == 0)
+					ready.push_back(dependent);
+			}
+		}
+
+		if (m_ExecutionOrder.size() != keptCount)
+		{
+			for (uint32_t p = 0; p < passCount; p++)
+			{
+				if (!m_Passes[p].Culled && waitingOn[p] > 0)
+					GE_CORE_ERROR("Render graph pass '{0}' is part of a dependency cycle", m_Passes[p].Name);
+			}
+			m_ExecutionOrder.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	// Resources are placed in order of first use, each in the first framebuffer of the same size that is
+	// free by then. Framebuffers can't be resized cheaply, so only matching descriptions alias.
+	void RenderGraph::AllocateResources()
+	{
+		struct Lifetime
+		{
+			RenderGraphResource Resource;
+			uint32_t FirstUse;
+			uint32_t LastUse;
+		};
+
+		std::vector<Lifetime> lifetimes(m_Resources.size(), { Invalid, Invalid, 0 });
+		for (uint32_t position = 0; position < (uint32_t)m_ExecutionOrder.size(); position++)
+		{
+			const Pass& pass = m_Passes[m_ExecutionOrder[position]];
+			for (const std::vector<RenderGraphResource>* uses : { &pass.Reads, &pass.Writes })
+			{
+				for (RenderGraphResource resource : *uses)
+				{
+					if (m_Resources[resource].Imported)
+						continue;
+
+					Lifetime& lifetime = lifetimes[resource];
+					lifetime.Resource = resource;
+					lifetime.FirstUse = std::min(lifetime.FirstUse, position);
+					lifetime.LastUse = std::max(lifetime.LastUse, position);
+				}
+			}
+		}
+
+		lifetimes.erase(std::remove_if(lifetimes.begin(), lifetimes.end(),
+			[](const Lifetime& lifetime) { return lifetime.Resource == Invalid; }), lifetimes.end());
+		std::stable_sort(lifetimes.begin(), lifetimes.end(),
+			[](const Lifetime& a, const Lifetime& b) { return a.FirstUse < b.FirstUse; });
+
+		for (const Lifetime& lifetime : lifetimes)
+		{
+			Resource& resource = m_Resources[lifetime.Resource];
+
+			uint32_t allocation = Invalid;
+			for (uint32_t a = 0; a < (uint32_t)m_Allocations.size() && allocation == Invalid; a++)
+			{
+				if (m_Allocations[a].Desc == resource.Desc && m_Allocations[a].LastUse < lifetime.FirstUse)
+					allocation = a;
+			}
+
+			if (allocation == Invalid)
+			{
+				allocation = (uint32_t)m_Allocations.size();
+				m_Allocations.push_back({ resource.Desc, lifetime.FirstUse, lifetime.LastUse, nullptr });
+				m_Statistics.AllocatedMemory += resource.Desc.GetMemorySize();
+			}
+			m_Allocations[allocation].LastUse = lifetime.LastUse;
+			resource.Allocation = allocation;
+
+			m_Statistics.TransientResources++;
+			m_Statistics.TransientMemory += resource.Desc.GetMemorySize();
+		}
+
+		m_Statistics.Framebuffers = (uint32_t)m_Allocations.size();
+	}
+
+	void RenderGraph::Execute(FramebufferPool& pool)
+	{
+		GE_CORE_ASSERT(m_Compiled, "Render graph has to be compiled before it is executed!");
+		if (!m_Compiled)
+			return;
+
+		RenderGraphContext context(*this);
+		for (uint32_t position = 0; position < (uint32_t)m_ExecutionOrder.size(); position++)
+		{
+			for (Allocation& allocation : m_Allocations)
+			{
+				if (allocation.FirstUse == position)
+					allocation.FramebufferPtr = pool.Acquire(allocation.Desc);
+			}
+
+			const Pass& pass = m_Passes[m_ExecutionOrder[position]];
+			if (pass.Execute)
+				pass.Execute(context);
+
+			for (Allocation& allocation : m_Allocations)
+			{
+				if (allocation.LastUse == position)
+				{
+					pool.Release(allocation.FramebufferPtr);
+					allocation.FramebufferPtr = nullptr;
+				}
+			}
+		}
+
+		// Later draws go to the default framebuffer again, as they did before the graph ran
+		if (context.m_BoundFramebuffer)
+			context.m_BoundFramebuffer->Unbind();
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_Resources.clear();
+		m_Passes.clear();
+		m_ExecutionOrder.clear();
+		m_Allocations.clear();
+		m_Statistics = Statistics();
+		m_Compiled = false;
+	}
+}
@@ -0,0 +1,159 @@
+/*
+	Render Graph
+
+	Describes a frame as passes that declare the framebuffers they read and write. Compiling the graph
+	culls the passes nothing needs, orders the rest by their dependencies and places the transient
+	framebuffers so ones whose lifetimes don't overlap share the same framebuffer. Compiling runs on the
+	CPU only, executing takes the framebuffers from a pool for just the passes using them.
+*/
+
+#pragma once
+
+#include "FramebufferPool.h"
+
+#include <functional>
+
+namespace ge {
+
+	using RenderGraphResource = uint32_t;
+
+	class RenderGraph;
+
+	// Handed to a pass while it is added, to declare what it uses
+	class RenderGraphBuilder
+	{
+	public:
+		// Transient framebuffer, it lives from the first pass using it to the last one
+		RenderGraphResource Create(const std::string& name, const FramebufferDesc& desc);
+		RenderGraphResource Read(RenderGraphResource resource);
+		RenderGraphResource Write(RenderGraphResource resource);
+		// Keeps the pass even when nothing reads what it writes
+		void SetSideEffect();
+	private:
+		RenderGraphBuilder(RenderGraph& graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+		RenderGraph& m_Graph;
+		uint32_t m_Pass;
+
+		friend class RenderGraph;
+	};
+
+	// Handed to a pass while it executes
+	class RenderGraphContext
+	{
+	public:
+		// Null for the default framebuffer
+		const Ref<Framebuffer>& GetFramebuffer(RenderGraphResource resource) const;
+		const FramebufferDesc& GetDesc(RenderGraphResource resource) const;
+		// Binds the framebuffer and sets the viewport to its size
+		void BindTarget(RenderGraphResource resource) const;
+	private:
+		RenderGraphContext(const RenderGraph& graph) : m_Graph(graph) {}
+
+		const RenderGraph& m_Graph;
+		mutable const Framebuffer* m_BoundFramebuffer = nullptr;
+
+		friend class RenderGraph;
+	};
+
+	class RenderGraph
+	{
+	public:
+		static constexpr uint32_t Invalid = UINT32_MAX;
+
+		using SetupFunction = std::function<void(RenderGraphBuilder& builder)>;
+		using ExecuteFunction = std::function<void(const RenderGraphContext& context)>;
+
+		struct Statistics
+		{
+			uint32_t Passes = 0;
+			uint32_t CulledPasses = 0;
+			uint32_t TransientResources = 0;	// Used by a pass that is kept
+			uint32_t Framebuffers = 0;			// The transient resources are placed in
+			size_t TransientMemory = 0;			// Without aliasing
+			size_t AllocatedMemory = 0;			// With aliasing
+		};
+
+		// Framebuffer owned outside the graph, null stands for the default framebuffer.
+		// Passes writing an imported resource are never culled.
+		RenderGraphResource Import(const std::string& name, const Ref<Framebuffer>& framebuffer, const FramebufferDesc& desc);
+		// Transient framebuffer, for resources a pass added before its producer reads
+		RenderGraphResource Create(const std::string& name, const FramebufferDesc& desc);
+
+		uint32_t AddPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute);
+
+		// Validates the graph, culls and orders the passes and places the transient resources.
+		// Returns false and logs the problems when the graph is invalid.
+		bool Compile();
+		// Runs the kept passes in order. Transient framebuffers keep what an earlier user left in them,
+		// the first pass writing a resource should clear it. The pool's EndFrame is left to the caller.
+		void Execute(FramebufferPool& pool);
+		// Empties the graph for the next frame
+		void Reset();
+
+		// Results of Compile
+		const std::vector<uint32_t>& GetExecutionOrder() const { return m_ExecutionOrder; }
+		bool IsPassCulled(uint32_t pass) const { return m_Passes[pass].Culled; }
+		// Transient resources with the same allocation alias, Invalid for imported and unused ones
+		uint32_t GetAllocation(RenderGraphResource resource) const { return m_Resources[resource].Allocation; }
+		const Statistics& GetStatistics() const { return m_Statistics; }
+
+		uint32_t GetPassCount() const { return (uint32_t)m_Passes.size(); }
+		const std::string& GetPassName(uint32_t pass) const { return m_Passes[pass].Name; }
+		uint32_t GetResourceCount() const { return (uint32_t)m_Resources.size(); }
+		const std::string& GetResourceName(RenderGraphResource resource) const { return m_Resources[resource].Name; }
+	private:
+		struct Resource
+		{
+			std::string Name;
+			FramebufferDesc Desc;
+			bool Imported = false;
+			Ref<Framebuffer> ImportedFramebuffer;
+
+			// Filled by Compile, writers in the order the passes were added
+			std::vector<uint32_t> Writers;
+			uint32_t Allocation = Invalid;
+		};
+
+		struct Pass
+		{
+			std::string Name;
+			ExecuteFunction Execute;
+			std::vector<RenderGraphResource> Reads;
+			std::vector<RenderGraphResource> Writes;
+			bool SideEffect = false;
+
+			// Filled by Compile. Dependencies produce what the pass uses and are kept with it, the passes
+			// in RunsAfter read what it overwrites and only order it when they are kept themselves.
+			std::vector<uint32_t> Dependencies;
+			std::vector<uint32_t> RunsAfter;
+			bool Culled = true;
+		};
+
+		// Framebuffer shared by transient resources, used from the first to the last pass of any of them
+		struct Allocation
+		{
+			FramebufferDesc Desc;
+			uint32_t FirstUse;
+			uint32_t LastUse;
+			Ref<Framebuffer> FramebufferPtr;
+		};
+
+		bool BuildDependencies();
+		void CullPasses();
+		bool OrderPasses();
+		void AllocateResources();
+		bool IsValid(RenderGraphResource resource) const { return resource < m_Resources.size(); }
+	private:
+		std::vector<Resource> m_Resources;
+		std::vector<Pass> m_Passes;
+
+		std::vector<uint32_t> m_ExecutionOrder;
+		std::vector<Allocation> m_Allocations;
+		Statistics m_Statistics;
+		bool m_Compiled = false;
+
+		friend class RenderGraphBuilder;
+		friend class RenderGraphContext;
+	};
+}
@@ -0,0 +1,321 @@
+/*
+	Render Queue
+
+	Draws submitted to the renderer are stored as small packets with a 64 bit sort key.
+	When the queue is flushed the packets are radix sorted and executed through a backend,
+	which only changes state when the next packet needs something different.
+*/
+
+#include "gepch.h"
+#include "RenderQueue.h"
+
+#include "RenderCommand.h"
+
+#include <cstring>
+
+namespace ge {
+
+	///////////////////////////////////////////////////////////////////////
+	// Sort Key ///////////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	uint64_t RenderSortKey::Encode(RenderPass pass, uint16_t shader, uint16_t material, float depth, uint16_t vertexArray)
+	{
+		const uint64_t passBits = (uint64_t)pass & 0xF;
+		const uint64_t shaderBits = (uint64_t)shader & 0xFFF;
+		const uint64_t materialBits = material;
+		const uint64_t vertexArrayBits = vertexArray;
+
+		if (pass == RenderPass::Transparent)
+		{
+			// Back to front
+			const uint64_t depthBits = (uint64_t)(0xFFFF - QuantizeDepth(depth));
+			return (passBits << 60) | (depthBits << 44) | (shaderBits << 32) | (materialBits << 16) | vertexArrayBits;
+		}
+
+		// Front to back inside each shader/material/vertex array bucket
+		// The vertex array comes before the depth so packets that can be instanced end up next to each other
+		const uint64_t depthBits = QuantizeDepth(depth);
+		return (passBits << 60) | (shaderBits << 48) | (materialBits << 32) | (vertexArrayBits << 16) | depthBits;
+	}
+
+	uint16_t RenderSortKey::QuantizeDepth(float depth)
+	{
+		// The bit pattern of a positive float increases with its value, so the top 16 bits
+		// give a logarithmic quantization that keeps its precision close to the camera
+		if (!(depth > 0.0f))
+			return 0;
+
+		uint32_t bits;
+		std::memcpy(&bits, &depth, sizeof(bits));
+		return (uint16_t)(bits >> 16);
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Instance Data //////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	const BufferLayout& InstanceData::GetLayout()
+	{
+		static const BufferLayout layout = {
+			{ ShaderDataType::Mat4, "a_InstanceTransform", false, 1 },
+			{ ShaderDataType::Float4, "a_InstanceColor", false, 1 },
+			{ ShaderDataType::Float4, "a_InstanceSecondaryColor", false, 1 }
+		};
+		return layout;
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Render Queue ///////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	// Packets can share an instanced draw when they only differ in their instance data
+	static bool CanInstance(const RenderPacket& a, const RenderPacket& b)
+	{
+		return a.ShaderPtr == b.ShaderPtr && a.MaterialPtr == b.MaterialPtr && a.VertexArrayPtr == b.VertexArrayPtr && a.Mode == b.Mode && a.Count == b.Count;
+	}
+
+	void RenderQueue::Submit(Shader* shader, VertexArray* vertexArray, DrawMode mode, uint32_t count, const InstanceData& instance,
+		float depth, RenderPass pass, const Material* material)
+	{
+		GE_CORE_ASSERT(!material || material->GetShader().get() == shader, "Material uses a different shader!");
+
+		const uint16_t materialKey = material ? material->GetSortKey() : 0;
+
+		RenderPacket packet;
+		packet.SortKey = RenderSortKey::Encode(pass, GetShaderID(shader), materialKey, depth, GetVertexArrayID(vertexArray));
+		packet.ShaderPtr = shader;
+		packet.MaterialPtr = material;
+		packet.VertexArrayPtr = vertexArray;
+		packet.Count = count;
+		packet.Mode = mode;
+		packet.Instance = instance;
+
+		m_Order.push_back({ packet.SortKey, (uint32_t)m_Packets.size() });
+		m_Packets.push_back(packet);
+	}
+
+	// LSD radix sort on the keys, 8 bits per pass. Passes where every key has the same digit are skipped,
+	// which is most of them as the keys of a frame share a lot of their bits.
+	void RenderQueue::Sort()
+	{
+		const size_t count = m_Order.size();
+		if (count < 2)
+			return;
+
+		m_SortScratch.resize(count);
+		SortEntry* src = m_Order.data();
+		SortEntry* dst = m_SortScratch.data();
+
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			uint32_t histogram[256] = {};
+			for (size_t i = 0; i < count; i++)
+				histogram[(src[i].Key >> shift) & 0xFF]++;
+
+			if (histogram[(src[0].Key >> shift) & 0xFF] == count)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				const uint32_t digitCount = histogram[i];
+				histogram[i] = offset;
+				offset += digitCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				dst[histogram[(src[i].Key >> shift) & 0xFF]++] = src[i];
+
+			std::swap(src, dst);
+		}
+
+		if (src != m_Order.data())
+			std::memcpy(m_Order.data(), src, count * sizeof(SortEntry));
+	}
+
+	void RenderQueue::Execute(RenderQueueBackend& backend, const glm::mat4& viewProjection)
+	{
+		const uint32_t count = (uint32_t)m_Order.size();
+		const uint32_t maxInstances = backend.GetMaxInstances();
+		m_Statistics.Packets += count;
+
+		Shader* currentShader = nullptr;
+		const Material* currentMaterial = nullptr;
+		VertexArray* currentVertexArray = nullptr;
+		uint32_t begin = 0;
+		while (begin < count)
+		{
+			// Group the packets into batches until the instance buffer is full, then upload the instance data once
+			m_Batches.clear();
+			m_InstanceData.clear();
+
+			uint32_t end = begin;
+			while (end < count)
+			{
+				const RenderPacket& packet = GetPacket(end);
+				if (!packet.ShaderPtr->IsInstanced())
+				{
+					m_Batches.push_back({ end, 1, 0, false });
+					end++;
+					continue;
+				}
+
+				const uint32_t space = maxInstances - (uint32_t)m_InstanceData.size();
+				if (space == 0)
+					break;
+
+				uint32_t runEnd = end + 1;
+				while (runEnd < count && runEnd - end < space && CanInstance(packet, GetPacket(runEnd)))
+					runEnd++;
+
+				m_Batches.push_back({ end, runEnd - end, (uint32_t)m_InstanceData.size(), true });
+				for (uint32_t i = end; i < runEnd; i++)
+					m_InstanceData.push_back(GetPacket(i).Instance);
+				end = runEnd;
+			}
+
+			if (!m_InstanceData.empty())
+				backend.UploadInstances(m_InstanceData.data(), (uint32_t)m_InstanceData.size());
+
+			for (const Batch& batch : m_Batches)
+			{
+				const RenderPacket& packet = GetPacket(batch.First);
+
+				if (packet.ShaderPtr != currentShader)
+				{
+					currentShader = packet.ShaderPtr;
+					backend.BindShader(currentShader);
+					// Uniforms live in the program so the view projection is only needed once per bind
+					backend.SetViewProjection(currentShader, viewProjection);
+					m_Statistics.ShaderBinds++;
+
+					// Uniforms of the previous program do not carry over
+					currentMaterial = nullptr;
+				}
+
+				if (packet.MaterialPtr && packet.MaterialPtr != currentMaterial)
+				{
+					currentMaterial = packet.MaterialPtr;
+					backend.BindMaterial(currentMaterial);
+					m_Statistics.MaterialBinds++;
+				}
+
+				if (packet.VertexArrayPtr != currentVertexArray)
+				{
+					currentVertexArray = packet.VertexArrayPtr;
+					backend.BindVertexArray(currentVertexArray);
+					m_Statistics.VertexArrayBinds++;
+				}
+
+				if (batch.Instanced)
+				{
+					backend.DrawInstanced(packet, batch.FirstInstance, batch.Count);
+					m_Statistics.InstancedDrawCalls++;
+					m_Statistics.Instances += batch.Count;
+				}
+				else
+				{
+					backend.Draw(packet);
+				}
+				m_Statistics.DrawCalls++;
+			}
+
+			begin = end;
+		}
+	}
+
+	// The ids only order the packets of one frame, so they are handed out again from 0 for the next.
+	// A shader or vertex array freed after this frame can't leave a stale id to the object reusing its address.
+	void RenderQueue::Clear()
+	{
+		m_Packets.clear();
+		m_Order.clear();
+		m_ShaderIDs.clear();
+		m_VertexArrayIDs.clear();
+	}
+
+	uint16_t RenderQueue::GetShaderID(const Shader* shader)
+	{
+		auto it = m_ShaderIDs.find(shader);
+		if (it != m_ShaderIDs.end())
+			return it->second;
+
+		const uint16_t id = (uint16_t)m_ShaderIDs.size();
+		m_ShaderIDs[shader] = id;
+		return id;
+	}
+
+	uint16_t RenderQueue::GetVertexArrayID(const VertexArray* vertexArray)
+	{
+		auto it = m_VertexArrayIDs.find(vertexArray);
+		if (it != m_VertexArrayIDs.end())
+			return it->second;
+
+		const uint16_t id = (uint16_t)m_VertexArrayIDs.size();
+		m_VertexArrayIDs[vertexArray] = id;
+		return id;
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Render Command Backend /////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	void RenderCommandQueueBackend::BindShader(Shader* shader)
+	{
+		shader->Bind();
+	}
+
+	static const UniformID s_ViewProjectionID("u_ViewProjection");
+	static const UniformID s_TransformID("u_Transform");
+
+	// Shaders that read the view projection from the Camera block have no such uniform, so this does nothing for them
+	void RenderCommandQueueBackend::SetViewProjection(Shader* shader, const glm::mat4& viewProjection)
+	{
+		shader->SetMat4(s_ViewProjectionID, viewProjection);
+	}
+
+	void RenderCommandQueueBackend::BindMaterial(const Material* material)
+	{
+		material->Upload();
+	}
+
+	void RenderCommandQueueBackend::BindVertexArray(VertexArray* vertexArray)
+	{
+		vertexArray->Bind();
+	}
+
+	void RenderCommandQueueBackend::Draw(const RenderPacket& packet)
+	{
+		packet.ShaderPtr->SetMat4(s_TransformID, packet.Instance.Transform);
+
+		if (packet.Mode == DrawMode::Indexed)
+			RenderCommand::DrawIndexed(packet.Count);
+		else
+			RenderCommand::DrawVertices(packet.Count);
+	}
+
+	void RenderCommandQueueBackend::UploadInstances(const InstanceData* instances, uint32_t count)
+	{
+		if (!m_InstanceBuffer)
+		{
+			m_InstanceBuffer.reset(VertexBuffer::Create(MaxInstances * sizeof(InstanceData)));
+			m_InstanceBuffer->SetLayout(InstanceData::GetLayout());
+		}
+
+		m_InstanceBuffer->SetData(instances, count * sizeof(InstanceData));
+	}
+
+	void RenderCommandQueueBackend::DrawInstanced(const RenderPacket& packet, uint32_t firstInstance, uint32_t instanceCount)
+	{
+		// Vertex arrays pick up the instance buffer the first time they are drawn instanced
+		const auto& vertexBuffers = packet.VertexArrayPtr->GetVertexBuffers();
+		if (std::find(vertexBuffers.begin(), vertexBuffers.end(), m_InstanceBuffer) == vertexBuffers.end())
+			packet.VertexArrayPtr->AddVertexBuffer(m_InstanceBuffer, InstanceData::FirstAttributeIndex);
+
+		if (packet.Mode == DrawMode::Indexed)
+			RenderCommand::DrawIndexedInstanced(packet.Count, instanceCount, firstInstance);
+		else
+			RenderCommand::DrawVerticesInstanced(packet.Count, instanceCount, firstInstance);
+	}
+}
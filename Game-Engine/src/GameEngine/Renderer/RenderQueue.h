@@ -0,0 +1,216 @@
+/*
+	Render Queue
+
+	Draws submitted to the renderer are stored as small packets with a 64 bit sort key.
+	When the queue is flushed the packets are radix sorted and executed through a backend,
+	which only changes state when the next packet needs something different.
+	Runs of packets with the same instanced shader and vertex array become one instanced draw.
+*/
+
+#pragma once
+
+#include "Shader.h"
+#include "Material.h"
+#include "VertexArray.h"
+
+#include <glm/glm.hpp>
+
+namespace ge {
+
+	enum class RenderPass : uint8_t
+	{
+		Opaque = 0, Transparent = 1
+	};
+
+	enum class DrawMode : uint8_t
+	{
+		Indexed = 0, Vertices = 1
+	};
+
+	// Sort key layout (most significant bits first)
+	// Opaque:		| pass 4 | shader 12 | material 16 | vertex array 16 | depth 16 (front to back) |
+	// Transparent:	| pass 4 | depth 16 (back to front) | shader 12 | material 16 | vertex array 16 |
+	struct RenderSortKey
+	{
+		static uint64_t Encode(RenderPass pass, uint16_t shader, uint16_t material, float depth, uint16_t vertexArray);
+
+		// Maps a view space depth to 16 bits that sort in the same order as the depth
+		static uint16_t QuantizeDepth(float depth);
+	};
+
+	// Data of one draw that instanced shaders read from vertex attributes. Shaders that are not instanced
+	// only get the transform, through the u_Transform uniform.
+	struct InstanceData
+	{
+		glm::mat4 Transform;
+		glm::vec4 Color = glm::vec4(1.0f);
+		glm::vec4 SecondaryColor = glm::vec4(1.0f);
+
+		// The attributes are bound to these locations in every shader, after anything a vertex array uses
+		static constexpr uint32_t FirstAttributeIndex = 8;
+		// Bump when the attributes change, cached shader binaries keep the locations they were linked with
+		static constexpr uint32_t LayoutVersion = 1;
+
+		static const BufferLayout& GetLayout();
+	};
+
+	// Plain data, the queue does not keep the shader or vertex array alive.
+	// Whatever is submitted has to outlive the next flush.
+	struct RenderPacket
+	{
+		uint64_t SortKey;
+		Shader* ShaderPtr;
+		const Material* MaterialPtr;	// Null when drawn with just a shader
+		VertexArray* VertexArrayPtr;
+		uint32_t Count;				// Number of indices or vertices to draw
+		DrawMode Mode;
+		InstanceData Instance;
+	};
+
+	// Executes packets. Kept separate from the queue so the sorting and state filtering can be exercised
+	// without a GPU (see RecordingRenderQueueBackend)
+	class RenderQueueBackend
+	{
+	public:
+		virtual ~RenderQueueBackend() = default;
+
+		virtual void BindShader(Shader* shader) = 0;
+		virtual void SetViewProjection(Shader* shader, const glm::mat4& viewProjection) = 0;
+		virtual void BindMaterial(const Material* material) = 0;
+		virtual void BindVertexArray(VertexArray* vertexArray) = 0;
+		virtual void Draw(const RenderPacket& packet) = 0;
+
+		// Instance data is uploaded before the draws that use it, up to GetMaxInstances() at a time
+		virtual uint32_t GetMaxInstances() const = 0;
+		virtual void UploadInstances(const InstanceData* instances, uint32_t count) = 0;
+		virtual void DrawInstanced(const RenderPacket& packet, uint32_t firstInstance, uint32_t instanceCount) = 0;
+	};
+
+	class RenderQueue
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t Packets = 0;
+			uint32_t DrawCalls = 0;
+			uint32_t InstancedDrawCalls = 0;
+			uint32_t Instances = 0;
+			uint32_t ShaderBinds = 0;
+			uint32_t MaterialBinds = 0;
+			uint32_t VertexArrayBinds = 0;
+		};
+
+	public:
+		// The material, when given, has to use the same shader
+		void Submit(Shader* shader, VertexArray* vertexArray, DrawMode mode, uint32_t count, const InstanceData& instance,
+			float depth, RenderPass pass = RenderPass::Opaque, const Material* material = nullptr);
+
+		// Sort is stable, so packets with equal keys keep their submission order
+		void Sort();
+		void Execute(RenderQueueBackend& backend, const glm::mat4& viewProjection);
+		void Clear();
+
+		bool IsEmpty() const { return m_Packets.empty(); }
+		uint32_t GetSize() const { return (uint32_t)m_Packets.size(); }
+		const RenderPacket& GetPacket(uint32_t index) const { return m_Packets[m_Order[index].Index]; }
+
+		const Statistics& GetStatistics() const { return m_Statistics; }
+		void ResetStatistics() { m_Statistics = Statistics(); }
+	private:
+		uint16_t GetShaderID(const Shader* shader);
+		uint16_t GetVertexArrayID(const VertexArray* vertexArray);
+	private:
+		struct SortEntry
+		{
+			uint64_t Key;
+			uint32_t Index;
+		};
+
+		// Consecutive sorted packets drawn with one call
+		struct Batch
+		{
+			uint32_t First;
+			uint32_t Count;
+			uint32_t FirstInstance;
+			bool Instanced;
+		};
+
+		std::vector<RenderPacket> m_Packets;
+		std::vector<SortEntry> m_Order;
+		std::vector<SortEntry> m_SortScratch;
+
+		std::vector<Batch> m_Batches;
+		std::vector<InstanceData> m_InstanceData;
+
+		// Small ids handed out in first seen order so they fit in the sort key, reset by Clear every frame
+		std::unordered_map<const Shader*, uint16_t> m_ShaderIDs;
+		std::unordered_map<const VertexArray*, uint16_t> m_VertexArrayIDs;
+
+		Statistics m_Statistics;
+	};
+
+	// Backend that draws through RenderCommand and the shader/vertex array objects
+	class RenderCommandQueueBackend : public RenderQueueBackend
+	{
+	public:
+		virtual void BindShader(Shader* shader) override;
+		virtual void SetViewProjection(Shader* shader, const glm::mat4& viewProjection) override;
+		virtual void BindMaterial(const Material* material) override;
+		virtual void BindVertexArray(VertexArray* vertexArray) override;
+		virtual void Draw(const RenderPacket& packet) override;
+
+		virtual uint32_t GetMaxInstances() const override { return MaxInstances; }
+		virtual void UploadInstances(const InstanceData* instances, uint32_t count) override;
+		virtual void DrawInstanced(const RenderPacket& packet, uint32_t firstInstance, uint32_t instanceCount) override;
+	private:
+		static constexpr uint32_t MaxInstances = 4096;
+
+		Ref<VertexBuffer> m_InstanceBuffer;		// Created on first use, it needs a context
+	};
+
+	// Backend that only records what it was asked to do, the engine tests check the sort order and state
+	// filtering with it
+	class RecordingRenderQueueBackend : public RenderQueueBackend
+	{
+	public:
+		enum class CommandType
+		{
+			BindShader, SetViewProjection, BindMaterial, BindVertexArray, Draw, UploadInstances, DrawInstanced
+		};
+
+		struct Command
+		{
+			CommandType Type;
+			const void* Object;
+			uint32_t Count;
+			uint32_t First;		// First instance of an instanced draw
+		};
+
+		RecordingRenderQueueBackend(uint32_t maxInstances = 1024) : m_MaxInstances(maxInstances) {}
+
+		virtual void BindShader(Shader* shader) override { m_Commands.push_back({ CommandType::BindShader, shader, 0, 0 }); }
+		virtual void SetViewProjection(Shader* shader, const glm::mat4& /*viewProjection*/) override { m_Commands.push_back({ CommandType::SetViewProjection, shader, 0, 0 }); }
+		virtual void BindMaterial(const Material* material) override { m_Commands.push_back({ CommandType::BindMaterial, material, 0, 0 }); }
+		virtual void BindVertexArray(VertexArray* vertexArray) override { m_Commands.push_back({ CommandType::BindVertexArray, vertexArray, 0, 0 }); }
+		virtual void Draw(const RenderPacket& packet) override { m_Commands.push_back({ CommandType::Draw, packet.VertexArrayPtr, packet.Count, 0 }); }
+
+		virtual uint32_t GetMaxInstances() const override { return m_MaxInstances; }
+		virtual void UploadInstances(const InstanceData* instances, uint32_t count) override
+		{
+			m_Instances.assign(instances, instances + count);
+			m_Commands.push_back({ CommandType::UploadInstances, nullptr, count, 0 });
+		}
+		virtual void DrawInstanced(const RenderPacket& packet, uint32_t firstInstance, uint32_t instanceCount) override
+		{
+			m_Commands.push_back({ CommandType::DrawInstanced, packet.VertexArrayPtr, instanceCount, firstInstance });
+		}
+
+		const std::vector<Command>& GetCommands() const { return m_Commands; }
+		const std::vector<InstanceData>& GetLastInstances() const { return m_Instances; }
+		void Clear() { m_Commands.clear(); m_Instances.clear(); }
+	private:
+		std::vector<Command> m_Commands;
+		std::vector<InstanceData> m_Instances;
+		uint32_t m_MaxInstances;
+	};
+}
@@ -7,11 +7,82 @@
 #include "gepch.h"
 #include "Renderer.h"
 
-#include "Platform/OpenGL/OpenGLShader.h"
+#include "UniformBuffer.h"
+
+#include "GameEngine/Core/ThreadPool.h"
 
 namespace ge {
 
 	Renderer::SceneData* Renderer::s_SceneData = new Renderer::SceneData;
+	RenderQueue* Renderer::s_RenderQueue = new RenderQueue;
+
+	static RenderCommandQueueBackend s_RenderCommandBackend;
+
+	// std140 layout of the Camera block
+	struct CameraBlock
+	{
+		glm::mat4 ViewProjection;
+		glm::mat4 View;
+		glm::mat4 Projection;
+		glm::vec4 Position;
+	};
+
+	// std140 layout of the Lights block, array elements are padded to a vec4
+	struct LightsBlock
+	{
+		glm::vec4 Positions[Renderer::MaxLights];
+		glm::vec4 Colors[Renderer::MaxLights];
+		int Count;
+	};
+
+	static Ref<UniformBuffer> s_CameraUniformBuffer;
+	static Ref<UniformBuffer> s_LightsUniformBuffer;
+	static LightsBlock s_Lights;
+	static bool s_LightsDirty = false;
+
+	// Written once per scene, every shader with a Camera block reads from it
+	static void UploadCamera(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection)
+	{
+		// Uniform buffers need a context, so they are made on first use
+		if (!s_CameraUniformBuffer)
+		{
+			s_CameraUniformBuffer = UniformBuffer::Create(sizeof(CameraBlock), UniformBlock::Camera);
+			s_LightsUniformBuffer = UniformBuffer::Create(sizeof(LightsBlock), UniformBlock::Lights);
+		}
+
+		CameraBlock camera;
+		camera.ViewProjection = viewProjection;
+		camera.View = view;
+		camera.Projection = projection;
+		camera.Position = glm::inverse(view)[3];
+		s_CameraUniformBuffer->SetData(&camera, sizeof(CameraBlock));
+
+		s_Lights.Count = 0;
+		s_LightsDirty = true;
+	}
+
+	// Draw held back until the flush culls it
+	struct CulledDraw
+	{
+		Shader* ShaderPtr;
+		const Material* MaterialPtr;
+		VertexArray* VertexArrayPtr;
+		InstanceData Instance;
+		float Depth;
+	};
+
+	static FrustumCuller s_Culler;
+	static std::vector<CulledDraw> s_CulledDraws;
+	static FrustumCuller::Statistics s_CullingStatistics;
+	static Scope<ThreadPool> s_CullingWorkers;		// Started by the first set large enough to split, or by occlusion culling
+	static OcclusionCuller s_OcclusionCuller;
+	static bool s_OcclusionCulling = false;
+
+	// Distance in front of the camera used for the depth part of the sort key
+	static float ViewDepth(const glm::mat4& viewMatrix, const glm::mat4& transform)
+	{
+		return -(viewMatrix * transform[3]).z;
+	}
 
 	void Renderer::Init()
 	{
@@ -26,58 +97,268 @@ namespace ge {
 	// Set up an Orthogonal Camera for the scene
 	void Renderer::BeginScene(OrthographicCamera& camera)
 	{
+		s_RenderQueue->Clear();
+		s_RenderQueue->ResetStatistics();
+		s_Culler.Clear();
+		s_CulledDraws.clear();
+		s_CullingStatistics = FrustumCuller::Statistics();
+
+		s_SceneData->RenderOrigin.Zero();
 		s_SceneData->ViewProjectionMatrix = camera.GetViewProjectionMatrix();
 		s_SceneData->ViewMatrix = camera.GetViewMatrix();
 		s_SceneData->ProjectionMatrix = camera.GetProjectionMatrix();
+		s_OcclusionCuller.Begin(s_SceneData->ViewProjectionMatrix);
+
+		UploadCamera(s_SceneData->ViewMatrix, s_SceneData->ProjectionMatrix, s_SceneData->ViewProjectionMatrix);
 	}
 
 	// Set up an Perspective Camera for the scene
 	void Renderer::BeginScene(PerspectiveCamera& camera)
 	{
+		s_RenderQueue->Clear();
+		s_RenderQueue->ResetStatistics();
+		s_Culler.Clear();
+		s_CulledDraws.clear();
+		s_CullingStatistics = FrustumCuller::Statistics();
+
+		// The camera's matrices leave out its position, which becomes the origin everything is drawn around
+		s_SceneData->RenderOrigin = camera.GetPosition();
 		s_SceneData->ViewProjectionMatrix = camera.GetViewProjectionMatrix();
 		s_SceneData->ViewMatrix = camera.GetViewMatrix();
 		s_SceneData->ProjectionMatrix = camera.GetProjectionMatrix();
+		s_OcclusionCuller.Begin(s_SceneData->ViewProjectionMatrix);
+
+		UploadCamera(s_SceneData->ViewMatrix, s_SceneData->ProjectionMatrix, s_SceneData->ViewProjectionMatrix);
 	}
 
 	void Renderer::EndScene()
 	{
-		// Does nothing for now
+		Flush();
+	}
+
+	// Culls the held back draws together and passes the visible ones to the queue
+	static void CullDraws(RenderQueue& queue, const glm::mat4& viewProjection)
+	{
+		if (s_CulledDraws.empty())
+			return;
+
+		if (!s_CullingWorkers && s_Culler.GetCount() >= FrustumCuller::ParallelThreshold)
+			s_CullingWorkers = std::make_unique<ThreadPool>();
+
+		// Occluders submitted since the last flush are drawn before the tests
+		const bool occlusion = s_OcclusionCulling && s_OcclusionCuller.GetStatistics().Triangles > 0;
+		if (occlusion)
+		{
+			if (!s_CullingWorkers)
+				s_CullingWorkers = std::make_unique<ThreadPool>();
+			if (s_OcclusionCuller.NeedsRasterize())
+				s_OcclusionCuller.Rasterize(s_CullingWorkers.get());
+		}
+
+		s_Culler.Cull(Frustum(viewProjection), s_CullingWorkers.get());
+		for (uint32_t index : s_Culler.GetVisible())
+		{
+			if (occlusion && !s_OcclusionCuller.Test(s_Culler.GetBox(index)))
+				continue;
+
+			const CulledDraw& draw = s_CulledDraws[index];
+			queue.Submit(draw.ShaderPtr, draw.VertexArrayPtr, DrawMode::Indexed, draw.VertexArrayPtr->GetIndexBuffer()->GetCount(),
+				draw.Instance, draw.Depth, RenderPass::Opaque, draw.MaterialPtr);
+		}
+
+		const FrustumCuller::Statistics& statistics = s_Culler.GetStatistics();
+		s_CullingStatistics.Tested += statistics.Tested;
+		s_CullingStatistics.Visible += statistics.Visible;
+		s_CullingStatistics.Culled += statistics.Culled;
+
+		s_Culler.Clear();
+		s_CulledDraws.clear();
+	}
+
+	void Renderer::Flush()
+	{
+		CullDraws(*s_RenderQueue, s_SceneData->ViewProjectionMatrix);
+
+		if (s_RenderQueue->IsEmpty())
+			return;
+
+		if (s_LightsDirty)
+		{
+			s_LightsUniformBuffer->SetData(&s_Lights, sizeof(LightsBlock));
+			s_LightsDirty = false;
+		}
+
+		s_RenderQueue->Sort();
+		s_RenderQueue->Execute(s_RenderCommandBackend, s_SceneData->ViewProjectionMatrix);
+		s_RenderQueue->Clear();
+	}
+
+	void Renderer::SubmitPointLight(const RVec3& position, const glm::vec3& color)
+	{
+		if (s_Lights.Count >= (int)MaxLights)
+		{
+			GE_CORE_WARN("Too many point lights submitted, only {0} are used", MaxLights);
+			return;
+		}
+
+		const Vec3 relative = (position - s_SceneData->RenderOrigin).ToVec3();
+		s_Lights.Positions[s_Lights.Count] = glm::vec4(relative.x, relative.y, relative.z, 1.0f);
+		s_Lights.Colors[s_Lights.Count] = glm::vec4(color, 1.0f);
+		s_Lights.Count++;
+		s_LightsDirty = true;
+	}
+
+	void Renderer::SubmitPointLight(const glm::vec3& position, const glm::vec3& color)
+	{
+		SubmitPointLight(RVec3(position.x, position.y, position.z), color);
+	}
+
+	const RenderQueue::Statistics& Renderer::GetQueueStatistics()
+	{
+		return s_RenderQueue->GetStatistics();
+	}
+
+	const FrustumCuller::Statistics& Renderer::GetCullingStatistics()
+	{
+		return s_CullingStatistics;
+	}
+
+	void Renderer::SetOcclusionCulling(bool enabled)
+	{
+		s_OcclusionCulling = enabled;
+	}
+
+	bool Renderer::IsOcclusionCullingEnabled()
+	{
+		return s_OcclusionCulling;
+	}
+
+	void Renderer::SubmitOccluder(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices, const glm::mat4& transform)
+	{
+		if (s_OcclusionCulling)
+			s_OcclusionCuller.AddOccluder(positions, indices, transform);
+	}
+
+	const OcclusionCuller::Statistics& Renderer::GetOcclusionStatistics()
+	{
+		return s_OcclusionCuller.GetStatistics();
+	}
+
+	OcclusionCuller& Renderer::GetOcclusionCuller()
+	{
+		return s_OcclusionCuller;
 	}
 
 	void Renderer::SetProjection(const std::shared_ptr<Shader>& shader, const glm::mat4& transform = glm::mat4(1.0f))
 	{
 		//shader->Bind();
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_ViewProjection", s_SceneData->ViewProjectionMatrix);
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_Transform", transform);
+		shader->SetMat4("u_ViewProjection", s_SceneData->ViewProjectionMatrix);
+		shader->SetMat4("u_Transform", transform);
 	}
 
-	// The vertex array will be submitted into a RenderCommand queue to be evaluated later and get rendered
-	// For now it is much simpler
+	// The vertex array is submitted into the render queue to be sorted and drawn when the queue is flushed
 	// Shader needs to be a parameter in submit because it can change for different objects in the scene
 	void Renderer::Submit(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, const glm::mat4& transform)
 	{
-		shader->Bind();
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_ViewProjection", s_SceneData->ViewProjectionMatrix);
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_Transform", transform);
+		InstanceData instance;
+		instance.Transform = transform;
 
-		vertexArray->Bind();
-		RenderCommand::DrawIndexed(vertexArray);
+		s_RenderQueue->Submit(shader.get(), vertexArray.get(), DrawMode::Indexed, vertexArray->GetIndexBuffer()->GetCount(),
+			instance, ViewDepth(s_SceneData->ViewMatrix, transform));
+	}
+
+	void Renderer::Submit(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+		const glm::vec4& color, const glm::vec4& secondaryColor)
+	{
+		InstanceData instance;
+		instance.Transform = transform;
+		instance.Color = color;
+		instance.SecondaryColor = secondaryColor;
+
+		s_RenderQueue->Submit(shader.get(), vertexArray.get(), DrawMode::Indexed, vertexArray->GetIndexBuffer()->GetCount(),
+			instance, ViewDepth(s_SceneData->ViewMatrix, transform));
+	}
+
+	// Material parameters are uploaded when the queue reaches the packet, the material has to outlive the flush
+	void Renderer::Submit(const Ref<Material>& material, const Ref<VertexArray>& vertexArray, const glm::mat4& transform)
+	{
+		InstanceData instance;
+		instance.Transform = transform;
+
+		s_RenderQueue->Submit(material->GetShader().get(), vertexArray.get(), DrawMode::Indexed, vertexArray->GetIndexBuffer()->GetCount(),
+			instance, ViewDepth(s_SceneData->ViewMatrix, transform), RenderPass::Opaque, material.get());
+	}
+
+	void Renderer::Submit(const Ref<Material>& material, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+		const glm::vec4& color, const glm::vec4& secondaryColor)
+	{
+		InstanceData instance;
+		instance.Transform = transform;
+		instance.Color = color;
+		instance.SecondaryColor = secondaryColor;
+
+		s_RenderQueue->Submit(material->GetShader().get(), vertexArray.get(), DrawMode::Indexed, vertexArray->GetIndexBuffer()->GetCount(),
+			instance, ViewDepth(s_SceneData->ViewMatrix, transform), RenderPass::Opaque, material.get());
 	}
 
 	// Use this function when there is no index buffer
 	void Renderer::Submit(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, unsigned int vertices, const glm::mat4& transform)
 	{
-		shader->Bind();
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_ViewProjection", s_SceneData->ViewProjectionMatrix);
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_Transform", transform);
+		InstanceData instance;
+		instance.Transform = transform;
 
-		vertexArray->Bind();
-		RenderCommand::DrawVertices(vertices);
+		s_RenderQueue->Submit(shader.get(), vertexArray.get(), DrawMode::Vertices, vertices,
+			instance, ViewDepth(s_SceneData->ViewMatrix, transform));
+	}
+
+	// Bounds go to the culler in world space, the draw waits next to them with the same index
+	template<typename Bounds>
+	static void HoldForCulling(Shader* shader, const Material* material, VertexArray* vertexArray, const glm::mat4& transform,
+		const Bounds& bounds, const glm::vec4& color, const glm::vec4& secondaryColor, const glm::mat4& viewMatrix)
+	{
+		CulledDraw draw;
+		draw.ShaderPtr = shader;
+		draw.MaterialPtr = material;
+		draw.VertexArrayPtr = vertexArray;
+		draw.Instance.Transform = transform;
+		draw.Instance.Color = color;
+		draw.Instance.SecondaryColor = secondaryColor;
+		draw.Depth = ViewDepth(viewMatrix, transform);
+
+		s_Culler.Add(bounds.Transform(transform));
+		s_CulledDraws.push_back(draw);
+	}
+
+	void Renderer::SubmitCulled(const Ref<Material>& material, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+		const BoundingSphere& bounds, const glm::vec4& color, const glm::vec4& secondaryColor)
+	{
+		HoldForCulling(material->GetShader().get(), material.get(), vertexArray.get(), transform, bounds, color, secondaryColor, s_SceneData->ViewMatrix);
+	}
+
+	void Renderer::SubmitCulled(const Ref<Material>& material, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+		const BoundingBox& bounds, const glm::vec4& color, const glm::vec4& secondaryColor)
+	{
+		HoldForCulling(material->GetShader().get(), material.get(), vertexArray.get(), transform, bounds, color, secondaryColor, s_SceneData->ViewMatrix);
+	}
+
+	void Renderer::SubmitCulled(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+		const BoundingSphere& bounds, const glm::vec4& color, const glm::vec4& secondaryColor)
+	{
+		HoldForCulling(shader.get(), nullptr, vertexArray.get(), transform, bounds, color, secondaryColor, s_SceneData->ViewMatrix);
+	}
+
+	void Renderer::SubmitCulled(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+		const BoundingBox& bounds, const glm::vec4& color, const glm::vec4& secondaryColor)
+	{
+		HoldForCulling(shader.get(), nullptr, vertexArray.get(), transform, bounds, color, secondaryColor, s_SceneData->ViewMatrix);
 	}
 
 	// Render framebuffer
+	// Drawn straight away, so anything queued before it is flushed first to keep the order
 	void Renderer::SubmitFramebuffer(const Ref<VertexArray>& vertexArray, unsigned int vertices)
 	{
+		Flush();
+
 		vertexArray->Bind();
 		RenderCommand::DrawVerticesStrip(vertices);
 	}
@@ -85,9 +366,11 @@ namespace ge {
 	// Render Skybox
 	void Renderer::SubmitSkybox(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, unsigned int vertices)
 	{
+		Flush();
+
 		shader->Bind();
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_View", glm::mat4(glm::mat3(s_SceneData->ViewMatrix)));  // remove translation from the view matrix
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_Projection", s_SceneData->ProjectionMatrix);
+		shader->SetMat4("u_View", glm::mat4(glm::mat3(s_SceneData->ViewMatrix)));  // remove translation from the view matrix
+		shader->SetMat4("u_Projection", s_SceneData->ProjectionMatrix);
 
 		vertexArray->Bind();
 		RenderCommand::DrawVertices(vertices);
@@ -10,6 +10,12 @@
 #include "OrthographicCamera.h"
 #include "PerspectiveCamera.h"
 #include "Shader.h"
+#include "Material.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+
+#include "GameEngine/Math/Vector.h"
 
 namespace ge {
 
@@ -22,13 +28,55 @@ namespace ge {
 		static void BeginScene(PerspectiveCamera& camera);
 		static void EndScene();
 
+		// Sorts and draws everything submitted so far. EndScene flushes on its own, call this before changing
+		// shader or texture state that earlier submissions depend on.
+		static void Flush();
+
+		// BeginScene sets the render origin to the camera's position, and the view matrix, the Camera block and
+		// the lights are all relative to it. Transforms given to Submit must be relative to it too: make world
+		// positions relative at full precision (see Body::GetRenderTransform) before converting them to floats.
+		static const RVec3& GetRenderOrigin() { return s_SceneData->RenderOrigin; }
+
 		static void SetProjection(const std::shared_ptr<Shader>& shader, const glm::mat4& transform);
 
 		static void Submit(const std::shared_ptr<Shader>& shader, const std::shared_ptr<VertexArray>& vertexArray, const glm::mat4& transform = glm::mat4(1.0f));
 		static void Submit(const std::shared_ptr<Shader>& shader, const std::shared_ptr<VertexArray>& vertexArray, unsigned int vertices, const glm::mat4& transform = glm::mat4(1.0f));
+		// Colours are per instance data, only shaders declaring a_InstanceColor / a_InstanceSecondaryColor read them
+		static void Submit(const std::shared_ptr<Shader>& shader, const std::shared_ptr<VertexArray>& vertexArray, const glm::mat4& transform,
+			const glm::vec4& color, const glm::vec4& secondaryColor = glm::vec4(1.0f));
+		static void Submit(const Ref<Material>& material, const Ref<VertexArray>& vertexArray, const glm::mat4& transform = glm::mat4(1.0f));
+		static void Submit(const Ref<Material>& material, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+			const glm::vec4& color, const glm::vec4& secondaryColor = glm::vec4(1.0f));
+		// Drawn only when the bounds, given in the space of the vertex array, are inside the camera's frustum.
+		// These draws are held back and culled together when the queue is flushed.
+		static void SubmitCulled(const Ref<Material>& material, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+			const BoundingSphere& bounds, const glm::vec4& color = glm::vec4(1.0f), const glm::vec4& secondaryColor = glm::vec4(1.0f));
+		static void SubmitCulled(const Ref<Material>& material, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+			const BoundingBox& bounds, const glm::vec4& color = glm::vec4(1.0f), const glm::vec4& secondaryColor = glm::vec4(1.0f));
+		static void SubmitCulled(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+			const BoundingSphere& bounds, const glm::vec4& color = glm::vec4(1.0f), const glm::vec4& secondaryColor = glm::vec4(1.0f));
+		static void SubmitCulled(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, const glm::mat4& transform,
+			const BoundingBox& bounds, const glm::vec4& color = glm::vec4(1.0f), const glm::vec4& secondaryColor = glm::vec4(1.0f));
+		// Occluders are drawn into a small depth buffer on the CPU while occlusion culling is on, and culled
+		// submissions hidden behind them are skipped. Use a few large, simple meshes, indices as triangle lists.
+		static void SetOcclusionCulling(bool enabled);
+		static bool IsOcclusionCullingEnabled();
+		static void SubmitOccluder(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices, const glm::mat4& transform);
 		static void SubmitFramebuffer(const std::shared_ptr<VertexArray>& vertexArray, unsigned int vertices);
 		static void SubmitSkybox(const std::shared_ptr<Shader>& shader, const std::shared_ptr<VertexArray>& vertexArray, unsigned int vertices);
 
+		// Lights are gathered for the current scene and uploaded to the Lights uniform block when the queue is flushed
+		static const uint32_t MaxLights = 4;
+		// Positions are in world space, the render origin is taken off before they are uploaded
+		static void SubmitPointLight(const RVec3& position, const glm::vec3& color);
+		static void SubmitPointLight(const glm::vec3& position, const glm::vec3& color);
+
+		static const RenderQueue::Statistics& GetQueueStatistics();
+		// Counts of the culled submissions since BeginScene
+		static const FrustumCuller::Statistics& GetCullingStatistics();
+		static const OcclusionCuller::Statistics& GetOcclusionStatistics();
+		static OcclusionCuller& GetOcclusionCuller();
+
 		inline static RendererAPI::API GetAPI() { return RendererAPI::GetAPI(); }
 	private:
 		struct SceneData 
@@ -36,8 +84,10 @@ namespace ge {
 			glm::mat4 ViewMatrix;
 			glm::mat4 ProjectionMatrix;
 			glm::mat4 ViewProjectionMatrix;
+			RVec3 RenderOrigin;
 		};
 
 		static SceneData* s_SceneData;
+		static RenderQueue* s_RenderQueue;
 	};
 }
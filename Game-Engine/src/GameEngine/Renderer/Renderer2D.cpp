@@ -0,0 +1,342 @@
+/*
+	Renderer 2D
+
+	Batch renderer for quads and sprites. Quads are transformed on the CPU and written into one
+	streaming vertex buffer, with up to MaxTextureSlots textures per draw call.
+*/
+
+#include "gepch.h"
+#include "Renderer2D.h"
+
+#include "RenderCommand.h"
+#include "Shader.h"
+#include "VertexArray.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace ge {
+
+	struct QuadVertex
+	{
+		glm::vec3 Position;
+		glm::vec4 Color;
+		glm::vec2 TexCoord;
+		float TexIndex;
+		float TilingFactor;
+	};
+
+	struct Renderer2DStorage
+	{
+		static const uint32_t MaxQuads = 10000;
+		static const uint32_t MaxVertices = MaxQuads * 4;
+		static const uint32_t MaxIndices = MaxQuads * 6;
+		static const uint32_t MaxTextureSlots = 16;		// Minimum number of fragment texture units OpenGL guarantees
+
+		Ref<VertexArray> QuadVertexArray;
+		Ref<VertexBuffer> QuadVertexBuffer;
+		Ref<Shader> QuadShader;
+		Ref<Texture2D> WhiteTexture;
+
+		uint32_t QuadIndexCount = 0;
+		QuadVertex* QuadVertexBufferBase = nullptr;
+		QuadVertex* QuadVertexBufferPtr = nullptr;
+
+		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
+		uint32_t TextureSlotIndex = 1;		// 0 = white texture
+
+		glm::vec4 QuadVertexPositions[4];
+
+		Renderer2D::Statistics Stats;
+	};
+
+	static Renderer2DStorage* s_Data = nullptr;
+
+	// Sampler arrays can only be indexed with constants in GLSL 330, so the lookup is a switch over the slots
+	static std::string QuadPixelSource()
+	{
+		std::string source = R"(
+			#version 330 core
+			layout(location = 0) out vec4 color;
+			in vec4 v_Color;
+			in vec2 v_TexCoord;
+			flat in float v_TexIndex;
+			in float v_TilingFactor;
+			uniform sampler2D u_Textures[)" + std::to_string(Renderer2DStorage::MaxTextureSlots) + R"(];
+			void main() {
+				vec2 texCoord = v_TexCoord * v_TilingFactor;
+				vec4 texColor = vec4(1.0);
+				switch (int(v_TexIndex)) {
+		)";
+
+		for (uint32_t i = 0; i < Renderer2DStorage::MaxTextureSlots; i++)
+		{
+			const std::string slot = std::to_string(i);
+			source += "\t\t\t\tcase " + slot + ": texColor = texture(u_Textures[" + slot + "], texCoord); break;\n";
+		}
+
+		source += R"(
+				}
+				color = texColor * v_Color;
+			}
+		)";
+		return source;
+	}
+
+	void Renderer2D::Init()
+	{
+		GE_CORE_ASSERT(!s_Data, "Renderer2D already initialized!");
+		s_Data = new Renderer2DStorage;
+
+		s_Data->QuadVertexArray.reset(VertexArray::Create());
+
+		s_Data->QuadVertexBuffer.reset(VertexBuffer::Create(Renderer2DStorage::MaxVertices * sizeof(QuadVertex)));
+		s_Data->QuadVertexBuffer->SetLayout({
+			{ ShaderDataType::Float3, "a_Position" },
+			{ ShaderDataType::Float4, "a_Color" },
+			{ ShaderDataType::Float2, "a_TexCoord" },
+			{ ShaderDataType::Float, "a_TexIndex" },
+			{ ShaderDataType::Float, "a_TilingFactor" }
+			});
+		s_Data->QuadVertexArray->AddVertexBuffer(s_Data->QuadVertexBuffer);
+
+		s_Data->QuadVertexBufferBase = new QuadVertex[Renderer2DStorage::MaxVertices];
+
+		// The index pattern never changes so it is only written once
+		uint32_t* quadIndices = new uint32_t[Renderer2DStorage::MaxIndices];
+		uint32_t offset = 0;
+		for (uint32_t i = 0; i < Renderer2DStorage::MaxIndices; i += 6)
+		{
+			quadIndices[i + 0] = offset + 0;
+			quadIndices[i + 1] = offset + 1;
+			quadIndices[i + 2] = offset + 2;
+
+			quadIndices[i + 3] = offset + 2;
+			quadIndices[i + 4] = offset + 3;
+			quadIndices[i + 5] = offset + 0;
+
+			offset += 4;
+		}
+
+		Ref<IndexBuffer> quadIB;
+		quadIB.reset(IndexBuffer::Create(quadIndices, Renderer2DStorage::MaxIndices));
+		s_Data->QuadVertexArray->SetIndexBuffer(quadIB);
+		delete[] quadIndices;
+
+		s_Data->WhiteTexture = Texture2D::Create(1, 1);
+		uint32_t whiteTextureData = 0xffffffff;
+		s_Data->WhiteTexture->SetData(&whiteTextureData, sizeof(uint32_t));
+
+		std::string vertexSrc = R"(
+			#version 330 core
+			layout(location = 0) in vec3 a_Position;
+			layout(location = 1) in vec4 a_Color;
+			layout(location = 2) in vec2 a_TexCoord;
+			layout(location = 3) in float a_TexIndex;
+			layout(location = 4) in float a_TilingFactor;
+			uniform mat4 u_ViewProjection;
+			out vec4 v_Color;
+			out vec2 v_TexCoord;
+			flat out float v_TexIndex;
+			out float v_TilingFactor;
+			void main() {
+				v_Color = a_Color;
+				v_TexCoord = a_TexCoord;
+				v_TexIndex = a_TexIndex;
+				v_TilingFactor = a_TilingFactor;
+				gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+			}
+		)";
+
+		s_Data->QuadShader = Shader::Create("Renderer2DQuad", vertexSrc, QuadPixelSource());
+
+		int samplers[Renderer2DStorage::MaxTextureSlots];
+		for (uint32_t i = 0; i < Renderer2DStorage::MaxTextureSlots; i++)
+			samplers[i] = i;
+
+		s_Data->QuadShader->Bind();
+		s_Data->QuadShader->SetIntArray("u_Textures", samplers, Renderer2DStorage::MaxTextureSlots);
+
+		s_Data->TextureSlots[0] = s_Data->WhiteTexture;
+
+		// Corners of a unit quad centred on the origin
+		s_Data->QuadVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
+		s_Data->QuadVertexPositions[1] = {  0.5f, -0.5f, 0.0f, 1.0f };
+		s_Data->QuadVertexPositions[2] = {  0.5f,  0.5f, 0.0f, 1.0f };
+		s_Data->QuadVertexPositions[3] = { -0.5f,  0.5f, 0.0f, 1.0f };
+	}
+
+	void Renderer2D::Shutdown()
+	{
+		delete[] s_Data->QuadVertexBufferBase;
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void Renderer2D::BeginScene(const OrthographicCamera& camera)
+	{
+		s_Data->QuadShader->Bind();
+		s_Data->QuadShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+
+		StartBatch();
+	}
+
+	void Renderer2D::EndScene()
+	{
+		Flush();
+	}
+
+	void Renderer2D::StartBatch()
+	{
+		s_Data->QuadIndexCount = 0;
+		s_Data->QuadVertexBufferPtr = s_Data->QuadVertexBufferBase;
+
+		s_Data->TextureSlotIndex = 1;
+	}
+
+	void Renderer2D::Flush()
+	{
+		if (s_Data->QuadIndexCount == 0)
+			return;
+
+		// One upload of only the part of the buffer that was written
+		uint32_t dataSize = (uint32_t)((uint8_t*)s_Data->QuadVertexBufferPtr - (uint8_t*)s_Data->QuadVertexBufferBase);
+		s_Data->QuadVertexBuffer->SetData(s_Data->QuadVertexBufferBase, dataSize);
+
+		for (uint32_t i = 0; i < s_Data->TextureSlotIndex; i++)
+			s_Data->TextureSlots[i]->Bind(i);
+
+		s_Data->QuadShader->Bind();
+		s_Data->QuadVertexArray->Bind();
+		RenderCommand::DrawIndexedTriangles(s_Data->QuadIndexCount);
+		s_Data->Stats.DrawCalls++;
+
+		StartBatch();
+	}
+
+	void Renderer2D::FlushAndReset()
+	{
+		Flush();
+		s_Data->Stats.FlushCount++;
+	}
+
+	// Slot of the texture in the current batch, flushes when every slot is taken
+	float Renderer2D::GetTextureIndex(const Ref<Texture2D>& texture)
+	{
+		for (uint32_t i = 1; i < s_Data->TextureSlotIndex; i++)
+		{
+			if (s_Data->TextureSlots[i].get() == texture.get())
+				return (float)i;
+		}
+
+		if (s_Data->TextureSlotIndex >= Renderer2DStorage::MaxTextureSlots)
+			FlushAndReset();
+
+		float textureIndex = (float)s_Data->TextureSlotIndex;
+		s_Data->TextureSlots[s_Data->TextureSlotIndex] = texture;
+		s_Data->TextureSlotIndex++;
+		return textureIndex;
+	}
+
+	void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+	{
+		DrawQuad({ position.x, position.y, 0.0f }, size, color);
+	}
+
+	void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color)
+	{
+		glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+		DrawQuad(transform, color);
+	}
+
+	void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor)
+	{
+		DrawQuad({ position.x, position.y, 0.0f }, size, texture, tilingFactor, tintColor);
+	}
+
+	void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor)
+	{
+		glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+		DrawQuad(transform, texture, tilingFactor, tintColor);
+	}
+
+	void Renderer2D::DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color)
+	{
+		DrawRotatedQuad({ position.x, position.y, 0.0f }, size, rotation, color);
+	}
+
+	void Renderer2D::DrawRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation, const glm::vec4& color)
+	{
+		glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
+			* glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })
+			* glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+		DrawQuad(transform, color);
+	}
+
+	void Renderer2D::DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor)
+	{
+		DrawRotatedQuad({ position.x, position.y, 0.0f }, size, rotation, texture, tilingFactor, tintColor);
+	}
+
+	void Renderer2D::DrawRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor)
+	{
+		glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
+			* glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })
+			* glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
+		DrawQuad(transform, texture, tilingFactor, tintColor);
+	}
+
+	void Renderer2D::DrawQuad(const glm::mat4& transform, const glm::vec4& color)
+	{
+		if (s_Data->QuadIndexCount >= Renderer2DStorage::MaxIndices)
+			FlushAndReset();
+
+		static const glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		const float textureIndex = 0.0f;		// White texture
+		const float tilingFactor = 1.0f;
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			s_Data->QuadVertexBufferPtr->Position = glm::vec3(transform * s_Data->QuadVertexPositions[i]);
+			s_Data->QuadVertexBufferPtr->Color = color;
+			s_Data->QuadVertexBufferPtr->TexCoord = textureCoords[i];
+			s_Data->QuadVertexBufferPtr->TexIndex = textureIndex;
+			s_Data->QuadVertexBufferPtr->TilingFactor = tilingFactor;
+			s_Data->QuadVertexBufferPtr++;
+		}
+
+		s_Data->QuadIndexCount += 6;
+		s_Data->Stats.QuadCount++;
+	}
+
+	void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor)
+	{
+		if (s_Data->QuadIndexCount >= Renderer2DStorage::MaxIndices)
+			FlushAndReset();
+
+		static const glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		const float textureIndex = GetTextureIndex(texture);
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			s_Data->QuadVertexBufferPtr->Position = glm::vec3(transform * s_Data->QuadVertexPositions[i]);
+			s_Data->QuadVertexBufferPtr->Color = tintColor;
+			s_Data->QuadVertexBufferPtr->TexCoord = textureCoords[i];
+			s_Data->QuadVertexBufferPtr->TexIndex = textureIndex;
+			s_Data->QuadVertexBufferPtr->TilingFactor = tilingFactor;
+			s_Data->QuadVertexBufferPtr++;
+		}
+
+		s_Data->QuadIndexCount += 6;
+		s_Data->Stats.QuadCount++;
+	}
+
+	const Renderer2D::Statistics& Renderer2D::GetStats()
+	{
+		return s_Data->Stats;
+	}
+
+	void Renderer2D::ResetStats()
+	{
+		s_Data->Stats = Statistics();
+	}
+}
@@ -0,0 +1,62 @@
+/*
+	Renderer 2D
+
+	Batch renderer for quads and sprites. Quads are transformed on the CPU and written into one
+	streaming vertex buffer, with up to MaxTextureSlots textures per draw call.
+*/
+
+#pragma once
+
+#include "OrthographicCamera.h"
+#include "Texture.h"
+
+#include <glm/glm.hpp>
+
+namespace ge {
+
+	class Renderer2D
+	{
+	public:
+		// Needs a graphics context
+		static void Init();
+		static void Shutdown();
+
+		static void BeginScene(const OrthographicCamera& camera);
+		static void EndScene();
+
+		// Draws the current batch, this happens on its own when the batch runs out of quads or texture slots
+		static void Flush();
+
+		// Primitives
+		static void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+		static void DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color);
+		static void DrawQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f));
+		static void DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f));
+
+		// Rotation is in radians around the z axis
+		static void DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color);
+		static void DrawRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation, const glm::vec4& color);
+		static void DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f));
+		static void DrawRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f));
+
+		static void DrawQuad(const glm::mat4& transform, const glm::vec4& color);
+		static void DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f));
+
+		struct Statistics
+		{
+			uint32_t DrawCalls = 0;
+			uint32_t QuadCount = 0;
+			uint32_t FlushCount = 0;		// Flushes forced by a full batch, the one at EndScene is not counted
+
+			uint32_t GetTotalVertexCount() const { return QuadCount * 4; }
+			uint32_t GetTotalIndexCount() const { return QuadCount * 6; }
+		};
+
+		static const Statistics& GetStats();
+		static void ResetStats();
+	private:
+		static void StartBatch();
+		static void FlushAndReset();
+		static float GetTextureIndex(const Ref<Texture2D>& texture);
+	};
+}
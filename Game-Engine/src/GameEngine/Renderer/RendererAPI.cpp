@@ -7,7 +7,24 @@
 #include "gepch.h"
 #include "RendererAPI.h"
 
+#include "Platform/OpenGL/OpenGLRendererAPI.h"
+#include "Platform/Software/SoftwareRendererAPI.h"
+
 namespace ge {
 	
 	RendererAPI::API RendererAPI::s_API = RendererAPI::API::OpenGL;
+
+	RendererAPI* RendererAPI::Create()
+	{
+		switch (s_API)
+		{
+		case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+		case RendererAPI::API::OpenGL:		return new OpenGLRendererAPI();
+		case RendererAPI::API::Software:	return new SoftwareRendererAPI();
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
 }
\ No newline at end of file
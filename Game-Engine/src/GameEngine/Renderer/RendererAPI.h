@@ -12,13 +12,31 @@
 
 namespace ge {
 
+	// One indexed draw out of a shared index buffer
+	struct IndexedDrawRange
+	{
+		uint32_t Count;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;		// Added to every index before fetching the vertex
+	};
+
 	// There will be an implementation of this class for each platform (ie. OpenGL, DirectX, Vulcan etc.)
 	class RendererAPI {
 	public:
 		enum class API {
-			None = 0, OpenGL = 1
+			None = 0, OpenGL = 1, Software = 2
+		};
+
+		// State changes and binds that reached the API versus the ones dropped because nothing changed
+		struct StateStatistics
+		{
+			uint32_t Issued = 0;
+			uint32_t Skipped = 0;
 		};
 	public:
+		// RenderCommand::SetAPI deletes the previous API through this base
+		virtual ~RendererAPI() = default;
+
 		virtual void Init() = 0;
 		virtual void EnableZBuffer() = 0;
 		virtual void DisableZBuffer() = 0;
@@ -30,12 +48,28 @@ namespace ge {
 		virtual void SetClearColor(const glm::vec4& color) = 0;
 		virtual void Clear() = 0;
 
+		// Triangle strips
 		virtual void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray) = 0;
-		virtual void DrawIndexed(const std::vector<unsigned int> indices) = 0;
+		virtual void DrawIndexed(uint32_t indexCount) = 0;
+		// Triangle list out of a range of the index buffer, the multi draws below are triangle lists too
+		virtual void DrawIndexedRange(const std::shared_ptr<VertexArray>& vertexArray, uint32_t count, uint32_t firstIndex, int32_t baseVertex) = 0;
+		virtual void MultiDrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, const IndexedDrawRange* draws, uint32_t drawCount) = 0;
+		virtual void MultiDrawIndexedIndirect(const std::shared_ptr<VertexArray>& vertexArray, const std::shared_ptr<IndirectBuffer>& commands, uint32_t drawCount, uint32_t firstCommand) = 0;
 		virtual void DrawVertices(int vertices) = 0;
 		virtual void DrawVerticesStrip(int vertices) = 0;
+		virtual void DrawIndexedTriangles(uint32_t indexCount) = 0;
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance) = 0;
+		virtual void DrawVerticesInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance) = 0;
+
+		virtual const StateStatistics& GetStateStatistics() const = 0;
+		virtual void ResetStateStatistics() = 0;
 
 		inline static API GetAPI() { return s_API; }
+		// Resources have to be created after the API is chosen, use RenderCommand::SetAPI to switch the commands too
+		inline static void SetAPI(API api) { s_API = api; }
+
+		// Use this instead of constructor
+		static RendererAPI* Create();
 	private:
 		static API s_API;
 	};
@@ -9,16 +9,18 @@
 
 #include "Renderer.h"
 #include "Platform/OpenGL/OpenGLShader.h"
+#include "Platform/Software/SoftwareShader.h"
 
 namespace ge {
 
-	Ref<Shader> Shader::Create(const std::string& filepath)
+	Ref<Shader> Shader::Create(const std::string& filepath, const ShaderDefines& defines)
 	{
 		switch (Renderer::GetAPI())
 		{
 			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
 
-			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLShader>(filepath);
+			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLShader>(filepath, defines);
+			case RendererAPI::API::Software:	return std::make_shared<SoftwareShader>(filepath, defines);
 		}
 
 		GE_CORE_ASSERT(false, "Unknown RendererAPI");
@@ -32,6 +34,7 @@ namespace ge {
 			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
 
 			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLShader>(name, vertexSrc, pixelSrc);
+			case RendererAPI::API::Software:	return std::make_shared<SoftwareShader>(name, vertexSrc, pixelSrc);
 		}
 
 		GE_CORE_ASSERT(false, "Unknown RendererAPI");
@@ -64,6 +67,13 @@ namespace ge {
 		return shader;
 	}
 
+	ge::Ref<Shader> ShaderLibrary::Load(const std::string& name, const std::string& filepath, const ShaderDefines& defines)
+	{
+		auto shader = Shader::Create(filepath, defines);
+		Add(name, shader);
+		return shader;
+	}
+
 	ge::Ref<Shader> ShaderLibrary::Get(const std::string& name)
 	{
 		GE_CORE_ASSERT(Exists(name), "Shader not found!");
@@ -74,4 +84,14 @@ namespace ge {
 	{
 		return m_Shaders.find(name) != m_Shaders.end();
 	}
+
+	bool ShaderLibrary::IsReady() const
+	{
+		for (const auto& kv : m_Shaders)
+		{
+			if (!kv.second->IsReady())
+				return false;
+		}
+		return true;
+	}
 }
\ No newline at end of file
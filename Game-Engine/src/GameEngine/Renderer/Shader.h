@@ -9,8 +9,33 @@
 #include <string>
 #include <unordered_map>
 
+#include <glm/glm.hpp>
+
+#include "ShaderPreprocessor.h"
+
 namespace ge {
 
+	// Uniform name hashed with 32 bit FNV-1a. Shaders look uniforms up by this hash, so an id built once
+	// (or at compile time from a literal) saves hashing the name on every upload.
+	struct UniformID
+	{
+		uint32_t Hash;
+
+		constexpr UniformID(const char* name) : Hash(HashName(name)) {}
+		UniformID(const std::string& name) : Hash(HashName(name.c_str())) {}
+
+		static constexpr uint32_t HashName(const char* name)
+		{
+			uint32_t hash = 2166136261u;
+			while (*name)
+			{
+				hash ^= (uint8_t)*name++;
+				hash *= 16777619u;
+			}
+			return hash;
+		}
+	};
+
 	class Shader {
 	public:
 		virtual ~Shader() = default;
@@ -20,7 +45,24 @@ namespace ge {
 
 		virtual const std::string& GetName() const = 0;
 
-		static Ref<Shader> Create(const std::string& filepath);
+		// True when the shader reads its transform from the per instance attributes (a_InstanceTransform)
+		// instead of the u_Transform uniform. The renderer draws runs of these with one instanced call.
+		virtual bool IsInstanced() const = 0;
+
+		// Programs compile in the background and the first use waits for them. False while that would still wait.
+		virtual bool IsReady() const = 0;
+
+		// Uniform uploads, the shader has to be bound
+		virtual void SetInt(const UniformID& id, int value) = 0;
+		virtual void SetIntArray(const UniformID& id, const int* values, uint32_t count) = 0;
+		virtual void SetFloat(const UniformID& id, float value) = 0;
+		virtual void SetFloat2(const UniformID& id, const glm::vec2& value) = 0;
+		virtual void SetFloat3(const UniformID& id, const glm::vec3& value) = 0;
+		virtual void SetFloat4(const UniformID& id, const glm::vec4& value) = 0;
+		virtual void SetMat3(const UniformID& id, const glm::mat3& value) = 0;
+		virtual void SetMat4(const UniformID& id, const glm::mat4& value) = 0;
+
+		static Ref<Shader> Create(const std::string& filepath, const ShaderDefines& defines = ShaderDefines());
 		static Ref<Shader> Create(const std::string& name, const std::string& vertexSrc, const std::string& pixelSrc);
 	};
 
@@ -31,10 +73,14 @@ namespace ge {
 		void Add(const Ref<Shader>& shader);
 		Ref<Shader> Load(const std::string& filepath);
 		Ref<Shader> Load(const std::string& name, const std::string& filepath);
+		// A permutation of the file, the name tells it apart from the others
+		Ref<Shader> Load(const std::string& name, const std::string& filepath, const ShaderDefines& defines);
 
 		Ref<Shader> Get(const std::string& name);
 
 		bool Exists(const std::string& name) const;
+		// True once no shader in the library would wait for the driver when first used
+		bool IsReady() const;
 	private:
 		std::unordered_map<std::string, Ref<Shader>> m_Shaders;
 	};
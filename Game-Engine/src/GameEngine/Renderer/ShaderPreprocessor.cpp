@@ -0,0 +1,171 @@
+/*
+	Shader Preprocessor
+
+	Turns a shader file into the source of each stage: splits the file on #type, pastes the #include files
+	into each stage and adds the permutation defines after each #version line. The final source is hashed
+	once here, so the backend can tell compiled programs apart without looking at the text again.
+*/
+
+#include "gepch.h"
+#include "ShaderPreprocessor.h"
+
+#include "GameEngine/Core/FileSystem.h"
+
+#include <filesystem>
+
+namespace ge {
+
+	// Name inside the quotes or angle brackets when the line is an #include, empty otherwise
+	static std::string GetIncludeName(const std::string& line)
+	{
+		size_t pos = line.find_first_not_of(" \t");
+		if (pos == std::string::npos || line.compare(pos, 8, "#include") != 0)
+			return std::string();
+
+		const size_t open = line.find_first_of("\"<", pos + 8);
+		if (open == std::string::npos)
+			return std::string();
+
+		const size_t close = line.find(line[open] == '"' ? '"' : '>', open + 1);
+		if (close == std::string::npos)
+			return std::string();
+
+		return line.substr(open + 1, close - open - 1);
+	}
+
+	static bool ReadText(const std::string& file, std::string& text)
+	{
+		std::vector<uint8_t> bytes;
+		if (!FileSystem::ReadFile(file, bytes))
+		{
+			GE_CORE_ERROR("Could not open file '{0}'", file);
+			return false;
+		}
+
+		text.assign(bytes.begin(), bytes.end());
+		return true;
+	}
+
+	// Pastes the includes of text, which comes from path, into output. Files already in included are skipped.
+	static bool ExpandIncludes(const std::string& text, const std::filesystem::path& path, std::string& output,
+		std::vector<std::string>& included, std::vector<std::string>& files)
+	{
+		size_t begin = 0;
+		while (begin < text.size())
+		{
+			size_t end = text.find('\n', begin);
+			end = end == std::string::npos ? text.size() : end + 1;
+			const std::string line = text.substr(begin, end - begin);
+			begin = end;
+
+			const std::string include = GetIncludeName(line);
+			if (include.empty())
+			{
+				output += line;
+				continue;
+			}
+
+			const std::filesystem::path includePath = (path.parent_path() / include).lexically_normal();
+			const std::string file = includePath.generic_string();
+			if (std::find(included.begin(), included.end(), file) != included.end())
+				continue;
+			included.push_back(file);
+			if (std::find(files.begin(), files.end(), file) == files.end())
+				files.push_back(file);
+
+			std::string includeText;
+			if (!ReadText(file, includeText) || !ExpandIncludes(includeText, includePath, output, included, files))
+			{
+				GE_CORE_ERROR("Included from '{0}'", path.generic_string());
+				return false;
+			}
+			if (!output.empty() && output.back() != '\n')
+				output += '\n';
+		}
+
+		return true;
+	}
+
+	static std::vector<ShaderStageSource> SplitStages(const std::string& source)
+	{
+		std::vector<ShaderStageSource> stages;
+
+		const char* typeToken = "#type";
+		const size_t typeTokenLength = strlen(typeToken);
+		size_t pos = source.find(typeToken, 0);
+		while (pos != std::string::npos)
+		{
+			const size_t eol = source.find_first_of("\r\n", pos);
+			GE_CORE_ASSERT(eol != std::string::npos, "Syntax error!");
+			const size_t begin = pos + typeTokenLength + 1;
+			const std::string type = source.substr(begin, eol - begin);
+
+			const size_t nextLinePos = source.find_first_not_of("\r\n", eol);
+			pos = nextLinePos == std::string::npos ? std::string::npos : source.find(typeToken, nextLinePos);
+			stages.push_back({ type, nextLinePos == std::string::npos ? std::string() : source.substr(nextLinePos, pos - nextLinePos) });
+		}
+
+		return stages;
+	}
+
+	// #version has to come first, so the defines go on the line after it
+	static void AddDefines(std::string& source, const ShaderDefines& defines)
+	{
+		if (defines.empty())
+			return;
+
+		std::string lines;
+		for (const auto& define : defines)
+			lines += "#define " + define.first + " " + define.second + "\n";
+
+		size_t pos = source.find("#version");
+		if (pos == std::string::npos)
+		{
+			source.insert(0, lines);
+			return;
+		}
+
+		pos = source.find('\n', pos);
+		if (pos == std::string::npos)
+			source += "\n" + lines;
+		else
+			source.insert(pos + 1, lines);
+	}
+
+	void ShaderPreprocessor::Process(std::vector<ShaderStageSource> stages, const ShaderDefines& defines, ShaderSource& source)
+	{
+		source.Stages = std::move(stages);
+
+		std::string hashed;
+		for (ShaderStageSource& stage : source.Stages)
+		{
+			AddDefines(stage.Source, defines);
+			hashed += "#type " + stage.Type + "\n" + stage.Source;
+		}
+		source.Hash = FileSystem::Hash(hashed.data(), hashed.size());
+	}
+
+	bool ShaderPreprocessor::Process(const std::string& filepath, const ShaderDefines& defines, ShaderSource& source)
+	{
+		const std::filesystem::path path = std::filesystem::path(filepath).lexically_normal();
+		source.Files = { path.generic_string() };
+
+		std::string text;
+		if (!ReadText(filepath, text))
+			return false;
+
+		// Every stage is compiled on its own, so each one gets its own copy of the includes
+		std::vector<ShaderStageSource> stages = SplitStages(text);
+		for (ShaderStageSource& stage : stages)
+		{
+			std::string expanded;
+			std::vector<std::string> included = { source.Files[0] };
+			if (!ExpandIncludes(stage.Source, path, expanded, included, source.Files))
+				return false;
+			stage.Source = std::move(expanded);
+		}
+
+		Process(std::move(stages), defines, source);
+		return !source.Stages.empty();
+	}
+}
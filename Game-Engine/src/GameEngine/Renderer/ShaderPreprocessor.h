@@ -0,0 +1,39 @@
+/*
+	Shader Preprocessor
+
+	Turns a shader file into the source of each stage: splits the file on #type, pastes the #include files
+	into each stage and adds the permutation defines after each #version line. The final source is hashed
+	once here, so the backend can tell compiled programs apart without looking at the text again.
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Core.h"
+
+namespace ge {
+
+	// Permutation defines, each added to every stage as "#define Name Value"
+	using ShaderDefines = std::vector<std::pair<std::string, std::string>>;
+
+	struct ShaderStageSource
+	{
+		std::string Type;		// Name after #type: vertex, fragment or pixel
+		std::string Source;
+	};
+
+	struct ShaderSource
+	{
+		std::vector<ShaderStageSource> Stages;
+		std::vector<std::string> Files;		// The shader file and every file it includes
+		uint64_t Hash = 0;					// Of the stages as they are compiled
+	};
+
+	class ShaderPreprocessor
+	{
+	public:
+		// #include "file" is resolved relative to the file it is in, and is pasted in once per stage
+		static bool Process(const std::string& filepath, const ShaderDefines& defines, ShaderSource& source);
+		// For shaders built in code, the stages go through the defines and hashing only
+		static void Process(std::vector<ShaderStageSource> stages, const ShaderDefines& defines, ShaderSource& source);
+	};
+}
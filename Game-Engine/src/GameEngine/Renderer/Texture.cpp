@@ -9,6 +9,7 @@
 
 #include "Renderer.h"
 #include "Platform/OpenGL/OpenGLTexture.h"
+#include "Platform/Software/SoftwareTexture.h"
 
 namespace ge {
 
@@ -19,6 +20,7 @@ namespace ge {
 			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
 
 			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture2D>(path, gammaCorrection);
+			case RendererAPI::API::Software:	return std::make_shared<SoftwareTexture2D>(path, gammaCorrection);
 		}
 
 		GE_CORE_ASSERT(false, "Unknown RendererAPI");
@@ -26,6 +28,48 @@ namespace ge {
 	}
 
 
+	Ref<Texture2D> Texture2D::Create(uint32_t width, uint32_t height)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture2D>(width, height);
+			case RendererAPI::API::Software:	return std::make_shared<SoftwareTexture2D>(width, height);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
+	Ref<Texture2D> Texture2D::Create(const ImageData& image, bool gammaCorrection)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture2D>(image, gammaCorrection);
+			case RendererAPI::API::Software:	return std::make_shared<SoftwareTexture2D>(image, gammaCorrection);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
+	Ref<Texture2D> Texture2D::Create(const CookedTexture& cooked)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture2D>(cooked);
+			case RendererAPI::API::Software:	return std::make_shared<SoftwareTexture2D>(cooked);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
 	Ref<Texture3D> Texture3D::Create(const std::string& path, const std::string& directory)
 	{
 		switch (Renderer::GetAPI())
@@ -33,6 +77,7 @@ namespace ge {
 		case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
 
 		case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture3D>(path, directory);
+		case RendererAPI::API::Software:	return std::make_shared<SoftwareTexture3D>(path, directory);
 		}
 
 		GE_CORE_ASSERT(false, "Unknown RendererAPI");
@@ -40,6 +85,35 @@ namespace ge {
 	}
 
 
+	Ref<Texture3D> Texture3D::Create(const ImageData& image, const std::string& path)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+		case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture3D>(image, path);
+		case RendererAPI::API::Software:	return std::make_shared<SoftwareTexture3D>(image, path);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
+
+	Ref<Texture3D> Texture3D::Create(const CookedTexture& cooked, const std::string& path)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+		case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture3D>(cooked, path);
+		case RendererAPI::API::Software:	return std::make_shared<SoftwareTexture3D>(cooked, path);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
 	Ref<Cubemap> Cubemap::Create(const std::vector<std::string> faces)
 	{
 		switch (Renderer::GetAPI())
@@ -47,6 +121,22 @@ namespace ge {
 		case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
 
 		case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLCubemap>(faces);
+		case RendererAPI::API::Software:	return std::make_shared<SoftwareCubemap>(faces);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
+
+	Ref<Cubemap> Cubemap::Create(const std::vector<ImageData>& faces)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+		case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLCubemap>(faces);
+		case RendererAPI::API::Software:	return std::make_shared<SoftwareCubemap>(faces);
 		}
 
 		GE_CORE_ASSERT(false, "Unknown RendererAPI");
@@ -61,6 +151,35 @@ namespace ge {
 		case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
 
 		case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLHDREnvironmentMap>(path);
+		case RendererAPI::API::Software:	return std::make_shared<SoftwareHDREnvironmentMap>(path);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
+	Ref<HDREnvironmentMap> HDREnvironmentMap::Create(const ImageData& image)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+		case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLHDREnvironmentMap>(image);
+		case RendererAPI::API::Software:	return std::make_shared<SoftwareHDREnvironmentMap>(image);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
+	Ref<HDREnvironmentMap> HDREnvironmentMap::Create(const IBLData& data)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+		case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLHDREnvironmentMap>(data);
+		case RendererAPI::API::Software:	return std::make_shared<SoftwareHDREnvironmentMap>(data);
 		}
 
 		GE_CORE_ASSERT(false, "Unknown RendererAPI");
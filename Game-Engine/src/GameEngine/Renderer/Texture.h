@@ -13,6 +13,11 @@
 
 namespace ge {
 
+	class ImageData;
+	class CookedTexture;
+	class StreamableTexture;
+	struct IBLData;
+
 	// Virtaul abstract base class for other texture classic to inherit from
 	class Texture 
 	{
@@ -23,13 +28,24 @@ namespace ge {
 		virtual uint32_t GetHeight() const = 0;
 
 		virtual void Bind(uint32_t slot = 0) const = 0;
+
+		// Streaming side of the texture, null when every mip is resident
+		virtual StreamableTexture* GetStreamable() { return nullptr; }
 	};
 
 	// 2D texture (still abstract, it needs to be implemented by specific renderer API's)
 	class Texture2D : public Texture
 	{
 	public:
+		// Data is RGBA with 8 bits per channel and must cover the whole texture
+		virtual void SetData(void* data, uint32_t size) = 0;
+
 		static Ref<Texture2D> Create(const std::string& path, bool gammaCorrection = false);
+		static Ref<Texture2D> Create(uint32_t width, uint32_t height);
+		// From an image decoded ahead of time, only the upload happens here
+		static Ref<Texture2D> Create(const ImageData& image, bool gammaCorrection = false);
+		// From a cooked file, the compressed mips are uploaded as they are
+		static Ref<Texture2D> Create(const CookedTexture& cooked);
 	};
 
 
@@ -38,6 +54,8 @@ namespace ge {
 	{
 	public:
 		static Ref<Texture3D> Create(const std::string& path, const std::string& directory);
+		static Ref<Texture3D> Create(const ImageData& image, const std::string& path);
+		static Ref<Texture3D> Create(const CookedTexture& cooked, const std::string& path);
 
 		virtual const std::string& GetPath() const = 0;
 
@@ -50,6 +68,7 @@ namespace ge {
 	{
 	public:
 		static Ref<Cubemap> Create(const std::vector<std::string> faces);
+		static Ref<Cubemap> Create(const std::vector<ImageData>& faces);
 	};
 
 	// HDR Environment Map
@@ -57,6 +76,9 @@ namespace ge {
 	{
 	public:
 		static Ref<HDREnvironmentMap> Create(const std::string& path);
+		static Ref<HDREnvironmentMap> Create(const ImageData& image);
+		// Uploads maps baked by IBLBaker, nothing is rendered
+		static Ref<HDREnvironmentMap> Create(const IBLData& data);
 
 		virtual void SetupCubemap(uint32_t width, uint32_t height) = 0;
 		virtual void SetupIrradianceMap(uint32_t width, uint32_t height) = 0;
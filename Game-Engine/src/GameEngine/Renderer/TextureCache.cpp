@@ -0,0 +1,285 @@
+/*
+	Texture Cache
+
+	Engine wide cache of textures loaded from files. Paths are normalised and the file contents hashed,
+	so the same image reached through different paths, or copied under another name, is only decoded
+	and uploaded once. The cache only holds weak references, a texture goes away with its last user.
+	With a memory budget the most recently used textures are also kept alive, least recently used first
+	to go, so a texture dropped and requested again soon after is still a hit.
+*/
+
+#include "gepch.h"
+#include "TextureCache.h"
+
+#include "GameEngine/Core/FileSystem.h"
+#include "GameEngine/Renderer/ImageData.h"
+#include "GameEngine/Renderer/CookedTexture.h"
+
+#include <cctype>
+#include <filesystem>
+#include <list>
+
+namespace ge {
+
+	// Part of every key, the same file is a different texture per type and colour space
+	enum class CachedTextureKind : uint32_t
+	{
+		Texture2D = 1,
+		Texture2DGamma = 2,
+		Texture3D = 3
+	};
+
+	// What a path held when it was last read, so unchanged files are not hashed again
+	struct PathRecord
+	{
+		FileStamp Stamp;
+		uint64_t ContentKey = 0;
+	};
+
+	using RetainedList = std::list<std::pair<uint64_t, Ref<Texture>>>;
+
+	struct CacheEntry
+	{
+		std::weak_ptr<Texture> Asset;
+		size_t Bytes = 0;
+		bool IsRetained = false;
+		RetainedList::iterator Retained;
+	};
+
+	struct TextureCacheData
+	{
+		std::unordered_map<std::string, PathRecord> Paths;
+		std::unordered_map<uint64_t, CacheEntry> Entries;
+		RetainedList Retained;			// Most recently used first
+		size_t RetainedBytes = 0;
+		size_t MemoryBudget = 0;
+		uint32_t InsertsSinceCollect = 0;
+
+		TextureCache::Statistics Stats;
+	};
+
+	static TextureCacheData s_Data;
+
+	// Expired entries are dropped in batches, looking at the whole map on every insert would cost more than they do
+	static constexpr uint32_t s_CollectInterval = 64;
+
+	// Mixed with the kind so the same file gives different keys per kind
+	static uint64_t HashContent(const std::vector<uint8_t>& bytes, CachedTextureKind kind)
+	{
+		uint64_t hash = FileSystem::Hash(bytes.data(), bytes.size());
+		hash ^= (uint64_t)kind;
+		hash *= 1099511628211ull;
+		return hash;
+	}
+
+	// RGBA8 with a full mip chain, the textures don't report their real format
+	static size_t EstimateTextureBytes(const Texture& texture)
+	{
+		return (size_t)texture.GetWidth() * texture.GetHeight() * 4 * 4 / 3;
+	}
+
+	static void EvictOverBudget()
+	{
+		while (s_Data.RetainedBytes > s_Data.MemoryBudget && !s_Data.Retained.empty())
+		{
+			CacheEntry& entry = s_Data.Entries[s_Data.Retained.back().first];
+			entry.IsRetained = false;
+			s_Data.RetainedBytes -= entry.Bytes;
+			s_Data.Retained.pop_back();
+			s_Data.Stats.Evictions++;
+		}
+	}
+
+	// Marks the entry as the most recently used one, keeping its texture alive while it fits the budget
+	static void Touch(uint64_t contentKey, CacheEntry& entry, const Ref<Texture>& texture)
+	{
+		if (s_Data.MemoryBudget == 0)
+			return;
+
+		if (entry.IsRetained)
+		{
+			s_Data.Retained.splice(s_Data.Retained.begin(), s_Data.Retained, entry.Retained);
+			return;
+		}
+
+		s_Data.Retained.emplace_front(contentKey, texture);
+		entry.Retained = s_Data.Retained.begin();
+		entry.IsRetained = true;
+		s_Data.RetainedBytes += entry.Bytes;
+		EvictOverBudget();
+	}
+
+	static void CollectExpired()
+	{
+		for (auto it = s_Data.Entries.begin(); it != s_Data.Entries.end();)
+		{
+			if (it->second.Asset.expired())
+				it = s_Data.Entries.erase(it);
+			else
+				++it;
+		}
+
+		for (auto it = s_Data.Paths.begin(); it != s_Data.Paths.end();)
+		{
+			if (s_Data.Entries.find(it->second.ContentKey) == s_Data.Entries.end())
+				it = s_Data.Paths.erase(it);
+			else
+				++it;
+		}
+
+		s_Data.InsertsSinceCollect = 0;
+	}
+
+	template<typename T>
+	static Ref<T> FindTexture(uint64_t contentKey)
+	{
+		auto it = s_Data.Entries.find(contentKey);
+		if (it == s_Data.Entries.end())
+			return nullptr;
+
+		Ref<Texture> texture = it->second.Asset.lock();
+		if (!texture)
+			return nullptr;
+
+		Touch(contentKey, it->second, texture);
+		return std::static_pointer_cast<T>(texture);
+	}
+
+	template<typename T, typename CreateFn, typename CreateCookedFn>
+	static Ref<T> GetTexture(const std::string& path, CachedTextureKind kind, bool sRGB, CreateFn create, CreateCookedFn createCooked)
+	{
+		s_Data.Stats.Requests++;
+
+		const std::string pathKey = std::to_string((uint32_t)kind) + '|' + TextureCache::NormalizePath(path);
+		FileStamp stamp;
+		const bool hasStamp = FileSystem::GetStamp(path, stamp);
+
+		// Same path and the file hasn't changed, no need to read it
+		auto pathIt = s_Data.Paths.find(pathKey);
+		if (hasStamp && pathIt != s_Data.Paths.end() && pathIt->second.Stamp == stamp)
+		{
+			if (Ref<T> texture = FindTexture<T>(pathIt->second.ContentKey))
+			{
+				s_Data.Stats.Hits++;
+				return texture;
+			}
+		}
+
+		std::vector<uint8_t> bytes;
+		if (!hasStamp || !FileSystem::ReadFile(path, bytes))
+		{
+			s_Data.Stats.Misses++;
+			GE_CORE_ERROR("Texture failed to load at path: {0}", path);
+			return create(ImageData());
+		}
+
+		const uint64_t contentKey = HashContent(bytes, kind);
+		s_Data.Paths[pathKey] = { stamp, contentKey };
+
+		if (Ref<T> texture = FindTexture<T>(contentKey))
+		{
+			s_Data.Stats.Hits++;
+			s_Data.Stats.ContentHits++;
+			return texture;
+		}
+
+		s_Data.Stats.Misses++;
+		Ref<T> texture;
+		size_t textureBytes = 0;
+
+		// A current cooked file skips the decode, its size is the real GPU size
+		CookedTexture cooked;
+		if (cooked.OpenForSource(path, sRGB))
+		{
+			texture = createCooked(cooked);
+			textureBytes = cooked.GetDataSize();
+			GE_CORE_INFO("{0} loaded", CookedTexture::GetCookedPath(path));
+		}
+		else
+		{
+			// Decoded from the bytes already read for the hash
+			ImageData image;
+			if (ImageData::LoadFromMemory(bytes.data(), bytes.size(), image))
+				GE_CORE_INFO("{0} loaded", path);
+			else
+				GE_CORE_ERROR("Texture failed to decode: {0}", path);
+
+			texture = create(image);
+			textureBytes = EstimateTextureBytes(*texture);
+		}
+
+		CacheEntry& entry = s_Data.Entries[contentKey];
+		entry.Asset = texture;
+		entry.Bytes = textureBytes;
+		Touch(contentKey, entry, texture);
+
+		if (++s_Data.InsertsSinceCollect >= s_CollectInterval)
+			CollectExpired();
+
+		return texture;
+	}
+
+	Ref<Texture2D> TextureCache::GetTexture2D(const std::string& path, bool gammaCorrection)
+	{
+		return GetTexture<Texture2D>(path, gammaCorrection ? CachedTextureKind::Texture2DGamma : CachedTextureKind::Texture2D, gammaCorrection,
+			[gammaCorrection](const ImageData& image) { return Texture2D::Create(image, gammaCorrection); },
+			[](const CookedTexture& cooked) { return Texture2D::Create(cooked); });
+	}
+
+	Ref<Texture3D> TextureCache::GetTexture3D(const std::string& path, const std::string& directory)
+	{
+		return GetTexture<Texture3D>(directory + '/' + path, CachedTextureKind::Texture3D, false,
+			[&path](const ImageData& image) { return Texture3D::Create(image, path); },
+			[&path](const CookedTexture& cooked) { return Texture3D::Create(cooked, path); });
+	}
+
+	void TextureCache::SetMemoryBudget(size_t bytes)
+	{
+		s_Data.MemoryBudget = bytes;
+		EvictOverBudget();
+	}
+
+	size_t TextureCache::GetMemoryBudget()
+	{
+		return s_Data.MemoryBudget;
+	}
+
+	void TextureCache::Clear()
+	{
+		s_Data.Retained.clear();
+		s_Data.RetainedBytes = 0;
+		s_Data.Entries.clear();
+		s_Data.Paths.clear();
+		s_Data.InsertsSinceCollect = 0;
+	}
+
+	std::string TextureCache::NormalizePath(const std::string& path)
+	{
+		std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+#ifdef GE_PLATFORM_WINDOWS
+		// The file system ignores case
+		std::transform(normalized.begin(), normalized.end(), normalized.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+#endif
+		return normalized;
+	}
+
+	TextureCache::Statistics TextureCache::GetStatistics()
+	{
+		Statistics stats = s_Data.Stats;
+		for (const auto& [key, entry] : s_Data.Entries)
+		{
+			if (entry.Asset.expired())
+				continue;
+
+			stats.LiveTextures++;
+			stats.LiveBytes += entry.Bytes;
+		}
+		stats.RetainedBytes = s_Data.RetainedBytes;
+		return stats;
+	}
+
+	void TextureCache::ResetStatistics()
+	{
+		s_Data.Stats = Statistics();
+	}
+}
@@ -0,0 +1,52 @@
+/*
+	Texture Cache
+
+	Engine wide cache of textures loaded from files. Paths are normalised and the file contents hashed,
+	so the same image reached through different paths, or copied under another name, is only decoded
+	and uploaded once. The cache only holds weak references, a texture goes away with its last user.
+	With a memory budget the most recently used textures are also kept alive, least recently used first
+	to go, so a texture dropped and requested again soon after is still a hit.
+	Textures are created here, so the cache is used from the thread with the graphics context.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/Texture.h"
+
+namespace ge {
+
+	class TextureCache
+	{
+	public:
+		static Ref<Texture2D> GetTexture2D(const std::string& path, bool gammaCorrection = false);
+		// Model textures, the path is relative to the directory of the model
+		static Ref<Texture3D> GetTexture3D(const std::string& path, const std::string& directory);
+
+		// Bytes of textures kept alive for reuse after their last user is gone, 0 keeps nothing alive
+		static void SetMemoryBudget(size_t bytes);
+		static size_t GetMemoryBudget();
+
+		// Drops every entry and every texture kept alive for reuse
+		static void Clear();
+
+		// Same form for every way of writing a path: generic separators, no "." or "..", lower case on Windows
+		static std::string NormalizePath(const std::string& path);
+
+		struct Statistics
+		{
+			uint32_t Requests = 0;
+			uint32_t Hits = 0;
+			uint32_t ContentHits = 0;		// Hits through a different path with the same contents
+			uint32_t Misses = 0;
+			uint32_t Evictions = 0;			// Textures no longer kept alive because of the budget
+			uint32_t LiveTextures = 0;
+			size_t LiveBytes = 0;			// Textures in use or kept alive, estimated from their size with mips
+			size_t RetainedBytes = 0;		// Of which kept alive by the cache
+
+			float GetHitRate() const { return Requests > 0 ? (float)Hits / (float)Requests : 0.0f; }
+		};
+
+		static Statistics GetStatistics();
+		static void ResetStatistics();
+	};
+}
@@ -0,0 +1,187 @@
+/*
+	Texture Cooker
+
+	Turns source images into cooked textures offline: builds the mip chain on the CPU, filtering colour
+	textures in linear space, and block compresses every level. Runs without a renderer, so it can be
+	called from a tool, a build step or a worker thread.
+*/
+
+#include "gepch.h"
+#include "TextureCooker.h"
+
+#include "GameEngine/Renderer/CookedTexture.h"
+#include "GameEngine/Renderer/ImageData.h"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+
+namespace ge {
+
+	static float SRGBToLinear(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	static float LinearToSRGB(float value)
+	{
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	// Image as floats with the given number of channels. Missing channels read like the GL upload would sample them:
+	// one channel is (r, 0, 0, 1) and two channels are (r, g, 0, 1).
+	static std::vector<float> ToFloat(const ImageData& image, uint32_t channels, bool sRGB)
+	{
+		const size_t pixelCount = (size_t)image.GetWidth() * image.GetHeight();
+		const uint32_t sourceChannels = image.GetChannels();
+		std::vector<float> pixels(pixelCount * channels);
+
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			for (uint32_t c = 0; c < channels; c++)
+			{
+				float value = c == 3 ? 1.0f : 0.0f;
+				if (c < sourceChannels)
+				{
+					if (image.IsHDR())
+						value = ((const float*)image.GetData())[i * sourceChannels + c];
+					else
+						value = ((const uint8_t*)image.GetData())[i * sourceChannels + c] / 255.0f;
+				}
+
+				// Alpha is always linear
+				if (sRGB && c < 3)
+					value = SRGBToLinear(value);
+				pixels[i * channels + c] = value;
+			}
+		}
+
+		return pixels;
+	}
+
+	static std::vector<uint8_t> ToRGBA8(const std::vector<float>& pixels, bool sRGB)
+	{
+		std::vector<uint8_t> rgba(pixels.size());
+		for (size_t i = 0; i < pixels.size(); i++)
+		{
+			float value = glm::clamp(pixels[i], 0.0f, 1.0f);
+			if (sRGB && i % 4 != 3)
+				value = LinearToSRGB(value);
+			rgba[i] = (uint8_t)std::lround(value * 255.0f);
+		}
+		return rgba;
+	}
+
+	// 2x2 box filter, the last row or column of odd sizes is repeated
+	static std::vector<float> Downsample(const std::vector<float>& pixels, uint32_t width, uint32_t height, uint32_t channels)
+	{
+		const uint32_t nextWidth = std::max(width / 2, 1u);
+		const uint32_t nextHeight = std::max(height / 2, 1u);
+		std::vector<float> next((size_t)nextWidth * nextHeight * channels);
+
+		for (uint32_t y = 0; y < nextHeight; y++)
+		{
+			const uint32_t y0 = std::min(y * 2, height - 1);
+			const uint32_t y1 = std::min(y * 2 + 1, height - 1);
+			for (uint32_t x = 0; x < nextWidth; x++)
+			{
+				const uint32_t x0 = std::min(x * 2, width - 1);
+				const uint32_t x1 = std::min(x * 2 + 1, width - 1);
+				for (uint32_t c = 0; c < channels; c++)
+				{
+					next[((size_t)y * nextWidth + x) * channels + c] = 0.25f * (
+						pixels[((size_t)y0 * width + x0) * channels + c] + pixels[((size_t)y0 * width + x1) * channels + c] +
+						pixels[((size_t)y1 * width + x0) * channels + c] + pixels[((size_t)y1 * width + x1) * channels + c]);
+				}
+			}
+		}
+
+		return next;
+	}
+
+	uint32_t TextureCooker::GetMipCount(uint32_t width, uint32_t height)
+	{
+		uint32_t count = 1;
+		for (uint32_t size = std::max(width, height); size > 1; size /= 2)
+			count++;
+		return count;
+	}
+
+	bool TextureCooker::Compress(const ImageData& image, const TextureCookSettings& settings, std::vector<std::vector<uint8_t>>& levels)
+	{
+		levels.clear();
+		if (!image.IsValid() || settings.Compression == TextureCompression::None)
+			return false;
+
+		const bool hdr = BlockCompression::IsHDR(settings.Compression);
+		if (hdr != image.IsHDR())
+		{
+			GE_CORE_ERROR("BC6H needs an HDR image and the other formats an 8 bit image");
+			return false;
+		}
+
+		// HDR values are already linear
+		const bool sRGB = settings.sRGB && !hdr;
+		const uint32_t channels = hdr ? 3 : 4;
+		uint32_t width = image.GetWidth();
+		uint32_t height = image.GetHeight();
+		std::vector<float> pixels = ToFloat(image, channels, sRGB);
+
+		const uint32_t levelCount = settings.GenerateMips ? GetMipCount(width, height) : 1;
+		levels.resize(levelCount);
+		for (uint32_t level = 0; level < levelCount; level++)
+		{
+			if (level > 0)
+			{
+				pixels = Downsample(pixels, width, height, channels);
+				width = std::max(width / 2, 1u);
+				height = std::max(height / 2, 1u);
+			}
+
+			if (hdr)
+				BlockCompression::Encode(settings.Compression, pixels.data(), width, height, levels[level]);
+			else
+				BlockCompression::Encode(settings.Compression, ToRGBA8(pixels, sRGB).data(), width, height, levels[level]);
+		}
+
+		return true;
+	}
+
+	bool TextureCooker::Cook(const std::string& path, const TextureCookSettings& settings)
+	{
+		FileStamp stamp;
+		if (!FileSystem::GetStamp(path, stamp))
+		{
+			GE_CORE_ERROR("Cannot cook {0}, the file does not exist", path);
+			return false;
+		}
+
+		// Same orientation as the runtime loads, so cooked and uncooked textures look the same
+		ImageData image;
+		const bool loaded = BlockCompression::IsHDR(settings.Compression) ? ImageData::LoadHDR(path, image, false) : ImageData::Load(path, image);
+		if (!loaded)
+		{
+			GE_CORE_ERROR("Cannot cook {0}, the image failed to load", path);
+			return false;
+		}
+
+		std::vector<std::vector<uint8_t>> levels;
+		if (!Compress(image, settings, levels))
+			return false;
+
+		CookedTextureHeader header;
+		header.Compression = (uint32_t)settings.Compression;
+		header.Flags = settings.sRGB && !BlockCompression::IsHDR(settings.Compression) ? CookedTextureFlags_sRGB : CookedTextureFlags_None;
+		header.Width = image.GetWidth();
+		header.Height = image.GetHeight();
+		header.SourceSize = stamp.Size;
+		header.SourceTime = stamp.Time;
+
+		const std::string cookedPath = CookedTexture::GetCookedPath(path);
+		if (!CookedTexture::Write(cookedPath, header, levels))
+			return false;
+
+		GE_CORE_INFO("Cooked {0} ({1}x{2}, {3} mips)", cookedPath, header.Width, header.Height, levels.size());
+		return true;
+	}
+}
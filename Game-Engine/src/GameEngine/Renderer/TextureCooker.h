@@ -0,0 +1,39 @@
+/*
+	Texture Cooker
+
+	Turns source images into cooked textures offline: builds the mip chain on the CPU, filtering colour
+	textures in linear space, and block compresses every level. Runs without a renderer, so it can be
+	called from a tool, a build step or a worker thread.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/BlockCompression.h"
+
+namespace ge {
+
+	class ImageData;
+
+	struct TextureCookSettings
+	{
+		// BC7 for colour, BC5 for normal maps, BC1 when memory matters more than quality, BC6H for HDR images
+		TextureCompression Compression = TextureCompression::BC7;
+		// Colour data: mips are averaged after decoding sRGB and the texture is sampled as sRGB.
+		// Must match the gamma correction flag the texture is loaded with.
+		bool sRGB = true;
+		bool GenerateMips = true;
+	};
+
+	class TextureCooker
+	{
+	public:
+		// Loads the image at path and writes CookedTexture::GetCookedPath(path)
+		static bool Cook(const std::string& path, const TextureCookSettings& settings = TextureCookSettings());
+
+		// Compressed mip chain of a decoded image, largest level first. HDR images need BC6H and 8 bit images the other formats.
+		static bool Compress(const ImageData& image, const TextureCookSettings& settings, std::vector<std::vector<uint8_t>>& levels);
+
+		// Mip count of a full chain down to 1x1
+		static uint32_t GetMipCount(uint32_t width, uint32_t height);
+	};
+}
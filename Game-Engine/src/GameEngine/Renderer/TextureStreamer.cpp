@@ -0,0 +1,290 @@
+/*
+	Texture Streamer
+
+	Decides which mip levels of streamed textures are resident. Textures start with only their small mips,
+	users request the level they need each frame (usually from the screen size of what the texture is on)
+	and Update grows or shrinks every texture towards its request within a memory budget, dropping the
+	finest levels of the least magnified textures first when the requests don't fit.
+	The streamer only makes decisions, the GPU work happens in the StreamableTexture, so the decisions
+	can run against any implementation.
+*/
+
+#include "gepch.h"
+#include "TextureStreamer.h"
+
+#include <cmath>
+#include <limits>
+
+namespace ge {
+
+	struct StreamedTextureRecord
+	{
+		uint32_t BaseMip = 0;				// Always resident
+		uint32_t TargetMip = 0;				// Where the last update wanted the texture to be
+		uint32_t RequestedMip = 0;			// Finest request of the last frame with requests
+		uint64_t RequestFrame = 0;
+		bool HasRequest = false;
+	};
+
+	// One more level of one texture, what the budget is spent on
+	struct StreamingStep
+	{
+		StreamableTexture* Texture;
+		uint32_t Level;
+		uint32_t Distance;		// Levels above the requested one, the texture is magnified 2^Distance times without this step
+		size_t Bytes;
+	};
+
+	struct TextureStreamerData
+	{
+		std::unordered_map<StreamableTexture*, StreamedTextureRecord> Textures;
+		std::vector<StreamingStep> Steps;
+
+		bool Enabled = true;
+		size_t MemoryBudget = 256 * 1024 * 1024;
+		size_t UploadBudget = 16 * 1024 * 1024;
+		uint32_t MinResidentSize = 64;
+		uint32_t EvictDelay = 60;
+		float MipBias = 0.0f;
+		uint64_t Frame = 1;
+
+		TextureStreamer::Statistics Stats;
+	};
+
+	static TextureStreamerData s_Data;
+
+	// Bytes of every level from level down to 1x1
+	static size_t GetTailSize(const StreamableTexture& texture, uint32_t level)
+	{
+		size_t size = 0;
+		for (uint32_t i = level; i < texture.GetMipCount(); i++)
+			size += texture.GetMipSize(i);
+		return size;
+	}
+
+	void TextureStreamer::Register(StreamableTexture* texture)
+	{
+		StreamedTextureRecord record;
+		record.BaseMip = GetBaseMip(texture->GetWidth(), texture->GetHeight(), texture->GetMipCount());
+		record.TargetMip = record.BaseMip;
+		s_Data.Textures[texture] = record;
+	}
+
+	void TextureStreamer::Unregister(StreamableTexture* texture)
+	{
+		s_Data.Textures.erase(texture);
+	}
+
+	void TextureStreamer::RequestMip(StreamableTexture* texture, uint32_t level)
+	{
+		auto it = s_Data.Textures.find(texture);
+		if (it == s_Data.Textures.end())
+			return;
+
+		StreamedTextureRecord& record = it->second;
+		level = std::min(level, texture->GetMipCount() - 1);
+		if (!record.HasRequest || record.RequestFrame != s_Data.Frame)
+			record.RequestedMip = level;
+		else
+			record.RequestedMip = std::min(record.RequestedMip, level);
+
+		record.RequestFrame = s_Data.Frame;
+		record.HasRequest = true;
+	}
+
+	void TextureStreamer::RequestScreenSize(Texture& texture, float screenSize)
+	{
+		StreamableTexture* streamable = texture.GetStreamable();
+		if (!streamable)
+			return;
+
+		RequestMip(streamable, ComputeMip(streamable->GetWidth(), streamable->GetHeight(), streamable->GetMipCount(), screenSize));
+	}
+
+	uint32_t TextureStreamer::ComputeMip(uint32_t width, uint32_t height, uint32_t mipCount, float screenSize)
+	{
+		if (mipCount == 0)
+			return 0;
+		if (screenSize <= 0.0f)
+			return mipCount - 1;
+
+		// Rounded down, so there is at least one texel per pixel
+		const float level = std::floor(std::log2((float)std::max(width, height) / screenSize) + s_Data.MipBias);
+		return (uint32_t)glm::clamp(level, 0.0f, (float)(mipCount - 1));
+	}
+
+	float TextureStreamer::ComputeScreenSize(const PerspectiveCamera& camera, const glm::vec3& center, float radius, float viewportHeight)
+	{
+		const glm::vec3 viewPosition = glm::vec3(camera.GetViewMatrix() * glm::vec4(center, 1.0f));
+		const float distance = glm::length(viewPosition);
+
+		// Inside the sphere it covers the screen, as close as it gets
+		if (distance <= radius)
+			return std::numeric_limits<float>::max();
+
+		// The projection scales y by cot(fov / 2), which maps the radius over the distance to half the viewport
+		return radius / distance * camera.GetProjectionMatrix()[1][1] * viewportHeight;
+	}
+
+	uint32_t TextureStreamer::GetBaseMip(uint32_t width, uint32_t height, uint32_t mipCount)
+	{
+		for (uint32_t level = 0; level < mipCount; level++)
+		{
+			if (std::max(width >> level, 1u) <= s_Data.MinResidentSize && std::max(height >> level, 1u) <= s_Data.MinResidentSize)
+				return level;
+		}
+		return mipCount > 0 ? mipCount - 1 : 0;
+	}
+
+	void TextureStreamer::Update()
+	{
+		Statistics& stats = s_Data.Stats;
+		stats = Statistics();
+		stats.Textures = (uint32_t)s_Data.Textures.size();
+
+		// Base mips first, they are never given up
+		size_t used = 0;
+		s_Data.Steps.clear();
+		for (auto& [texture, record] : s_Data.Textures)
+		{
+			used += GetTailSize(*texture, record.BaseMip);
+
+			uint32_t wanted = record.BaseMip;
+			if (record.HasRequest && s_Data.Frame - record.RequestFrame <= s_Data.EvictDelay)
+				wanted = std::min(record.RequestedMip, record.BaseMip);
+
+			stats.RequestedBytes += GetTailSize(*texture, wanted);
+			for (uint32_t level = wanted; level < record.BaseMip; level++)
+				s_Data.Steps.push_back({ texture, level, level - wanted, texture->GetMipSize(level) });
+
+			record.TargetMip = record.BaseMip;
+		}
+
+		// Most magnified first, so coarser steps of a texture always come before its finer ones
+		std::sort(s_Data.Steps.begin(), s_Data.Steps.end(), [](const StreamingStep& a, const StreamingStep& b)
+		{
+			if (a.Distance != b.Distance)
+				return a.Distance > b.Distance;
+			return a.Bytes < b.Bytes;
+		});
+
+		for (const StreamingStep& step : s_Data.Steps)
+		{
+			StreamedTextureRecord& record = s_Data.Textures[step.Texture];
+
+			// A coarser level of this texture was turned down
+			if (record.TargetMip != step.Level + 1)
+				continue;
+
+			if (used + step.Bytes > s_Data.MemoryBudget)
+			{
+				stats.OverBudget = true;
+				continue;
+			}
+
+			used += step.Bytes;
+			record.TargetMip = step.Level;
+		}
+
+		// Evictions free memory before anything is loaded
+		std::vector<std::pair<StreamableTexture*, uint32_t>> loads;
+		for (auto& [texture, record] : s_Data.Textures)
+		{
+			const uint32_t resident = texture->GetResidentMip();
+			if (record.TargetMip > resident)
+			{
+				texture->SetResidentMip(record.TargetMip);
+				stats.LevelsEvicted += record.TargetMip - resident;
+			}
+			else if (record.TargetMip < resident)
+			{
+				loads.push_back({ texture, resident - record.TargetMip });
+			}
+		}
+
+		// The furthest from their target first, a level at a time once the upload budget is reached
+		std::sort(loads.begin(), loads.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+		for (const auto& [texture, missing] : loads)
+		{
+			const uint32_t resident = texture->GetResidentMip();
+			const uint32_t target = s_Data.Textures[texture].TargetMip;
+
+			uint32_t level = resident;
+			while (level > target)
+			{
+				const size_t size = texture->GetMipSize(level - 1);
+				if (stats.LoadedBytes > 0 && stats.LoadedBytes + size > s_Data.UploadBudget)
+					break;
+
+				stats.LoadedBytes += size;
+				level--;
+			}
+
+			if (level < resident)
+			{
+				texture->SetResidentMip(level);
+				stats.LevelsLoaded += resident - level;
+			}
+		}
+
+		for (auto& [texture, record] : s_Data.Textures)
+			stats.ResidentBytes += GetTailSize(*texture, texture->GetResidentMip());
+
+		s_Data.Frame++;
+	}
+
+	void TextureStreamer::SetEnabled(bool enabled)
+	{
+		s_Data.Enabled = enabled;
+	}
+
+	bool TextureStreamer::IsEnabled()
+	{
+		return s_Data.Enabled;
+	}
+
+	void TextureStreamer::SetMemoryBudget(size_t bytes)
+	{
+		s_Data.MemoryBudget = bytes;
+	}
+
+	size_t TextureStreamer::GetMemoryBudget()
+	{
+		return s_Data.MemoryBudget;
+	}
+
+	void TextureStreamer::SetUploadBudget(size_t bytesPerFrame)
+	{
+		s_Data.UploadBudget = bytesPerFrame;
+	}
+
+	size_t TextureStreamer::GetUploadBudget()
+	{
+		return s_Data.UploadBudget;
+	}
+
+	void TextureStreamer::SetMinResidentSize(uint32_t size)
+	{
+		s_Data.MinResidentSize = std::max(size, 1u);
+	}
+
+	uint32_t TextureStreamer::GetMinResidentSize()
+	{
+		return s_Data.MinResidentSize;
+	}
+
+	void TextureStreamer::SetEvictDelay(uint32_t frames)
+	{
+		s_Data.EvictDelay = frames;
+	}
+
+	void TextureStreamer::SetMipBias(float bias)
+	{
+		s_Data.MipBias = bias;
+	}
+
+	TextureStreamer::Statistics TextureStreamer::GetStatistics()
+	{
+		return s_Data.Stats;
+	}
+}
@@ -0,0 +1,90 @@
+/*
+	Texture Streamer
+
+	Decides which mip levels of streamed textures are resident. Textures start with only their small mips,
+	users request the level they need each frame (usually from the screen size of what the texture is on)
+	and Update grows or shrinks every texture towards its request within a memory budget, dropping the
+	finest levels of the least magnified textures first when the requests don't fit.
+	The streamer only makes decisions, the GPU work happens in the StreamableTexture, so the decisions
+	can run against any implementation. Used from the thread with the graphics context.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/Texture.h"
+#include "GameEngine/Renderer/PerspectiveCamera.h"
+
+namespace ge {
+
+	// A texture whose mip chain can be partly resident. Resident levels are always a tail of the chain,
+	// from the finest resident level down to 1x1.
+	class StreamableTexture
+	{
+	public:
+		virtual ~StreamableTexture() = default;
+
+		// Size of level 0
+		virtual uint32_t GetWidth() const = 0;
+		virtual uint32_t GetHeight() const = 0;
+		virtual uint32_t GetMipCount() const = 0;
+		// Bytes level takes on the GPU
+		virtual size_t GetMipSize(uint32_t level) const = 0;
+
+		virtual uint32_t GetResidentMip() const = 0;
+		// Loads or drops levels so level is the finest one resident
+		virtual void SetResidentMip(uint32_t level) = 0;
+	};
+
+	class TextureStreamer
+	{
+	public:
+		// Only registered textures are streamed, the streamer does not own them
+		static void Register(StreamableTexture* texture);
+		static void Unregister(StreamableTexture* texture);
+
+		// The finest level a texture wants this frame, the finest of every request counts
+		static void RequestMip(StreamableTexture* texture, uint32_t level);
+		// Request from how many pixels the texture covers on screen, ignored for textures that are not streamed
+		static void RequestScreenSize(Texture& texture, float screenSize);
+
+		// Level whose texels match screenSize pixels, assuming the texture is stretched over the surface once
+		static uint32_t ComputeMip(uint32_t width, uint32_t height, uint32_t mipCount, float screenSize);
+		// Diameter in pixels of a sphere seen by the camera
+		static float ComputeScreenSize(const PerspectiveCamera& camera, const glm::vec3& center, float radius, float viewportHeight);
+		// Finest level that is always resident, the first one no larger than the minimum resident size
+		static uint32_t GetBaseMip(uint32_t width, uint32_t height, uint32_t mipCount);
+
+		// Moves every texture towards its requests, once per frame after the requests
+		static void Update();
+
+		// Streaming applies to textures created after it is turned on, cooked textures are fully resident otherwise
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled();
+		// Bytes every streamed texture together may take, the base mips always stay even above it
+		static void SetMemoryBudget(size_t bytes);
+		static size_t GetMemoryBudget();
+		// Bytes loaded per frame, one texture may go over it so a large level always gets in eventually
+		static void SetUploadBudget(size_t bytesPerFrame);
+		static size_t GetUploadBudget();
+		// Levels no wider or taller than this stay resident from the start (64 by default)
+		static void SetMinResidentSize(uint32_t size);
+		static uint32_t GetMinResidentSize();
+		// Frames a request is kept after the texture was last requested, so brief gaps don't evict anything
+		static void SetEvictDelay(uint32_t frames);
+		// Added to the levels ComputeMip gives, positive values save memory at the cost of sharpness
+		static void SetMipBias(float bias);
+
+		struct Statistics
+		{
+			uint32_t Textures = 0;
+			uint32_t LevelsLoaded = 0;		// In the last update
+			uint32_t LevelsEvicted = 0;
+			size_t LoadedBytes = 0;
+			size_t ResidentBytes = 0;
+			size_t RequestedBytes = 0;		// What the requests would take without a budget
+			bool OverBudget = false;		// Some request was turned down for the budget
+		};
+
+		static Statistics GetStatistics();
+	};
+}
@@ -0,0 +1,41 @@
+/*
+	Uniform Buffer
+
+	Abstract class for uniform buffers inherited by classes for each Renderering API.
+	Data shared by many shaders (camera, lights) is written once per frame into a uniform
+	buffer instead of being uploaded to every shader that uses it.
+*/
+
+#include "gepch.h"
+#include "UniformBuffer.h"
+
+#include "Renderer.h"
+#include "Platform/OpenGL/OpenGLUniformBuffer.h"
+#include "Platform/Software/SoftwareUniformBuffer.h"
+
+namespace ge {
+
+	int UniformBuffer::GetBlockBinding(const std::string& blockName)
+	{
+		if (blockName == "Camera")
+			return (int)UniformBlock::Camera;
+		if (blockName == "Lights")
+			return (int)UniformBlock::Lights;
+
+		return -1;
+	}
+
+	Ref<UniformBuffer> UniformBuffer::Create(uint32_t size, UniformBlock block)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
+
+			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLUniformBuffer>(size, (uint32_t)block);
+			case RendererAPI::API::Software:	return std::make_shared<SoftwareUniformBuffer>(size, (uint32_t)block);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+}
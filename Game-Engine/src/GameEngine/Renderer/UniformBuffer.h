@@ -0,0 +1,35 @@
+/*
+	Uniform Buffer
+
+	Abstract class for uniform buffers inherited by classes for each Renderering API.
+	Data shared by many shaders (camera, lights) is written once per frame into a uniform
+	buffer instead of being uploaded to every shader that uses it.
+*/
+
+#pragma once
+
+#include <string>
+
+namespace ge {
+
+	// Binding points of the uniform blocks the renderer fills. Shaders declaring a block with
+	// one of these names get connected to it when they are linked.
+	enum class UniformBlock : uint32_t
+	{
+		Camera = 0, Lights = 1
+	};
+
+	class UniformBuffer
+	{
+	public:
+		virtual ~UniformBuffer() = default;
+
+		// Data is expected in the std140 layout of the block
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+		// Binding point for a block name, -1 if the renderer does not provide that block
+		static int GetBlockBinding(const std::string& blockName);
+
+		static Ref<UniformBuffer> Create(uint32_t size, UniformBlock block);
+	};
+}
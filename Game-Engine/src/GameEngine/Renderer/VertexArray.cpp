@@ -9,6 +9,7 @@
 
 #include "Renderer.h"
 #include "Platform/OpenGL/OpenGLVertexArray.h"
+#include "Platform/Software/SoftwareVertexArray.h"
 
 namespace ge {
 
@@ -19,6 +20,7 @@ namespace ge {
 			case RendererAPI::API::None:		GE_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
 
 			case RendererAPI::API::OpenGL:	return new OpenGLVertexArray();
+			case RendererAPI::API::Software:	return new SoftwareVertexArray();
 		}
 
 		GE_CORE_ASSERT(false, "Unknown RendererAPI");
@@ -20,6 +20,8 @@ namespace ge {
 		virtual void Unbind() const = 0;
 
 		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) = 0;
+		// Places the layout at fixed attribute locations starting at firstAttributeIndex
+		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, uint32_t firstAttributeIndex) = 0;
 		virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) = 0;
 
 		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const = 0;
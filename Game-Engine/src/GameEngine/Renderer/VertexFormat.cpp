@@ -0,0 +1,256 @@
+/*
+	Vertex Format
+
+	Compressed layouts for mesh vertices. Normals and tangents are octahedral encoded into two
+	snorm16 values, the bitangent is rebuilt in the shader from the tangent handedness sign,
+	texture coordinates are half floats and positions can be quantized to unorm16 inside the mesh bounds.
+*/
+
+#include "gepch.h"
+#include "VertexFormat.h"
+
+#include "Mesh.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace ge {
+
+	struct PackedVertex
+	{
+		glm::vec3 Position;
+		int16_t Normal[2];
+		uint16_t TexCoords[2];
+		int16_t Tangent[4];
+	};
+
+	struct PackedQuantizedVertex
+	{
+		uint16_t Position[4];
+		int16_t Normal[2];
+		uint16_t TexCoords[2];
+		int16_t Tangent[4];
+	};
+
+	static_assert(sizeof(PackedVertex) == 28, "Packed vertex has padding!");
+	static_assert(sizeof(PackedQuantizedVertex) == 24, "Packed quantized vertex has padding!");
+
+	BufferLayout VertexFormat::GetLayout(MeshVertexFormat format)
+	{
+		switch (format)
+		{
+			case MeshVertexFormat::Full:
+				return MeshVertex::GetLayout();
+			case MeshVertexFormat::Packed:
+				return {
+					{ ShaderDataType::Float3, "a_Position" },
+					{ ShaderDataType::Short2, "a_Normal", true },
+					{ ShaderDataType::Half2, "a_TexCoords" },
+					{ ShaderDataType::Short4, "a_Tangent", true }
+				};
+			case MeshVertexFormat::PackedQuantized:
+				return {
+					{ ShaderDataType::UShort4, "a_Position", true },
+					{ ShaderDataType::Short2, "a_Normal", true },
+					{ ShaderDataType::Half2, "a_TexCoords" },
+					{ ShaderDataType::Short4, "a_Tangent", true }
+				};
+		}
+
+		GE_CORE_ASSERT(false, "Unknown MeshVertexFormat!");
+		return {};
+	}
+
+	uint32_t VertexFormat::GetStride(MeshVertexFormat format)
+	{
+		switch (format)
+		{
+			case MeshVertexFormat::Full:				return sizeof(MeshVertex);
+			case MeshVertexFormat::Packed:				return sizeof(PackedVertex);
+			case MeshVertexFormat::PackedQuantized:		return sizeof(PackedQuantizedVertex);
+		}
+
+		GE_CORE_ASSERT(false, "Unknown MeshVertexFormat!");
+		return 0;
+	}
+
+	void VertexFormat::ComputeBounds(const MeshVertex* vertices, uint32_t count, glm::vec3& boundsMin, glm::vec3& boundsExtent)
+	{
+		if (count == 0)
+		{
+			boundsMin = glm::vec3(0.0f);
+			boundsExtent = glm::vec3(1.0f);
+			return;
+		}
+
+		glm::vec3 boundsMax = vertices[0].Position;
+		boundsMin = vertices[0].Position;
+		for (uint32_t i = 1; i < count; i++)
+		{
+			boundsMin = glm::min(boundsMin, vertices[i].Position);
+			boundsMax = glm::max(boundsMax, vertices[i].Position);
+		}
+
+		// Flat meshes still need a scale the shader can multiply by
+		boundsExtent = glm::max(boundsMax - boundsMin, glm::vec3(1e-6f));
+	}
+
+	// Octahedral normal and tangent with the handedness of the bitangent in the third component
+	static void PackTangentFrame(const MeshVertex& vertex, int16_t normal[2], int16_t tangent[4])
+	{
+		const glm::vec2 n = VertexFormat::OctahedralEncode(vertex.Normal);
+		normal[0] = VertexFormat::PackSnorm16(n.x);
+		normal[1] = VertexFormat::PackSnorm16(n.y);
+
+		const glm::vec2 t = VertexFormat::OctahedralEncode(vertex.Tangent);
+		const float handedness = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) < 0.0f ? -1.0f : 1.0f;
+		tangent[0] = VertexFormat::PackSnorm16(t.x);
+		tangent[1] = VertexFormat::PackSnorm16(t.y);
+		tangent[2] = VertexFormat::PackSnorm16(handedness);
+		tangent[3] = 0;
+	}
+
+	void VertexFormat::Pack(const MeshVertex* vertices, uint32_t count, MeshVertexFormat format,
+		const glm::vec3& boundsMin, const glm::vec3& boundsExtent, std::vector<uint8_t>& data)
+	{
+		data.resize((size_t)count * GetStride(format));
+
+		switch (format)
+		{
+			case MeshVertexFormat::Full:
+			{
+				if (count > 0)
+					std::memcpy(data.data(), vertices, data.size());
+				break;
+			}
+			case MeshVertexFormat::Packed:
+			{
+				PackedVertex* packed = (PackedVertex*)data.data();
+				for (uint32_t i = 0; i < count; i++)
+				{
+					packed[i].Position = vertices[i].Position;
+					packed[i].TexCoords[0] = FloatToHalf(vertices[i].TexCoords.x);
+					packed[i].TexCoords[1] = FloatToHalf(vertices[i].TexCoords.y);
+					PackTangentFrame(vertices[i], packed[i].Normal, packed[i].Tangent);
+				}
+				break;
+			}
+			case MeshVertexFormat::PackedQuantized:
+			{
+				PackedQuantizedVertex* packed = (PackedQuantizedVertex*)data.data();
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const glm::vec3 position = (vertices[i].Position - boundsMin) / boundsExtent;
+					packed[i].Position[0] = PackUnorm16(position.x);
+					packed[i].Position[1] = PackUnorm16(position.y);
+					packed[i].Position[2] = PackUnorm16(position.z);
+					packed[i].Position[3] = 0;
+					packed[i].TexCoords[0] = FloatToHalf(vertices[i].TexCoords.x);
+					packed[i].TexCoords[1] = FloatToHalf(vertices[i].TexCoords.y);
+					PackTangentFrame(vertices[i], packed[i].Normal, packed[i].Tangent);
+				}
+				break;
+			}
+		}
+	}
+
+	static float SignNotZero(float value)
+	{
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	// Projects the direction onto an octahedron and folds the lower half over, giving a point in [-1, 1]^2
+	glm::vec2 VertexFormat::OctahedralEncode(const glm::vec3& direction)
+	{
+		const float sum = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+		if (sum == 0.0f)
+			return glm::vec2(0.0f, 0.0f);
+
+		const glm::vec3 n = direction / sum;
+		if (n.z >= 0.0f)
+			return glm::vec2(n.x, n.y);
+
+		return glm::vec2((1.0f - std::abs(n.y)) * SignNotZero(n.x), (1.0f - std::abs(n.x)) * SignNotZero(n.y));
+	}
+
+	glm::vec3 VertexFormat::OctahedralDecode(const glm::vec2& encoded)
+	{
+		glm::vec3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+		const float t = glm::max(-n.z, 0.0f);
+		n.x += n.x >= 0.0f ? -t : t;
+		n.y += n.y >= 0.0f ? -t : t;
+		return glm::normalize(n);
+	}
+
+	// IEEE half, rounded to nearest. Values too large become infinity and values too small flush to zero.
+	uint16_t VertexFormat::FloatToHalf(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		const uint32_t sign = (bits >> 16) & 0x8000;
+		const uint32_t floatExponent = (bits >> 23) & 0xFF;
+		uint32_t mantissa = bits & 0x7FFFFF;
+
+		// Infinity and NaN
+		if (floatExponent == 0xFF)
+			return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+		const int32_t exponent = (int32_t)floatExponent - 127 + 15;
+		if (exponent >= 31)
+			return (uint16_t)(sign | 0x7C00);
+
+		// Subnormal halves
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+				return (uint16_t)sign;
+
+			mantissa |= 0x800000;
+			const uint32_t shift = (uint32_t)(14 - exponent);
+			uint32_t half = mantissa >> shift;
+			if ((mantissa >> (shift - 1)) & 1)
+				half++;
+			return (uint16_t)(sign | half);
+		}
+
+		// Rounding can carry into the exponent, which gives the right result
+		uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+		if (mantissa & 0x1000)
+			half++;
+		return (uint16_t)half;
+	}
+
+	float VertexFormat::HalfToFloat(uint16_t value)
+	{
+		const uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+		const uint32_t exponent = (value >> 10) & 0x1F;
+		const uint32_t mantissa = value & 0x3FF;
+
+		if (exponent == 0)
+		{
+			const float subnormal = std::ldexp((float)mantissa, -24);
+			return sign ? -subnormal : subnormal;
+		}
+
+		uint32_t bits;
+		if (exponent == 31)
+			bits = sign | 0x7F800000 | (mantissa << 13);
+		else
+			bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	int16_t VertexFormat::PackSnorm16(float value)
+	{
+		return (int16_t)std::round(glm::clamp(value, -1.0f, 1.0f) * 32767.0f);
+	}
+
+	uint16_t VertexFormat::PackUnorm16(float value)
+	{
+		return (uint16_t)std::round(glm::clamp(value, 0.0f, 1.0f) * 65535.0f);
+	}
+}
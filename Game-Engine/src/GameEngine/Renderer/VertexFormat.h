@@ -0,0 +1,51 @@
+/*
+	Vertex Format
+
+	Compressed layouts for mesh vertices. Normals and tangents are octahedral encoded into two
+	snorm16 values, the bitangent is rebuilt in the shader from the tangent handedness sign,
+	texture coordinates are half floats and positions can be quantized to unorm16 inside the mesh bounds.
+*/
+
+#pragma once
+
+#include "Buffer.h"
+
+#include <glm/glm.hpp>
+
+namespace ge {
+
+	struct MeshVertex;
+
+	enum class MeshVertexFormat
+	{
+		Full = 0,				// 56 bytes, every attribute as floats
+		Packed = 1,				// 28 bytes, float positions
+		PackedQuantized = 2		// 24 bytes, unorm16 positions inside the bounds
+	};
+
+	// Attributes keep the locations of the full format: 0 position, 1 normal, 2 texture coordinates, 3 tangent.
+	// The packed tangent is (octahedral x, octahedral y, handedness, 0) and the bitangent is cross(normal, tangent) * handedness.
+	// Shaders for both packed formats compute the position as u_BoundsMin + a_Position.xyz * u_BoundsExtent, with 0 and 1
+	// set when the positions are not quantized (see NormalMappingPacked.glsl).
+	class VertexFormat
+	{
+	public:
+		static BufferLayout GetLayout(MeshVertexFormat format);
+		static uint32_t GetStride(MeshVertexFormat format);
+
+		// Axis aligned bounds of the positions, extent is never 0 on any axis so it can be divided by
+		static void ComputeBounds(const MeshVertex* vertices, uint32_t count, glm::vec3& boundsMin, glm::vec3& boundsExtent);
+
+		// Writes count vertices in the format to data, which is resized to fit. The bounds are only used when quantizing.
+		static void Pack(const MeshVertex* vertices, uint32_t count, MeshVertexFormat format,
+			const glm::vec3& boundsMin, const glm::vec3& boundsExtent, std::vector<uint8_t>& data);
+
+		// Encoding helpers
+		static glm::vec2 OctahedralEncode(const glm::vec3& direction);
+		static glm::vec3 OctahedralDecode(const glm::vec2& encoded);
+		static uint16_t FloatToHalf(float value);
+		static float HalfToFloat(uint16_t value);
+		static int16_t PackSnorm16(float value);
+		static uint16_t PackUnorm16(float value);
+	};
+}
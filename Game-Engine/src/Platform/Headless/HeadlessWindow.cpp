@@ -0,0 +1,18 @@
+/*
+	Headless window
+
+	Stands in for the window when the application renders without a display. It has a size, which becomes
+	the viewport and the size of the software back buffer, but no native window and no events.
+*/
+
+#include "gepch.h"
+#include "HeadlessWindow.h"
+
+namespace ge {
+
+	HeadlessWindow::HeadlessWindow(const WindowProps& props)
+		: m_Width(props.Width), m_Height(props.Height)
+	{
+		GE_CORE_INFO("Running headless at {0} x {1}", props.Width, props.Height);
+	}
+}
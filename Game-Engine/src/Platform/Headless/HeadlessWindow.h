@@ -0,0 +1,35 @@
+/*
+	Headless window
+
+	Stands in for the window when the application renders without a display. It has a size, which becomes
+	the viewport and the size of the software back buffer, but no native window and no events.
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Window.h"
+
+namespace ge {
+
+	class HeadlessWindow : public Window
+	{
+	public:
+		HeadlessWindow(const WindowProps& props);
+
+		void OnUpdate() override {}
+
+		inline unsigned int GetWidth() const override { return m_Width; }
+		inline unsigned int GetHeight() const override { return m_Height; }
+
+		// Window attributes
+		inline void SetEventCallback(const EventCallbackFn& callback) override { m_EventCallback = callback; }
+		void SetVSync(bool /*enabled*/) override {}
+		bool IsVSync() const override { return false; }
+
+		// Input reads nothing without a native window
+		inline virtual void* GetNativeWindow() const override { return nullptr; }
+	private:
+		unsigned int m_Width, m_Height;
+		EventCallbackFn m_EventCallback;
+	};
+}
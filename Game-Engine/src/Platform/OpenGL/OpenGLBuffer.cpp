@@ -16,10 +16,17 @@ namespace ge {
 	///////////////////////////////////////////////////////////////////////
 
 	OpenGLVertexBuffer::OpenGLVertexBuffer(void* vertices, uint32_t size)
+		: m_Size(size)
 	{
 		glCreateBuffers(1, &m_RendererID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-		glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+		glNamedBufferData(m_RendererID, size, vertices, GL_STATIC_DRAW);
+	}
+
+	OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size)
+		: m_Size(size)
+	{
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW);
 	}
 
 	OpenGLVertexBuffer::~OpenGLVertexBuffer()
@@ -37,6 +44,15 @@ namespace ge {
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
+	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size)
+	{
+		GE_CORE_ASSERT(size <= m_Size, "Data does not fit in the vertex buffer!");
+
+		// Orphan the old storage so the driver does not wait on draws still reading it
+		glNamedBufferData(m_RendererID, m_Size, nullptr, GL_DYNAMIC_DRAW);
+		glNamedBufferSubData(m_RendererID, 0, size, data);
+	}
+
 	///////////////////////////////////////////////////////////////////////
 	// Index Buffer ///////////////////////////////////////////////////////
 	///////////////////////////////////////////////////////////////////////
@@ -44,9 +60,9 @@ namespace ge {
 	OpenGLIndexBuffer::OpenGLIndexBuffer(void* indices, uint32_t count)
 		: m_Count(count)
 	{
+		// Uploaded without binding, binding an element buffer would attach it to whatever vertex array is bound
 		glCreateBuffers(1, &m_RendererID);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+		glNamedBufferData(m_RendererID, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
 	}
 
 	OpenGLIndexBuffer::~OpenGLIndexBuffer()
@@ -63,4 +79,33 @@ namespace ge {
 	{
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Indirect Buffer ////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	OpenGLIndirectBuffer::OpenGLIndirectBuffer(const DrawIndirectCommand* commands, uint32_t count)
+		: m_Capacity(count), m_Count(count)
+	{
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferData(m_RendererID, count * sizeof(DrawIndirectCommand), commands, GL_DYNAMIC_DRAW);
+	}
+
+	OpenGLIndirectBuffer::~OpenGLIndirectBuffer()
+	{
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLIndirectBuffer::Bind() const
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+	}
+
+	void OpenGLIndirectBuffer::SetData(const DrawIndirectCommand* commands, uint32_t count)
+	{
+		GE_CORE_ASSERT(count <= m_Capacity, "Commands do not fit in the indirect buffer!");
+
+		glNamedBufferSubData(m_RendererID, 0, count * sizeof(DrawIndirectCommand), commands);
+		m_Count = count;
+	}
 }
\ No newline at end of file
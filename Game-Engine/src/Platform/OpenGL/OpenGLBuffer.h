@@ -14,6 +14,7 @@ namespace ge {
 	{
 	public:
 		OpenGLVertexBuffer(void* vertices, uint32_t size);
+		OpenGLVertexBuffer(uint32_t size);
 		virtual ~OpenGLVertexBuffer();
 
 		virtual void Bind() const override;
@@ -21,8 +22,11 @@ namespace ge {
 
 		virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
 		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
+
+		virtual void SetData(const void* data, uint32_t size) override;
 	private:
 		uint32_t m_RendererID;
+		uint32_t m_Size;
 		BufferLayout m_Layout;
 	};
 
@@ -41,4 +45,20 @@ namespace ge {
 		uint32_t m_Count;
 	};
 
+	class OpenGLIndirectBuffer : public IndirectBuffer
+	{
+	public:
+		OpenGLIndirectBuffer(const DrawIndirectCommand* commands, uint32_t count);
+		virtual ~OpenGLIndirectBuffer();
+
+		virtual void Bind() const override;
+
+		virtual void SetData(const DrawIndirectCommand* commands, uint32_t count) override;
+		virtual uint32_t GetCount() const override { return m_Count; }
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Capacity;
+		uint32_t m_Count;
+	};
+
 }
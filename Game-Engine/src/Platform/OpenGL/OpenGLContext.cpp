@@ -6,6 +6,7 @@
 
 #include "gepch.h"
 #include "OpenGLContext.h"
+#include "OpenGLShaderCache.h"
 
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
@@ -13,6 +14,28 @@
 
 namespace ge {
 
+	// GL_KHR_parallel_shader_compile (or the ARB version), which Glad was generated without
+	typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+	static bool EnableParallelShaderCompile()
+	{
+		const char* functionName = nullptr;
+		if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+			functionName = "glMaxShaderCompilerThreadsKHR";
+		else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+			functionName = "glMaxShaderCompilerThreadsARB";
+		else
+			return false;
+
+		auto maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)glfwGetProcAddress(functionName);
+		if (!maxShaderCompilerThreads)
+			return false;
+
+		// As many threads as the driver wants to use
+		maxShaderCompilerThreads(0xFFFFFFFF);
+		return true;
+	}
+
 	OpenGLContext::OpenGLContext(GLFWwindow* windowHandle)
 		: m_WindowHandle(windowHandle)
 	{
@@ -31,6 +54,10 @@ namespace ge {
 		GE_CORE_INFO("  Vendor: {0}", glGetString(GL_VENDOR));
 		GE_CORE_INFO("  Renderer: {0}", glGetString(GL_RENDERER));
 		GE_CORE_INFO("  Version: {0}", glGetString(GL_VERSION));
+
+		const bool parallelCompile = EnableParallelShaderCompile();
+		GE_CORE_INFO("  Parallel shader compile: {0}", parallelCompile ? "yes" : "no");
+		OpenGLShaderCache::Init(parallelCompile);
 	}
 
 	void OpenGLContext::SwapBuffers() 
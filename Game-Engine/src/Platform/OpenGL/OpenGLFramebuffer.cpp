@@ -6,6 +6,7 @@
 
 #include "gepch.h"
 #include "OpenGLFramebuffer.h"
+#include "OpenGLStateCache.h"
 
 #include <glad/glad.h>
 
@@ -33,6 +34,7 @@ namespace ge {
 			// generate texture
 			glGenTextures(1, &m_TexColorBuffer);
 			glBindTexture(GL_TEXTURE_2D, m_TexColorBuffer);
+			OpenGLStateCache::InvalidateTextures();
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -85,8 +87,7 @@ namespace ge {
 
 	void OpenGLFramebuffer::BindTexture() const
 	{
-		glActiveTexture(0);
-		glBindTexture(GL_TEXTURE_2D, m_TexColorBuffer);
+		OpenGLStateCache::BindTexture(0, m_TexColorBuffer);
 	}
 
 	void OpenGLFramebuffer::Attach2DTexture(uint32_t id, uint32_t level) const
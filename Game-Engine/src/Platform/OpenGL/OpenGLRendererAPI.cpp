@@ -6,6 +6,7 @@
 
 #include "gepch.h"
 #include "OpenGLRendererAPI.h"
+#include "OpenGLStateCache.h"
 
 #include <glad/glad.h>
 
@@ -13,32 +14,32 @@ namespace ge {
 
 	void OpenGLRendererAPI::Init()
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		OpenGLStateCache::SetBlend(true);
+		OpenGLStateCache::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	}
 
 	void OpenGLRendererAPI::EnableZBuffer()
 	{
-		glEnable(GL_DEPTH_TEST);
+		OpenGLStateCache::SetDepthTest(true);
 	}
 
 	void OpenGLRendererAPI::DisableZBuffer()
 	{
-		glDisable(GL_DEPTH_TEST);
+		OpenGLStateCache::SetDepthTest(false);
 	}
 
 	void OpenGLRendererAPI::DepthFunc(const std::string setting) 
 	{
 		if (setting == "EQUAL")
-			glDepthFunc(GL_EQUAL);
+			OpenGLStateCache::SetDepthFunc(GL_EQUAL);
 		else if (setting == "LEQUAL")
-			glDepthFunc(GL_LEQUAL);
+			OpenGLStateCache::SetDepthFunc(GL_LEQUAL);
 		else if (setting == "GEQUAL")
-			glDepthFunc(GL_GEQUAL);
+			OpenGLStateCache::SetDepthFunc(GL_GEQUAL);
 		else if (setting == "LESS")
-			glDepthFunc(GL_LESS);
+			OpenGLStateCache::SetDepthFunc(GL_LESS);
 		else if (setting == "GREATER")
-			glDepthFunc(GL_GREATER);
+			OpenGLStateCache::SetDepthFunc(GL_GREATER);
 		else
 			GE_CORE_ERROR("Invalid depth function value: " + setting);
 	}		
@@ -55,7 +56,7 @@ namespace ge {
 
 	void OpenGLRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
 	{
-		glViewport(x, y, width, height);
+		OpenGLStateCache::SetViewport(x, y, width, height);
 	}
 	
 	void OpenGLRendererAPI::SetClearColor(const glm::vec4& color)
@@ -70,13 +71,38 @@ namespace ge {
 
 	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray)
 	{
-		glDrawElements(GL_TRIANGLE_STRIP, vertexArray->GetIndexBuffer()->GetCount(), GL_UNSIGNED_INT, nullptr);
+		DrawIndexed(vertexArray->GetIndexBuffer()->GetCount());
 	}
 
-	void OpenGLRendererAPI::DrawIndexed(const std::vector<unsigned int> indices)
+	// Draws from the bound vertex array
+	void OpenGLRendererAPI::DrawIndexed(uint32_t indexCount)
 	{
-		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, nullptr);
-		glBindVertexArray(0);
+		glDrawElements(GL_TRIANGLE_STRIP, indexCount, GL_UNSIGNED_INT, nullptr);
+	}
+
+	// Triangle list. The vertex array stays bound, the state cache skips binding it again for the next draw
+	void OpenGLRendererAPI::DrawIndexedRange(const Ref<VertexArray>& vertexArray, uint32_t count, uint32_t firstIndex, int32_t baseVertex)
+	{
+		vertexArray->Bind();
+		const void* offset = (const void*)(uintptr_t)(firstIndex * sizeof(uint32_t));
+		glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, offset, baseVertex);
+	}
+
+	void OpenGLRendererAPI::MultiDrawIndexed(const Ref<VertexArray>& vertexArray, const IndexedDrawRange* draws, uint32_t drawCount)
+	{
+		m_MultiDrawCounts.resize(drawCount);
+		m_MultiDrawOffsets.resize(drawCount);
+		m_MultiDrawBaseVertices.resize(drawCount);
+		for (uint32_t i = 0; i < drawCount; i++)
+		{
+			m_MultiDrawCounts[i] = draws[i].Count;
+			m_MultiDrawOffsets[i] = (const void*)(uintptr_t)(draws[i].FirstIndex * sizeof(uint32_t));
+			m_MultiDrawBaseVertices[i] = draws[i].BaseVertex;
+		}
+
+		vertexArray->Bind();
+		glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_MultiDrawCounts.data(), GL_UNSIGNED_INT,
+			m_MultiDrawOffsets.data(), drawCount, m_MultiDrawBaseVertices.data());
 	}
 
 	void OpenGLRendererAPI::DrawVertices(int vertices)
@@ -88,4 +114,41 @@ namespace ge {
 	{
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices);
 	}
+
+	// Indexed triangle list from the bound vertex array
+	void OpenGLRendererAPI::DrawIndexedTriangles(uint32_t indexCount)
+	{
+		glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+	}
+
+	// Same primitive types as DrawIndexed(indexCount) and DrawVertices, per instance attributes start at baseInstance
+	void OpenGLRendererAPI::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance)
+	{
+		glDrawElementsInstancedBaseInstance(GL_TRIANGLE_STRIP, indexCount, GL_UNSIGNED_INT, nullptr, instanceCount, baseInstance);
+	}
+
+	void OpenGLRendererAPI::DrawVerticesInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance)
+	{
+		glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, vertexCount, instanceCount, baseInstance);
+	}
+
+	void OpenGLRendererAPI::MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& commands, uint32_t drawCount, uint32_t firstCommand)
+	{
+		GE_CORE_ASSERT(firstCommand + drawCount <= commands->GetCount(), "Indirect draw reads past the end of the command buffer!");
+
+		vertexArray->Bind();
+		commands->Bind();
+		const void* offset = (const void*)(uintptr_t)(firstCommand * sizeof(DrawIndirectCommand));
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, drawCount, 0);
+	}
+
+	const RendererAPI::StateStatistics& OpenGLRendererAPI::GetStateStatistics() const
+	{
+		return OpenGLStateCache::GetStatistics();
+	}
+
+	void OpenGLRendererAPI::ResetStateStatistics()
+	{
+		OpenGLStateCache::ResetStatistics();
+	}
 }
\ No newline at end of file
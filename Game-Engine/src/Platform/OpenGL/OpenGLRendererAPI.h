@@ -24,8 +24,22 @@ namespace ge {
 		virtual void Clear() override;
 
 		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray) override;
-		virtual void DrawIndexed(const std::vector<unsigned int> indices) override;
+		virtual void DrawIndexed(uint32_t indexCount) override;
+		virtual void DrawIndexedRange(const Ref<VertexArray>& vertexArray, uint32_t count, uint32_t firstIndex, int32_t baseVertex) override;
+		virtual void MultiDrawIndexed(const Ref<VertexArray>& vertexArray, const IndexedDrawRange* draws, uint32_t drawCount) override;
+		virtual void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& commands, uint32_t drawCount, uint32_t firstCommand) override;
 		virtual void DrawVertices(int vertices) override;
 		virtual void DrawVerticesStrip(int vertices) override;
+		virtual void DrawIndexedTriangles(uint32_t indexCount) override;
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance) override;
+		virtual void DrawVerticesInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance) override;
+
+		virtual const StateStatistics& GetStateStatistics() const override;
+		virtual void ResetStateStatistics() override;
+	private:
+		// Reused between multi draws so they do not allocate
+		std::vector<int32_t> m_MultiDrawCounts;
+		std::vector<const void*> m_MultiDrawOffsets;
+		std::vector<int32_t> m_MultiDrawBaseVertices;
 	};
 }
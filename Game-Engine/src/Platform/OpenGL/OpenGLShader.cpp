@@ -6,11 +6,20 @@
 
 #include "gepch.h"
 #include "OpenGLShader.h"
+#include "OpenGLStateCache.h"
+#include "OpenGLShaderCache.h"
+
+#include "GameEngine/Renderer/RenderQueue.h"
+#include "GameEngine/Renderer/UniformBuffer.h"
 
-#include <fstream>
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
+// GL_KHR_parallel_shader_compile, which Glad was generated without
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace ge {
 
 	static GLenum ShaderTypeFromString(const std::string& type)
@@ -25,14 +34,14 @@ namespace ge {
 	}
 
 	// Load shader
-	OpenGLShader::OpenGLShader(const std::string & filepath)
+	OpenGLShader::OpenGLShader(const std::string& filepath, const ShaderDefines& defines)
 	{
-		// Read filepath
-		std::string source = ReadFile(filepath);
-
-		// Process result
-		auto shaderSources = PreProcess(source);
-		Compile(shaderSources);
+		// Read filepath, paste in the includes and split the stages
+		ShaderSource source;
+		if (ShaderPreprocessor::Process(filepath, defines, source))
+			Compile(source);
+		else
+			GE_CORE_ASSERT(false, "Failed to read shader!");
 
 		// Extract name from filepath
 		// assets/shaders/Texture.glsl
@@ -46,213 +55,276 @@ namespace ge {
 	OpenGLShader::OpenGLShader(const std::string& name, const std::string & vertexSrc, const std::string& fragmentSrc)
 		: m_Name(name)
 	{
-		std::unordered_map<GLenum, std::string> sources;
-		sources[GL_VERTEX_SHADER] = vertexSrc;
-		sources[GL_FRAGMENT_SHADER] = fragmentSrc;
-		Compile(sources);
+		ShaderSource source;
+		ShaderPreprocessor::Process({ { "vertex", vertexSrc }, { "fragment", fragmentSrc } }, ShaderDefines(), source);
+		Compile(source);
 	}
 
 	OpenGLShader::~OpenGLShader()
 	{
+		for (auto id : m_PendingShaders)
+			glDeleteShader(id);
+
+		OpenGLStateCache::OnProgramDeleted(m_RendererID);
 		glDeleteProgram(m_RendererID);
 	}
 
-	void OpenGLShader::Compile(const std::unordered_map<GLenum, std::string>& shaderSources)
+	void OpenGLShader::Compile(const ShaderSource& source)
 	{
+		GE_CORE_ASSERT(source.Stages.size() <= 2, "We only support 2 shaders!");
+		m_SourceHash = source.Hash;
+
 		// Get a program object.
 		GLuint program = glCreateProgram();
+		m_RendererID = program;
 
-		GE_CORE_ASSERT(shaderSources.size() <= 2, "We only support 2 shaders!");
-		
-		// Keep track of shader IDs
-		std::array<GLenum, 2> glShaderIDs;
-		int glShaderIDIndex = 0;
-		for (auto& kv : shaderSources)
+		// A binary linked by an earlier run skips compiling altogether
+		if (OpenGLShaderCache::Load(m_SourceHash, program))
 		{
-			GLenum type = kv.first;
-			const std::string& source = kv.second;
+			m_Instanced = glGetAttribLocation(program, "a_InstanceTransform") != -1;
+			Reflect();
+			return;
+		}
 
+		for (const ShaderStageSource& stage : source.Stages)
+		{
 			// Create an empty shader handle
-			GLuint shader = glCreateShader(type);
+			GLuint shader = glCreateShader(ShaderTypeFromString(stage.Type));
 
 			// Send the shader source code to GL
 			// Note that std::string's .c_str is NULL character terminated.
-			const GLchar* sourceCStr = source.c_str();
+			const GLchar* sourceCStr = stage.Source.c_str();
 			glShaderSource(shader, 1, &sourceCStr, 0);
 
-			// Compile the shader
+			// Compile the shader, the status is checked after linking so the driver doesn't have to finish first
 			glCompileShader(shader);
 
-			GLint isCompiled = 0;
-			glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
-			if (isCompiled == GL_FALSE)
-			{
-				GLint maxLength = 0;
-				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
-
-				// The maxLength includes the NULL character
-				std::vector<GLchar> infoLog(maxLength);
-				glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
+			// Attach our shaders to our program
+			glAttachShader(program, shader);
+			m_PendingShaders.push_back(shader);
+		}
 
-				// We don't need the shader anymore.
-				glDeleteShader(shader);
+		// Per instance attributes go to fixed locations so the renderer's instance buffer
+		// lines up with any vertex array. Names the shader does not declare are ignored.
+		uint32_t instanceAttributeIndex = InstanceData::FirstAttributeIndex;
+		for (const auto& element : InstanceData::GetLayout())
+		{
+			glBindAttribLocation(program, instanceAttributeIndex, element.Name.c_str());
+			instanceAttributeIndex += element.GetLocationCount();
+		}
 
-				// Use the infoLog as you see fit.
+		// Link our program, keeping the binary around for the cache
+		if (OpenGLShaderCache::IsEnabled())
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(program);
+		m_Pending = true;
+	}
 
-				GE_CORE_ERROR("Shader Error: {0}", infoLog.data());
-				GE_CORE_ASSERT(false, "Shader Compilation Failure!");
+	bool OpenGLShader::IsReady() const
+	{
+		if (!m_Pending)
+			return true;
 
-				break;
-			}
+		// Without the extension there is no way to ask without waiting
+		if (!OpenGLShaderCache::IsParallelCompileSupported())
+			return false;
 
-			// Shaders are successfully compiled.
-			// Attach our shaders to our program
-			glAttachShader(program, shader);
-			glShaderIDs[glShaderIDIndex++] = shader;
-		}
+		GLint isComplete = 0;
+		glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &isComplete);
+		return isComplete == GL_TRUE;
+	}
 
-		// Link our program
-		glLinkProgram(program);
+	void OpenGLShader::FinishLink() const
+	{
+		if (!m_Pending)
+			return;
+		m_Pending = false;
 
 		// Note the different functions here: glGetProgram* instead of glGetShader*.
 		GLint isLinked = 0;
-		glGetProgramiv(program, GL_LINK_STATUS, (int *)&isLinked);
+		glGetProgramiv(m_RendererID, GL_LINK_STATUS, (int *)&isLinked);
 		if (isLinked == GL_FALSE)
 		{
-			GLint maxLength = 0;
-			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
+			// A stage that failed to compile says more than the link error
+			bool compileFailed = false;
+			for (auto id : m_PendingShaders)
+			{
+				GLint isCompiled = 0;
+				glGetShaderiv(id, GL_COMPILE_STATUS, &isCompiled);
+				if (isCompiled == GL_TRUE)
+					continue;
 
-			// The maxLength includes the NULL character
-			std::vector<GLchar> infoLog(maxLength);
-			glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
+				GLint maxLength = 0;
+				glGetShaderiv(id, GL_INFO_LOG_LENGTH, &maxLength);
 
-			// We don't need the program anymore.
-			glDeleteProgram(program);
+				// The maxLength includes the NULL character
+				std::vector<GLchar> infoLog(maxLength + 1);
+				glGetShaderInfoLog(id, maxLength, &maxLength, &infoLog[0]);
 
-			// Don't leak shaders either.
-			for (auto id : glShaderIDs)
-				glDeleteShader(id);
+				GE_CORE_ERROR("Shader Error in {0}: {1}", m_Name, infoLog.data());
+				compileFailed = true;
+			}
 
-			// Use the infoLog as you see fit.
-			GE_CORE_ERROR("{0}", infoLog.data());
-			GE_CORE_ASSERT(false, "Shader Link Failure!");
+			if (!compileFailed)
+			{
+				GLint maxLength = 0;
+				glGetProgramiv(m_RendererID, GL_INFO_LOG_LENGTH, &maxLength);
 
+				// The maxLength includes the NULL character
+				std::vector<GLchar> infoLog(maxLength + 1);
+				glGetProgramInfoLog(m_RendererID, maxLength, &maxLength, &infoLog[0]);
+				GE_CORE_ERROR("Shader Link Error in {0}: {1}", m_Name, infoLog.data());
+			}
+
+			// We don't need the program anymore. Don't leak shaders either.
+			glDeleteProgram(m_RendererID);
+			m_RendererID = 0;
+			for (auto id : m_PendingShaders)
+				glDeleteShader(id);
+			m_PendingShaders.clear();
+
+			GE_CORE_ASSERT(false, compileFailed ? "Shader Compilation Failure!" : "Shader Link Failure!");
 			return;
 		}
 
 		// Always detach shaders after a successful link.
-		for (auto id : glShaderIDs)
+		for (auto id : m_PendingShaders)
 		{
-			glDetachShader(program, id);
+			glDetachShader(m_RendererID, id);
 			glDeleteShader(id);
 		}
-			
+		m_PendingShaders.clear();
 
-		// Now time to link them together into a program.
-		m_RendererID = program;
+		OpenGLShaderCache::Save(m_SourceHash, m_RendererID);
+
+		m_Instanced = glGetAttribLocation(m_RendererID, "a_InstanceTransform") != -1;
+		Reflect();
 	}
 
-	// Read shader file to a string
-	std::string OpenGLShader::ReadFile(const std::string& filepath)
+	// Looks up every active uniform once so uploads never have to ask OpenGL for a location,
+	// and connects uniform blocks to the binding points the renderer fills
+	void OpenGLShader::Reflect() const
 	{
-		std::string result;
-		std::ifstream in(filepath, std::ios::in | std::ios::binary);
-		if (in)
-		{
-			in.seekg(0, std::ios::end);				// Point to end of file
-			result.resize(in.tellg());				// Where is pointer? aka resize string to size of file
-			in.seekg(0, std::ios::beg);
-			in.read(&result[0], result.size());
-			in.close();
-		}
-		else
+		GLint uniformCount = 0;
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+		GLint maxNameLength = 0;
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+		std::vector<GLchar> nameBuffer(maxNameLength + 1);
+
+		for (GLint i = 0; i < uniformCount; i++)
 		{
-			GE_CORE_ERROR("Could not open file '{0}'", filepath);
+			GLint size = 0;
+			GLenum type = 0;
+			GLsizei length = 0;
+			glGetActiveUniform(m_RendererID, i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+
+			std::string name(nameBuffer.data(), length);
+			GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+			if (location == -1)
+				continue;		// Member of a uniform block
+
+			// Arrays are reported as "name[0]", register the plain name and every element
+			size_t bracket = name.find('[');
+			if (bracket == std::string::npos)
+			{
+				m_UniformLocations[UniformID(name).Hash] = location;
+				continue;
+			}
+
+			std::string baseName = name.substr(0, bracket);
+			m_UniformLocations[UniformID(baseName).Hash] = location;
+			for (GLint element = 0; element < size; element++)
+			{
+				std::string elementName = baseName + "[" + std::to_string(element) + "]";
+				m_UniformLocations[UniformID(elementName).Hash] = glGetUniformLocation(m_RendererID, elementName.c_str());
+			}
 		}
 
-		return result;
-	}
+		GLint blockCount = 0;
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+		for (GLint i = 0; i < blockCount; i++)
+		{
+			GLchar blockName[128];
+			GLsizei length = 0;
+			glGetActiveUniformBlockName(m_RendererID, i, sizeof(blockName), &length, blockName);
 
-	// Process the shader string
-	std::unordered_map<GLenum, std::string> OpenGLShader::PreProcess(const std::string& source)
-	{
-		std::unordered_map <GLenum, std::string> shaderSources;
+			int binding = UniformBuffer::GetBlockBinding(std::string(blockName, length));
+			if (binding < 0)
+			{
+				GE_CORE_WARN("Unknown uniform block {0}", std::string(blockName, length));
+				continue;
+			}
 
-		const char* typeToken = "#type";				// Look for type token
-		size_t typeTokenLength = strlen(typeToken);
-		size_t pos = source.find(typeToken, 0);
-		while (pos != std::string::npos)
-		{
-			size_t eol = source.find_first_of("\r\n", pos);			// End of line
-			GE_CORE_ASSERT(eol != std::string::npos, "Syntax error!");
-			size_t begin = pos + typeTokenLength + 1;
-			std::string type = source.substr(begin, eol - begin);
-			GE_CORE_ASSERT(ShaderTypeFromString(type), "Invalid shader type specified!");
-
-			size_t nextLinePos = source.find_first_not_of("\r\n", eol);
-			pos = source.find(typeToken, nextLinePos);
-			shaderSources[ShaderTypeFromString(type)] = source.substr(nextLinePos, pos - (nextLinePos == std::string::npos ? source.size() - 1 : nextLinePos));
+			glUniformBlockBinding(m_RendererID, i, binding);
 		}
-
-		return shaderSources;
 	}
 
 	void OpenGLShader::Bind() const
 	{
-		glUseProgram(m_RendererID);
+		FinishLink();
+		OpenGLStateCache::BindProgram(m_RendererID);
 	}
 
 	void OpenGLShader::Unbind() const
 	{
-		glUseProgram(0);
+		OpenGLStateCache::BindProgram(0);
 	}
 
 	// Upload data for uniforms
 	// -------------------------------
 
-	void OpenGLShader::UploadUniformInt(const std::string& name, int value)
+	int OpenGLShader::GetUniformLocation(const UniformID& id) const
+	{
+		FinishLink();
+		auto it = m_UniformLocations.find(id.Hash);
+		if (it != m_UniformLocations.end())
+			return it->second;
+
+		return -1;
+	}
+
+	void OpenGLShader::UploadUniformInt(const UniformID& id, int value)
+	{
+		glUniform1i(GetUniformLocation(id), value);
+	}
+
+	void OpenGLShader::UploadUniformIntArray(const UniformID& id, const int* values, uint32_t count)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1i(location, value);
+		glUniform1iv(GetUniformLocation(id), count, values);
 	}
 
-	void OpenGLShader::UploadUniformFloat(const std::string& name, const float value)
+	void OpenGLShader::UploadUniformFloat(const UniformID& id, const float value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1f(location, value);
+		glUniform1f(GetUniformLocation(id), value);
 	}
 
-	void OpenGLShader::UploadUniformFloat2(const std::string& name, const glm::vec2& value)
+	void OpenGLShader::UploadUniformFloat2(const UniformID& id, const glm::vec2& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform2f(location, value.x, value.y);
+		glUniform2f(GetUniformLocation(id), value.x, value.y);
 	}
 
-	void OpenGLShader::UploadUniformFloat3(const std::string& name, const glm::vec3& value)
+	void OpenGLShader::UploadUniformFloat3(const UniformID& id, const glm::vec3& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform3f(location, value.x, value.y, value.z);
+		glUniform3f(GetUniformLocation(id), value.x, value.y, value.z);
 	}
 
-	void OpenGLShader::UploadUniformFloat4(const std::string& name, const glm::vec4& value)
+	void OpenGLShader::UploadUniformFloat4(const UniformID& id, const glm::vec4& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
 		// f in this function name means "float"
-		glUniform4f(location, value.x, value.y, value.z, value.w);
+		glUniform4f(GetUniformLocation(id), value.x, value.y, value.z, value.w);
 	}
 
-	void OpenGLShader::UploadUniformMat3(const std::string& name, const glm::mat3& matrix)
+	void OpenGLShader::UploadUniformMat3(const UniformID& id, const glm::mat3& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
 		// f in this function name means "float" and v means "array of" floats
-		glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+		glUniformMatrix3fv(GetUniformLocation(id), 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
-	void OpenGLShader::UploadUniformMat4(const std::string& name, const glm::mat4& matrix)
+	void OpenGLShader::UploadUniformMat4(const UniformID& id, const glm::mat4& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
 		// f in this function name means "float" and v means "array of" floats
-		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+		glUniformMatrix4fv(GetUniformLocation(id), 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "GameEngine/Renderer/Shader.h"
+#include "GameEngine/Renderer/ShaderPreprocessor.h"
 
 #include <glm/glm.hpp>
 
@@ -18,7 +19,7 @@ namespace ge {
 	class OpenGLShader : public Shader
 	{
 	public:
-		OpenGLShader(const std::string& filepath);
+		OpenGLShader(const std::string& filepath, const ShaderDefines& defines = ShaderDefines());
 		OpenGLShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
 		virtual ~OpenGLShader();
 
@@ -27,21 +28,46 @@ namespace ge {
 
 		virtual const std::string& GetName() const override { return m_Name; }
 
-		void UploadUniformInt(const std::string& name, int value);
+		virtual bool IsInstanced() const override { FinishLink(); return m_Instanced; }
+		virtual bool IsReady() const override;
 
-		void UploadUniformFloat(const std::string& name, const float value);
-		void UploadUniformFloat2(const std::string& name, const glm::vec2& value);
-		void UploadUniformFloat3(const std::string& name, const glm::vec3& value);
-		void UploadUniformFloat4(const std::string& name, const glm::vec4& value);
+		virtual void SetInt(const UniformID& id, int value) override { UploadUniformInt(id, value); }
+		virtual void SetIntArray(const UniformID& id, const int* values, uint32_t count) override { UploadUniformIntArray(id, values, count); }
+		virtual void SetFloat(const UniformID& id, float value) override { UploadUniformFloat(id, value); }
+		virtual void SetFloat2(const UniformID& id, const glm::vec2& value) override { UploadUniformFloat2(id, value); }
+		virtual void SetFloat3(const UniformID& id, const glm::vec3& value) override { UploadUniformFloat3(id, value); }
+		virtual void SetFloat4(const UniformID& id, const glm::vec4& value) override { UploadUniformFloat4(id, value); }
+		virtual void SetMat3(const UniformID& id, const glm::mat3& value) override { UploadUniformMat3(id, value); }
+		virtual void SetMat4(const UniformID& id, const glm::mat4& value) override { UploadUniformMat4(id, value); }
 
-		void UploadUniformMat3(const std::string& name, const glm::mat3& matrix);
-		void UploadUniformMat4(const std::string& name, const glm::mat4& matrix);
+		void UploadUniformInt(const UniformID& id, int value);
+		void UploadUniformIntArray(const UniformID& id, const int* values, uint32_t count);
+
+		void UploadUniformFloat(const UniformID& id, const float value);
+		void UploadUniformFloat2(const UniformID& id, const glm::vec2& value);
+		void UploadUniformFloat3(const UniformID& id, const glm::vec3& value);
+		void UploadUniformFloat4(const UniformID& id, const glm::vec4& value);
+
+		void UploadUniformMat3(const UniformID& id, const glm::mat3& matrix);
+		void UploadUniformMat4(const UniformID& id, const glm::mat4& matrix);
+
+		// -1 when the shader has no active uniform with that name
+		int GetUniformLocation(const UniformID& id) const;
 	private:
-		std::string ReadFile(const std::string& filepath);
-		std::unordered_map<GLenum, std::string> PreProcess(const std::string& source);
-		void Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
+		// Starts the compile and link without waiting for them, unless the program comes from the binary cache
+		void Compile(const ShaderSource& source);
+		// Waits for the link started by Compile and reports any errors, the first use of the shader calls it
+		void FinishLink() const;
+		void Reflect() const;
 	private:
-		uint32_t m_RendererID;		// Number that identifies this object in OpenGL
+		mutable uint32_t m_RendererID = 0;		// Number that identifies this object in OpenGL, 0 when it failed to link
 		std::string m_Name;
+		uint64_t m_SourceHash = 0;
+
+		// Linking is checked on first use, so loading shaders one after another keeps the driver busy with all of them
+		mutable std::vector<uint32_t> m_PendingShaders;
+		mutable bool m_Pending = false;
+		mutable bool m_Instanced = false;
+		mutable std::unordered_map<uint32_t, int> m_UniformLocations;		// UniformID hash -> location, filled at link time
 	};
 }
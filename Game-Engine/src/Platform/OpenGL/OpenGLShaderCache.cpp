@@ -0,0 +1,183 @@
+/*
+	OpenGL Shader Cache
+
+	Keeps linked programs on disk with glGetProgramBinary, so later runs load them with glProgramBinary
+	instead of compiling. Binaries only work on the driver that made them, so the files are keyed by the
+	source hash together with a hash of the vendor, renderer and version strings. The instance attributes
+	are bound to fixed locations before linking, so their layout is part of the key as well.
+	Also knows whether the driver compiles in the background (GL_KHR_parallel_shader_compile).
+*/
+
+#include "gepch.h"
+#include "OpenGLShaderCache.h"
+
+#include "GameEngine/Core/FileSystem.h"
+#include "GameEngine/Renderer/RenderQueue.h"
+
+#include <filesystem>
+#include <fstream>
+#include <glad/glad.h>
+
+namespace ge {
+
+	struct ShaderBinaryHeader
+	{
+		uint32_t Magic = 0;
+		uint32_t Version = 0;
+		uint32_t Format = 0;		// Driver specific, from glGetProgramBinary
+		uint32_t Size = 0;
+		uint64_t SourceHash = 0;
+		uint64_t DriverHash = 0;
+		uint32_t FirstInstanceAttribute = 0;	// InstanceData::FirstAttributeIndex when linked
+		uint32_t InstanceLayout = 0;			// InstanceData::LayoutVersion when linked
+	};
+
+	static_assert(sizeof(ShaderBinaryHeader) == 40, "Shader binary header layout changed, bump s_ShaderBinaryVersion!");
+
+	static constexpr uint32_t s_ShaderBinaryMagic = 0x42534547;		// "GESB"
+	static constexpr uint32_t s_ShaderBinaryVersion = 2;
+
+	struct ShaderCacheData
+	{
+		std::string Directory = "cache/shaders";
+		bool Enabled = true;
+		bool Supported = false;			// The driver has at least one binary format
+		bool ParallelCompile = false;
+		uint64_t DriverHash = 0;
+	};
+
+	static ShaderCacheData s_Data;
+
+	void OpenGLShaderCache::Init(bool parallelCompile)
+	{
+		s_Data.ParallelCompile = parallelCompile;
+
+		GLint formatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		s_Data.Supported = formatCount > 0;
+
+		std::string driver;
+		for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+		{
+			const char* value = (const char*)glGetString(name);
+			driver += value ? value : "";
+			driver += '\n';
+		}
+		s_Data.DriverHash = FileSystem::Hash(driver.data(), driver.size());
+
+		if (!s_Data.Supported)
+			GE_CORE_WARN("The driver has no program binary formats, shaders are compiled every run");
+	}
+
+	void OpenGLShaderCache::SetDirectory(const std::string& directory)
+	{
+		s_Data.Directory = directory;
+	}
+
+	const std::string& OpenGLShaderCache::GetDirectory()
+	{
+		return s_Data.Directory;
+	}
+
+	void OpenGLShaderCache::SetEnabled(bool enabled)
+	{
+		s_Data.Enabled = enabled;
+	}
+
+	bool OpenGLShaderCache::IsEnabled()
+	{
+		return s_Data.Enabled && s_Data.Supported;
+	}
+
+	bool OpenGLShaderCache::IsParallelCompileSupported()
+	{
+		return s_Data.ParallelCompile;
+	}
+
+	static std::string GetBinaryPath(uint64_t sourceHash)
+	{
+		const uint64_t key[3] = { sourceHash, s_Data.DriverHash,
+			((uint64_t)InstanceData::FirstAttributeIndex << 32) | InstanceData::LayoutVersion };
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.glbin", (unsigned long long)FileSystem::Hash(key, sizeof(key)));
+		return s_Data.Directory + "/" + name;
+	}
+
+	bool OpenGLShaderCache::Load(uint64_t sourceHash, uint32_t program)
+	{
+		if (!IsEnabled())
+			return false;
+
+		std::vector<uint8_t> bytes;
+		if (!FileSystem::ReadFile(GetBinaryPath(sourceHash), bytes) || bytes.size() < sizeof(ShaderBinaryHeader))
+			return false;
+
+		ShaderBinaryHeader header;
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (header.Magic != s_ShaderBinaryMagic || header.Version != s_ShaderBinaryVersion || header.SourceHash != sourceHash
+			|| header.DriverHash != s_Data.DriverHash || header.FirstInstanceAttribute != InstanceData::FirstAttributeIndex
+			|| header.InstanceLayout != InstanceData::LayoutVersion || header.Size != bytes.size() - sizeof(header))
+			return false;
+
+		glProgramBinary(program, header.Format, bytes.data() + sizeof(header), (GLsizei)header.Size);
+
+		// Drivers may still refuse a binary they wrote, the shader is compiled again then
+		GLint isLinked = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+		return isLinked == GL_TRUE;
+	}
+
+	void OpenGLShaderCache::Save(uint64_t sourceHash, uint32_t program)
+	{
+		if (!IsEnabled())
+			return;
+
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+			return;
+
+		ShaderBinaryHeader header;
+		std::vector<uint8_t> binary((size_t)length);
+		GLenum format = 0;
+		glGetProgramBinary(program, length, &length, &format, binary.data());
+
+		header.Magic = s_ShaderBinaryMagic;
+		header.Version = s_ShaderBinaryVersion;
+		header.Format = format;
+		header.Size = (uint32_t)length;
+		header.SourceHash = sourceHash;
+		header.DriverHash = s_Data.DriverHash;
+		header.FirstInstanceAttribute = InstanceData::FirstAttributeIndex;
+		header.InstanceLayout = InstanceData::LayoutVersion;
+
+		std::error_code error;
+		std::filesystem::create_directories(s_Data.Directory, error);
+
+		const std::string path = GetBinaryPath(sourceHash);
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!out)
+			{
+				GE_CORE_WARN("Could not open {0} for writing", tempPath);
+				return;
+			}
+
+			out.write((const char*)&header, sizeof(header));
+			out.write((const char*)binary.data(), header.Size);
+			if (!out)
+			{
+				GE_CORE_WARN("Failed writing {0}", tempPath);
+				return;
+			}
+		}
+
+		std::filesystem::rename(tempPath, path, error);
+		if (error)
+		{
+			GE_CORE_WARN("Could not replace {0}: {1}", path, error.message());
+			std::filesystem::remove(tempPath, error);
+		}
+	}
+}
@@ -0,0 +1,37 @@
+/*
+	OpenGL Shader Cache
+
+	Keeps linked programs on disk with glGetProgramBinary, so later runs load them with glProgramBinary
+	instead of compiling. Binaries only work on the driver that made them, so the files are keyed by the
+	source hash together with a hash of the vendor, renderer and version strings. The instance attributes
+	are bound to fixed locations before linking, so their layout is part of the key as well.
+	Also knows whether the driver compiles in the background (GL_KHR_parallel_shader_compile).
+*/
+
+#pragma once
+
+#include "GameEngine/Core/Core.h"
+
+namespace ge {
+
+	class OpenGLShaderCache
+	{
+	public:
+		// Called by the context once OpenGL is loaded
+		static void Init(bool parallelCompile);
+
+		// Folder the binaries are written to, created when the first one is saved
+		static void SetDirectory(const std::string& directory);
+		static const std::string& GetDirectory();
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled();
+
+		// True when compiles and links run on driver threads and can be polled with GL_COMPLETION_STATUS_KHR
+		static bool IsParallelCompileSupported();
+
+		// Links the program from the cached binary, false when there is none or the driver rejects it
+		static bool Load(uint64_t sourceHash, uint32_t program);
+		// The program has to be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+		static void Save(uint64_t sourceHash, uint32_t program);
+	};
+}
@@ -0,0 +1,175 @@
+/*
+	OpenGL State Cache
+
+	Shadow copy of the OpenGL state the renderer changes most often. Binds and state changes
+	go through here and are only issued when the value is different from the last one set.
+	Anything that changes this state without going through the cache has to invalidate it.
+*/
+
+#include "gepch.h"
+#include "OpenGLStateCache.h"
+
+#include <glad/glad.h>
+
+namespace ge {
+
+	// Value that never matches a real name, so the next call is issued
+	static constexpr uint32_t s_Unknown = 0xFFFFFFFF;
+
+	struct StateCacheData
+	{
+		uint32_t Program = s_Unknown;
+		uint32_t VertexArray = s_Unknown;
+		std::array<uint32_t, OpenGLStateCache::MaxTextureUnits> Textures;
+
+		uint32_t Blend = s_Unknown;
+		uint32_t BlendSource = s_Unknown;
+		uint32_t BlendDestination = s_Unknown;
+		uint32_t DepthTest = s_Unknown;
+		uint32_t DepthFunc = s_Unknown;
+		std::array<uint32_t, 4> Viewport;
+
+		RendererAPI::StateStatistics Stats;
+
+		StateCacheData()
+		{
+			Textures.fill(s_Unknown);
+			Viewport.fill(s_Unknown);
+		}
+	};
+
+	static StateCacheData s_Cache;
+
+	// Returns true when the call has to be issued and records the new value
+	static bool Update(uint32_t& cached, uint32_t value)
+	{
+		if (cached == value)
+		{
+			s_Cache.Stats.Skipped++;
+			return false;
+		}
+
+		cached = value;
+		s_Cache.Stats.Issued++;
+		return true;
+	}
+
+	void OpenGLStateCache::BindProgram(uint32_t program)
+	{
+		if (Update(s_Cache.Program, program))
+			glUseProgram(program);
+	}
+
+	void OpenGLStateCache::BindVertexArray(uint32_t vertexArray)
+	{
+		if (Update(s_Cache.VertexArray, vertexArray))
+			glBindVertexArray(vertexArray);
+	}
+
+	void OpenGLStateCache::BindTexture(uint32_t unit, uint32_t texture)
+	{
+		GE_CORE_ASSERT(unit < MaxTextureUnits, "Texture unit out of range!");
+
+		if (Update(s_Cache.Textures[unit], texture))
+			glBindTextureUnit(unit, texture);
+	}
+
+	void OpenGLStateCache::SetBlend(bool enabled)
+	{
+		if (Update(s_Cache.Blend, enabled))
+		{
+			if (enabled)
+				glEnable(GL_BLEND);
+			else
+				glDisable(GL_BLEND);
+		}
+	}
+
+	void OpenGLStateCache::SetBlendFunc(uint32_t source, uint32_t destination)
+	{
+		if (s_Cache.BlendSource == source && s_Cache.BlendDestination == destination)
+		{
+			s_Cache.Stats.Skipped++;
+			return;
+		}
+
+		s_Cache.BlendSource = source;
+		s_Cache.BlendDestination = destination;
+		s_Cache.Stats.Issued++;
+		glBlendFunc(source, destination);
+	}
+
+	void OpenGLStateCache::SetDepthTest(bool enabled)
+	{
+		if (Update(s_Cache.DepthTest, enabled))
+		{
+			if (enabled)
+				glEnable(GL_DEPTH_TEST);
+			else
+				glDisable(GL_DEPTH_TEST);
+		}
+	}
+
+	void OpenGLStateCache::SetDepthFunc(uint32_t func)
+	{
+		if (Update(s_Cache.DepthFunc, func))
+			glDepthFunc(func);
+	}
+
+	void OpenGLStateCache::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		const std::array<uint32_t, 4> viewport = { x, y, width, height };
+		if (s_Cache.Viewport == viewport)
+		{
+			s_Cache.Stats.Skipped++;
+			return;
+		}
+
+		s_Cache.Viewport = viewport;
+		s_Cache.Stats.Issued++;
+		glViewport(x, y, width, height);
+	}
+
+	void OpenGLStateCache::OnProgramDeleted(uint32_t program)
+	{
+		if (s_Cache.Program == program)
+			s_Cache.Program = s_Unknown;
+	}
+
+	void OpenGLStateCache::OnVertexArrayDeleted(uint32_t vertexArray)
+	{
+		if (s_Cache.VertexArray == vertexArray)
+			s_Cache.VertexArray = s_Unknown;
+	}
+
+	void OpenGLStateCache::OnTextureDeleted(uint32_t texture)
+	{
+		for (uint32_t& bound : s_Cache.Textures)
+		{
+			if (bound == texture)
+				bound = s_Unknown;
+		}
+	}
+
+	void OpenGLStateCache::InvalidateTextures()
+	{
+		s_Cache.Textures.fill(s_Unknown);
+	}
+
+	void OpenGLStateCache::Invalidate()
+	{
+		RendererAPI::StateStatistics stats = s_Cache.Stats;
+		s_Cache = StateCacheData();
+		s_Cache.Stats = stats;
+	}
+
+	const RendererAPI::StateStatistics& OpenGLStateCache::GetStatistics()
+	{
+		return s_Cache.Stats;
+	}
+
+	void OpenGLStateCache::ResetStatistics()
+	{
+		s_Cache.Stats = RendererAPI::StateStatistics();
+	}
+}
@@ -0,0 +1,44 @@
+/*
+	OpenGL State Cache
+
+	Shadow copy of the OpenGL state the renderer changes most often. Binds and state changes
+	go through here and are only issued when the value is different from the last one set.
+	Anything that changes this state without going through the cache has to invalidate it.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/RendererAPI.h"
+
+namespace ge {
+
+	class OpenGLStateCache
+	{
+	public:
+		static constexpr uint32_t MaxTextureUnits = 32;
+
+		static void BindProgram(uint32_t program);
+		static void BindVertexArray(uint32_t vertexArray);
+		// Binds to the unit with glBindTextureUnit, so the target comes from the texture
+		static void BindTexture(uint32_t unit, uint32_t texture);
+
+		static void SetBlend(bool enabled);
+		static void SetBlendFunc(uint32_t source, uint32_t destination);
+		static void SetDepthTest(bool enabled);
+		static void SetDepthFunc(uint32_t func);
+		static void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+		// Deleted names can be handed out again, so they must not stay cached as bound
+		static void OnProgramDeleted(uint32_t program);
+		static void OnVertexArrayDeleted(uint32_t vertexArray);
+		static void OnTextureDeleted(uint32_t texture);
+
+		// For code that binds textures with glBindTexture (uploads, framebuffer attachments)
+		static void InvalidateTextures();
+		// Forgets everything, the next call for each state is always issued
+		static void Invalidate();
+
+		static const RendererAPI::StateStatistics& GetStatistics();
+		static void ResetStatistics();
+	};
+}
@@ -6,98 +6,253 @@
 
 #include "gepch.h"
 #include "OpenGLTexture.h"
+#include "OpenGLStateCache.h"
 
-#include "stb_image.h"
+#include "GameEngine/Renderer/ImageData.h"
+#include "GameEngine/Renderer/CookedTexture.h"
+#include "GameEngine/Renderer/IBLBaker.h"
 #include <glad/glad.h>
 
+// S3TC formats, which the core profile headers leave to the extensions
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
 namespace ge {
 
-	// Load textures from file
-	OpenGLTexture2D::OpenGLTexture2D(const std::string& path, bool gammaCorrection)
-		: m_Path(path)
+	// Binds to the active unit for the non DSA upload and parameter calls. The state cache can no longer
+	// tell what the active unit holds, so it forgets its texture bindings.
+	static void BindForEditing(GLenum target, uint32_t texture)
 	{
-		glGenTextures(1, &m_RendererID);
+		glBindTexture(target, texture);
+		OpenGLStateCache::InvalidateTextures();
+	}
 
-		int width, height, nrComponents;
-		unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrComponents, 0);
-		if (data)
+	static GLenum GetCompressedFormat(TextureCompression compression, bool sRGB)
+	{
+		switch (compression)
 		{
-			GLenum internalFormat;
-			GLenum dataFormat;
-			if (nrComponents == 1)
-			{
-				internalFormat = dataFormat = GL_RED;
-			}
-			else if (nrComponents == 3)
-			{
-				internalFormat = gammaCorrection ? GL_SRGB : GL_RGB;
-				dataFormat = GL_RGB;
-			}
-			else if (nrComponents == 4)
-			{
-				internalFormat = gammaCorrection ? GL_SRGB_ALPHA : GL_RGBA;
-				dataFormat = GL_RGBA;
-			}
-
-			glBindTexture(GL_TEXTURE_2D, m_RendererID);
-			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, dataFormat, GL_UNSIGNED_BYTE, data);
-			glGenerateMipmap(GL_TEXTURE_2D);
+			case TextureCompression::BC1:	return sRGB ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			case TextureCompression::BC3:	return sRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			case TextureCompression::BC5:	return GL_COMPRESSED_RG_RGTC2;
+			case TextureCompression::BC6H:	return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+			case TextureCompression::BC7:	return sRGB ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+			case TextureCompression::None:	break;
+		}
 
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		GE_CORE_ASSERT(false, "Not a block compressed format!");
+		return 0;
+	}
 
-			stbi_image_free(data);
-			GE_CORE_INFO(path + " loaded");
-		}
-		else
+	// Uploads the cooked mip levels from firstLevel down to the bound 2D texture as they are stored, nothing is
+	// decoded or generated. firstLevel becomes level 0 of the texture.
+	static void UploadCompressedLevels(const CookedTexture& cooked, uint32_t firstLevel)
+	{
+		const GLenum format = GetCompressedFormat(cooked.GetCompression(), cooked.IsSRGB());
+		const uint32_t levelCount = cooked.GetHeader().LevelCount;
+		for (uint32_t i = firstLevel; i < levelCount; i++)
 		{
-			std::cout << "Texture failed to load at path: " << path << std::endl;
-			stbi_image_free(data);
+			const CookedTextureLevel& level = cooked.GetLevels()[i];
+			glCompressedTexImage2D(GL_TEXTURE_2D, i - firstLevel, format, level.Width, level.Height, 0, (GLsizei)level.Size, cooked.GetLevelData(i));
 		}
+
+		// A chain that stops early must not leave the texture incomplete
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1 - firstLevel);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount - firstLevel > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	}
 
-	OpenGLTexture2D::~OpenGLTexture2D()
+	Scope<OpenGLStreamedTexture> OpenGLStreamedTexture::Create(const CookedTexture& cooked, uint32_t& rendererID)
+	{
+		if (!TextureStreamer::IsEnabled())
+			return nullptr;
+
+		const CookedTextureHeader& header = cooked.GetHeader();
+		if (TextureStreamer::GetBaseMip(header.Width, header.Height, header.LevelCount) == 0)
+			return nullptr;
+
+		// A mapping of its own, the one passed in usually goes away after loading
+		Scope<CookedTexture> mapping = std::make_unique<CookedTexture>();
+		if (!mapping->Open(cooked.GetPath()))
+			return nullptr;
+
+		return std::make_unique<OpenGLStreamedTexture>(std::move(mapping), rendererID);
+	}
+
+	OpenGLStreamedTexture::OpenGLStreamedTexture(Scope<CookedTexture> cooked, uint32_t& rendererID)
+		: m_Cooked(std::move(cooked)), m_RendererID(rendererID)
+	{
+		const CookedTextureHeader& header = m_Cooked->GetHeader();
+		m_ResidentMip = TextureStreamer::GetBaseMip(header.Width, header.Height, header.LevelCount);
+
+		glGenTextures(1, &m_RendererID);
+		BindForEditing(GL_TEXTURE_2D, m_RendererID);
+		UploadCompressedLevels(*m_Cooked, m_ResidentMip);
+
+		TextureStreamer::Register(this);
+	}
+
+	OpenGLStreamedTexture::~OpenGLStreamedTexture()
+	{
+		TextureStreamer::Unregister(this);
+	}
+
+	uint32_t OpenGLStreamedTexture::GetWidth() const
+	{
+		return m_Cooked->GetHeader().Width;
+	}
+
+	uint32_t OpenGLStreamedTexture::GetHeight() const
 	{
+		return m_Cooked->GetHeader().Height;
+	}
+
+	uint32_t OpenGLStreamedTexture::GetMipCount() const
+	{
+		return m_Cooked->GetHeader().LevelCount;
+	}
+
+	size_t OpenGLStreamedTexture::GetMipSize(uint32_t level) const
+	{
+		return (size_t)m_Cooked->GetLevels()[level].Size;
+	}
+
+	// Single levels can't be handed back from a texture object, so the resident levels go into a new one that replaces the old one
+	void OpenGLStreamedTexture::SetResidentMip(uint32_t level)
+	{
+		uint32_t texture;
+		glGenTextures(1, &texture);
+		BindForEditing(GL_TEXTURE_2D, texture);
+		UploadCompressedLevels(*m_Cooked, level);
+
+		OpenGLStateCache::OnTextureDeleted(m_RendererID);
 		glDeleteTextures(1, &m_RendererID);
+		m_RendererID = texture;
+		m_ResidentMip = level;
 	}
 
-	void OpenGLTexture2D::Bind(uint32_t slot) const
+	// Load textures from file
+	OpenGLTexture2D::OpenGLTexture2D(const std::string& path, bool gammaCorrection)
+		: m_Path(path)
 	{
-		if (slot == 0)
+		CookedTexture cooked;
+		if (cooked.OpenForSource(path, gammaCorrection))
 		{
-			glActiveTexture(GL_TEXTURE0);
+			Upload(cooked);
+			return;
 		}
-		else if (slot == 1)
-		{
-			glActiveTexture(GL_TEXTURE1);
-		}
-		else if (slot == 2)
-		{
-			glActiveTexture(GL_TEXTURE2);
-		}
-		else if (slot == 3)
-		{
-			glActiveTexture(GL_TEXTURE3);
-		}
-		else if (slot == 4)
+
+		ImageData image;
+		if (ImageData::Load(path, image))
+			GE_CORE_INFO(path + " loaded");
+		else
+			std::cout << "Texture failed to load at path: " << path << std::endl;
+
+		Upload(image, gammaCorrection);
+	}
+
+	OpenGLTexture2D::OpenGLTexture2D(const ImageData& image, bool gammaCorrection)
+	{
+		Upload(image, gammaCorrection);
+	}
+
+	void OpenGLTexture2D::Upload(const ImageData& image, bool gammaCorrection)
+	{
+		glGenTextures(1, &m_RendererID);
+		if (!image.IsValid())
+			return;
+
+		m_Width = image.GetWidth();
+		m_Height = image.GetHeight();
+
+		GLenum internalFormat = GL_RGBA;
+		GLenum dataFormat = GL_RGBA;
+		if (image.GetChannels() == 1)
 		{
-			glActiveTexture(GL_TEXTURE4);
+			internalFormat = dataFormat = GL_RED;
 		}
-		else if (slot == 5)
+		else if (image.GetChannels() == 2)
 		{
-			glActiveTexture(GL_TEXTURE5);
+			internalFormat = dataFormat = GL_RG;
 		}
-		else if (slot == 6)
+		else if (image.GetChannels() == 3)
 		{
-			glActiveTexture(GL_TEXTURE6);
+			internalFormat = gammaCorrection ? GL_SRGB : GL_RGB;
+			dataFormat = GL_RGB;
 		}
-		else if (slot == 7)
+		else if (image.GetChannels() == 4)
 		{
-			glActiveTexture(GL_TEXTURE7);
+			internalFormat = gammaCorrection ? GL_SRGB_ALPHA : GL_RGBA;
+			dataFormat = GL_RGBA;
 		}
-		glBindTexture(GL_TEXTURE_2D, m_RendererID);
+
+		BindForEditing(GL_TEXTURE_2D, m_RendererID);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Width, m_Height, 0, dataFormat, GL_UNSIGNED_BYTE, image.GetData());
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+
+	OpenGLTexture2D::OpenGLTexture2D(const CookedTexture& cooked)
+	{
+		Upload(cooked);
+	}
+
+	void OpenGLTexture2D::Upload(const CookedTexture& cooked)
+	{
+		m_Width = cooked.GetHeader().Width;
+		m_Height = cooked.GetHeader().Height;
+
+		m_Streamed = OpenGLStreamedTexture::Create(cooked, m_RendererID);
+		if (m_Streamed)
+			return;
+
+		glGenTextures(1, &m_RendererID);
+		BindForEditing(GL_TEXTURE_2D, m_RendererID);
+		UploadCompressedLevels(cooked, 0);
+	}
+
+	OpenGLTexture2D::~OpenGLTexture2D()
+	{
+		OpenGLStateCache::OnTextureDeleted(m_RendererID);
+		glDeleteTextures(1, &m_RendererID);
+	}
+
+	// Empty RGBA texture filled in with SetData
+	OpenGLTexture2D::OpenGLTexture2D(uint32_t width, uint32_t height)
+		: m_Width(width), m_Height(height)
+	{
+		glGenTextures(1, &m_RendererID);
+		BindForEditing(GL_TEXTURE_2D, m_RendererID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+
+	void OpenGLTexture2D::SetData(void* data, uint32_t size)
+	{
+		GE_CORE_ASSERT(size == m_Width * m_Height * 4, "Data must be entire texture!");
+
+		BindForEditing(GL_TEXTURE_2D, m_RendererID);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	}
+
+	void OpenGLTexture2D::Bind(uint32_t slot) const
+	{
+		OpenGLStateCache::BindTexture(slot, m_RendererID);
 	}
 
 
@@ -109,61 +264,85 @@ namespace ge {
 		std::string filename = std::string(path);
 		filename = directory + '/' + filename;
 		GE_CORE_TRACE(filename);
-		glGenTextures(1, &m_RendererID);
 
-		int width, height, nrComponents;
-		unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-		m_Width = width;
-		m_Height = height;
-		if (data)
+		CookedTexture cooked;
+		if (cooked.OpenForSource(filename, false))
 		{
-			GLenum format;
-			if (nrComponents == 1)
-				format = GL_RED;
-			else if (nrComponents == 3)
-				format = GL_RGB;
-			else if (nrComponents == 4)
-				format = GL_RGBA;
-
-			glBindTexture(GL_TEXTURE_2D, m_RendererID);
-			glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-			glGenerateMipmap(GL_TEXTURE_2D);
-
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-			stbi_image_free(data);
-			GE_CORE_INFO(path + " loaded");
+			Upload(cooked);
+			return;
 		}
+
+		ImageData image;
+		if (ImageData::Load(filename, image))
+			GE_CORE_INFO(path + " loaded");
 		else
-		{
 			std::cout << "Texture failed to load at path: " << path << std::endl;
-			stbi_image_free(data);
-		}
+
+		Upload(image);
+	}
+
+	OpenGLTexture3D::OpenGLTexture3D(const ImageData& image, const std::string& path)
+		: m_Path(path)
+	{
+		Upload(image);
+	}
+
+	void OpenGLTexture3D::Upload(const ImageData& image)
+	{
+		glGenTextures(1, &m_RendererID);
+		if (!image.IsValid())
+			return;
+
+		m_Width = image.GetWidth();
+		m_Height = image.GetHeight();
+
+		GLenum format = GL_RGBA;
+		if (image.GetChannels() == 1)
+			format = GL_RED;
+		else if (image.GetChannels() == 2)
+			format = GL_RG;
+		else if (image.GetChannels() == 3)
+			format = GL_RGB;
+
+		BindForEditing(GL_TEXTURE_2D, m_RendererID);
+		glTexImage2D(GL_TEXTURE_2D, 0, format, m_Width, m_Height, 0, format, GL_UNSIGNED_BYTE, image.GetData());
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+
+	OpenGLTexture3D::OpenGLTexture3D(const CookedTexture& cooked, const std::string& path)
+		: m_Path(path)
+	{
+		Upload(cooked);
+	}
+
+	void OpenGLTexture3D::Upload(const CookedTexture& cooked)
+	{
+		m_Width = cooked.GetHeader().Width;
+		m_Height = cooked.GetHeader().Height;
+
+		m_Streamed = OpenGLStreamedTexture::Create(cooked, m_RendererID);
+		if (m_Streamed)
+			return;
+
+		glGenTextures(1, &m_RendererID);
+		BindForEditing(GL_TEXTURE_2D, m_RendererID);
+		UploadCompressedLevels(cooked, 0);
 	}
 
 	OpenGLTexture3D::~OpenGLTexture3D()
 	{
+		OpenGLStateCache::OnTextureDeleted(m_RendererID);
 		glDeleteTextures(1, &m_RendererID);
 	}
 
 	void OpenGLTexture3D::Bind(uint32_t slot) const
 	{
-		if (slot == 0)
-		{
-			glActiveTexture(GL_TEXTURE0);
-		}
-		else if (slot == 1)
-		{
-			glActiveTexture(GL_TEXTURE1);
-		}
-		else if (slot == 2)
-		{
-			glActiveTexture(GL_TEXTURE2);
-		}
-		glBindTexture(GL_TEXTURE_2D, m_RendererID);
+		OpenGLStateCache::BindTexture(slot, m_RendererID);
 	}
 
 
@@ -172,28 +351,39 @@ namespace ge {
 	OpenGLCubemap::OpenGLCubemap(const std::vector<std::string> faces)
 		: m_FacePaths(faces)
 	{
-		glGenTextures(1, &m_RendererID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID);
-
 		// Load image
-		int width, height, channels;
-		stbi_set_flip_vertically_on_load(0);
+		std::vector<ImageData> images(faces.size());
 		for (unsigned int i = 0; i < faces.size(); i++)
 		{
-			stbi_uc* data = stbi_load(faces[i].c_str(), &width, &height, &channels, 0);
-			if (data)
+			if (!ImageData::Load(faces[i], images[i]))
 			{
-				m_Width = width;
-				m_Height = height;
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-				stbi_image_free(data);
-			}
-			else
-			{
-				GE_CORE_ASSERT(data, "Failed to load cubmap image!");
+				GE_CORE_ASSERT(false, "Failed to load cubmap image!");
 			}
 		}
 
+		Upload(images);
+	}
+
+	OpenGLCubemap::OpenGLCubemap(const std::vector<ImageData>& faces)
+	{
+		Upload(faces);
+	}
+
+	void OpenGLCubemap::Upload(const std::vector<ImageData>& faces)
+	{
+		glGenTextures(1, &m_RendererID);
+		BindForEditing(GL_TEXTURE_CUBE_MAP, m_RendererID);
+
+		for (unsigned int i = 0; i < faces.size(); i++)
+		{
+			if (!faces[i].IsValid())
+				continue;
+
+			m_Width = faces[i].GetWidth();
+			m_Height = faces[i].GetHeight();
+			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, m_Width, m_Height, 0, GL_RGB, GL_UNSIGNED_BYTE, faces[i].GetData());
+		}
+
 		// Defining parameters (for scaling)
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -204,12 +394,13 @@ namespace ge {
 
 	OpenGLCubemap::~OpenGLCubemap()
 	{
+		OpenGLStateCache::OnTextureDeleted(m_RendererID);
 		glDeleteTextures(1, &m_RendererID);
 	}
 
 	void OpenGLCubemap::Bind(uint32_t slot) const
 	{
-		glBindTextureUnit(slot, m_RendererID);
+		OpenGLStateCache::BindTexture(slot, m_RendererID);
 	}
 
 	// Load HDR Environment Map texture
@@ -217,116 +408,123 @@ namespace ge {
 		: m_Path(path)
 	{
 		// Load image
-		stbi_set_flip_vertically_on_load(true);
-		int width, height, channels;
-		float* data = stbi_loadf(path.c_str(), &width, &height, &channels, 0);
-		if (data)
+		ImageData image;
+		if (ImageData::LoadHDR(path, image, true))
 		{
-			m_Width = width;
-			m_Height = height;
-
-			glGenTextures(1, &m_RendererID);
-			glBindTexture(GL_TEXTURE_2D, m_RendererID);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
-
-			// Defining parameters (for scaling)
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-			stbi_image_free(data);
-
 			GE_CORE_INFO(path + " loaded");
 		}
 		else
 		{
-			GE_CORE_ASSERT(data, "Failed to load HDR image!");
+			GE_CORE_ASSERT(false, "Failed to load HDR image!");
 		}
+
+		Upload(image);
 	}
 
-	OpenGLHDREnvironmentMap::~OpenGLHDREnvironmentMap()
+	OpenGLHDREnvironmentMap::OpenGLHDREnvironmentMap(const ImageData& image)
 	{
-		glDeleteTextures(1, &m_RendererID);
+		Upload(image);
 	}
 
-	void OpenGLHDREnvironmentMap::Bind(uint32_t slot) const
+	void OpenGLHDREnvironmentMap::Upload(const ImageData& image)
 	{
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, m_RendererID);
+		if (!image.IsValid())
+			return;
+
+		m_Width = image.GetWidth();
+		m_Height = image.GetHeight();
+
+		glGenTextures(1, &m_RendererID);
+		BindForEditing(GL_TEXTURE_2D, m_RendererID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, m_Width, m_Height, 0, GL_RGB, GL_FLOAT, image.GetData());
+
+		// Defining parameters (for scaling)
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	}
 
-	void OpenGLHDREnvironmentMap::BindCubemap(uint32_t slot) const
+	// Creates a cubemap holding every level of the baked data, the levels are stored one after another
+	static uint32_t UploadBakedCubemap(const CubemapData& cubemap)
 	{
-		if (slot == 0)
-		{
-			glActiveTexture(GL_TEXTURE0);
-		}
-		else if (slot == 1)
+		uint32_t rendererID = 0;
+		glGenTextures(1, &rendererID);
+		BindForEditing(GL_TEXTURE_CUBE_MAP, rendererID);
+
+		for (uint32_t level = 0; level < cubemap.Levels; level++)
 		{
-			glActiveTexture(GL_TEXTURE1);
+			const uint32_t size = cubemap.GetLevelSize(level);
+			for (uint32_t face = 0; face < 6; face++)
+				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, level, GL_RGB16F, size, size, 0, GL_RGB, GL_FLOAT, cubemap.GetFace(level, face));
 		}
-		else if (slot == 2)
+
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, cubemap.Levels - 1);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, cubemap.Levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		return rendererID;
+	}
+
+	// Maps baked on the CPU, there is no equirectangular texture to keep around
+	OpenGLHDREnvironmentMap::OpenGLHDREnvironmentMap(const IBLData& data)
+		: m_Width(data.SourceWidth), m_Height(data.SourceHeight)
+	{
+		m_CubemapID = UploadBakedCubemap(data.Environment);
+		m_IrradianceID = UploadBakedCubemap(data.Irradiance);
+		m_PrefilterID = UploadBakedCubemap(data.Prefilter);
+
+		glGenTextures(1, &m_BrdfLUTTextureID);
+		BindForEditing(GL_TEXTURE_2D, m_BrdfLUTTextureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, data.BrdfLUTSize, data.BrdfLUTSize, 0, GL_RG, GL_FLOAT, data.BrdfLUT.data());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+
+	OpenGLHDREnvironmentMap::~OpenGLHDREnvironmentMap()
+	{
+		// Maps that were never created are 0, which deleting ignores
+		const uint32_t textures[] = { m_RendererID, m_CubemapID, m_IrradianceID, m_PrefilterID, m_BrdfLUTTextureID };
+		for (uint32_t texture : textures)
 		{
-			glActiveTexture(GL_TEXTURE2);
+			if (texture != 0)
+				OpenGLStateCache::OnTextureDeleted(texture);
 		}
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_CubemapID);
+		glDeleteTextures(5, textures);
+	}
+
+	void OpenGLHDREnvironmentMap::Bind(uint32_t slot) const
+	{
+		OpenGLStateCache::BindTexture(0, m_RendererID);
+	}
+
+	void OpenGLHDREnvironmentMap::BindCubemap(uint32_t slot) const
+	{
+		OpenGLStateCache::BindTexture(slot, m_CubemapID);
 	}
 
 	void OpenGLHDREnvironmentMap::BindIrradianceMap(uint32_t slot) const
 	{
-		if (slot == 0)
-		{
-			glActiveTexture(GL_TEXTURE0);
-		}
-		else if (slot == 1)
-		{
-			glActiveTexture(GL_TEXTURE1);
-		}
-		else if (slot == 2)
-		{
-			glActiveTexture(GL_TEXTURE2);
-		}
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_IrradianceID);
+		OpenGLStateCache::BindTexture(slot, m_IrradianceID);
 	}
 
 	void OpenGLHDREnvironmentMap::BindPrefilterMap(uint32_t slot) const
 	{
-		if (slot == 0)
-		{
-			glActiveTexture(GL_TEXTURE0);
-		}
-		else if (slot == 1)
-		{
-			glActiveTexture(GL_TEXTURE1);
-		}
-		else if (slot == 2)
-		{
-			glActiveTexture(GL_TEXTURE2);
-		}
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_PrefilterID);
+		OpenGLStateCache::BindTexture(slot, m_PrefilterID);
 	}
 
 	void OpenGLHDREnvironmentMap::BindBrdfLUTTexture(uint32_t slot) const
 	{
-		if (slot == 0)
-		{
-			glActiveTexture(GL_TEXTURE0);
-		}
-		else if (slot == 1)
-		{
-			glActiveTexture(GL_TEXTURE1);
-		}
-		else if (slot == 2)
-		{
-			glActiveTexture(GL_TEXTURE2);
-		}
-		glBindTexture(GL_TEXTURE_2D, m_BrdfLUTTextureID);
+		OpenGLStateCache::BindTexture(slot, m_BrdfLUTTextureID);
 	}
 
 	void OpenGLHDREnvironmentMap::GenerateMipmap() const
 	{
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_CubemapID);
+		BindForEditing(GL_TEXTURE_CUBE_MAP, m_CubemapID);
 		glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 	}
 
@@ -334,7 +532,7 @@ namespace ge {
 	void OpenGLHDREnvironmentMap::SetupCubemap(uint32_t width, uint32_t height)
 	{
 		glGenTextures(1, &m_CubemapID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_CubemapID);
+		BindForEditing(GL_TEXTURE_CUBE_MAP, m_CubemapID);
 
 		for (unsigned int i = 0; i < 6; ++i)
 		{
@@ -350,7 +548,7 @@ namespace ge {
 	void OpenGLHDREnvironmentMap::SetupIrradianceMap(uint32_t width, uint32_t height)
 	{
 		glGenTextures(1, &m_IrradianceID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_IrradianceID);
+		BindForEditing(GL_TEXTURE_CUBE_MAP, m_IrradianceID);
 
 		SetMapTextures(width, height);
 	}
@@ -358,7 +556,7 @@ namespace ge {
 	void OpenGLHDREnvironmentMap::SetupPrefilterMap(uint32_t width, uint32_t height)
 	{
 		glGenTextures(1, &m_PrefilterID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_PrefilterID);
+		BindForEditing(GL_TEXTURE_CUBE_MAP, m_PrefilterID);
 
 		for (unsigned int i = 0; i < 6; ++i)
 		{
@@ -377,7 +575,7 @@ namespace ge {
 	void OpenGLHDREnvironmentMap::SetupBrdfLUTTexture(uint32_t width, uint32_t height)
 	{
 		glGenTextures(1, &m_BrdfLUTTextureID);
-		glBindTexture(GL_TEXTURE_2D, m_BrdfLUTTextureID);
+		BindForEditing(GL_TEXTURE_2D, m_BrdfLUTTextureID);
 
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, width, height, 0, GL_RG, GL_FLOAT, 0);
 
@@ -7,23 +7,60 @@
 #pragma once
 
 #include "GameEngine/Renderer/Texture.h"
+#include "GameEngine/Renderer/TextureStreamer.h"
 
 namespace ge {
 
+	// Mips of a cooked texture that the TextureStreamer moves in and out. The texture object is recreated with
+	// only the resident levels when they change, so dropped levels really give their memory back.
+	class OpenGLStreamedTexture : public StreamableTexture
+	{
+	public:
+		// Null when streaming is off, the texture has nothing above its base mips or the file can't be mapped again.
+		// Otherwise the base mips are uploaded into rendererID, which the streamed texture replaces from then on.
+		static Scope<OpenGLStreamedTexture> Create(const CookedTexture& cooked, uint32_t& rendererID);
+
+		OpenGLStreamedTexture(Scope<CookedTexture> cooked, uint32_t& rendererID);
+		virtual ~OpenGLStreamedTexture();
+
+		virtual uint32_t GetWidth() const override;
+		virtual uint32_t GetHeight() const override;
+		virtual uint32_t GetMipCount() const override;
+		virtual size_t GetMipSize(uint32_t level) const override;
+
+		virtual uint32_t GetResidentMip() const override { return m_ResidentMip; }
+		virtual void SetResidentMip(uint32_t level) override;
+	private:
+		Scope<CookedTexture> m_Cooked;		// Kept mapped, the levels are read again each time they come back
+		uint32_t& m_RendererID;
+		uint32_t m_ResidentMip = 0;
+	};
+
 	class OpenGLTexture2D : public Texture2D 
 	{
 	public:
 		OpenGLTexture2D(const std::string& path, bool gammaCorrection);
+		OpenGLTexture2D(uint32_t width, uint32_t height);
+		OpenGLTexture2D(const ImageData& image, bool gammaCorrection);
+		OpenGLTexture2D(const CookedTexture& cooked);
 		virtual ~OpenGLTexture2D();
 
 		virtual uint32_t GetWidth() const override { return m_Width; }
 		virtual uint32_t GetHeight() const override { return m_Height; }
 
+		virtual void SetData(void* data, uint32_t size) override;
+
 		virtual void Bind(uint32_t slot = 0) const override;
+
+		virtual StreamableTexture* GetStreamable() override { return m_Streamed.get(); }
 	private:
+		void Upload(const ImageData& image, bool gammaCorrection);
+		void Upload(const CookedTexture& cooked);
+
 		std::string m_Path;
-		uint32_t m_Width, m_Height;
+		uint32_t m_Width = 0, m_Height = 0;
 		uint32_t m_RendererID;
+		Scope<OpenGLStreamedTexture> m_Streamed;
 	};
 
 
@@ -31,6 +68,8 @@ namespace ge {
 	{
 	public:
 		OpenGLTexture3D(const std::string& path, const std::string& directory);
+		OpenGLTexture3D(const ImageData& image, const std::string& path);
+		OpenGLTexture3D(const CookedTexture& cooked, const std::string& path);
 		virtual ~OpenGLTexture3D();
 
 		virtual uint32_t GetWidth() const override { return m_Width; }
@@ -42,11 +81,17 @@ namespace ge {
 		virtual void SetType(const std::string& type) override { m_Type = type; }
 
 		virtual void Bind(uint32_t slot = 0) const override;
+
+		virtual StreamableTexture* GetStreamable() override { return m_Streamed.get(); }
 	private:
+		void Upload(const ImageData& image);
+		void Upload(const CookedTexture& cooked);
+
 		std::string m_Path;
 		std::string m_Type;
-		uint32_t m_Width, m_Height;
+		uint32_t m_Width = 0, m_Height = 0;
 		uint32_t m_RendererID;
+		Scope<OpenGLStreamedTexture> m_Streamed;
 	};
 
 
@@ -54,6 +99,7 @@ namespace ge {
 	{
 	public:
 		OpenGLCubemap(const std::vector<std::string> faces);
+		OpenGLCubemap(const std::vector<ImageData>& faces);
 		virtual ~OpenGLCubemap();
 
 		virtual uint32_t GetWidth() const override { return m_Width; }
@@ -61,8 +107,10 @@ namespace ge {
 
 		virtual void Bind(uint32_t slot = 0) const override;
 	private:
+		void Upload(const std::vector<ImageData>& faces);
+
 		std::vector<std::string> m_FacePaths;
-		uint32_t m_Width, m_Height;
+		uint32_t m_Width = 0, m_Height = 0;
 		uint32_t m_RendererID;
 	};
 
@@ -71,6 +119,8 @@ namespace ge {
 	{
 	public:
 		OpenGLHDREnvironmentMap(const std::string& path);
+		OpenGLHDREnvironmentMap(const ImageData& image);
+		OpenGLHDREnvironmentMap(const IBLData& data);
 		virtual ~OpenGLHDREnvironmentMap();
 
 		virtual uint32_t GetWidth() const override { return m_Width; }
@@ -96,15 +146,16 @@ namespace ge {
 		virtual uint32_t GetBrdfLUTTextureID() const override { return m_BrdfLUTTextureID; }
 	private:
 		virtual void SetMapTextures(uint32_t width, uint32_t height) override;
+		void Upload(const ImageData& image);
 
 		std::string m_Path;
-		uint32_t m_Width, m_Height;
+		uint32_t m_Width = 0, m_Height = 0;
 
-		uint32_t m_RendererID;
-		uint32_t m_CubemapID;
-		uint32_t m_IrradianceID;
-		uint32_t m_PrefilterID;
-		uint32_t m_BrdfLUTTextureID;
+		uint32_t m_RendererID = 0;
+		uint32_t m_CubemapID = 0;
+		uint32_t m_IrradianceID = 0;
+		uint32_t m_PrefilterID = 0;
+		uint32_t m_BrdfLUTTextureID = 0;
 	};
 
 }
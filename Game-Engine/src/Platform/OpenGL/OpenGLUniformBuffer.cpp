@@ -0,0 +1,32 @@
+/*
+	OpenGL Uniform Buffer
+
+	Class for uniform buffers in OpenGL, each one stays bound to its binding point
+*/
+
+#include "gepch.h"
+#include "OpenGLUniformBuffer.h"
+
+#include <glad/glad.h>
+
+namespace ge {
+
+	OpenGLUniformBuffer::OpenGLUniformBuffer(uint32_t size, uint32_t binding)
+		: m_Size(size)
+	{
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_RendererID);
+	}
+
+	OpenGLUniformBuffer::~OpenGLUniformBuffer()
+	{
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLUniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		GE_CORE_ASSERT(offset + size <= m_Size, "Data does not fit in the uniform buffer!");
+		glNamedBufferSubData(m_RendererID, offset, size, data);
+	}
+}
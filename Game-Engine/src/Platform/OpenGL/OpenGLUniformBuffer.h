@@ -0,0 +1,24 @@
+/*
+	OpenGL Uniform Buffer
+
+	Class for uniform buffers in OpenGL, each one stays bound to its binding point
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/UniformBuffer.h"
+
+namespace ge {
+
+	class OpenGLUniformBuffer : public UniformBuffer
+	{
+	public:
+		OpenGLUniformBuffer(uint32_t size, uint32_t binding);
+		virtual ~OpenGLUniformBuffer();
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Size;
+	};
+}
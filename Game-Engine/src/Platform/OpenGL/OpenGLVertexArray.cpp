@@ -6,6 +6,7 @@
 
 #include "gepch.h"
 #include "OpenGLVertexArray.h"
+#include "OpenGLStateCache.h"
 
 #include <glad/glad.h>
 
@@ -27,6 +28,12 @@ namespace ge {
 			case ShaderDataType::Int3:		return GL_INT;
 			case ShaderDataType::Int4:		return GL_INT;
 			case ShaderDataType::Bool:		return GL_BOOL;
+			case ShaderDataType::Half2:		return GL_HALF_FLOAT;
+			case ShaderDataType::Half4:		return GL_HALF_FLOAT;
+			case ShaderDataType::Short2:	return GL_SHORT;
+			case ShaderDataType::Short4:	return GL_SHORT;
+			case ShaderDataType::UShort2:	return GL_UNSIGNED_SHORT;
+			case ShaderDataType::UShort4:	return GL_UNSIGNED_SHORT;
 		}
 		GE_CORE_ASSERT(false, "Unknown ShaderDataType!");
 		return 0;
@@ -39,47 +46,64 @@ namespace ge {
 
 	OpenGLVertexArray::~OpenGLVertexArray()
 	{
+		OpenGLStateCache::OnVertexArrayDeleted(m_RendererID);
 		glDeleteVertexArrays(1, &m_RendererID);
 	}
 
 	void OpenGLVertexArray::Bind() const
 	{
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 	}
 
 	void OpenGLVertexArray::Unbind() const
 	{
-		glBindVertexArray(0);
+		OpenGLStateCache::BindVertexArray(0);
 	}
 
 	// Add vertex buffers to the vertex array
 	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
+	{
+		AddVertexBuffer(vertexBuffer, m_VertexBufferIndex);
+	}
+
+	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, uint32_t firstAttributeIndex)
 	{
 		GE_CORE_ASSERT(vertexBuffer->GetLayout().GetElements.size(), "Vertex Buffer has no layout!")
 
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		vertexBuffer->Bind();
 
+		uint32_t index = firstAttributeIndex;
 		const auto& layout = vertexBuffer->GetLayout();
 		for (const auto& element : layout)
 		{
-			glEnableVertexAttribArray(m_VertexBufferIndex);
-			glVertexAttribPointer(m_VertexBufferIndex,
-				element.GetComponentCount(),
-				ShaderDataTypeToOpenGLBaseType(element.Type),
-				element.Normalized ? GL_TRUE : GL_FALSE,
-				layout.GetStride(),
-				(const void*)element.Offset);
-			m_VertexBufferIndex++;
+			// Matrices are passed as one attribute per column
+			const uint32_t locations = element.GetLocationCount();
+			const uint32_t components = element.GetComponentCount() / locations;
+			for (uint32_t i = 0; i < locations; i++)
+			{
+				glEnableVertexAttribArray(index);
+				glVertexAttribPointer(index,
+					components,
+					ShaderDataTypeToOpenGLBaseType(element.Type),
+					element.Normalized ? GL_TRUE : GL_FALSE,
+					layout.GetStride(),
+					(const void*)(element.Offset + sizeof(float) * components * i));
+				glVertexAttribDivisor(index, element.Divisor);
+				index++;
+			}
 		}
 
+		if (index > m_VertexBufferIndex)
+			m_VertexBufferIndex = index;
+
 		m_VertexBuffers.push_back(vertexBuffer);
 	}
 
 	// Add index buffer to vertex array
 	void OpenGLVertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
 	{
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		indexBuffer->Bind();
 
 		m_IndexBuffer = indexBuffer;
@@ -0,0 +1,66 @@
+/*
+	POSIX Mapped File
+
+	Implementation of MappedFile with a read only, private mmap
+*/
+
+#include "gepch.h"
+#include "GameEngine/Core/MappedFile.h"
+
+#ifdef GE_PLATFORM_LINUX
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ge {
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+		const int file = open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(file, &info) != 0 || info.st_size <= 0)
+		{
+			close(file);
+			return false;
+		}
+
+		const size_t size = (size_t)info.st_size;
+		void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		// The mapping keeps its own reference to the file, so the descriptor is not needed any more
+		close(file);
+		if (data == MAP_FAILED)
+			return false;
+
+		// The data is read front to back
+		madvise(data, size, MADV_SEQUENTIAL);
+
+		m_Data = (const uint8_t*)data;
+		m_Size = size;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data)
+			munmap((void*)m_Data, m_Size);
+
+		m_FileHandle = nullptr;
+		m_MappingHandle = nullptr;
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+}
+
+#endif
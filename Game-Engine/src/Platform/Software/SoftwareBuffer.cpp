@@ -0,0 +1,57 @@
+/*
+	Software Buffer
+
+	Vertex, index and indirect buffers of the software renderer, kept in system memory
+*/
+
+#include "gepch.h"
+#include "SoftwareBuffer.h"
+
+#include <cstring>
+
+namespace ge {
+
+	///////////////////////////////////////////////////////////////////////
+	// Vertex Buffer //////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	SoftwareVertexBuffer::SoftwareVertexBuffer(void* vertices, uint32_t size)
+		: m_Data((const uint8_t*)vertices, (const uint8_t*)vertices + size)
+	{
+	}
+
+	SoftwareVertexBuffer::SoftwareVertexBuffer(uint32_t size)
+		: m_Data(size, 0)
+	{
+	}
+
+	void SoftwareVertexBuffer::SetData(const void* data, uint32_t size)
+	{
+		GE_CORE_ASSERT(size <= m_Data.size(), "Data does not fit in the vertex buffer!");
+		std::memcpy(m_Data.data(), data, size);
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Index Buffer ///////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	SoftwareIndexBuffer::SoftwareIndexBuffer(void* indices, uint32_t count)
+		: m_Indices((const uint32_t*)indices, (const uint32_t*)indices + count)
+	{
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Indirect Buffer ////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	SoftwareIndirectBuffer::SoftwareIndirectBuffer(const DrawIndirectCommand* commands, uint32_t count)
+		: m_Commands(commands, commands + count), m_Capacity(count)
+	{
+	}
+
+	void SoftwareIndirectBuffer::SetData(const DrawIndirectCommand* commands, uint32_t count)
+	{
+		GE_CORE_ASSERT(count <= m_Capacity, "Too many commands for the indirect buffer!");
+		m_Commands.assign(commands, commands + count);
+	}
+}
@@ -0,0 +1,64 @@
+/*
+	Software Buffer
+
+	Vertex, index and indirect buffers of the software renderer, kept in system memory
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/Buffer.h"
+
+namespace ge {
+
+	class SoftwareVertexBuffer : public VertexBuffer
+	{
+	public:
+		SoftwareVertexBuffer(void* vertices, uint32_t size);
+		SoftwareVertexBuffer(uint32_t size);
+
+		virtual void Bind() const override {}
+		virtual void Unbind() const override {}
+
+		virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
+
+		virtual void SetData(const void* data, uint32_t size) override;
+
+		const uint8_t* GetData() const { return m_Data.data(); }
+		uint32_t GetSize() const { return (uint32_t)m_Data.size(); }
+	private:
+		std::vector<uint8_t> m_Data;
+		BufferLayout m_Layout;
+	};
+
+	class SoftwareIndexBuffer : public IndexBuffer
+	{
+	public:
+		SoftwareIndexBuffer(void* indices, uint32_t count);
+
+		virtual void Bind() const override {}
+		virtual void Unbind() const override {}
+
+		virtual uint32_t GetCount() const override { return (uint32_t)m_Indices.size(); }
+
+		const uint32_t* GetData() const { return m_Indices.data(); }
+	private:
+		std::vector<uint32_t> m_Indices;
+	};
+
+	class SoftwareIndirectBuffer : public IndirectBuffer
+	{
+	public:
+		SoftwareIndirectBuffer(const DrawIndirectCommand* commands, uint32_t count);
+
+		virtual void Bind() const override {}
+
+		virtual void SetData(const DrawIndirectCommand* commands, uint32_t count) override;
+		virtual uint32_t GetCount() const override { return (uint32_t)m_Commands.size(); }
+
+		const DrawIndirectCommand* GetData() const { return m_Commands.data(); }
+	private:
+		std::vector<DrawIndirectCommand> m_Commands;
+		uint32_t m_Capacity;
+	};
+}
@@ -0,0 +1,61 @@
+/*
+	Software Framebuffer
+
+	Framebuffer of the software renderer, an unclamped float colour buffer with depth like the
+	RGBA16F target of the OpenGL framebuffer. Its colour can be read back or written to an image.
+*/
+
+#include "gepch.h"
+#include "SoftwareFramebuffer.h"
+#include "SoftwareRendererAPI.h"
+
+namespace ge {
+
+	// Environment framebuffers render into attached textures, which have no ids here, so they keep their own colour buffer
+	SoftwareFramebuffer::SoftwareFramebuffer(uint32_t width, uint32_t height, bool /*isEnvironment*/)
+	{
+		m_Target.Resize(width, height);
+	}
+
+	SoftwareFramebuffer::~SoftwareFramebuffer()
+	{
+		if (SoftwareRendererAPI::GetRenderTarget() == &m_Target)
+			SoftwareRendererAPI::SetRenderTarget(nullptr);
+	}
+
+	void SoftwareFramebuffer::Bind() const
+	{
+		SoftwareRendererAPI::SetRenderTarget(&m_Target);
+	}
+
+	void SoftwareFramebuffer::Unbind() const
+	{
+		SoftwareRendererAPI::SetRenderTarget(nullptr);
+	}
+
+	void SoftwareFramebuffer::Rescale(const uint32_t width, const uint32_t height) const
+	{
+		m_Target.Resize(width, height);
+	}
+
+	void SoftwareFramebuffer::ResizeRenderBuffer(const uint32_t width, const uint32_t height) const
+	{
+		m_Target.Resize(width, height);
+	}
+
+	void SoftwareFramebuffer::BindTexture() const
+	{
+		SoftwareSampler::Bind(0, &m_Target.GetColor());
+	}
+
+	void SoftwareFramebuffer::Attach2DTexture(uint32_t /*id*/, uint32_t /*level*/) const
+	{
+		GE_CORE_WARN("Software framebuffers can't attach textures by id, drawing to the framebuffer's own colour buffer");
+	}
+
+	void SoftwareFramebuffer::AttachCubemapTexture(uint32_t /*id*/, uint32_t /*face*/, uint32_t /*level*/) const
+	{
+		GE_CORE_WARN("Software framebuffers can't attach textures by id, drawing to the framebuffer's own colour buffer");
+	}
+
+}
@@ -0,0 +1,36 @@
+/*
+	Software Framebuffer
+
+	Framebuffer of the software renderer, an unclamped float colour buffer with depth like the
+	RGBA16F target of the OpenGL framebuffer. Its colour can be read back or written to an image.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/Framebuffer.h"
+#include "SoftwareRasterizer.h"
+
+namespace ge {
+
+	class SoftwareFramebuffer : public Framebuffer
+	{
+	public:
+		SoftwareFramebuffer(uint32_t width, uint32_t height, bool isEnvironment);
+		virtual ~SoftwareFramebuffer();
+
+		virtual void Bind() const;
+		virtual void Unbind() const;
+
+		virtual void Rescale(const uint32_t width, const uint32_t height) const;
+		virtual void ResizeRenderBuffer(const uint32_t width, const uint32_t height) const;
+		virtual void BindTexture() const;
+		virtual void Attach2DTexture(uint32_t id, uint32_t level) const;
+		virtual void AttachCubemapTexture(uint32_t id, uint32_t face, uint32_t level) const;
+
+		const SoftwareRenderTarget& GetTarget() const { return m_Target; }
+	private:
+		// The interface resizes through const methods
+		mutable SoftwareRenderTarget m_Target = SoftwareRenderTarget(false);
+	};
+
+}
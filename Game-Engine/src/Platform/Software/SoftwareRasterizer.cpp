@@ -0,0 +1,420 @@
+/*
+	Software Rasterizer
+
+	Triangle pipeline of the software renderer. Vertices are shaded by the program's vertex callable,
+	triangles are clipped against the near plane and binned into screen tiles, and the tiles are filled
+	in parallel on a thread pool. Each tile draws its triangles in submission order, so depth testing and
+	blending give the same result as drawing them one after the other.
+	Pixels follow the OpenGL rules: centres are sampled, shared edges use the top left rule and
+	varyings are interpolated with perspective correction.
+*/
+
+#include "gepch.h"
+#include "SoftwareRasterizer.h"
+
+#include "SoftwareVertexArray.h"
+#include "GameEngine/Core/ThreadPool.h"
+
+#include <cfloat>
+#include <fstream>
+
+namespace ge {
+
+	/////////////////////////////////////////////////////////////////////////////
+	// Render Target ////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+
+	void SoftwareRenderTarget::Resize(uint32_t width, uint32_t height)
+	{
+		if (width == m_Width && height == m_Height)
+			return;
+
+		m_Width = width;
+		m_Height = height;
+		m_Color.Allocate(width, height);
+		m_Depth.assign((size_t)width * height, 1.0f);
+	}
+
+	void SoftwareRenderTarget::Clear(const glm::vec4& color)
+	{
+		glm::vec4 value = m_ClampColor ? glm::clamp(color, glm::vec4(0.0f), glm::vec4(1.0f)) : color;
+		std::fill(m_Color.GetTexels(), m_Color.GetTexels() + (size_t)m_Width * m_Height, value);
+		std::fill(m_Depth.begin(), m_Depth.end(), 1.0f);
+	}
+
+	void SoftwareRenderTarget::ReadPixels(std::vector<uint8_t>& pixels) const
+	{
+		pixels.resize((size_t)m_Width * m_Height * 4);
+		const glm::vec4* texels = m_Color.GetTexels();
+		for (uint32_t y = 0; y < m_Height; y++)
+		{
+			const glm::vec4* row = texels + (size_t)(m_Height - 1 - y) * m_Width;
+			uint8_t* out = pixels.data() + (size_t)y * m_Width * 4;
+			for (uint32_t x = 0; x < m_Width; x++)
+			{
+				for (int c = 0; c < 4; c++)
+					out[x * 4 + c] = (uint8_t)(glm::clamp(row[x][c], 0.0f, 1.0f) * 255.0f + 0.5f);
+			}
+		}
+	}
+
+	bool SoftwareRenderTarget::WriteImage(const std::string& path) const
+	{
+		std::ofstream out(path, std::ios::out | std::ios::binary);
+		if (!out)
+		{
+			GE_CORE_ERROR("Could not write image '{0}'", path);
+			return false;
+		}
+
+		std::vector<uint8_t> pixels;
+		ReadPixels(pixels);
+
+		std::vector<uint8_t> rgb((size_t)m_Width * m_Height * 3);
+		for (size_t i = 0; i < (size_t)m_Width * m_Height; i++)
+		{
+			rgb[i * 3 + 0] = pixels[i * 4 + 0];
+			rgb[i * 3 + 1] = pixels[i * 4 + 1];
+			rgb[i * 3 + 2] = pixels[i * 4 + 2];
+		}
+
+		out << "P6\n" << m_Width << " " << m_Height << "\n255\n";
+		out.write((const char*)rgb.data(), rgb.size());
+		return (bool)out;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////
+	// Rasterizer ///////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+
+	static bool DepthPasses(SoftwareDepthFunc func, float depth, float stored)
+	{
+		switch (func)
+		{
+			case SoftwareDepthFunc::Less:			return depth < stored;
+			case SoftwareDepthFunc::LessEqual:		return depth <= stored;
+			case SoftwareDepthFunc::Equal:			return depth == stored;
+			case SoftwareDepthFunc::GreaterEqual:	return depth >= stored;
+			case SoftwareDepthFunc::Greater:		return depth > stored;
+		}
+		return true;
+	}
+
+	void SoftwareRasterizer::Draw(SoftwareRenderTarget& target, const SoftwarePipelineState& state, const SoftwareDraw& draw, ThreadPool* pool)
+	{
+		if (!draw.Shader || !draw.VertexArray || draw.Count < 3 || draw.InstanceCount == 0)
+			return;
+
+		m_Target = &target;
+		m_State = state;
+		m_Shader = draw.Shader;
+		m_Program = &draw.Shader->GetProgram();
+		if (!m_Program->Vertex || !m_Program->Pixel)
+			return;
+
+		m_ClipX0 = (int32_t)state.ViewportX;
+		m_ClipY0 = (int32_t)state.ViewportY;
+		m_ClipX1 = (int32_t)std::min(state.ViewportX + state.ViewportWidth, target.GetWidth()) - 1;
+		m_ClipY1 = (int32_t)std::min(state.ViewportY + state.ViewportHeight, target.GetHeight()) - 1;
+		if (m_ClipX0 > m_ClipX1 || m_ClipY0 > m_ClipY1)
+			return;
+
+		m_TilesX = (target.GetWidth() + TileSize - 1) / TileSize;
+		m_TilesY = (target.GetHeight() + TileSize - 1) / TileSize;
+		m_Bins.resize((size_t)m_TilesX * m_TilesY);
+
+		// Only the vertices the draw references are shaded, once per instance
+		uint32_t firstVertex = draw.FirstVertex;
+		uint32_t lastVertex = draw.FirstVertex + draw.Count - 1;
+		if (draw.Indices)
+		{
+			firstVertex = UINT32_MAX;
+			lastVertex = 0;
+			for (uint32_t i = 0; i < draw.Count; i++)
+			{
+				uint32_t vertex = (uint32_t)((int64_t)draw.Indices[i] + draw.BaseVertex);
+				firstVertex = std::min(firstVertex, vertex);
+				lastVertex = std::max(lastVertex, vertex);
+			}
+		}
+
+		const bool strip = draw.Topology == SoftwareTopology::TriangleStrip;
+		const uint32_t triangleCount = strip ? draw.Count - 2 : draw.Count / 3;
+
+		for (uint32_t instance = 0; instance < draw.InstanceCount; instance++)
+		{
+			ShadeVertices(draw, firstVertex, lastVertex - firstVertex + 1, instance, pool);
+
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				uint32_t corners[3] = { strip ? t : t * 3, strip ? t + 1 : t * 3 + 1, strip ? t + 2 : t * 3 + 2 };
+				// Odd triangles of a strip are wound the other way, swapping keeps the winding of the strip
+				if (strip && (t & 1))
+					std::swap(corners[0], corners[1]);
+
+				const SoftwareVertex* vertices[3];
+				for (int i = 0; i < 3; i++)
+				{
+					uint32_t vertex = draw.Indices ? (uint32_t)((int64_t)draw.Indices[corners[i]] + draw.BaseVertex) : draw.FirstVertex + corners[i];
+					vertices[i] = &m_Vertices[vertex - firstVertex];
+				}
+				AddTriangle(vertices);
+
+				if (m_Triangles.size() >= BatchSize)
+					Flush(pool);
+			}
+		}
+
+		Flush(pool);
+	}
+
+	void SoftwareRasterizer::ShadeVertices(const SoftwareDraw& draw, uint32_t firstVertex, uint32_t vertexCount, uint32_t instance, ThreadPool* pool)
+	{
+		m_Vertices.resize(vertexCount);
+
+		auto shade = [this, &draw, firstVertex, instance](uint32_t begin, uint32_t end)
+		{
+			glm::vec4 attributes[SoftwareVertexArray::MaxAttributes];
+			for (uint32_t i = begin; i < end; i++)
+			{
+				draw.VertexArray->Fetch(firstVertex + i, instance, draw.BaseInstance, attributes);
+				m_Vertices[i] = SoftwareVertex();
+				m_Program->Vertex(*m_Shader, attributes, m_Vertices[i]);
+			}
+		};
+
+		constexpr uint32_t chunkSize = 1024;
+		if (pool && vertexCount > chunkSize)
+		{
+			for (uint32_t begin = 0; begin < vertexCount; begin += chunkSize)
+			{
+				uint32_t end = std::min(begin + chunkSize, vertexCount);
+				pool->Submit([&shade, begin, end]() { shade(begin, end); });
+			}
+			pool->WaitIdle();
+		}
+		else
+		{
+			shade(0, vertexCount);
+		}
+	}
+
+	void SoftwareRasterizer::AddTriangle(const SoftwareVertex* vertices[3])
+	{
+		const uint32_t varyingCount = std::min(m_Program->VaryingCount, SoftwareVertex::MaxVaryings);
+
+		// Clip against the near plane (z >= -w), which leaves a triangle or a quad
+		SoftwareVertex clipped[4];
+		uint32_t clippedCount = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			const SoftwareVertex& a = *vertices[i];
+			const SoftwareVertex& b = *vertices[(i + 1) % 3];
+			float da = a.Position.z + a.Position.w;
+			float db = b.Position.z + b.Position.w;
+
+			if (da >= 0.0f)
+				clipped[clippedCount++] = a;
+			if ((da >= 0.0f) != (db >= 0.0f))
+			{
+				float t = da / (da - db);
+				SoftwareVertex& vertex = clipped[clippedCount++];
+				vertex.Position = glm::mix(a.Position, b.Position, t);
+				for (uint32_t v = 0; v < varyingCount; v++)
+					vertex.Varyings[v] = glm::mix(a.Varyings[v], b.Varyings[v], t);
+			}
+		}
+		if (clippedCount < 3)
+			return;
+
+		// To the viewport, with y up like OpenGL
+		glm::vec3 screen[4];
+		float invW[4];
+		for (uint32_t i = 0; i < clippedCount; i++)
+		{
+			const glm::vec4& position = clipped[i].Position;
+			if (position.w <= 0.0f)
+				return;
+
+			invW[i] = 1.0f / position.w;
+			screen[i].x = (float)m_State.ViewportX + (position.x * invW[i] * 0.5f + 0.5f) * (float)m_State.ViewportWidth;
+			screen[i].y = (float)m_State.ViewportY + (position.y * invW[i] * 0.5f + 0.5f) * (float)m_State.ViewportHeight;
+			screen[i].z = position.z * invW[i] * 0.5f + 0.5f;
+		}
+
+		for (uint32_t fan = 1; fan + 1 < clippedCount; fan++)
+		{
+			uint32_t corners[3] = { 0, fan, fan + 1 };
+
+			float area = (screen[corners[1]].x - screen[corners[0]].x) * (screen[corners[2]].y - screen[corners[0]].y) -
+				(screen[corners[2]].x - screen[corners[0]].x) * (screen[corners[1]].y - screen[corners[0]].y);
+			// Nothing is culled, clockwise triangles are turned around so every edge test has the same sign
+			if (area < 0.0f)
+				std::swap(corners[1], corners[2]);
+			else if (!(area > 0.0f))
+				continue;
+
+			Triangle triangle;
+			float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+			for (int i = 0; i < 3; i++)
+			{
+				const uint32_t corner = corners[i];
+				triangle.Screen[i] = screen[corner];
+				triangle.InvW[i] = invW[corner];
+				for (uint32_t v = 0; v < varyingCount; v++)
+					triangle.Varyings[i][v] = clipped[corner].Varyings[v] * invW[corner];
+
+				minX = std::min(minX, screen[corner].x);
+				minY = std::min(minY, screen[corner].y);
+				maxX = std::max(maxX, screen[corner].x);
+				maxY = std::max(maxY, screen[corner].y);
+			}
+
+			// Pixels whose centre can be inside
+			triangle.MinX = std::max(m_ClipX0, (int32_t)std::ceil(std::max(minX - 0.5f, -1.0f)));
+			triangle.MinY = std::max(m_ClipY0, (int32_t)std::ceil(std::max(minY - 0.5f, -1.0f)));
+			triangle.MaxX = std::min(m_ClipX1, (int32_t)std::floor(std::min(maxX - 0.5f, (float)m_ClipX1 + 1.0f)));
+			triangle.MaxY = std::min(m_ClipY1, (int32_t)std::floor(std::min(maxY - 0.5f, (float)m_ClipY1 + 1.0f)));
+			if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+				continue;
+
+			m_Triangles.push_back(triangle);
+		}
+	}
+
+	void SoftwareRasterizer::Flush(ThreadPool* pool)
+	{
+		if (m_Triangles.empty())
+			return;
+
+		for (std::vector<uint32_t>& bin : m_Bins)
+			bin.clear();
+
+		uint32_t busyTiles = 0;
+		for (uint32_t i = 0; i < (uint32_t)m_Triangles.size(); i++)
+		{
+			const Triangle& triangle = m_Triangles[i];
+			for (int32_t ty = triangle.MinY / (int32_t)TileSize; ty <= triangle.MaxY / (int32_t)TileSize; ty++)
+			{
+				for (int32_t tx = triangle.MinX / (int32_t)TileSize; tx <= triangle.MaxX / (int32_t)TileSize; tx++)
+				{
+					std::vector<uint32_t>& bin = m_Bins[ty * m_TilesX + tx];
+					busyTiles += bin.empty() ? 1 : 0;
+					bin.push_back(i);
+				}
+			}
+		}
+
+		// Tiles cover separate pixels, so they need no locking
+		const uint32_t tileCount = m_TilesX * m_TilesY;
+		if (pool && busyTiles > 1)
+		{
+			for (uint32_t tile = 0; tile < tileCount; tile++)
+			{
+				if (!m_Bins[tile].empty())
+					pool->Submit([this, tile]() { RasterizeTile(tile); });
+			}
+			pool->WaitIdle();
+		}
+		else
+		{
+			for (uint32_t tile = 0; tile < tileCount; tile++)
+			{
+				if (!m_Bins[tile].empty())
+					RasterizeTile(tile);
+			}
+		}
+
+		m_Triangles.clear();
+	}
+
+	void SoftwareRasterizer::RasterizeTile(uint32_t tile)
+	{
+		const int32_t tileX0 = (int32_t)(tile % m_TilesX * TileSize);
+		const int32_t tileY0 = (int32_t)(tile / m_TilesX * TileSize);
+		const int32_t tileX1 = tileX0 + (int32_t)TileSize - 1;
+		const int32_t tileY1 = tileY0 + (int32_t)TileSize - 1;
+
+		const uint32_t width = m_Target->GetWidth();
+		glm::vec4* colors = m_Target->GetColor().GetTexels();
+		float* depths = m_Target->GetDepth();
+		const bool clampColor = m_Target->ClampsColor();
+		const uint32_t varyingCount = std::min(m_Program->VaryingCount, SoftwareVertex::MaxVaryings);
+
+		glm::vec4 varyings[SoftwareVertex::MaxVaryings];
+		for (uint32_t index : m_Bins[tile])
+		{
+			const Triangle& triangle = m_Triangles[index];
+			const int32_t minX = std::max(triangle.MinX, tileX0), maxX = std::min(triangle.MaxX, tileX1);
+			const int32_t minY = std::max(triangle.MinY, tileY0), maxY = std::min(triangle.MaxY, tileY1);
+
+			// Edge i runs from corner i to the next and is positive inside. In doubles the products of the
+			// float coordinates are exact, so an edge shared by two triangles gets exactly opposite values.
+			double a[3], b[3], c[3];
+			bool topLeft[3];
+			for (int i = 0; i < 3; i++)
+			{
+				const glm::vec3& v0 = triangle.Screen[i];
+				const glm::vec3& v1 = triangle.Screen[(i + 1) % 3];
+				a[i] = (double)v0.y - (double)v1.y;
+				b[i] = (double)v1.x - (double)v0.x;
+				c[i] = (double)v0.x * (double)v1.y - (double)v0.y * (double)v1.x;
+				topLeft[i] = a[i] > 0.0 || (a[i] == 0.0 && b[i] < 0.0);
+			}
+			const double area = a[0] * triangle.Screen[2].x + b[0] * triangle.Screen[2].y + c[0];
+			if (!(area > 0.0))
+				continue;
+			const double invArea = 1.0 / area;
+
+			for (int32_t y = minY; y <= maxY; y++)
+			{
+				const double py = y + 0.5;
+				for (int32_t x = minX; x <= maxX; x++)
+				{
+					const double px = x + 0.5;
+					double e[3];
+					bool inside = true;
+					for (int i = 0; i < 3 && inside; i++)
+					{
+						e[i] = a[i] * px + b[i] * py + c[i];
+						inside = e[i] > 0.0 || (e[i] == 0.0 && topLeft[i]);
+					}
+					if (!inside)
+						continue;
+
+					// Each edge weighs the corner opposite it
+					const float w0 = (float)(e[1] * invArea);
+					const float w1 = (float)(e[2] * invArea);
+					const float w2 = (float)(e[0] * invArea);
+
+					// Pixels beyond the far plane are clipped like on the GPU
+					const float depth = w0 * triangle.Screen[0].z + w1 * triangle.Screen[1].z + w2 * triangle.Screen[2].z;
+					if (depth < 0.0f || depth > 1.0f)
+						continue;
+
+					const size_t pixel = (size_t)y * width + x;
+					if (m_State.DepthTest && !DepthPasses(m_State.DepthFunc, depth, depths[pixel]))
+						continue;
+
+					const float invW = w0 * triangle.InvW[0] + w1 * triangle.InvW[1] + w2 * triangle.InvW[2];
+					const float w = 1.0f / invW;
+					for (uint32_t v = 0; v < varyingCount; v++)
+						varyings[v] = (triangle.Varyings[0][v] * w0 + triangle.Varyings[1][v] * w1 + triangle.Varyings[2][v] * w2) * w;
+
+					glm::vec4 color(0.0f);
+					if (!m_Program->Pixel(*m_Shader, varyings, color))
+						continue;
+
+					if (m_State.DepthTest)
+						depths[pixel] = depth;
+
+					if (clampColor)
+						color = glm::clamp(color, glm::vec4(0.0f), glm::vec4(1.0f));
+					if (m_State.Blend)
+						color = color * color.a + colors[pixel] * (1.0f - color.a);
+					colors[pixel] = color;
+				}
+			}
+		}
+	}
+}
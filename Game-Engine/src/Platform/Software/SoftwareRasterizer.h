@@ -0,0 +1,119 @@
+/*
+	Software Rasterizer
+
+	Triangle pipeline of the software renderer. Vertices are shaded by the program's vertex callable,
+	triangles are clipped against the near plane and binned into screen tiles, and the tiles are filled
+	in parallel on a thread pool. Each tile draws its triangles in submission order, so depth testing and
+	blending give the same result as drawing them one after the other.
+	Pixels follow the OpenGL rules: centres are sampled, shared edges use the top left rule and
+	varyings are interpolated with perspective correction.
+*/
+
+#pragma once
+
+#include "SoftwareShader.h"
+#include "SoftwareTexture.h"
+
+namespace ge {
+
+	class ThreadPool;
+	class SoftwareVertexArray;
+
+	// Colour and depth buffer. Colour is kept as floats, targets standing in for 8 bit buffers clamp it to [0, 1].
+	class SoftwareRenderTarget
+	{
+	public:
+		SoftwareRenderTarget(bool clampColor) : m_ClampColor(clampColor) {}
+
+		void Resize(uint32_t width, uint32_t height);
+		// Colour to the value, depth to 1
+		void Clear(const glm::vec4& color);
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		bool ClampsColor() const { return m_ClampColor; }
+
+		// Rows from the bottom, like OpenGL. The colour can be bound as a texture.
+		SoftwareImage& GetColor() { return m_Color; }
+		const SoftwareImage& GetColor() const { return m_Color; }
+		float* GetDepth() { return m_Depth.data(); }
+
+		// RGBA with 8 bits per channel, the top row first like image files
+		void ReadPixels(std::vector<uint8_t>& pixels) const;
+		// Binary PPM, which needs no image library and every image tool reads
+		bool WriteImage(const std::string& path) const;
+	private:
+		uint32_t m_Width = 0, m_Height = 0;
+		SoftwareImage m_Color = SoftwareImage(false);
+		std::vector<float> m_Depth;
+		bool m_ClampColor;
+	};
+
+	enum class SoftwareDepthFunc
+	{
+		Less = 0, LessEqual, Equal, GreaterEqual, Greater
+	};
+
+	struct SoftwarePipelineState
+	{
+		bool DepthTest = false;
+		SoftwareDepthFunc DepthFunc = SoftwareDepthFunc::Less;
+		bool Blend = false;				// Source alpha, one minus source alpha
+		uint32_t ViewportX = 0, ViewportY = 0;
+		uint32_t ViewportWidth = 0, ViewportHeight = 0;
+	};
+
+	enum class SoftwareTopology
+	{
+		Triangles = 0, TriangleStrip
+	};
+
+	struct SoftwareDraw
+	{
+		const SoftwareShader* Shader = nullptr;
+		const SoftwareVertexArray* VertexArray = nullptr;
+		SoftwareTopology Topology = SoftwareTopology::Triangles;
+		const uint32_t* Indices = nullptr;		// Null draws Count vertices from FirstVertex
+		uint32_t Count = 0;
+		uint32_t FirstVertex = 0;
+		int32_t BaseVertex = 0;
+		uint32_t InstanceCount = 1;
+		uint32_t BaseInstance = 0;
+	};
+
+	class SoftwareRasterizer
+	{
+	public:
+		static constexpr uint32_t TileSize = 64;
+		// Triangles are rasterized in batches of this many to bound the memory a large draw needs
+		static constexpr uint32_t BatchSize = 8192;
+
+		// Runs on the pool's threads, or on the calling thread without one
+		void Draw(SoftwareRenderTarget& target, const SoftwarePipelineState& state, const SoftwareDraw& draw, ThreadPool* pool);
+	private:
+		// Screen space triangle with counter clockwise corners, varyings divided by w for perspective correction
+		struct Triangle
+		{
+			glm::vec3 Screen[3];		// Pixels and depth from 0 to 1
+			float InvW[3];
+			glm::vec4 Varyings[3][SoftwareVertex::MaxVaryings];
+			int32_t MinX, MinY, MaxX, MaxY;
+		};
+
+		void ShadeVertices(const SoftwareDraw& draw, uint32_t firstVertex, uint32_t vertexCount, uint32_t instance, ThreadPool* pool);
+		void AddTriangle(const SoftwareVertex* vertices[3]);
+		void Flush(ThreadPool* pool);
+		void RasterizeTile(uint32_t tile);
+	private:
+		SoftwareRenderTarget* m_Target = nullptr;
+		SoftwarePipelineState m_State;
+		const SoftwareProgram* m_Program = nullptr;
+		const SoftwareShader* m_Shader = nullptr;
+		int32_t m_ClipX0 = 0, m_ClipY0 = 0, m_ClipX1 = 0, m_ClipY1 = 0;		// Viewport inside the target, inclusive
+
+		std::vector<SoftwareVertex> m_Vertices;
+		std::vector<Triangle> m_Triangles;
+		uint32_t m_TilesX = 0, m_TilesY = 0;
+		std::vector<std::vector<uint32_t>> m_Bins;
+	};
+}
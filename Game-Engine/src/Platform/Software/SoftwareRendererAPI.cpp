@@ -0,0 +1,227 @@
+/*
+	Software Renderer API
+
+	Renderer API drawing on the CPU with the software rasterizer, so scenes can be rendered without
+	a GPU or a window, for example to compare them against golden images in automated tests.
+	Draws go to the bound software framebuffer or to the back buffer, which takes the size of the viewport.
+*/
+
+#include "gepch.h"
+#include "SoftwareRendererAPI.h"
+
+#include "SoftwareBuffer.h"
+#include "SoftwareVertexArray.h"
+#include "GameEngine/Core/ThreadPool.h"
+
+namespace ge {
+
+	struct SoftwareRendererData
+	{
+		SoftwareRenderTarget BackBuffer = SoftwareRenderTarget(true);
+		SoftwareRenderTarget* Target = nullptr;
+		SoftwarePipelineState State;
+		glm::vec4 ClearColor = glm::vec4(0.0f);
+		SoftwareRasterizer Rasterizer;
+
+		Scope<ThreadPool> Workers;
+		uint32_t ThreadCount = 0;
+
+		RendererAPI::StateStatistics Statistics;
+	};
+
+	static SoftwareRendererData s_Data;
+
+	void SoftwareRendererAPI::Init()
+	{
+		s_Data.State.Blend = true;
+	}
+
+	void SoftwareRendererAPI::EnableZBuffer()
+	{
+		s_Data.State.DepthTest = true;
+		s_Data.Statistics.Issued++;
+	}
+
+	void SoftwareRendererAPI::DisableZBuffer()
+	{
+		s_Data.State.DepthTest = false;
+		s_Data.Statistics.Issued++;
+	}
+
+	void SoftwareRendererAPI::DepthFunc(const std::string setting)
+	{
+		if (setting == "EQUAL")
+			s_Data.State.DepthFunc = SoftwareDepthFunc::Equal;
+		else if (setting == "LEQUAL")
+			s_Data.State.DepthFunc = SoftwareDepthFunc::LessEqual;
+		else if (setting == "GEQUAL")
+			s_Data.State.DepthFunc = SoftwareDepthFunc::GreaterEqual;
+		else if (setting == "LESS")
+			s_Data.State.DepthFunc = SoftwareDepthFunc::Less;
+		else if (setting == "GREATER")
+			s_Data.State.DepthFunc = SoftwareDepthFunc::Greater;
+		else
+			GE_CORE_ERROR("Invalid depth function value: " + setting);
+		s_Data.Statistics.Issued++;
+	}
+
+	// Cubemaps are always sampled across their seams
+	void SoftwareRendererAPI::EnableSeamlessCubemap()
+	{
+	}
+
+	void SoftwareRendererAPI::WireFrame()
+	{
+		GE_CORE_WARN("Wireframe is not supported by the software renderer, triangles are filled");
+	}
+
+	void SoftwareRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		s_Data.State.ViewportX = x;
+		s_Data.State.ViewportY = y;
+		s_Data.State.ViewportWidth = width;
+		s_Data.State.ViewportHeight = height;
+		s_Data.Statistics.Issued++;
+
+		// The back buffer follows the window size, which the renderer passes on as the viewport
+		if (!s_Data.Target)
+			s_Data.BackBuffer.Resize(x + width, y + height);
+	}
+
+	void SoftwareRendererAPI::SetClearColor(const glm::vec4& color)
+	{
+		s_Data.ClearColor = color;
+	}
+
+	void SoftwareRendererAPI::Clear()
+	{
+		GetRenderTarget()->Clear(s_Data.ClearColor);
+	}
+
+	void SoftwareRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray)
+	{
+		DrawIndexed(vertexArray->GetIndexBuffer()->GetCount());
+	}
+
+	// Draws from the bound vertex array
+	void SoftwareRendererAPI::DrawIndexed(uint32_t indexCount)
+	{
+		Draw(nullptr, SoftwareTopology::TriangleStrip, true, indexCount, 0, 0, 1, 0);
+	}
+
+	// Triangle list, binds the vertex array
+	void SoftwareRendererAPI::DrawIndexedRange(const Ref<VertexArray>& vertexArray, uint32_t count, uint32_t firstIndex, int32_t baseVertex)
+	{
+		vertexArray->Bind();
+		Draw(vertexArray.get(), SoftwareTopology::Triangles, true, count, firstIndex, baseVertex, 1, 0);
+	}
+
+	void SoftwareRendererAPI::MultiDrawIndexed(const Ref<VertexArray>& vertexArray, const IndexedDrawRange* draws, uint32_t drawCount)
+	{
+		vertexArray->Bind();
+		for (uint32_t i = 0; i < drawCount; i++)
+			Draw(vertexArray.get(), SoftwareTopology::Triangles, true, draws[i].Count, draws[i].FirstIndex, draws[i].BaseVertex, 1, 0);
+	}
+
+	void SoftwareRendererAPI::MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& commands, uint32_t drawCount, uint32_t firstCommand)
+	{
+		GE_CORE_ASSERT(firstCommand + drawCount <= commands->GetCount(), "Indirect draw reads past the end of the command buffer!");
+
+		vertexArray->Bind();
+		const DrawIndirectCommand* command = static_cast<const SoftwareIndirectBuffer*>(commands.get())->GetData() + firstCommand;
+		for (uint32_t i = 0; i < drawCount; i++, command++)
+			Draw(vertexArray.get(), SoftwareTopology::Triangles, true, command->Count, command->FirstIndex, command->BaseVertex, command->InstanceCount, command->BaseInstance);
+	}
+
+	void SoftwareRendererAPI::DrawVertices(int vertices)
+	{
+		Draw(nullptr, SoftwareTopology::Triangles, false, (uint32_t)vertices, 0, 0, 1, 0);
+	}
+
+	void SoftwareRendererAPI::DrawVerticesStrip(int vertices)
+	{
+		Draw(nullptr, SoftwareTopology::TriangleStrip, false, (uint32_t)vertices, 0, 0, 1, 0);
+	}
+
+	// Indexed triangle list from the bound vertex array
+	void SoftwareRendererAPI::DrawIndexedTriangles(uint32_t indexCount)
+	{
+		Draw(nullptr, SoftwareTopology::Triangles, true, indexCount, 0, 0, 1, 0);
+	}
+
+	// Same primitive types as DrawIndexed(indexCount) and DrawVertices, per instance attributes start at baseInstance
+	void SoftwareRendererAPI::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance)
+	{
+		Draw(nullptr, SoftwareTopology::TriangleStrip, true, indexCount, 0, 0, instanceCount, baseInstance);
+	}
+
+	void SoftwareRendererAPI::DrawVerticesInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance)
+	{
+		Draw(nullptr, SoftwareTopology::Triangles, false, vertexCount, 0, 0, instanceCount, baseInstance);
+	}
+
+	const RendererAPI::StateStatistics& SoftwareRendererAPI::GetStateStatistics() const
+	{
+		return s_Data.Statistics;
+	}
+
+	void SoftwareRendererAPI::ResetStateStatistics()
+	{
+		s_Data.Statistics = StateStatistics();
+	}
+
+	SoftwareRenderTarget& SoftwareRendererAPI::GetBackBuffer()
+	{
+		return s_Data.BackBuffer;
+	}
+
+	void SoftwareRendererAPI::SetRenderTarget(SoftwareRenderTarget* target)
+	{
+		s_Data.Target = target;
+	}
+
+	SoftwareRenderTarget* SoftwareRendererAPI::GetRenderTarget()
+	{
+		return s_Data.Target ? s_Data.Target : &s_Data.BackBuffer;
+	}
+
+	void SoftwareRendererAPI::SetThreadCount(uint32_t threadCount)
+	{
+		if (threadCount == s_Data.ThreadCount)
+			return;
+
+		s_Data.ThreadCount = threadCount;
+		s_Data.Workers.reset();
+	}
+
+	void SoftwareRendererAPI::Draw(const VertexArray* vertexArray, SoftwareTopology topology, bool indexed, uint32_t count,
+		uint32_t firstIndex, int32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance)
+	{
+		SoftwareDraw draw;
+		draw.Shader = SoftwareShader::GetBound();
+		draw.VertexArray = vertexArray ? static_cast<const SoftwareVertexArray*>(vertexArray) : SoftwareVertexArray::GetBound();
+		draw.Topology = topology;
+		draw.Count = count;
+		draw.BaseVertex = baseVertex;
+		draw.InstanceCount = instanceCount;
+		draw.BaseInstance = baseInstance;
+
+		if (!draw.Shader || !draw.VertexArray)
+		{
+			GE_CORE_WARN("Software draw without a bound shader or vertex array was skipped");
+			return;
+		}
+
+		if (indexed)
+		{
+			const Ref<IndexBuffer>& indexBuffer = draw.VertexArray->GetIndexBuffer();
+			GE_CORE_ASSERT(indexBuffer && firstIndex + count <= indexBuffer->GetCount(), "Indexed draw reads past the end of the index buffer!");
+			draw.Indices = static_cast<const SoftwareIndexBuffer*>(indexBuffer.get())->GetData() + firstIndex;
+		}
+
+		if (!s_Data.Workers && s_Data.ThreadCount != 1)
+			s_Data.Workers = std::make_unique<ThreadPool>(s_Data.ThreadCount);
+
+		s_Data.Rasterizer.Draw(*GetRenderTarget(), s_Data.State, draw, s_Data.Workers.get());
+	}
+}
@@ -0,0 +1,56 @@
+/*
+	Software Renderer API
+
+	Renderer API drawing on the CPU with the software rasterizer, so scenes can be rendered without
+	a GPU or a window, for example to compare them against golden images in automated tests.
+	Draws go to the bound software framebuffer or to the back buffer, which takes the size of the viewport.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/RendererAPI.h"
+#include "SoftwareRasterizer.h"
+
+namespace ge {
+
+	class SoftwareRendererAPI : public RendererAPI {
+	public:
+		virtual void Init() override;
+		virtual void EnableZBuffer() override;
+		virtual void DisableZBuffer() override;
+		virtual void DepthFunc(const std::string setting) override;
+		virtual void EnableSeamlessCubemap() override;
+		virtual void WireFrame() override;
+		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+
+		virtual void SetClearColor(const glm::vec4& color) override;
+		virtual void Clear() override;
+
+		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray) override;
+		virtual void DrawIndexed(uint32_t indexCount) override;
+		virtual void DrawIndexedRange(const Ref<VertexArray>& vertexArray, uint32_t count, uint32_t firstIndex, int32_t baseVertex) override;
+		virtual void MultiDrawIndexed(const Ref<VertexArray>& vertexArray, const IndexedDrawRange* draws, uint32_t drawCount) override;
+		virtual void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& commands, uint32_t drawCount, uint32_t firstCommand) override;
+		virtual void DrawVertices(int vertices) override;
+		virtual void DrawVerticesStrip(int vertices) override;
+		virtual void DrawIndexedTriangles(uint32_t indexCount) override;
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance) override;
+		virtual void DrawVerticesInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance) override;
+
+		virtual const StateStatistics& GetStateStatistics() const override;
+		virtual void ResetStateStatistics() override;
+
+		// Stands in for the window's default framebuffer, read it back after the frame
+		static SoftwareRenderTarget& GetBackBuffer();
+		// Null draws to the back buffer again
+		static void SetRenderTarget(SoftwareRenderTarget* target);
+		static SoftwareRenderTarget* GetRenderTarget();
+
+		// Threads rasterizing tiles, 0 for one per core and 1 to draw on the calling thread only
+		static void SetThreadCount(uint32_t threadCount);
+	private:
+		// Draws with the bound shader, from the vertex array or the bound one when it is null
+		void Draw(const VertexArray* vertexArray, SoftwareTopology topology, bool indexed, uint32_t count,
+			uint32_t firstIndex, int32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance);
+	};
+}
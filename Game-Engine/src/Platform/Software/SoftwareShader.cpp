@@ -0,0 +1,256 @@
+/*
+	Software Shader
+
+	Shaders of the software renderer are C++ callables instead of GLSL. A program is registered
+	under the name of the shader it stands in for, the file name for shaders loaded from files,
+	and every shader created with that name runs it. Shaders without a program draw in magenta.
+*/
+
+#include "gepch.h"
+#include "SoftwareShader.h"
+#include "SoftwareTexture.h"
+#include "SoftwareUniformBuffer.h"
+
+namespace ge {
+
+	static const SoftwareShader* s_BoundShader = nullptr;
+
+	static const UniformID s_ViewProjectionID("u_ViewProjection");
+	static const UniformID s_TransformID("u_Transform");
+	static const UniformID s_TexturesID("u_Textures");
+
+	// Stands in for the engine's own shaders, which are written inline rather than loaded from files
+	static void AddBuiltinPrograms(std::unordered_map<std::string, SoftwareProgram>& programs)
+	{
+		// Renderer2D batch: position, colour, texture coordinates, texture slot and tiling factor
+		SoftwareProgram quad;
+		quad.VaryingCount = 2;
+		quad.Vertex = [](const SoftwareShader& shader, const glm::vec4* attributes, SoftwareVertex& vertex)
+		{
+			vertex.Position = shader.GetMat4(s_ViewProjectionID) * glm::vec4(glm::vec3(attributes[0]), 1.0f);
+			vertex.Varyings[0] = attributes[1];
+			vertex.Varyings[1] = glm::vec4(attributes[2].x, attributes[2].y, attributes[3].x, attributes[4].x);
+		};
+		quad.Pixel = [](const SoftwareShader& shader, const glm::vec4* varyings, glm::vec4& color)
+		{
+			uint32_t count;
+			const int* samplers = shader.GetIntArray(s_TexturesID, count);
+			const uint32_t index = (uint32_t)(varyings[1].z + 0.5f);
+			const glm::vec3 coordinates(varyings[1].x * varyings[1].w, varyings[1].y * varyings[1].w, 0.0f);
+			const glm::vec4 texel = index < count ? shader.Sample((uint32_t)samplers[index], coordinates) : glm::vec4(1.0f);
+			color = texel * varyings[0];
+			return true;
+		};
+		programs["Renderer2DQuad"] = quad;
+	}
+
+	static std::unordered_map<std::string, SoftwareProgram>& GetPrograms()
+	{
+		static std::unordered_map<std::string, SoftwareProgram> programs;
+		if (programs.empty())
+			AddBuiltinPrograms(programs);
+		return programs;
+	}
+
+	// Shows where a program is missing
+	static SoftwareProgram GetFallbackProgram()
+	{
+		SoftwareProgram program;
+		program.Vertex = [](const SoftwareShader& shader, const glm::vec4* attributes, SoftwareVertex& vertex)
+		{
+			vertex.Position = shader.GetMat4(s_ViewProjectionID) * shader.GetMat4(s_TransformID) * glm::vec4(glm::vec3(attributes[0]), 1.0f);
+		};
+		program.Pixel = [](const SoftwareShader& /*shader*/, const glm::vec4* /*varyings*/, glm::vec4& color)
+		{
+			color = glm::vec4(1.0f, 0.0f, 1.0f, 1.0f);
+			return true;
+		};
+		return program;
+	}
+
+	SoftwareShader::SoftwareShader(const std::string& filepath, const ShaderDefines& defines)
+		: m_Defines(defines)
+	{
+		// Extract name from filepath
+		// assets/shaders/Texture.glsl
+		auto lastSlash = filepath.find_last_of("/\\");
+		lastSlash = lastSlash == std::string::npos ? 0 : lastSlash + 1;
+		auto lastDot = filepath.rfind('.');
+		auto count = lastDot == std::string::npos ? filepath.size() - lastSlash : lastDot - lastSlash;
+		m_Name = filepath.substr(lastSlash, count);
+
+		FindProgram();
+	}
+
+	SoftwareShader::SoftwareShader(const std::string& name, const std::string& /*vertexSrc*/, const std::string& /*fragmentSrc*/)
+		: m_Name(name)
+	{
+		FindProgram();
+	}
+
+	SoftwareShader::~SoftwareShader()
+	{
+		if (s_BoundShader == this)
+			s_BoundShader = nullptr;
+	}
+
+	void SoftwareShader::FindProgram()
+	{
+		auto& programs = GetPrograms();
+		auto it = programs.find(m_Name);
+		if (it != programs.end())
+		{
+			m_Program = it->second;
+			return;
+		}
+
+		GE_CORE_WARN("No software program registered for shader {0}", m_Name);
+		m_Program = GetFallbackProgram();
+	}
+
+	void SoftwareShader::Register(const std::string& name, const SoftwareProgram& program)
+	{
+		GetPrograms()[name] = program;
+	}
+
+	bool SoftwareShader::IsRegistered(const std::string& name)
+	{
+		return GetPrograms().find(name) != GetPrograms().end();
+	}
+
+	void SoftwareShader::Bind() const
+	{
+		s_BoundShader = this;
+	}
+
+	void SoftwareShader::Unbind() const
+	{
+		s_BoundShader = nullptr;
+	}
+
+	const SoftwareShader* SoftwareShader::GetBound()
+	{
+		return s_BoundShader;
+	}
+
+	bool SoftwareShader::HasDefine(const std::string& name) const
+	{
+		for (const auto& define : m_Defines)
+		{
+			if (define.first == name)
+				return true;
+		}
+		return false;
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Uniforms ///////////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	void SoftwareShader::SetInt(const UniformID& id, int value)
+	{
+		SetIntArray(id, &value, 1);
+	}
+
+	void SoftwareShader::SetIntArray(const UniformID& id, const int* values, uint32_t count)
+	{
+		Uniform& uniform = m_Uniforms[id.Hash];
+		uniform.Ints.assign(values, values + count);
+		uniform.Value[0][0] = count > 0 ? (float)values[0] : 0.0f;
+	}
+
+	void SoftwareShader::SetFloat(const UniformID& id, float value)
+	{
+		m_Uniforms[id.Hash].Value[0] = glm::vec4(value, 0.0f, 0.0f, 0.0f);
+	}
+
+	void SoftwareShader::SetFloat2(const UniformID& id, const glm::vec2& value)
+	{
+		m_Uniforms[id.Hash].Value[0] = glm::vec4(value.x, value.y, 0.0f, 0.0f);
+	}
+
+	void SoftwareShader::SetFloat3(const UniformID& id, const glm::vec3& value)
+	{
+		m_Uniforms[id.Hash].Value[0] = glm::vec4(value, 0.0f);
+	}
+
+	void SoftwareShader::SetFloat4(const UniformID& id, const glm::vec4& value)
+	{
+		m_Uniforms[id.Hash].Value[0] = value;
+	}
+
+	void SoftwareShader::SetMat3(const UniformID& id, const glm::mat3& value)
+	{
+		m_Uniforms[id.Hash].Value = glm::mat4(value);
+	}
+
+	void SoftwareShader::SetMat4(const UniformID& id, const glm::mat4& value)
+	{
+		m_Uniforms[id.Hash].Value = value;
+	}
+
+	const SoftwareShader::Uniform* SoftwareShader::FindUniform(const UniformID& id) const
+	{
+		auto it = m_Uniforms.find(id.Hash);
+		return it != m_Uniforms.end() ? &it->second : nullptr;
+	}
+
+	int SoftwareShader::GetInt(const UniformID& id) const
+	{
+		const Uniform* uniform = FindUniform(id);
+		return uniform && !uniform->Ints.empty() ? uniform->Ints[0] : 0;
+	}
+
+	const int* SoftwareShader::GetIntArray(const UniformID& id, uint32_t& count) const
+	{
+		const Uniform* uniform = FindUniform(id);
+		count = uniform ? (uint32_t)uniform->Ints.size() : 0;
+		return count ? uniform->Ints.data() : nullptr;
+	}
+
+	float SoftwareShader::GetFloat(const UniformID& id) const
+	{
+		const Uniform* uniform = FindUniform(id);
+		return uniform ? uniform->Value[0][0] : 0.0f;
+	}
+
+	glm::vec2 SoftwareShader::GetFloat2(const UniformID& id) const
+	{
+		const Uniform* uniform = FindUniform(id);
+		return uniform ? glm::vec2(uniform->Value[0].x, uniform->Value[0].y) : glm::vec2(0.0f);
+	}
+
+	glm::vec3 SoftwareShader::GetFloat3(const UniformID& id) const
+	{
+		const Uniform* uniform = FindUniform(id);
+		return uniform ? glm::vec3(uniform->Value[0]) : glm::vec3(0.0f);
+	}
+
+	glm::vec4 SoftwareShader::GetFloat4(const UniformID& id) const
+	{
+		const Uniform* uniform = FindUniform(id);
+		return uniform ? uniform->Value[0] : glm::vec4(0.0f);
+	}
+
+	glm::mat4 SoftwareShader::GetMat4(const UniformID& id) const
+	{
+		const Uniform* uniform = FindUniform(id);
+		return uniform ? uniform->Value : glm::mat4(0.0f);
+	}
+
+	glm::vec4 SoftwareShader::Sample(const UniformID& sampler, const glm::vec3& coordinates, float level) const
+	{
+		return Sample((uint32_t)GetInt(sampler), coordinates, level);
+	}
+
+	glm::vec4 SoftwareShader::Sample(uint32_t slot, const glm::vec3& coordinates, float level) const
+	{
+		const SoftwareSampler* sampler = SoftwareSampler::Get(slot);
+		return sampler ? sampler->Sample(coordinates, level) : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	const void* SoftwareShader::GetUniformBlock(UniformBlock block) const
+	{
+		return SoftwareUniformBuffer::GetData((uint32_t)block);
+	}
+}
@@ -0,0 +1,109 @@
+/*
+	Software Shader
+
+	Shaders of the software renderer are C++ callables instead of GLSL. A program is registered
+	under the name of the shader it stands in for, the file name for shaders loaded from files,
+	and every shader created with that name runs it. Shaders without a program draw in magenta.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/Shader.h"
+#include "GameEngine/Renderer/UniformBuffer.h"
+
+#include <functional>
+
+namespace ge {
+
+	class SoftwareShader;
+
+	// Output of the vertex stage. Varyings are interpolated with perspective correction for the pixel stage.
+	struct SoftwareVertex
+	{
+		static constexpr uint32_t MaxVaryings = 8;
+
+		glm::vec4 Position;		// Clip space, like gl_Position
+		glm::vec4 Varyings[MaxVaryings];
+	};
+
+	struct SoftwareProgram
+	{
+		// Attributes are indexed by location, the per instance data is at InstanceData::FirstAttributeIndex
+		using VertexFunction = std::function<void(const SoftwareShader& shader, const glm::vec4* attributes, SoftwareVertex& vertex)>;
+		// Returns false to discard the pixel
+		using PixelFunction = std::function<bool(const SoftwareShader& shader, const glm::vec4* varyings, glm::vec4& color)>;
+
+		VertexFunction Vertex;
+		PixelFunction Pixel;
+		uint32_t VaryingCount = 0;		// Only these are interpolated
+		bool Instanced = false;			// Reads its transform from the per instance attributes
+	};
+
+	class SoftwareShader : public Shader
+	{
+	public:
+		SoftwareShader(const std::string& filepath, const ShaderDefines& defines);
+		SoftwareShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
+		virtual ~SoftwareShader();
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+
+		virtual const std::string& GetName() const override { return m_Name; }
+		virtual bool IsInstanced() const override { return m_Program.Instanced; }
+		virtual bool IsReady() const override { return true; }
+
+		virtual void SetInt(const UniformID& id, int value) override;
+		virtual void SetIntArray(const UniformID& id, const int* values, uint32_t count) override;
+		virtual void SetFloat(const UniformID& id, float value) override;
+		virtual void SetFloat2(const UniformID& id, const glm::vec2& value) override;
+		virtual void SetFloat3(const UniformID& id, const glm::vec3& value) override;
+		virtual void SetFloat4(const UniformID& id, const glm::vec4& value) override;
+		virtual void SetMat3(const UniformID& id, const glm::mat3& value) override;
+		virtual void SetMat4(const UniformID& id, const glm::mat4& value) override;
+
+		// Uniforms for the programs, ones never set read as 0 like in GLSL. The lookups hash, so programs
+		// should read uniforms in the vertex stage and pass them on as varyings where they can.
+		int GetInt(const UniformID& id) const;
+		const int* GetIntArray(const UniformID& id, uint32_t& count) const;
+		float GetFloat(const UniformID& id) const;
+		glm::vec2 GetFloat2(const UniformID& id) const;
+		glm::vec3 GetFloat3(const UniformID& id) const;
+		glm::vec4 GetFloat4(const UniformID& id) const;
+		glm::mat4 GetMat4(const UniformID& id) const;
+
+		// Samples the texture in the slot the sampler uniform holds
+		glm::vec4 Sample(const UniformID& sampler, const glm::vec3& coordinates, float level = 0.0f) const;
+		glm::vec4 Sample(uint32_t slot, const glm::vec3& coordinates, float level = 0.0f) const;
+		// std140 data of the block, null when no uniform buffer is bound to it
+		const void* GetUniformBlock(UniformBlock block) const;
+
+		// Defines the shader was loaded with, for programs that handle permutations
+		const ShaderDefines& GetDefines() const { return m_Defines; }
+		bool HasDefine(const std::string& name) const;
+
+		const SoftwareProgram& GetProgram() const { return m_Program; }
+
+		// Programs have to be registered before the shaders using them are created
+		static void Register(const std::string& name, const SoftwareProgram& program);
+		static bool IsRegistered(const std::string& name);
+
+		static const SoftwareShader* GetBound();
+	private:
+		void FindProgram();
+	private:
+		// Every uniform fits in a matrix, arrays of ints (samplers) are kept apart
+		struct Uniform
+		{
+			glm::mat4 Value = glm::mat4(0.0f);
+			std::vector<int> Ints;
+		};
+
+		const Uniform* FindUniform(const UniformID& id) const;
+	private:
+		std::string m_Name;
+		ShaderDefines m_Defines;
+		SoftwareProgram m_Program;
+		std::unordered_map<uint32_t, Uniform> m_Uniforms;
+	};
+}
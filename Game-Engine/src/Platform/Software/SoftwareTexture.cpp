@@ -0,0 +1,346 @@
+/*
+	Software Texture
+
+	Textures of the software renderer, stored as linear float texels in system memory.
+	Binding a texture puts it in a slot that shader programs sample from, the same slots
+	materials set their sampler uniforms to. Sampling is bilinear from the first mip only.
+*/
+
+#include "gepch.h"
+#include "SoftwareTexture.h"
+
+#include "GameEngine/Renderer/ImageData.h"
+#include "GameEngine/Renderer/CookedTexture.h"
+
+#include <cmath>
+
+namespace ge {
+
+	static const SoftwareSampler* s_Slots[SoftwareSampler::MaxSlots] = {};
+
+	///////////////////////////////////////////////////////////////////////
+	// Sampler ////////////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	SoftwareSampler::~SoftwareSampler()
+	{
+		for (const SoftwareSampler*& slot : s_Slots)
+		{
+			if (slot == this)
+				slot = nullptr;
+		}
+	}
+
+	void SoftwareSampler::Bind(uint32_t slot, const SoftwareSampler* sampler)
+	{
+		GE_CORE_ASSERT(slot < MaxSlots, "Texture slot out of range!");
+		s_Slots[slot] = sampler;
+	}
+
+	const SoftwareSampler* SoftwareSampler::Get(uint32_t slot)
+	{
+		return slot < MaxSlots ? s_Slots[slot] : nullptr;
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Image //////////////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	static float SRGBToLinear(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	void SoftwareImage::Allocate(uint32_t width, uint32_t height, const glm::vec4& value)
+	{
+		m_Width = width;
+		m_Height = height;
+		m_Texels.assign((size_t)width * height, value);
+	}
+
+	void SoftwareImage::Load(const ImageData& image, bool sRGB)
+	{
+		if (!image.IsValid())
+		{
+			Allocate(1, 1, glm::vec4(1.0f));
+			return;
+		}
+
+		Allocate(image.GetWidth(), image.GetHeight());
+		const uint32_t channels = image.GetChannels();
+		const size_t count = m_Texels.size();
+
+		// Like the GPU formats the images are uploaded to: the colour of sRGB images is decoded, alpha is not
+		for (size_t i = 0; i < count; i++)
+		{
+			glm::vec4 texel(0.0f, 0.0f, 0.0f, 1.0f);
+			for (uint32_t c = 0; c < channels && c < 4; c++)
+			{
+				if (image.IsHDR())
+					texel[c] = ((const float*)image.GetData())[i * channels + c];
+				else
+					texel[c] = ((const uint8_t*)image.GetData())[i * channels + c] / 255.0f;
+
+				if (sRGB && c < 3 && channels >= 3 && !image.IsHDR())
+					texel[c] = SRGBToLinear(texel[c]);
+			}
+			m_Texels[i] = texel;
+		}
+	}
+
+	void SoftwareImage::LoadRGBA8(const uint8_t* pixels, uint32_t width, uint32_t height, bool sRGB)
+	{
+		Allocate(width, height);
+		for (size_t i = 0; i < m_Texels.size(); i++)
+		{
+			glm::vec4 texel = glm::vec4(pixels[i * 4], pixels[i * 4 + 1], pixels[i * 4 + 2], pixels[i * 4 + 3]) / 255.0f;
+			if (sRGB)
+				texel = glm::vec4(SRGBToLinear(texel.r), SRGBToLinear(texel.g), SRGBToLinear(texel.b), texel.a);
+			m_Texels[i] = texel;
+		}
+	}
+
+	// Bilinear between texel centres, rows from the bottom like OpenGL texture coordinates
+	glm::vec4 SoftwareImage::Sample(const glm::vec3& coordinates, float /*level*/) const
+	{
+		if (m_Texels.empty())
+			return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+		const float x = coordinates.x * m_Width - 0.5f;
+		const float y = coordinates.y * m_Height - 0.5f;
+		const float fx = x - std::floor(x), fy = y - std::floor(y);
+		const int32_t x0 = (int32_t)std::floor(x), y0 = (int32_t)std::floor(y);
+
+		auto wrap = [this](int32_t value, uint32_t size)
+		{
+			if (m_Repeat)
+				return (uint32_t)(((int64_t)value % size + size) % size);
+			return (uint32_t)glm::clamp(value, 0, (int32_t)size - 1);
+		};
+		const uint32_t ix0 = wrap(x0, m_Width), ix1 = wrap(x0 + 1, m_Width);
+		const uint32_t iy0 = wrap(y0, m_Height), iy1 = wrap(y0 + 1, m_Height);
+
+		const glm::vec4* row0 = m_Texels.data() + (size_t)iy0 * m_Width;
+		const glm::vec4* row1 = m_Texels.data() + (size_t)iy1 * m_Width;
+		return glm::mix(glm::mix(row0[ix0], row0[ix1], fx), glm::mix(row1[ix0], row1[ix1], fx), fy);
+	}
+
+	// Only uncompressed cooked files can be read back, block compressed ones would need a decoder
+	static void LoadCooked(const CookedTexture& cooked, SoftwareImage& image)
+	{
+		const CookedTextureHeader& header = cooked.GetHeader();
+		const CookedTextureLevel& level = cooked.GetLevels()[0];
+		if (cooked.GetCompression() == TextureCompression::None && level.Size == (uint64_t)level.Width * level.Height * 4)
+		{
+			image.LoadRGBA8(cooked.GetLevelData(0), level.Width, level.Height, cooked.IsSRGB());
+			return;
+		}
+
+		GE_CORE_WARN("The software renderer can't decode block compressed texture {0}", cooked.GetPath());
+		image.Allocate(header.Width, header.Height, glm::vec4(1.0f));
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Texture 2D /////////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	// Cooked files are not looked for, the source image is what the software renderer can read
+	SoftwareTexture2D::SoftwareTexture2D(const std::string& path, bool gammaCorrection)
+	{
+		ImageData image;
+		if (ImageData::Load(path, image))
+			GE_CORE_INFO(path + " loaded");
+		else
+			GE_CORE_ERROR("Texture failed to load at path: {0}", path);
+
+		m_Image.Load(image, gammaCorrection);
+	}
+
+	SoftwareTexture2D::SoftwareTexture2D(uint32_t width, uint32_t height)
+	{
+		m_Image.Allocate(width, height);
+	}
+
+	SoftwareTexture2D::SoftwareTexture2D(const ImageData& image, bool gammaCorrection)
+	{
+		m_Image.Load(image, gammaCorrection);
+	}
+
+	SoftwareTexture2D::SoftwareTexture2D(const CookedTexture& cooked)
+	{
+		LoadCooked(cooked, m_Image);
+	}
+
+	void SoftwareTexture2D::SetData(void* data, uint32_t size)
+	{
+		GE_CORE_ASSERT(size == m_Image.GetWidth() * m_Image.GetHeight() * 4, "Data must be entire texture!");
+		(void)size;
+		m_Image.LoadRGBA8((const uint8_t*)data, m_Image.GetWidth(), m_Image.GetHeight(), false);
+	}
+
+	void SoftwareTexture2D::Bind(uint32_t slot) const
+	{
+		SoftwareSampler::Bind(slot, &m_Image);
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Texture 3D /////////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	SoftwareTexture3D::SoftwareTexture3D(const std::string& path, const std::string& directory)
+		: m_Path(path)
+	{
+		const std::string filename = directory + '/' + path;
+
+		ImageData image;
+		if (ImageData::Load(filename, image))
+			GE_CORE_INFO(path + " loaded");
+		else
+			GE_CORE_ERROR("Texture failed to load at path: {0}", filename);
+
+		m_Image.Load(image, false);
+	}
+
+	SoftwareTexture3D::SoftwareTexture3D(const ImageData& image, const std::string& path)
+		: m_Path(path)
+	{
+		m_Image.Load(image, false);
+	}
+
+	SoftwareTexture3D::SoftwareTexture3D(const CookedTexture& cooked, const std::string& path)
+		: m_Path(path)
+	{
+		LoadCooked(cooked, m_Image);
+	}
+
+	void SoftwareTexture3D::Bind(uint32_t slot) const
+	{
+		SoftwareSampler::Bind(slot, &m_Image);
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Cubemap ////////////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	glm::vec4 SoftwareCubemapSampler::Sample(const glm::vec3& coordinates, float level) const
+	{
+		if (Data.Pixels.empty())
+			return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+		return glm::vec4(Data.Sample(coordinates, level), 1.0f);
+	}
+
+	SoftwareCubemap::SoftwareCubemap(const std::vector<std::string> faces)
+	{
+		std::vector<ImageData> images(faces.size());
+		for (size_t i = 0; i < faces.size(); i++)
+		{
+			if (!ImageData::Load(faces[i], images[i]))
+				GE_CORE_ERROR("Cubemap texture failed to load at path: {0}", faces[i]);
+		}
+
+		Load(images);
+	}
+
+	SoftwareCubemap::SoftwareCubemap(const std::vector<ImageData>& faces)
+	{
+		Load(faces);
+	}
+
+	// Faces keep their rows in the order they are stored, as they would be uploaded
+	void SoftwareCubemap::Load(const std::vector<ImageData>& faces)
+	{
+		GE_CORE_ASSERT(faces.size() == 6, "A cubemap needs six faces!");
+
+		const uint32_t size = faces[0].IsValid() ? faces[0].GetWidth() : 1;
+		m_Cubemap.Data.Allocate(size, 1);
+		for (uint32_t face = 0; face < 6 && face < faces.size(); face++)
+		{
+			SoftwareImage image;
+			image.Load(faces[face], false);
+			float* pixels = m_Cubemap.Data.GetFace(0, face);
+			for (uint32_t y = 0; y < size; y++)
+			{
+				for (uint32_t x = 0; x < size; x++)
+				{
+					const glm::vec4 texel = image.Sample(glm::vec3((x + 0.5f) / size, (y + 0.5f) / size, 0.0f));
+					float* p = pixels + ((size_t)y * size + x) * 3;
+					p[0] = texel.r;
+					p[1] = texel.g;
+					p[2] = texel.b;
+				}
+			}
+		}
+	}
+
+	void SoftwareCubemap::Bind(uint32_t slot) const
+	{
+		SoftwareSampler::Bind(slot, &m_Cubemap);
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// HDR Environment Map ////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	SoftwareHDREnvironmentMap::SoftwareHDREnvironmentMap(const std::string& path)
+	{
+		IBLData data;
+		if (IBLBaker::LoadOrBake(path, IBLBakeSettings(), data))
+			SetMaps(std::move(data));
+		else
+			GE_CORE_ERROR("Failed to load HDR image {0}", path);
+	}
+
+	SoftwareHDREnvironmentMap::SoftwareHDREnvironmentMap(const ImageData& image)
+	{
+		IBLData data;
+		if (IBLBaker::Bake(image, IBLBakeSettings(), data))
+			SetMaps(std::move(data));
+	}
+
+	SoftwareHDREnvironmentMap::SoftwareHDREnvironmentMap(const IBLData& data)
+	{
+		IBLData copy = data;
+		SetMaps(std::move(copy));
+	}
+
+	void SoftwareHDREnvironmentMap::SetMaps(IBLData&& data)
+	{
+		m_Width = data.SourceWidth;
+		m_Height = data.SourceHeight;
+		m_Environment.Data = std::move(data.Environment);
+		m_Irradiance.Data = std::move(data.Irradiance);
+		m_Prefilter.Data = std::move(data.Prefilter);
+
+		// Scale and bias in red and green
+		const uint32_t size = data.BrdfLUTSize;
+		m_BrdfLUT.Allocate(size, size);
+		for (size_t i = 0; i < (size_t)size * size; i++)
+			m_BrdfLUT.GetTexels()[i] = glm::vec4(data.BrdfLUT[i * 2], data.BrdfLUT[i * 2 + 1], 0.0f, 1.0f);
+	}
+
+	void SoftwareHDREnvironmentMap::Bind(uint32_t slot) const
+	{
+		BindCubemap(slot);
+	}
+
+	void SoftwareHDREnvironmentMap::BindCubemap(uint32_t slot) const
+	{
+		SoftwareSampler::Bind(slot, &m_Environment);
+	}
+
+	void SoftwareHDREnvironmentMap::BindIrradianceMap(uint32_t slot) const
+	{
+		SoftwareSampler::Bind(slot, &m_Irradiance);
+	}
+
+	void SoftwareHDREnvironmentMap::BindPrefilterMap(uint32_t slot) const
+	{
+		SoftwareSampler::Bind(slot, &m_Prefilter);
+	}
+
+	void SoftwareHDREnvironmentMap::BindBrdfLUTTexture(uint32_t slot) const
+	{
+		SoftwareSampler::Bind(slot, &m_BrdfLUT);
+	}
+}
@@ -0,0 +1,165 @@
+/*
+	Software Texture
+
+	Textures of the software renderer, stored as linear float texels in system memory.
+	Binding a texture puts it in a slot that shader programs sample from, the same slots
+	materials set their sampler uniforms to. Sampling is bilinear from the first mip only.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/Texture.h"
+#include "GameEngine/Renderer/IBLBaker.h"
+
+#include <glm/glm.hpp>
+
+namespace ge {
+
+	// Anything a program can sample. 2D textures read the coordinates' xy, cubemaps a direction.
+	class SoftwareSampler
+	{
+	public:
+		static constexpr uint32_t MaxSlots = 32;
+
+		virtual ~SoftwareSampler();
+
+		virtual glm::vec4 Sample(const glm::vec3& coordinates, float level = 0.0f) const = 0;
+
+		static void Bind(uint32_t slot, const SoftwareSampler* sampler);
+		// Null when nothing is bound there
+		static const SoftwareSampler* Get(uint32_t slot);
+	};
+
+	// Texels of a 2D image, single channel images read (r, 0, 0, 1) and RGB images have an alpha of 1
+	class SoftwareImage : public SoftwareSampler
+	{
+	public:
+		SoftwareImage(bool repeat = true) : m_Repeat(repeat) {}
+
+		void Allocate(uint32_t width, uint32_t height, const glm::vec4& value = glm::vec4(0.0f));
+		// sRGB colour is decoded to linear here, which is what the GPU does when sampling sRGB textures
+		void Load(const ImageData& image, bool sRGB);
+		// Tightly packed RGBA, 8 bits per channel
+		void LoadRGBA8(const uint8_t* pixels, uint32_t width, uint32_t height, bool sRGB);
+
+		// There are no mips, the level is ignored
+		virtual glm::vec4 Sample(const glm::vec3& coordinates, float level = 0.0f) const override;
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		glm::vec4* GetTexels() { return m_Texels.data(); }
+		const glm::vec4* GetTexels() const { return m_Texels.data(); }
+	private:
+		uint32_t m_Width = 0, m_Height = 0;
+		std::vector<glm::vec4> m_Texels;
+		bool m_Repeat;
+	};
+
+	class SoftwareTexture2D : public Texture2D
+	{
+	public:
+		SoftwareTexture2D(const std::string& path, bool gammaCorrection);
+		SoftwareTexture2D(uint32_t width, uint32_t height);
+		SoftwareTexture2D(const ImageData& image, bool gammaCorrection);
+		SoftwareTexture2D(const CookedTexture& cooked);
+
+		virtual uint32_t GetWidth() const override { return m_Image.GetWidth(); }
+		virtual uint32_t GetHeight() const override { return m_Image.GetHeight(); }
+
+		virtual void SetData(void* data, uint32_t size) override;
+
+		virtual void Bind(uint32_t slot = 0) const override;
+	private:
+		SoftwareImage m_Image;
+	};
+
+	class SoftwareTexture3D : public Texture3D
+	{
+	public:
+		SoftwareTexture3D(const std::string& path, const std::string& directory);
+		SoftwareTexture3D(const ImageData& image, const std::string& path);
+		SoftwareTexture3D(const CookedTexture& cooked, const std::string& path);
+
+		virtual uint32_t GetWidth() const override { return m_Image.GetWidth(); }
+		virtual uint32_t GetHeight() const override { return m_Image.GetHeight(); }
+
+		virtual void Bind(uint32_t slot = 0) const override;
+
+		virtual const std::string& GetPath() const override { return m_Path; }
+
+		virtual std::string GetType() const override { return m_Type; }
+		virtual void SetType(const std::string& type) override { m_Type = type; }
+	private:
+		SoftwareImage m_Image;
+		std::string m_Path;
+		std::string m_Type;
+	};
+
+	// Cubemap faces sampled with a direction, faces in the order +X, -X, +Y, -Y, +Z, -Z
+	class SoftwareCubemapSampler : public SoftwareSampler
+	{
+	public:
+		CubemapData Data;
+
+		virtual glm::vec4 Sample(const glm::vec3& coordinates, float level = 0.0f) const override;
+	};
+
+	class SoftwareCubemap : public Cubemap
+	{
+	public:
+		SoftwareCubemap(const std::vector<std::string> faces);
+		SoftwareCubemap(const std::vector<ImageData>& faces);
+
+		virtual uint32_t GetWidth() const override { return m_Cubemap.Data.Size; }
+		virtual uint32_t GetHeight() const override { return m_Cubemap.Data.Size; }
+
+		virtual void Bind(uint32_t slot = 0) const override;
+	private:
+		void Load(const std::vector<ImageData>& faces);
+	private:
+		SoftwareCubemapSampler m_Cubemap;
+	};
+
+	// Every map is baked on the CPU by IBLBaker. There is nothing to render into, so the Setup functions do nothing.
+	class SoftwareHDREnvironmentMap : public HDREnvironmentMap
+	{
+	public:
+		SoftwareHDREnvironmentMap(const std::string& path);
+		SoftwareHDREnvironmentMap(const ImageData& image);
+		SoftwareHDREnvironmentMap(const IBLData& data);
+
+		virtual uint32_t GetWidth() const override { return m_Width; }
+		virtual uint32_t GetHeight() const override { return m_Height; }
+
+		// Binds the environment cubemap
+		virtual void Bind(uint32_t slot = 0) const override;
+
+		virtual void SetupCubemap(uint32_t /*width*/, uint32_t /*height*/) override {}
+		virtual void SetupIrradianceMap(uint32_t /*width*/, uint32_t /*height*/) override {}
+		virtual void SetupPrefilterMap(uint32_t /*width*/, uint32_t /*height*/) override {}
+		virtual void SetupBrdfLUTTexture(uint32_t /*width*/, uint32_t /*height*/) override {}
+
+		virtual void BindCubemap(uint32_t slot = 0) const override;
+		virtual void BindIrradianceMap(uint32_t slot = 0) const override;
+		virtual void BindPrefilterMap(uint32_t slot = 0) const override;
+		virtual void BindBrdfLUTTexture(uint32_t slot = 0) const override;
+		virtual void GenerateMipmap() const override {}
+
+		// There are no GPU objects behind the maps
+		virtual uint32_t GetRendererID() const override { return 0; }
+		virtual uint32_t GetCubemapID() const override { return 0; }
+		virtual uint32_t GetIrradianceID() const override { return 0; }
+		virtual uint32_t GetPrefilterID() const override { return 0; }
+		virtual uint32_t GetBrdfLUTTextureID() const override { return 0; }
+	private:
+		virtual void SetMapTextures(uint32_t /*width*/, uint32_t /*height*/) override {}
+
+		void SetMaps(IBLData&& data);
+	private:
+		uint32_t m_Width = 0, m_Height = 0;
+		SoftwareCubemapSampler m_Environment;
+		SoftwareCubemapSampler m_Irradiance;
+		SoftwareCubemapSampler m_Prefilter;
+		SoftwareImage m_BrdfLUT = SoftwareImage(false);
+	};
+}
@@ -0,0 +1,41 @@
+/*
+	Software Uniform Buffer
+
+	Uniform buffer of the software renderer. Programs read the block bound at a binding point
+	as the same std140 bytes a GPU shader would see.
+*/
+
+#include "gepch.h"
+#include "SoftwareUniformBuffer.h"
+
+#include <cstring>
+
+namespace ge {
+
+	static const SoftwareUniformBuffer* s_Bindings[SoftwareUniformBuffer::MaxBindings] = {};
+
+	SoftwareUniformBuffer::SoftwareUniformBuffer(uint32_t size, uint32_t binding)
+		: m_Data(size, 0), m_Binding(binding)
+	{
+		GE_CORE_ASSERT(binding < MaxBindings, "Uniform buffer binding out of range!");
+		s_Bindings[binding] = this;
+	}
+
+	SoftwareUniformBuffer::~SoftwareUniformBuffer()
+	{
+		if (s_Bindings[m_Binding] == this)
+			s_Bindings[m_Binding] = nullptr;
+	}
+
+	void SoftwareUniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		GE_CORE_ASSERT(offset + size <= m_Data.size(), "Data does not fit in the uniform buffer!");
+		std::memcpy(m_Data.data() + offset, data, size);
+	}
+
+	const void* SoftwareUniformBuffer::GetData(uint32_t binding)
+	{
+		const SoftwareUniformBuffer* buffer = binding < MaxBindings ? s_Bindings[binding] : nullptr;
+		return buffer ? buffer->m_Data.data() : nullptr;
+	}
+}
@@ -0,0 +1,31 @@
+/*
+	Software Uniform Buffer
+
+	Uniform buffer of the software renderer. Programs read the block bound at a binding point
+	as the same std140 bytes a GPU shader would see.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/UniformBuffer.h"
+
+namespace ge {
+
+	class SoftwareUniformBuffer : public UniformBuffer
+	{
+	public:
+		static constexpr uint32_t MaxBindings = 8;
+
+		// Bound to the binding point straight away, like the OpenGL buffer
+		SoftwareUniformBuffer(uint32_t size, uint32_t binding);
+		virtual ~SoftwareUniformBuffer();
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+
+		// Null when no buffer is bound there
+		static const void* GetData(uint32_t binding);
+	private:
+		std::vector<uint8_t> m_Data;
+		uint32_t m_Binding;
+	};
+}
@@ -0,0 +1,172 @@
+/*
+	Software Vertex Array
+
+	Vertex array of the software renderer. It keeps where every attribute location reads from,
+	so vertices can be fetched straight out of the buffers as vec4s.
+*/
+
+#include "gepch.h"
+#include "SoftwareVertexArray.h"
+#include "SoftwareBuffer.h"
+
+#include "GameEngine/Renderer/VertexFormat.h"
+
+#include <cfloat>
+#include <cstring>
+
+namespace ge {
+
+	static const SoftwareVertexArray* s_BoundVertexArray = nullptr;
+
+	SoftwareVertexArray::~SoftwareVertexArray()
+	{
+		if (s_BoundVertexArray == this)
+			s_BoundVertexArray = nullptr;
+	}
+
+	void SoftwareVertexArray::Bind() const
+	{
+		s_BoundVertexArray = this;
+	}
+
+	void SoftwareVertexArray::Unbind() const
+	{
+		s_BoundVertexArray = nullptr;
+	}
+
+	const SoftwareVertexArray* SoftwareVertexArray::GetBound()
+	{
+		return s_BoundVertexArray;
+	}
+
+	void SoftwareVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
+	{
+		AddVertexBuffer(vertexBuffer, m_VertexBufferIndex);
+	}
+
+	void SoftwareVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, uint32_t firstAttributeIndex)
+	{
+		GE_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
+
+		uint32_t index = firstAttributeIndex;
+		const auto& layout = vertexBuffer->GetLayout();
+		for (const auto& element : layout)
+		{
+			// Matrices are passed as one attribute per column
+			const uint32_t locations = element.GetLocationCount();
+			const uint32_t components = element.GetComponentCount() / locations;
+			for (uint32_t i = 0; i < locations; i++)
+			{
+				GE_CORE_ASSERT(index < MaxAttributes, "Too many vertex attributes for the software renderer!");
+
+				// A location set again replaces what it read before
+				m_Attributes.erase(std::remove_if(m_Attributes.begin(), m_Attributes.end(),
+					[index](const Attribute& attribute) { return attribute.Location == index; }), m_Attributes.end());
+
+				Attribute attribute;
+				attribute.Buffer = (const SoftwareVertexBuffer*)vertexBuffer.get();
+				attribute.Location = index;
+				attribute.Type = element.Type;
+				attribute.Components = components;
+				attribute.Offset = (uint32_t)(element.Offset + sizeof(float) * components * i);
+				attribute.Stride = layout.GetStride();
+				attribute.Divisor = element.Divisor;
+				attribute.Normalized = element.Normalized;
+				m_Attributes.push_back(attribute);
+				index++;
+			}
+		}
+
+		if (index > m_VertexBufferIndex)
+			m_VertexBufferIndex = index;
+
+		m_VertexBuffers.push_back(vertexBuffer);
+	}
+
+	void SoftwareVertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
+	{
+		m_IndexBuffer = indexBuffer;
+	}
+
+	static uint32_t ComponentSize(ShaderDataType type)
+	{
+		switch (type)
+		{
+			case ShaderDataType::Bool:		return 1;
+			case ShaderDataType::Half2:
+			case ShaderDataType::Half4:
+			case ShaderDataType::Short2:
+			case ShaderDataType::Short4:
+			case ShaderDataType::UShort2:
+			case ShaderDataType::UShort4:	return 2;
+			default:						return 4;
+		}
+	}
+
+	template<typename T>
+	static void ReadComponents(const uint8_t* data, uint32_t components, float scale, float minimum, glm::vec4& value)
+	{
+		for (uint32_t c = 0; c < components; c++)
+		{
+			T component;
+			std::memcpy(&component, data + c * sizeof(T), sizeof(T));
+			value[c] = std::max((float)component * scale, minimum);
+		}
+	}
+
+	void SoftwareVertexArray::Fetch(uint32_t vertex, uint32_t instance, uint32_t baseInstance, glm::vec4 attributes[MaxAttributes]) const
+	{
+		for (uint32_t i = 0; i < MaxAttributes; i++)
+			attributes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+		for (const Attribute& attribute : m_Attributes)
+		{
+			const uint32_t element = attribute.Divisor ? baseInstance + instance / attribute.Divisor : vertex;
+			const size_t offset = (size_t)element * attribute.Stride + attribute.Offset;
+			if (offset + attribute.Components * ComponentSize(attribute.Type) > attribute.Buffer->GetSize())
+				continue;
+
+			const uint8_t* data = attribute.Buffer->GetData() + offset;
+			glm::vec4& value = attributes[attribute.Location];
+			switch (attribute.Type)
+			{
+				case ShaderDataType::Float:
+				case ShaderDataType::Float2:
+				case ShaderDataType::Float3:
+				case ShaderDataType::Float4:
+				case ShaderDataType::Mat3:
+				case ShaderDataType::Mat4:
+					ReadComponents<float>(data, attribute.Components, 1.0f, -FLT_MAX, value);
+					break;
+				case ShaderDataType::Int:
+				case ShaderDataType::Int2:
+				case ShaderDataType::Int3:
+				case ShaderDataType::Int4:
+					ReadComponents<int32_t>(data, attribute.Components, 1.0f, -FLT_MAX, value);
+					break;
+				case ShaderDataType::Bool:
+					ReadComponents<uint8_t>(data, attribute.Components, 1.0f, -FLT_MAX, value);
+					break;
+				case ShaderDataType::Half2:
+				case ShaderDataType::Half4:
+					for (uint32_t c = 0; c < attribute.Components; c++)
+					{
+						uint16_t half;
+						std::memcpy(&half, data + c * sizeof(uint16_t), sizeof(uint16_t));
+						value[c] = VertexFormat::HalfToFloat(half);
+					}
+					break;
+				case ShaderDataType::Short2:
+				case ShaderDataType::Short4:
+					ReadComponents<int16_t>(data, attribute.Components, attribute.Normalized ? 1.0f / 32767.0f : 1.0f, attribute.Normalized ? -1.0f : -FLT_MAX, value);
+					break;
+				case ShaderDataType::UShort2:
+				case ShaderDataType::UShort4:
+					ReadComponents<uint16_t>(data, attribute.Components, attribute.Normalized ? 1.0f / 65535.0f : 1.0f, -FLT_MAX, value);
+					break;
+				default:
+					break;
+			}
+		}
+	}
+}
@@ -0,0 +1,59 @@
+/*
+	Software Vertex Array
+
+	Vertex array of the software renderer. It keeps where every attribute location reads from,
+	so vertices can be fetched straight out of the buffers as vec4s.
+*/
+
+#pragma once
+
+#include "GameEngine/Renderer/VertexArray.h"
+
+#include <glm/glm.hpp>
+
+namespace ge {
+
+	class SoftwareVertexBuffer;
+
+	class SoftwareVertexArray : public VertexArray
+	{
+	public:
+		static constexpr uint32_t MaxAttributes = 16;
+
+		virtual ~SoftwareVertexArray();
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+
+		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) override;
+		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, uint32_t firstAttributeIndex) override;
+		virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) override;
+
+		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const override { return m_VertexBuffers; }
+		virtual const Ref<IndexBuffer>& GetIndexBuffer() const override { return m_IndexBuffer; }
+
+		// Reads every attribute of a vertex, locations without an attribute get (0, 0, 0, 1) like on the GPU.
+		// Per instance attributes read element baseInstance + instance / divisor.
+		void Fetch(uint32_t vertex, uint32_t instance, uint32_t baseInstance, glm::vec4 attributes[MaxAttributes]) const;
+
+		static const SoftwareVertexArray* GetBound();
+	private:
+		// One attribute location, matrices take one per column
+		struct Attribute
+		{
+			const SoftwareVertexBuffer* Buffer;
+			uint32_t Location;
+			ShaderDataType Type;
+			uint32_t Components;
+			uint32_t Offset;
+			uint32_t Stride;
+			uint32_t Divisor;
+			bool Normalized;
+		};
+	private:
+		uint32_t m_VertexBufferIndex = 0;
+		std::vector<Ref<VertexBuffer>> m_VertexBuffers;
+		Ref<IndexBuffer> m_IndexBuffer;
+		std::vector<Attribute> m_Attributes;
+	};
+}
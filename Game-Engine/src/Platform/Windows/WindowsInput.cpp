@@ -21,6 +21,9 @@ namespace ge
 	bool  WindowsInput::IsKeyPressedImpl(int keycode)
 	{
 		auto window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+		// A headless window has nothing to read
+		if (!window)
+			return false;
 		auto state = glfwGetKey(window, keycode);
 						
 		return state == GLFW_PRESS || state == GLFW_REPEAT;
@@ -30,6 +33,8 @@ namespace ge
 	bool WindowsInput::IsMouseButtonPressedImpl(int button)
 	{
 		auto window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+		if (!window)
+			return false;
 		auto state = glfwGetMouseButton(window, button);
 
 		return state == GLFW_PRESS;
@@ -39,6 +44,8 @@ namespace ge
 	std::pair<float, float> WindowsInput::GetMousePositionImpl()
 	{
 		auto window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+		if (!window)
+			return { 0.0f, 0.0f };
 		double xpos, ypos;
 		glfwGetCursorPos(window, &xpos, &ypos);
 
@@ -0,0 +1,36 @@
+/*
+	Math Tests
+
+	Entry point. Runs the property checks and then the benchmarks.
+	Usage: MathTests [--no-bench] [element count]
+	Returns a non-zero exit code when any check fails.
+*/
+
+#include "MathTests.h"
+
+#include <cstring>
+#include <cstdlib>
+
+int main(int argc, char** argv)
+{
+	ge::Log::Init();
+
+	bool benchmarks = true;
+	uint32_t count = 1 << 20;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--no-bench") == 0)
+			benchmarks = false;
+		else
+			count = (uint32_t)std::strtoul(argv[i], nullptr, 10);
+	}
+
+	const int failed = ge::RunMathTests();
+
+	if (benchmarks && count > 0)
+	{
+		ge::RunMathBenchmarks(count);
+		ge::RunPrecisionBenchmarks(count);
+	}
+
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/*
+	Math Benchmarks
+
+	Measures the cost of each math operation by running it over arrays that are too large
+	for the cache, so that the numbers include the memory traffic a real workload pays for.
+*/
+
+#include "MathTests.h"
+
+#include <chrono>
+#include <vector>
+
+namespace ge {
+
+	// Results are summed into this so the compiler cannot drop the work
+	static volatile float s_Sink = 0.0f;
+
+	static float Sum(const Vec3& v) { return v.x + v.y + v.z; }
+	static float Sum(const Vec4& v) { return v.x + v.y + v.z + v.w; }
+	static float Sum(const Mat3& m) { return Sum(m.rows[0]) + Sum(m.rows[1]) + Sum(m.rows[2]); }
+	static float Sum(const Mat4& m) { return Sum(m.rows[0]) + Sum(m.rows[1]) + Sum(m.rows[2]) + Sum(m.rows[3]); }
+	static float Sum(const Quat& q) { return q.w + q.x + q.y + q.z; }
+	static float Sum(float f) { return f; }
+
+	// Runs op(i) for every element, writes the result to out and reports the best of a few runs
+	template<typename T, typename Fn>
+	static void Benchmark(const char* name, std::vector<T>& out, Fn&& op)
+	{
+		constexpr int runs = 5;
+		const size_t count = out.size();
+
+		double best = 1e30;
+		for (int run = 0; run < runs; run++) {
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; i++)
+				out[i] = op(i);
+			const auto end = std::chrono::steady_clock::now();
+
+			best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+		}
+
+		float sum = 0.0f;
+		for (size_t i = 0; i < count; i += 97)
+			sum += Sum(out[i]);
+		s_Sink = s_Sink + sum;
+
+		GE_INFO("{0:<28} {1:8.2f} ns/op", name, best / (double)count);
+	}
+
+	void RunMathBenchmarks(uint32_t count)
+	{
+		MathRandom random;
+
+		std::vector<Vec3> vec3A(count), vec3B(count);
+		std::vector<Vec4> vec4A(count), vec4B(count);
+		std::vector<Mat3> mat3A(count), mat3B(count);
+		std::vector<Mat4> mat4A(count), mat4B(count);
+		std::vector<Quat> quatA(count), quatB(count);
+		std::vector<Transform> transforms(count);
+		for (uint32_t i = 0; i < count; i++) {
+			vec3A[i] = random.Vector();
+			vec3B[i] = random.Vector();
+			vec4A[i] = random.Vector4();
+			vec4B[i] = random.Vector4();
+			mat3A[i] = random.Matrix3();
+			mat3B[i] = random.Matrix3();
+			mat4A[i] = random.Matrix4();
+			mat4B[i] = random.Matrix4();
+			quatA[i] = random.Rotation();
+			quatB[i] = random.Rotation();
+			transforms[i] = random.RandomTransform(false);
+		}
+
+		std::vector<float> floats(count);
+		std::vector<Vec3> vec3Out(count);
+		std::vector<Vec4> vec4Out(count);
+		std::vector<Mat3> mat3Out(count);
+		std::vector<Mat4> mat4Out(count);
+		std::vector<Quat> quatOut(count);
+
+		GE_INFO("Math benchmarks over {0} elements", count);
+
+		// Vectors ///////////////////////////////////////////////////////////////////////////////
+		Benchmark("Vec3 + Vec3", vec3Out, [&](size_t i) { return vec3A[i] + vec3B[i]; });
+		Benchmark("Vec3 * float", vec3Out, [&](size_t i) { return vec3A[i] * 2.5f; });
+		Benchmark("Vec3::Dot", floats, [&](size_t i) { return vec3A[i].Dot(vec3B[i]); });
+		Benchmark("Vec3::Cross", vec3Out, [&](size_t i) { return vec3A[i].Cross(vec3B[i]); });
+		Benchmark("Vec3::GetMagnitude", floats, [&](size_t i) { return vec3A[i].GetMagnitude(); });
+		Benchmark("Vec3::Normalize", vec3Out, [&](size_t i) { Vec3 v = vec3A[i]; v.Normalize(); return v; });
+		Benchmark("Vec4 + Vec4", vec4Out, [&](size_t i) { return vec4A[i] + vec4B[i]; });
+		Benchmark("Vec4::Dot", floats, [&](size_t i) { return vec4A[i].Dot(vec4B[i]); });
+		Benchmark("Vec4::Normalize", vec4Out, [&](size_t i) { Vec4 v = vec4A[i]; v.Normalize(); return v; });
+
+		// Matrices //////////////////////////////////////////////////////////////////////////////
+		Benchmark("Mat3 * Vec3", vec3Out, [&](size_t i) { return mat3A[i] * vec3A[i]; });
+		Benchmark("Mat3 * Mat3", mat3Out, [&](size_t i) { return mat3A[i] * mat3B[i]; });
+		Benchmark("Mat3::Transpose", mat3Out, [&](size_t i) { return mat3A[i].Transpose(); });
+		Benchmark("Mat3::Determinant", floats, [&](size_t i) { return mat3A[i].Determinant(); });
+		Benchmark("Mat3::Inverse", mat3Out, [&](size_t i) { return mat3A[i].Inverse(); });
+		Benchmark("Mat4 * Vec4", vec4Out, [&](size_t i) { return mat4A[i] * vec4A[i]; });
+		Benchmark("Mat4 * Mat4", mat4Out, [&](size_t i) { return mat4A[i] * mat4B[i]; });
+		Benchmark("Mat4::Transpose", mat4Out, [&](size_t i) { return mat4A[i].Transpose(); });
+		Benchmark("Mat4::Determinant", floats, [&](size_t i) { return mat4A[i].Determinant(); });
+		Benchmark("Mat4::Inverse", mat4Out, [&](size_t i) { return mat4A[i].Inverse(); });
+
+		// Quaternions ///////////////////////////////////////////////////////////////////////////
+		Benchmark("Quat * Quat", quatOut, [&](size_t i) { return quatA[i] * quatB[i]; });
+		Benchmark("Quat::Normalize", quatOut, [&](size_t i) { Quat q = quatA[i]; q.Normalize(); return q; });
+		Benchmark("Quat::Inverse", quatOut, [&](size_t i) { return quatA[i].Inverse(); });
+		Benchmark("Quat::RotatePoint", vec3Out, [&](size_t i) { return quatA[i].RotatePoint(vec3A[i]); });
+		Benchmark("Quat::ToMat3", mat3Out, [&](size_t i) { return quatA[i].ToMat3(); });
+
+		// Transforms ////////////////////////////////////////////////////////////////////////////
+		Benchmark("Transform::TransformPoint", vec3Out, [&](size_t i) { return transforms[i].TransformPoint(vec3A[i]); });
+		Benchmark("Transform::ToMat4", mat4Out, [&](size_t i) { return transforms[i].ToMat4(); });
+		Benchmark("Transform::Inverse", vec3Out, [&](size_t i) { return transforms[i].Inverse().position; });
+	}
+
+}
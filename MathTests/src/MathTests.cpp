@@ -0,0 +1,247 @@
+/*
+	Math Tests
+
+	Standalone checks and benchmarks for the engine math library.
+	Nothing in here depends on OpenGL or a window so it builds on every platform.
+*/
+
+#include "MathTests.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace ge {
+
+	static constexpr int s_Iterations = 10000;
+
+	static float MaxError(const Vec3& a, const Vec3& b)
+	{
+		return std::max({ std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z) });
+	}
+
+	static float MaxError(const Vec4& a, const Vec4& b)
+	{
+		return std::max({ std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z), std::fabs(a.w - b.w) });
+	}
+
+	static float MaxError(const Mat3& a, const Mat3& b)
+	{
+		float error = 0.0f;
+		for (int i = 0; i < 3; i++)
+			error = std::max(error, MaxError(a.rows[i], b.rows[i]));
+		return error;
+	}
+
+	static float MaxError(const Mat4& a, const Mat4& b)
+	{
+		float error = 0.0f;
+		for (int i = 0; i < 4; i++)
+			error = std::max(error, MaxError(a.rows[i], b.rows[i]));
+		return error;
+	}
+
+	static Mat3 Identity3() { Mat3 m; m.Identity(); return m; }
+	static Mat4 Identity4() { Mat4 m; m.Identity(); return m; }
+
+	// Runs the check on random inputs and compares the largest error against the tolerance
+	template<typename Fn>
+	static bool Check(const char* name, float tolerance, Fn&& fn)
+	{
+		MathRandom random;
+		float maxError = 0.0f;
+		for (int i = 0; i < s_Iterations; i++) {
+			const float error = fn(random);
+			// Also catches NaN
+			if (!(error <= maxError))
+				maxError = error;
+		}
+
+		const bool passed = maxError <= tolerance;
+		if (passed)
+			GE_INFO("[PASS] {0} (max error {1}, tolerance {2})", name, maxError, tolerance);
+		else
+			GE_ERROR("[FAIL] {0} (max error {1}, tolerance {2})", name, maxError, tolerance);
+		return passed;
+	}
+
+	int RunMathTests()
+	{
+		int failed = 0;
+		auto run = [&failed](bool passed) { if (!passed) failed++; };
+
+		// Inverse ///////////////////////////////////////////////////////////////////////////////
+
+		run(Check("Mat3: Inverse(M) * M == I", 1e-5f, [](MathRandom& r) {
+			const Mat3 m = r.Matrix3();
+			return MaxError(m.Inverse() * m, Identity3());
+		}));
+
+		run(Check("Mat3: M * Inverse(M) == I", 1e-5f, [](MathRandom& r) {
+			const Mat3 m = r.Matrix3();
+			return MaxError(m * m.Inverse(), Identity3());
+		}));
+
+		run(Check("Mat4: Inverse(M) * M == I", 1e-5f, [](MathRandom& r) {
+			const Mat4 m = r.Matrix4();
+			return MaxError(m.Inverse() * m, Identity4());
+		}));
+
+		run(Check("Mat4: M * Inverse(M) == I", 1e-5f, [](MathRandom& r) {
+			const Mat4 m = r.Matrix4();
+			return MaxError(m * m.Inverse(), Identity4());
+		}));
+
+		// Determinant and cofactors /////////////////////////////////////////////////////////////
+
+		run(Check("Mat3: det(A * B) == det(A) * det(B)", 1e-5f, [](MathRandom& r) {
+			const Mat3 a = r.Matrix3();
+			const Mat3 b = r.Matrix3();
+			const float expected = a.Determinant() * b.Determinant();
+			return std::fabs((a * b).Determinant() - expected) / std::fabs(expected);
+		}));
+
+		run(Check("Mat4: det(A * B) == det(A) * det(B)", 1e-5f, [](MathRandom& r) {
+			const Mat4 a = r.Matrix4();
+			const Mat4 b = r.Matrix4();
+			const float expected = a.Determinant() * b.Determinant();
+			return std::fabs((a * b).Determinant() - expected) / std::fabs(expected);
+		}));
+
+		run(Check("Mat4: det(transpose(M)) == det(M)", 1e-5f, [](MathRandom& r) {
+			const Mat4 m = r.Matrix4();
+			return std::fabs(m.Transpose().Determinant() - m.Determinant()) / std::fabs(m.Determinant());
+		}));
+
+		run(Check("Mat4: det(Inverse(M)) == 1 / det(M)", 1e-5f, [](MathRandom& r) {
+			const Mat4 m = r.Matrix4();
+			return std::fabs(m.Inverse().Determinant() * m.Determinant() - 1.0f);
+		}));
+
+		// Laplace expansion along every row and column gives the same determinant
+		run(Check("Mat3: cofactor expansion == det(M)", 1e-5f, [](MathRandom& r) {
+			const Mat3 m = r.Matrix3();
+			const float det = m.Determinant();
+			float error = 0.0f;
+			for (int i = 0; i < 3; i++) {
+				float row = 0.0f;
+				float column = 0.0f;
+				for (int j = 0; j < 3; j++) {
+					row += m.rows[i][j] * m.Cofactor(i, j);
+					column += m.rows[j][i] * m.Cofactor(j, i);
+				}
+				error = std::max({ error, std::fabs(row - det) / std::fabs(det), std::fabs(column - det) / std::fabs(det) });
+			}
+			return error;
+		}));
+
+		run(Check("Mat4: cofactor expansion == det(M)", 1e-5f, [](MathRandom& r) {
+			const Mat4 m = r.Matrix4();
+			const float det = m.Determinant();
+			float error = 0.0f;
+			for (int i = 0; i < 4; i++) {
+				float row = 0.0f;
+				float column = 0.0f;
+				for (int j = 0; j < 4; j++) {
+					row += m.rows[i][j] * m.Cofactor(i, j);
+					column += m.rows[j][i] * m.Cofactor(j, i);
+				}
+				error = std::max({ error, std::fabs(row - det) / std::fabs(det), std::fabs(column - det) / std::fabs(det) });
+			}
+			return error;
+		}));
+
+		// Expanding a row against the cofactors of a different row is the determinant of a
+		// matrix with two equal rows, which is zero
+		run(Check("Mat4: alien cofactor expansion == 0", 1e-5f, [](MathRandom& r) {
+			const Mat4 m = r.Matrix4();
+			const float det = m.Determinant();
+			float error = 0.0f;
+			for (int i = 0; i < 4; i++) {
+				for (int k = 0; k < 4; k++) {
+					if (i == k)
+						continue;
+
+					float sum = 0.0f;
+					for (int j = 0; j < 4; j++)
+						sum += m.rows[i][j] * m.Cofactor(k, j);
+					error = std::max(error, std::fabs(sum) / std::fabs(det));
+				}
+			}
+			return error;
+		}));
+
+		// Quaternions ///////////////////////////////////////////////////////////////////////////
+
+		run(Check("Quat: ToMat3() * v == RotatePoint(v)", 1e-5f, [](MathRandom& r) {
+			const Quat q = r.Rotation();
+			const Vec3 v = r.Vector();
+			return MaxError(q.ToMat3() * v, q.RotatePoint(v));
+		}));
+
+		run(Check("Quat: ToMat3() is orthonormal with det 1", 1e-5f, [](MathRandom& r) {
+			const Mat3 m = r.Rotation().ToMat3();
+			return std::max(MaxError(m * m.Transpose(), Identity3()), std::fabs(m.Determinant() - 1.0f));
+		}));
+
+		run(Check("Quat: (a * b).RotatePoint(v) == a.RotatePoint(b.RotatePoint(v))", 1e-5f, [](MathRandom& r) {
+			const Quat a = r.Rotation();
+			const Quat b = r.Rotation();
+			const Vec3 v = r.Vector();
+			return MaxError((a * b).RotatePoint(v), a.RotatePoint(b.RotatePoint(v)));
+		}));
+
+		run(Check("Quat: Inverse().RotatePoint(RotatePoint(v)) == v", 1e-5f, [](MathRandom& r) {
+			const Quat q = r.Rotation();
+			const Vec3 v = r.Vector();
+			return MaxError(q.Inverse().RotatePoint(q.RotatePoint(v)), v);
+		}));
+
+		run(Check("Quat: axis angle rotation matches the matrix", 1e-5f, [](MathRandom& r) {
+			const Vec3 axis = r.Vector();
+			if (axis.GetMag2() < 1e-4f)
+				return 0.0f;
+
+			// Rodrigues' rotation formula
+			Vec3 n = axis;
+			n.Normalize();
+			const float angle = r.Float(-3.0f, 3.0f);
+			const Vec3 v = r.Vector();
+			const Vec3 expected = v * cosf(angle) + n.Cross(v) * sinf(angle) + n * (n.Dot(v) * (1.0f - cosf(angle)));
+			return MaxError(Quat(axis, angle).RotatePoint(v), expected);
+		}));
+
+		// Transforms ////////////////////////////////////////////////////////////////////////////
+
+		run(Check("Transform: Inverse().TransformPoint(TransformPoint(p)) == p", 1e-4f, [](MathRandom& r) {
+			const Transform t = r.RandomTransform(true);
+			const Vec3 p = r.Vector(10.0f);
+			return MaxError(t.Inverse().TransformPoint(t.TransformPoint(p)), p);
+		}));
+
+		run(Check("Transform: ToMat4() * p == TransformPoint(p)", 1e-4f, [](MathRandom& r) {
+			const Transform t = r.RandomTransform(false);
+			const Vec3 p = r.Vector(10.0f);
+			const Vec3 expected = t.TransformPoint(p);
+			return MaxError(t.ToMat4() * Vec4(p.x, p.y, p.z, 1.0f), Vec4(expected.x, expected.y, expected.z, 1.0f));
+		}));
+
+		run(Check("Transform: Inverse().ToMat4() == Inverse(ToMat4())", 1e-4f, [](MathRandom& r) {
+			const Transform t = r.RandomTransform(true);
+			return MaxError(t.Inverse().ToMat4(), t.ToMat4().Inverse());
+		}));
+
+		run(Check("Transform: (a * b).TransformPoint(p) == a.TransformPoint(b.TransformPoint(p))", 1e-4f, [](MathRandom& r) {
+			const Transform a = r.RandomTransform(true);
+			const Transform b = r.RandomTransform(false);
+			const Vec3 p = r.Vector(10.0f);
+			return MaxError((a * b).TransformPoint(p), a.TransformPoint(b.TransformPoint(p)));
+		}));
+
+		if (failed == 0)
+			GE_INFO("All math tests passed");
+		else
+			GE_ERROR("{0} math tests failed", failed);
+		return failed;
+	}
+
+}
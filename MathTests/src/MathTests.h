@@ -0,0 +1,72 @@
+/*
+	Math Tests
+
+	Standalone checks and benchmarks for the engine math library.
+	Nothing in here depends on OpenGL or a window so it builds on every platform.
+*/
+
+#pragma once
+
+#include "GameEngine/Math/Transform.h"
+
+#include <random>
+
+namespace ge {
+
+	// Random inputs with a fixed seed so that failures can be reproduced
+	class MathRandom
+	{
+	public:
+		MathRandom(uint32_t seed = 1337) : m_Engine(seed) {}
+
+		float Float(float min = -1.0f, float max = 1.0f) { return std::uniform_real_distribution<float>(min, max)(m_Engine); }
+
+		Vec3 Vector(float range = 1.0f) { return Vec3(Float(-range, range), Float(-range, range), Float(-range, range)); }
+		Vec4 Vector4(float range = 1.0f) { return Vec4(Float(-range, range), Float(-range, range), Float(-range, range), Float(-range, range)); }
+
+		Quat Rotation()
+		{
+			Quat q(Float(), Float(), Float(), Float());
+			if (q.Mag2() < 1e-4f)
+				return Quat();
+			q.Normalize();
+			return q;
+		}
+
+		// Random entries plus a dominant diagonal keeps the matrix well conditioned
+		Mat3 Matrix3()
+		{
+			Mat3 m(Vector(), Vector(), Vector());
+			for (int i = 0; i < 3; i++)
+				m.rows[i][i] += 3.0f;
+			return m;
+		}
+
+		Mat4 Matrix4()
+		{
+			Mat4 m(Vector4(), Vector4(), Vector4(), Vector4());
+			for (int i = 0; i < 4; i++)
+				m.rows[i][i] += 4.0f;
+			return m;
+		}
+
+		Transform RandomTransform(bool uniformScale)
+		{
+			const float s = Float(0.5f, 2.0f);
+			const Vec3 scale = uniformScale ? Vec3(s) : Vec3(Float(0.5f, 2.0f), Float(0.5f, 2.0f), Float(0.5f, 2.0f));
+			return Transform(Vector(10.0f), Rotation(), scale);
+		}
+
+	private:
+		std::mt19937 m_Engine;
+	};
+
+	// Returns the number of failed checks
+	int RunMathTests();
+
+	void RunMathBenchmarks(uint32_t count);
+
+	// Float against double world positions on the way to a render transform
+	void RunPrecisionBenchmarks(uint32_t count);
+
+}
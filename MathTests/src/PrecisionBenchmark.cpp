@@ -0,0 +1,112 @@
+/*
+	Precision Benchmark
+
+	Compares the float and double world position paths (see RVec3 and GE_DOUBLE_PRECISION).
+	Bodies are placed further and further from the world origin with the camera close to them.
+	Each path stores the positions at its precision, makes them relative to the camera and builds
+	the float render transform the way Body::GetRenderTransform does. The cost per transform is
+	reported with the largest error of the relative position compared to the exact value.
+*/
+
+#include "MathTests.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace ge {
+
+	// Same layout and operations as RVec3 with the precision picked per instance, so both paths can
+	// run in one program without two definitions of RVec3
+	template<typename T>
+	struct WorldPosition
+	{
+		T x, y, z;
+
+		Vec3 RelativeTo(const WorldPosition& origin) const { return Vec3((float)(x - origin.x), (float)(y - origin.y), (float)(z - origin.z)); }
+	};
+
+	struct RenderTransform
+	{
+		float m[16];
+	};
+
+	static volatile float s_PrecisionSink = 0.0f;
+
+	template<typename T>
+	static void RunPath(const char* name, const std::vector<double>& positions, const std::vector<Quat>& rotations, const double origin[3])
+	{
+		const size_t count = rotations.size();
+
+		std::vector<WorldPosition<T>> stored(count);
+		for (size_t i = 0; i < count; i++)
+			stored[i] = { (T)positions[i * 3 + 0], (T)positions[i * 3 + 1], (T)positions[i * 3 + 2] };
+		const WorldPosition<T> cameraPosition = { (T)origin[0], (T)origin[1], (T)origin[2] };
+
+		std::vector<RenderTransform> out(count);
+		constexpr int runs = 5;
+		double best = 1e30;
+		for (int run = 0; run < runs; run++) {
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; i++) {
+				const Vec3 position = stored[i].RelativeTo(cameraPosition);
+				const Mat3 rotation = rotations[i].ToMat3();
+
+				float* m = out[i].m;
+				for (int r = 0; r < 3; r++) {
+					for (int c = 0; c < 3; c++) {
+						m[c * 4 + r] = rotation.rows[r][c];
+					}
+					m[r * 4 + 3] = 0.0f;
+				}
+				m[12] = position.x;
+				m[13] = position.y;
+				m[14] = position.z;
+				m[15] = 1.0f;
+			}
+			const auto end = std::chrono::steady_clock::now();
+
+			best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+		}
+
+		// The error against the relative positions worked out exactly from the inputs
+		double maxError = 0.0;
+		float sum = 0.0f;
+		for (size_t i = 0; i < count; i++) {
+			const float* m = out[i].m;
+			for (int c = 0; c < 3; c++) {
+				const long double exact = (long double)positions[i * 3 + c] - (long double)origin[c];
+				maxError = std::max(maxError, (double)std::fabs((long double)m[12 + c] - exact));
+			}
+			sum += m[12] + m[0];
+		}
+		s_PrecisionSink = s_PrecisionSink + sum;
+
+		GE_INFO("  {0:<8} {1:6.2f} ns/transform, max position error {2}", name, best / (double)count, maxError);
+	}
+
+	void RunPrecisionBenchmarks(uint32_t count)
+	{
+		GE_INFO("World position precision over {0} transforms (RVec3 is {1} here)", count, sizeof(Real) == sizeof(double) ? "double" : "float");
+
+		for (double distance : { 1.0e2, 1.0e4, 1.0e6, 1.0e8 }) {
+			MathRandom random;
+
+			// The camera and the bodies share a region of a few hundred units around the distance
+			const double origin[3] = { distance + random.Float(), distance * 0.5 + random.Float(), -distance + random.Float() };
+
+			std::vector<double> positions(count * 3);
+			std::vector<Quat> rotations(count);
+			for (uint32_t i = 0; i < count; i++) {
+				for (int c = 0; c < 3; c++)
+					positions[i * 3 + c] = origin[c] + (double)random.Float(-200.0f, 200.0f) + (double)random.Float() * 1e-3;
+				rotations[i] = random.Rotation();
+			}
+
+			GE_INFO("Distance from the world origin {0}", distance);
+			RunPath<float>("float", positions, rotations, origin);
+			RunPath<double>("double", positions, rotations, origin);
+		}
+	}
+
+}
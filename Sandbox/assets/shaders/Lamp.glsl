@@ -6,7 +6,14 @@
 layout(location = 0) in vec3 a_Position;
 layout(location = 1) in vec2 a_Normal;
 
-uniform mat4 u_ViewProjection;
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_CameraPosition;
+};
+
 uniform mat4 u_Transform;
 
 void main() {
@@ -0,0 +1,100 @@
+// Normal Mapping Shader for packed mesh vertices (MeshVertexFormat::Packed and PackedQuantized)
+// Normal and tangent are octahedral encoded, the bitangent is rebuilt from the handedness
+// stored in the tangent and positions are placed inside the mesh bounds
+
+#type vertex
+#version 330 core
+
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec2 a_Normal;
+layout(location = 2) in vec2 a_TexCoords;
+layout(location = 3) in vec4 a_Tangent;
+
+uniform mat4 u_ViewProjection;
+uniform mat4 u_Transform;
+
+uniform vec3 u_BoundsMin;
+uniform vec3 u_BoundsExtent;
+
+uniform vec3 u_LightPosition;
+uniform vec3 u_ViewPosition;
+
+out VS_OUT {
+	vec3 v_FragmentPosition;
+	vec2 v_TexCoords;
+	vec3 v_TangentLightPosition;
+	vec3 v_TangentViewPosition;
+	vec3 v_TangentFragmentPosition;
+} vs_out;
+
+vec3 OctahedralDecode(vec2 e) {
+	vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+void main() {
+	vec3 position = u_BoundsMin + a_Position.xyz * u_BoundsExtent;
+
+	// convert everything to world space
+	vs_out.v_FragmentPosition = vec3(u_Transform * vec4(position, 1.0));
+	vs_out.v_TexCoords = a_TexCoords;
+
+	mat3 normalMatrix = transpose(inverse(mat3(u_Transform)));
+	vec3 T = normalize(normalMatrix * OctahedralDecode(a_Tangent.xy));
+	vec3 N = normalize(normalMatrix * OctahedralDecode(a_Normal));
+	T = normalize(T - dot(T,N)*N);			// make sure tangent is orthogonal - gram schmidt
+	vec3 B = cross(N, T) * (a_Tangent.z < 0.0 ? -1.0 : 1.0);
+
+	mat3 TBN = transpose(mat3(T,B,N)); 		// T,B,N are orthogonal => TBN orthogonal => transpose = inverse (transpose is easier than inverse)
+	vs_out.v_TangentLightPosition = TBN * u_LightPosition;
+	vs_out.v_TangentViewPosition = TBN * u_ViewPosition;
+	vs_out.v_TangentFragmentPosition = TBN * vs_out.v_FragmentPosition;
+
+	gl_Position = u_ViewProjection * vec4(vs_out.v_FragmentPosition, 1.0);
+}
+
+#type pixel
+#version 330 core
+
+out vec4 color;
+
+in VS_OUT {
+	vec3 v_FragmentPosition;
+	vec2 v_TexCoords;
+	vec3 v_TangentLightPosition;
+	vec3 v_TangentViewPosition;
+	vec3 v_TangentFragmentPosition;
+} fs_in;
+
+uniform sampler2D u_DiffuseMap;
+uniform sampler2D u_NormalMap;
+
+uniform vec3 u_LightPosition;
+uniform vec3 u_ViewPosition;
+
+void main() {
+	// obtain normal from normal map in range [0,1]
+	vec3 normal = texture(u_NormalMap, fs_in.v_TexCoords).rgb;
+	// transform normal vector range to [-1, 1]
+	normal = normalize(normal*2.0 - 1.0);		// this normal is in tangent space
+
+	// get diff color
+	vec3 col = texture(u_DiffuseMap, fs_in.v_TexCoords).rgb;
+	//ambient
+	vec3 ambient = 0.1 * col;
+	// diffuse
+	vec3 lightDirection= normalize(fs_in.v_TangentLightPosition - fs_in.v_TangentFragmentPosition);
+	float diff = max(dot(lightDirection, normal), 0.0);
+	vec3 diffuse= diff * col;
+	// specular
+	vec3 viewDirection = normalize(fs_in.v_TangentViewPosition - fs_in.v_TangentFragmentPosition);
+	vec3 reflectDirection = reflect(-lightDirection, normal);
+	vec3 halfwayDirection = normalize(lightDirection + viewDirection);
+	float spec = pow(max(dot(normal, halfwayDirection), 0.0), 32.0);
+
+	vec3 specular = vec3(0.2) * spec;
+	color = vec4(ambient + diffuse + specular, 1.0);
+}
\ No newline at end of file
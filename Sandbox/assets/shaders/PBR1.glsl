@@ -6,18 +6,32 @@ layout (location = 0) in vec3 a_Position;
 layout (location = 1) in vec2 a_TexCoords;
 layout (location = 2) in vec3 a_Normal;
 
+// Per instance attributes, the renderer draws every body with the same sphere in one call
+in mat4 a_InstanceTransform;
+in vec4 a_InstanceColor;
+in vec4 a_InstanceSecondaryColor;
+
 out vec2 v_TexCoords;
 out vec3 v_WorldPosition;
 out vec3 v_Normal;
+flat out vec3 v_Albedo;
+flat out vec3 v_AlbedoB;
 
-uniform mat4 u_ViewProjection;
-uniform mat4 u_Transform;
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_CameraPosition;
+};
 
 void main()
 {
     v_TexCoords = a_TexCoords;
-    v_WorldPosition = vec3(u_Transform * vec4(a_Position, 1.0));
-    v_Normal = mat3(u_Transform) * a_Normal;
+    v_WorldPosition = vec3(a_InstanceTransform * vec4(a_Position, 1.0));
+    v_Normal = mat3(a_InstanceTransform) * a_Normal;
+    v_Albedo = a_InstanceColor.rgb;
+    v_AlbedoB = a_InstanceSecondaryColor.rgb;
 
     gl_Position = u_ViewProjection * vec4(v_WorldPosition, 1.0);
 }
@@ -29,19 +43,29 @@ out vec4 FragmentColor;
 in vec2 v_TexCoords;
 in vec3 v_WorldPosition;
 in vec3 v_Normal;
+flat in vec3 v_Albedo;
+flat in vec3 v_AlbedoB;
 
 // material parameters
-uniform vec3 u_Albedo;
-uniform vec3 u_AlbedoB;
 uniform float u_Metallic;
 uniform float u_Roughness;
 uniform float u_Ao;
 
-// light
-uniform vec3 u_LightPositions[1];
-uniform vec3 u_LightColors[1];
+// Per frame data shared with the other shaders
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+    mat4 u_View;
+    mat4 u_Projection;
+    vec4 u_CameraPosition;
+};
 
-uniform vec3 u_ViewPosition;
+layout(std140) uniform Lights
+{
+    vec4 u_LightPositions[4];
+    vec4 u_LightColors[4];
+    int u_LightCount;
+};
 
 uniform sampler2D u_Texture;
 
@@ -98,21 +122,21 @@ vec3 FresnelSchlick(float cosTheta, vec3 F0)
 void main() 
 {   
     vec3 N = normalize(v_Normal);                               // Normal to interface
-    vec3 V = normalize(u_ViewPosition - v_WorldPosition);       // View direction
+    vec3 V = normalize(u_CameraPosition.xyz - v_WorldPosition);       // View direction
 
     vec3 F0 = vec3(0.04);
-    F0 = mix(F0, u_Albedo, u_Metallic);         // mixes the two parameters with the metallic ratio
+    F0 = mix(F0, v_Albedo, u_Metallic);         // mixes the two parameters with the metallic ratio
 
     // reflection equation
     vec3 Lo = vec3(0.0);
-    for(int i = 0; i < 1; ++i)
+    for(int i = 0; i < u_LightCount; ++i)
     {
         // calculate per-light radiance
-        vec3 L = normalize(u_LightPositions[i] - v_WorldPosition);         // Light direction
+        vec3 L = normalize(u_LightPositions[i].xyz - v_WorldPosition);         // Light direction
         vec3 H = normalize(V + L);                                      // Halfway direction
-        float distance = length(u_LightPositions[i] - v_WorldPosition);
+        float distance = length(u_LightPositions[i].xyz - v_WorldPosition);
         float attenuation = 1.0 / (distance * distance);                // Usual inverse square law
-        vec3 radiance = u_LightColors[i] * attenuation;
+        vec3 radiance = u_LightColors[i].rgb * attenuation;
 
         // cook-torrance brdf
         float NDF = DistributionGGX(N, H, u_Roughness);                 // Normal distribution coefficient
@@ -129,19 +153,19 @@ void main()
 
         // add to outgoing radiance Lo
         float NdotL = max(dot(N, L), 0.0);
-        Lo += (kD * u_Albedo / PI + specular) * radiance * NdotL;
+        Lo += (kD * v_Albedo / PI + specular) * radiance * NdotL;
     }
 
-    vec3 ambient = u_Albedo * u_Ao;
+    vec3 ambient = v_Albedo * u_Ao;
 
     vec4 textureColor = texture(u_Texture, v_TexCoords);
     if (textureColor.r > 0.5f)
     {
-        ambient = vec3(0.5) * u_Albedo * u_Ao;
+        ambient = vec3(0.5) * v_Albedo * u_Ao;
     }
     else
     {
-        ambient = vec3(0.5) * u_AlbedoB * u_Ao;
+        ambient = vec3(0.5) * v_AlbedoB * u_Ao;
     }
 
     vec3 color = (ambient + Lo);
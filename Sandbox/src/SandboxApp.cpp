@@ -4,22 +4,25 @@
 
 #include "imgui/imgui.h"
 
+#include "SoftwarePrograms.h"
+
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/quaternion.hpp>
 
-#include "Platform/OpenGL/OpenGLShader.h"
+#include <chrono>
+
 
 class ExampleLayer : public ge::Layer {
 
 public:
 	ExampleLayer()
-		: Layer("Example"), m_OrthographicCameraController(1280.0f / 720.0f, true), m_PerspectiveCameraController(45.0f, 1280.0f / 720.0f, 0.1f, 1000.0f), m_Model(""), m_SceneType(SceneType::Scene3D)
+		: Layer("Example"), m_OrthographicCameraController(1280.0f / 720.0f, true), m_PerspectiveCameraController(45.0f, 1280.0f / 720.0f, 0.1f, 1000.0f), m_SceneType(SceneType::Scene3D)
 	{
 		// Code for 3D Scene
 		if (m_SceneType == SceneType::Scene3D)
 		{
-			m_PerspectiveCameraController.SetCameraPosition(glm::vec3(0,10,25));
+			m_PerspectiveCameraController.SetCameraPosition(ge::RVec3(0,10,25));
 			glm::vec3 forwardDirection = glm::vec3(0, -0.2f, -0.95f);
 			forwardDirection = glm::normalize(forwardDirection);
 			m_PerspectiveCameraController.SetCameraFront(forwardDirection);
@@ -78,6 +81,30 @@ public:
 
 			m_IndexCount = indices.size();
 
+			// Coarse triangle list of the same sphere for the occlusion culler. It lies inside the rendered sphere,
+			// so it never hides more than the sphere does.
+			const unsigned int OCCLUDER_SEGMENTS = 16;
+			for (unsigned int y = 0; y <= OCCLUDER_SEGMENTS; ++y)
+			{
+				for (unsigned int x = 0; x <= OCCLUDER_SEGMENTS; ++x)
+				{
+					float xSegment = (float)x / (float)OCCLUDER_SEGMENTS;
+					float ySegment = (float)y / (float)OCCLUDER_SEGMENTS;
+					m_OccluderPositions.push_back(glm::vec3(std::cos(xSegment * 2.0f * PI) * std::sin(ySegment * PI),
+						std::cos(ySegment * PI), std::sin(xSegment * 2.0f * PI) * std::sin(ySegment * PI)));
+				}
+			}
+
+			for (unsigned int y = 0; y < OCCLUDER_SEGMENTS; ++y)
+			{
+				for (unsigned int x = 0; x < OCCLUDER_SEGMENTS; ++x)
+				{
+					uint32_t i0 = y * (OCCLUDER_SEGMENTS + 1) + x;
+					uint32_t i2 = i0 + OCCLUDER_SEGMENTS + 1;
+					m_OccluderIndices.insert(m_OccluderIndices.end(), { i0, i0 + 1, i2, i0 + 1, i2 + 1, i2 });
+				}
+			}
+
 			std::vector<float> data;
 			for (int i = 0; i < positions.size(); ++i)
 			{
@@ -116,16 +143,18 @@ public:
 			// Shaders
 			auto pbrShader = m_ShaderLibrary.Load("assets/shaders/PBR1.glsl");
 			auto lampShader = m_ShaderLibrary.Load("assets/shaders/Lamp.glsl");
-
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->Bind();
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat3("u_Albedo", { 0.5f, 0.0f, 0.0f });
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat("u_Ao", 1.0f);
+			m_ModelShader = m_ShaderLibrary.Load("assets/shaders/SimpleModel.glsl");
 
 			// Create textures
-			m_Texture = ge::Texture2D::Create("assets/textures/Chessboard.png");
+			m_Texture = ge::TextureCache::GetTexture2D("assets/textures/Chessboard.png");
 
-			// Bind shader and upload texture uniform
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformInt("u_Texture", 0);		// 0 is the texure slot of m_Texture
+			// Materials
+			m_PbrMaterial = ge::Material::Create(pbrShader);
+			m_PbrMaterial->SetFloat("u_Ao", 1.0f);
+			m_PbrMaterial->SetTexture("u_Texture", m_Texture, 0);
+
+			m_LampMaterial = ge::Material::Create(lampShader);
+			m_LampMaterial->SetFloat3("u_LightColor", glm::vec3(1.0f, 1.0f, 1.0f));
 
 			// lighting info
 			// -------------
@@ -239,46 +268,21 @@ public:
 			m_Shader = ge::Shader::Create("VertexPosColor", vertexSrc, pixelSrc);
 
 
-			std::string flatColorShaderVertexSrc = R"(
-				#version 330 core
-				layout(location = 0) in vec3 a_Position;
-				uniform mat4 u_ViewProjection;
-				uniform mat4 u_Transform;
-				out vec3 v_Position;
-				void main() {
-					v_Position = a_Position;
-					gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
-				}
-		
-				)";
-
-			std::string flatColorShaderPixelSrc = R"(
-				#version 330 core
-				layout(location = 0) out vec4 color;
-				in vec3 v_Position;
-				uniform vec3 u_Color;
-				void main() {
-					color = vec4(u_Color, 1.0);
-				}
-		
-				)";
-
-			m_FlatColorShader = ge::Shader::Create("FlatColor", flatColorShaderVertexSrc, flatColorShaderPixelSrc);
-
-			auto textureShader = m_ShaderLibrary.Load("assets/shaders/Texture.glsl");
+			// Quads are drawn through the batch renderer
+			ge::Renderer2D::Init();
 
 			// Create textures
-			m_Texture = ge::Texture2D::Create("assets/textures/Checkerboard.png");
-			m_BlendTexture = ge::Texture2D::Create("assets/textures/ChernoLogo.png");
-
-			// Bind shader and upload texture uniform
-			std::dynamic_pointer_cast<ge::OpenGLShader>(textureShader)->Bind();
-			std::dynamic_pointer_cast<ge::OpenGLShader>(textureShader)->UploadUniformInt("u_Texture", 0);		// 0 is the texure slot of m_Texture
+			m_Texture = ge::TextureCache::GetTexture2D("assets/textures/Checkerboard.png");
+			// Decoded in the background, the quad shows the placeholder until the upload
+			m_BlendTexture = ge::AssetManager::LoadTexture2D("assets/textures/ChernoLogo.png");
 		}
 	}
 
 	~ExampleLayer()
 	{
+		if (m_SceneType == SceneType::Scene2D)
+			ge::Renderer2D::Shutdown();
+
 		delete m_scene;
 		m_scene = NULL;
 	}
@@ -302,33 +306,32 @@ public:
 			// Begin the current scene
 			ge::Renderer::BeginScene(m_PerspectiveCameraController.GetCamera());
 
-			auto pbrShader = m_ShaderLibrary.Get("PBR1");
-
-			// Set up uniforms
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->Bind();
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat3("u_ViewPosition", m_PerspectiveCameraController.GetCameraPosition());
-
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat3("u_Albedo", m_ColorA);
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat3("u_AlbedoB", m_ColorB);
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat("u_Metallic", m_Metallic);
+			// Set up material parameters, the camera is read from the Camera uniform block
+			m_PbrMaterial->SetFloat("u_Metallic", m_Metallic);
 			// we clamp the roughness to 0.025 - 1.0 as perfectly smooth surfaces (roughness of 0.0) tend to look
 			// a bit off on direct lighting
-			std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat("u_Roughness", glm::clamp(m_Roughness, 0.05f, 1.0f));
+			m_PbrMaterial->SetFloat("u_Roughness", glm::clamp(m_Roughness, 0.05f, 1.0f));
 			glm::mat4 transform = glm::mat4(1.0f);
 
 			for (int i = 0; i < m_scene->m_bodies.size(); i++) 
 			{
+				glm::vec4 albedo = glm::vec4(m_ColorA, 1.0f);
+				glm::vec4 albedoB = glm::vec4(m_ColorB, 1.0f);
 				if (i == m_scene->m_bodies.size() - 1)
 				{
 					// Use ground colours
-					std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat3("u_Albedo", glm::vec3(0.075, 0.192, 0.426));
-					std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat3("u_AlbedoB", glm::vec3(0, 0.082, 0.388));
+					albedo = glm::vec4(0.075, 0.192, 0.426, 1.0);
+					albedoB = glm::vec4(0, 0.082, 0.388, 1.0);
 				}
 
 				ge::Body& body = m_scene->m_bodies[i];
 				transform = glm::mat4(1.0f);
-				transform = body.GetRenderTransform();
-				ge::Renderer::Submit(pbrShader, m_PbrVA, transform);
+				transform = body.GetRenderTransform(ge::Renderer::GetRenderOrigin());
+
+				// The ground hides whatever falls below it
+				if (i == m_scene->m_bodies.size() - 1)
+					ge::Renderer::SubmitOccluder(m_OccluderPositions, m_OccluderIndices, transform);
+				ge::Renderer::SubmitCulled(m_PbrMaterial, m_PbrVA, transform, m_SphereBounds, albedo, albedoB);
 			}
 
 			m_TotalTime += dt;
@@ -336,28 +339,42 @@ public:
 			// this looks a bit off as we use the same shader, but it'll make their positions obvious and 
 			// keeps the codeprint small.
 
-			auto lampShader = m_ShaderLibrary.Get("Lamp");
-
 			for (unsigned int i = 0; i < m_LightPositions.size(); ++i)
 			{
 				glm::vec3 newPos = m_LightPositions[i] + glm::vec3(sin(m_TotalTime * 5.0) * 5.0, 0.0, 0.0);
 				newPos = m_LightPositions[i];
-				std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->Bind();
-				std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat3("u_LightPositions[" + std::to_string(i) + "]", newPos);
-				std::dynamic_pointer_cast<ge::OpenGLShader>(pbrShader)->UploadUniformFloat3("u_LightColors[" + std::to_string(i) + "]", m_LightColors[i]);
-
-				// Set up uniforms
-				std::dynamic_pointer_cast<ge::OpenGLShader>(lampShader)->Bind();
-				std::dynamic_pointer_cast<ge::OpenGLShader>(lampShader)->UploadUniformFloat3("u_ViewPosition", m_PerspectiveCameraController.GetCameraPosition());
-				std::dynamic_pointer_cast<ge::OpenGLShader>(lampShader)->UploadUniformFloat3("u_LightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+				ge::Renderer::SubmitPointLight(newPos, m_LightColors[i]);
 
+				// Drawn relative to the render origin like the bodies, the light itself is given in world space
+				const ge::Vec3 lampPos = (ge::RVec3(newPos.x, newPos.y, newPos.z) - ge::Renderer::GetRenderOrigin()).ToVec3();
 				transform = glm::mat4(1.0f);
-				transform = glm::translate(transform, newPos);
+				transform = glm::translate(transform, glm::vec3(lampPos.x, lampPos.y, lampPos.z));
 				transform = glm::scale(transform, glm::vec3(0.5f));
-				ge::Renderer::Submit(lampShader, m_PbrVA, transform);
+				ge::Renderer::SubmitCulled(m_LampMaterial, m_PbrVA, transform, m_SphereBounds);
 			}
 
 			ge::Renderer::EndScene();
+
+			// The benchmark model is drawn straight away, after the queue has been flushed
+			if (m_BenchmarkModel)
+			{
+				const ge::Vec3 modelPos = (m_BenchmarkPosition - ge::Renderer::GetRenderOrigin()).ToVec3();
+				transform = glm::translate(glm::mat4(1.0f), glm::vec3(modelPos.x, modelPos.y, modelPos.z));
+				transform = glm::scale(transform, glm::vec3(m_BenchmarkScale));
+
+				// The material textures only stream in the mips the model needs at its size on screen
+				const float viewportHeight = (float)ge::Application::Get().GetWindow().GetHeight();
+				m_BenchmarkModel->RequestTextureMips(m_PerspectiveCameraController.GetCamera(), transform, viewportHeight);
+
+				auto drawStart = std::chrono::steady_clock::now();
+				m_ModelShader->Bind();
+				ge::Renderer::SetProjection(m_ModelShader, transform);
+				m_BenchmarkModel->Draw(m_ModelShader);
+				const float drawTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - drawStart).count();
+
+				// Smoothed so the value can be read
+				m_BenchmarkDrawTime = m_BenchmarkDrawTime == 0.0f ? drawTime : glm::mix(m_BenchmarkDrawTime, drawTime, 0.05f);
+			}
 		}
 
 		// Code for 2D scene
@@ -370,34 +387,22 @@ public:
 			ge::RenderCommand::SetClearColor({ 0.1f, 0.1f, 0.1f, 1 });
 			ge::RenderCommand::Clear();
 
-			ge::Renderer::BeginScene(m_OrthographicCameraController.GetCamera());
-
-			static glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(0.1f));
-
-			// Set up uniform
-			std::dynamic_pointer_cast<ge::OpenGLShader>(m_FlatColorShader)->Bind();
-			std::dynamic_pointer_cast<ge::OpenGLShader>(m_FlatColorShader)->UploadUniformFloat3("u_Color", m_ColorA);
+			ge::Renderer2D::ResetStats();
+			ge::Renderer2D::BeginScene(m_OrthographicCameraController.GetCamera());
 
 			// Render grid of blue squares
 			for (int x = -10; x < 11; x++) {
 				for (int y = -10; y < 11; y++) {
-					glm::vec3 pos(x * 0.11f, y * 0.11f, 0.0f);
-					glm::mat4 transform = glm::translate(glm::mat4(1.0f), pos) * scale;
-					ge::Renderer::Submit(m_FlatColorShader, m_SquareVA, transform);
+					glm::vec2 pos(x * 0.11f, y * 0.11f);
+					ge::Renderer2D::DrawQuad(pos, glm::vec2(0.1f), glm::vec4(m_ColorA, 1.0f));
 				}
 			}
 
-			// Get shader from library
-			auto textureShader = m_ShaderLibrary.Get("Texture");
-
-			// Bind texures and dray shapes
-			m_Texture->Bind(0);
-			ge::Renderer::Submit(textureShader, m_SquareVA, glm::scale(glm::mat4(1.0f), glm::vec3(1.5f)));
-
-			m_BlendTexture->Bind(0);
-			ge::Renderer::Submit(textureShader, m_SquareVA, glm::scale(glm::mat4(1.0f), glm::vec3(1.5f)));
+			// Textured quads share the batch with the grid, each texture takes its own slot
+			ge::Renderer2D::DrawQuad(glm::vec2(0.0f), glm::vec2(1.5f), m_Texture);
+			ge::Renderer2D::DrawQuad(glm::vec2(0.0f), glm::vec2(1.5f), m_BlendTexture.Get());
 
-			ge::Renderer::EndScene();
+			ge::Renderer2D::EndScene();
 		}
 	}
 
@@ -409,6 +414,59 @@ public:
 		ImGui::ColorEdit3("Color B", glm::value_ptr(m_ColorB));
 		ImGui::DragFloat("Metallic", &m_Metallic, 0.001f, 0.0f, 1.0f);
 		ImGui::DragFloat("Roughness", &m_Roughness, 0.001f, 0.0f, 1.0f);
+
+		if (m_SceneType == SceneType::Scene2D)
+		{
+			const auto& stats = ge::Renderer2D::GetStats();
+			ImGui::Text("Draw Calls: %d", stats.DrawCalls);
+			ImGui::Text("Quads: %d", stats.QuadCount);
+			ImGui::Text("Flushes: %d", stats.FlushCount);
+		}
+		else
+		{
+			const auto& stats = ge::Renderer::GetQueueStatistics();
+			ImGui::Text("Draw Calls: %d (%d instanced, %d instances)", stats.DrawCalls, stats.InstancedDrawCalls, stats.Instances);
+			ImGui::Text("Shader Binds: %d", stats.ShaderBinds);
+
+			const auto& cullingStats = ge::Renderer::GetCullingStatistics();
+			ImGui::Text("Culling: %d visible, %d culled", cullingStats.Visible, cullingStats.Culled);
+
+			bool occlusionCulling = ge::Renderer::IsOcclusionCullingEnabled();
+			if (ImGui::Checkbox("Occlusion Culling", &occlusionCulling))
+				ge::Renderer::SetOcclusionCulling(occlusionCulling);
+			const auto& occlusionStats = ge::Renderer::GetOcclusionStatistics();
+			ImGui::Text("Occlusion: %d occluded, %d triangles, %.2f ms", occlusionStats.Occluded, occlusionStats.Triangles, occlusionStats.RasterTime);
+
+			// Large model benchmark, the import skips the cooked file so assimp is timed every time
+			ImGui::Checkbox("Packed Model Storage", &m_BenchmarkPacked);
+			if (ImGui::Button("Load Benchmark Model"))
+				LoadBenchmarkModel();
+			if (m_BenchmarkModel)
+			{
+				const auto& report = m_BenchmarkModel->GetMemoryReport();
+				const bool packed = m_BenchmarkModel->GetSettings().Storage == ge::ModelStorage::Packed;
+				ImGui::Text("Model Load: %.1f ms import, %.1f ms pack, %.1f ms upload", m_BenchmarkImportTime, report.PackTime, report.UploadTime);
+				ImGui::Text("Model Memory: %d meshes, %d KB GPU, %d KB CPU at load", report.MeshCount, (int)(report.GPUBytes / 1024),
+					(int)(report.CPUBytesAtLoad / 1024));
+				ImGui::Text("Model Draw: %.3f ms CPU, %d draw calls", m_BenchmarkDrawTime, packed ? 1 : (int)report.MeshCount);
+			}
+		}
+
+		const auto& stateStats = ge::RenderCommand::GetStateStatistics();
+		ImGui::Text("GL State Calls: %d issued, %d skipped", stateStats.Issued, stateStats.Skipped);
+
+		const auto assetStats = ge::AssetManager::GetStatistics();
+		ImGui::Text("Assets: %d decoding, %d waiting for upload, %d loaded, %d failed", assetStats.Decoding, assetStats.WaitingForUpload,
+			assetStats.Loaded, assetStats.Failed);
+		ImGui::Text("Uploads: %d (%d KB, %.2f ms)", assetStats.Uploads, (int)(assetStats.UploadedBytes / 1024), assetStats.UploadTime);
+
+		const auto cacheStats = ge::TextureCache::GetStatistics();
+		ImGui::Text("Texture Cache: %.0f%% hits, %d textures, %d KB", cacheStats.GetHitRate() * 100.0f, cacheStats.LiveTextures,
+			(int)(cacheStats.LiveBytes / 1024));
+
+		const auto streamingStats = ge::TextureStreamer::GetStatistics();
+		ImGui::Text("Streaming: %d textures, %d KB resident of %d KB requested%s", streamingStats.Textures,
+			(int)(streamingStats.ResidentBytes / 1024), (int)(streamingStats.RequestedBytes / 1024), streamingStats.OverBudget ? " (over budget)" : "");
 		ImGui::End();
 	}
 
@@ -425,6 +483,27 @@ public:
 
 	}
 
+	// Loads the benchmark model on this thread so the import and upload can be timed on their own
+	void LoadBenchmarkModel()
+	{
+		ge::ModelSettings settings;
+		settings.Storage = m_BenchmarkPacked ? ge::ModelStorage::Packed : ge::ModelStorage::PerMesh;
+		settings.UseCookedMesh = false;
+
+		auto importStart = std::chrono::steady_clock::now();
+		ge::ModelData data;
+		if (!ge::Model::Import(m_BenchmarkPath, settings, data))
+		{
+			GE_ERROR("Could not load the benchmark model {0}", m_BenchmarkPath);
+			m_BenchmarkModel.reset();
+			return;
+		}
+		m_BenchmarkImportTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - importStart).count();
+
+		m_BenchmarkModel = std::make_unique<ge::Model>(std::move(data));
+		m_BenchmarkDrawTime = 0.0f;
+	}
+
 	void setupCube()
 	{
 		m_CubeVA.reset(ge::VertexArray::Create());
@@ -515,7 +594,9 @@ private:
 	// General Variables
 	ge::ShaderLibrary m_ShaderLibrary;					// Library for shader files
 
-	ge::Ref<ge::Texture2D> m_Texture, m_BlendTexture, m_SpecularMap;	// Texture files
+	ge::Ref<ge::Texture2D> m_Texture, m_SpecularMap;				// Texture files
+	ge::AssetHandle<ge::Texture2D> m_BlendTexture;					// Loaded in the background
+	ge::Ref<ge::Material> m_PbrMaterial, m_LampMaterial;				// Materials for the 3D scene
 
 	float m_TotalTime = 0.0f;							// Total time passed in application life time (mod 2pi)
 
@@ -525,7 +606,6 @@ private:
 	ge::Ref<ge::Shader> m_Shader;					// Basic shader test
 	ge::Ref<ge::VertexArray> m_VertexArray;			// Basic vertex array for traingle
 
-	ge::Ref<ge::Shader> m_FlatColorShader;			// Flat color shader
 	ge::Ref<ge::VertexArray> m_SquareVA;			// Vertex array for square
 
 	glm::vec3 m_ColorA = { 0.9f, 1.0f, 0.8f };	// Color
@@ -537,15 +617,24 @@ private:
 	ge::PerspectiveCameraController m_PerspectiveCameraController;	// Perspective Camera Controller
 
 	ge::Ref<ge::VertexArray> m_PbrVA, m_CubeVA, m_QuadVA;
+	ge::BoundingSphere m_SphereBounds = { glm::vec3(0.0f), 1.0f };		// Unit sphere of m_PbrVA, for culling
+	std::vector<glm::vec3> m_OccluderPositions;						// Coarse unit sphere drawn by the occlusion culler
+	std::vector<uint32_t> m_OccluderIndices;
 
 	//ge::Ref<ge::Texture2D> m_Albedo, m_Normal, m_Metallic, m_Roughness, m_Ao;
 
 	std::vector<glm::vec3> m_LightPositions;
 	std::vector<glm::vec3> m_LightColors;
 
-	ge::Ref<ge::Framebuffer> m_Framebuffer;
-
-	ge::Model m_Model;								// Model to be rendered
+	// Large model benchmark
+	std::string m_BenchmarkPath = "assets/cerberus/Cerberus_LP.FBX";
+	ge::Scope<ge::Model> m_BenchmarkModel;			// Loaded from the settings window
+	ge::Ref<ge::Shader> m_ModelShader;
+	ge::RVec3 m_BenchmarkPosition = { 0.0f, 8.0f, 0.0f };
+	float m_BenchmarkScale = 0.05f;
+	bool m_BenchmarkPacked = false;
+	float m_BenchmarkImportTime = 0.0f;				// Milliseconds in Model::Import
+	float m_BenchmarkDrawTime = 0.0f;				// Milliseconds issuing Model::Draw, smoothed
 
 	unsigned int m_IndexCount;
 	int m_Rows = 7;
@@ -569,6 +658,9 @@ class Sandbox : public ge::Application
 {
 public:
 	Sandbox() {
+		if (ge::Renderer::GetAPI() == ge::RendererAPI::API::Software)
+			RegisterSoftwarePrograms();
+
 		PushLayer(new ExampleLayer());
 	}
 
@@ -0,0 +1,162 @@
+// C++ versions of the sandbox shaders for the software renderer
+
+#include "SoftwarePrograms.h"
+
+#include "GameEngine/Core/Application.h"
+#include "GameEngine/Core/Log.h"
+#include "GameEngine/Renderer/Renderer.h"
+#include "GameEngine/Renderer/RenderQueue.h"
+#include "Platform/Software/SoftwareShader.h"
+
+// std140 layouts of the blocks the renderer fills
+struct CameraBlock
+{
+	glm::mat4 ViewProjection;
+	glm::mat4 View;
+	glm::mat4 Projection;
+	glm::vec4 Position;
+};
+
+struct LightsBlock
+{
+	glm::vec4 Positions[ge::Renderer::MaxLights];
+	glm::vec4 Colors[ge::Renderer::MaxLights];
+	int Count;
+};
+
+static const float PI = 3.14159265359f;
+
+static const CameraBlock& GetCamera(const ge::SoftwareShader& shader)
+{
+	static const CameraBlock empty = {};
+	const void* block = shader.GetUniformBlock(ge::UniformBlock::Camera);
+	return block ? *(const CameraBlock*)block : empty;
+}
+
+// Same functions as PBR1.glsl
+static float DistributionGGX(const glm::vec3& N, const glm::vec3& H, float roughness)
+{
+	float a = roughness * roughness;
+	float a2 = a * a;
+	float NdotH = glm::max(glm::dot(N, H), 0.0f);
+	float denom = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+	return a2 / (PI * denom * denom);
+}
+
+static float GeometrySchlickGGX(float NdotV, float roughness)
+{
+	float r = roughness + 1.0f;
+	float k = (r * r) / 8.0f;
+	return NdotV / (NdotV * (1.0f - k) + k);
+}
+
+static glm::vec3 FresnelSchlick(float cosTheta, const glm::vec3& F0)
+{
+	cosTheta = glm::min(cosTheta, 1.0f);
+	return F0 + (glm::vec3(1.0f) - F0) * std::pow(1.0f - cosTheta, 5.0f);
+}
+
+void RegisterSoftwarePrograms()
+{
+	static const ge::UniformID s_MetallicID("u_Metallic");
+	static const ge::UniformID s_RoughnessID("u_Roughness");
+	static const ge::UniformID s_AoID("u_Ao");
+	static const ge::UniformID s_TextureID("u_Texture");
+	static const ge::UniformID s_TransformID("u_Transform");
+	static const ge::UniformID s_ViewProjectionID("u_ViewProjection");
+	static const ge::UniformID s_LightColorID("u_LightColor");
+
+	// PBR1.glsl, the material uniforms are read once per vertex and passed on with the varyings
+	ge::SoftwareProgram pbr;
+	pbr.VaryingCount = 5;
+	pbr.Instanced = true;
+	pbr.Vertex = [](const ge::SoftwareShader& shader, const glm::vec4* attributes, ge::SoftwareVertex& vertex)
+	{
+		const uint32_t instance = ge::InstanceData::FirstAttributeIndex;
+		const glm::mat4 transform(attributes[instance], attributes[instance + 1], attributes[instance + 2], attributes[instance + 3]);
+		const glm::vec3 worldPosition = glm::vec3(transform * glm::vec4(glm::vec3(attributes[0]), 1.0f));
+
+		vertex.Varyings[0] = glm::vec4(attributes[1].x, attributes[1].y, shader.GetFloat(s_MetallicID), shader.GetFloat(s_RoughnessID));
+		vertex.Varyings[1] = glm::vec4(worldPosition, 1.0f);
+		vertex.Varyings[2] = glm::vec4(glm::mat3(transform) * glm::vec3(attributes[2]), 0.0f);
+		vertex.Varyings[3] = glm::vec4(glm::vec3(attributes[instance + 4]), shader.GetFloat(s_AoID));
+		vertex.Varyings[4] = glm::vec4(glm::vec3(attributes[instance + 5]), (float)shader.GetInt(s_TextureID));
+		vertex.Position = GetCamera(shader).ViewProjection * glm::vec4(worldPosition, 1.0f);
+	};
+	pbr.Pixel = [](const ge::SoftwareShader& shader, const glm::vec4* varyings, glm::vec4& color)
+	{
+		const glm::vec3 worldPosition = glm::vec3(varyings[1]);
+		const glm::vec3 albedo = glm::vec3(varyings[3]);
+		const glm::vec3 albedoB = glm::vec3(varyings[4]);
+		const float metallic = varyings[0].z;
+		const float roughness = varyings[0].w;
+		const float ao = varyings[3].w;
+
+		const glm::vec3 N = glm::normalize(glm::vec3(varyings[2]));
+		const glm::vec3 V = glm::normalize(glm::vec3(GetCamera(shader).Position) - worldPosition);
+		const glm::vec3 F0 = glm::mix(glm::vec3(0.04f), albedo, metallic);
+
+		glm::vec3 Lo(0.0f);
+		if (const LightsBlock* lights = (const LightsBlock*)shader.GetUniformBlock(ge::UniformBlock::Lights))
+		{
+			for (int i = 0; i < lights->Count && i < (int)ge::Renderer::MaxLights; i++)
+			{
+				const glm::vec3 toLight = glm::vec3(lights->Positions[i]) - worldPosition;
+				const glm::vec3 L = glm::normalize(toLight);
+				const glm::vec3 H = glm::normalize(V + L);
+				const float distance = glm::length(toLight);
+				const glm::vec3 radiance = glm::vec3(lights->Colors[i]) * (1.0f / (distance * distance));
+
+				const float NdotV = glm::max(glm::dot(N, V), 0.0f);
+				const float NdotL = glm::max(glm::dot(N, L), 0.0f);
+				const float NDF = DistributionGGX(N, H, roughness);
+				const float G = GeometrySchlickGGX(NdotV, roughness) * GeometrySchlickGGX(NdotL, roughness);
+				const glm::vec3 F = FresnelSchlick(glm::max(glm::dot(H, V), 0.0f), F0);
+
+				const glm::vec3 kD = (glm::vec3(1.0f) - F) * (1.0f - metallic);
+				const glm::vec3 specular = F * (NDF * G / glm::max(4.0f * NdotV * NdotL, 0.001f));
+				Lo += (kD * albedo / PI + specular) * radiance * NdotL;
+			}
+		}
+
+		const glm::vec4 textureColor = shader.Sample((uint32_t)(varyings[4].w + 0.5f), glm::vec3(varyings[0].x, varyings[0].y, 0.0f));
+		const glm::vec3 ambient = 0.5f * (textureColor.r > 0.5f ? albedo : albedoB) * ao;
+
+		glm::vec3 result = ambient + Lo;
+		result = result / (result + glm::vec3(1.0f));							// Reinhard tone mapping
+		result = glm::pow(result, glm::vec3(1.0f / 2.2f));						// Gamma correction
+		color = glm::vec4(result, 1.0f);
+		return true;
+	};
+	ge::SoftwareShader::Register("PBR1", pbr);
+
+	// Lamp.glsl
+	ge::SoftwareProgram lamp;
+	lamp.VaryingCount = 1;
+	lamp.Vertex = [](const ge::SoftwareShader& shader, const glm::vec4* attributes, ge::SoftwareVertex& vertex)
+	{
+		vertex.Position = GetCamera(shader).ViewProjection * shader.GetMat4(s_TransformID) * glm::vec4(glm::vec3(attributes[0]), 1.0f);
+		vertex.Varyings[0] = glm::vec4(shader.GetFloat3(s_LightColorID), 1.0f);
+	};
+	lamp.Pixel = [](const ge::SoftwareShader& shader, const glm::vec4* varyings, glm::vec4& color)
+	{
+		color = varyings[0];
+		return true;
+	};
+	ge::SoftwareShader::Register("Lamp", lamp);
+
+	// Inline shader of the 2D scene
+	ge::SoftwareProgram vertexPosColor;
+	vertexPosColor.VaryingCount = 1;
+	vertexPosColor.Vertex = [](const ge::SoftwareShader& shader, const glm::vec4* attributes, ge::SoftwareVertex& vertex)
+	{
+		vertex.Position = shader.GetMat4(s_ViewProjectionID) * shader.GetMat4(s_TransformID) * glm::vec4(glm::vec3(attributes[0]), 1.0f);
+		vertex.Varyings[0] = attributes[1];
+	};
+	vertexPosColor.Pixel = [](const ge::SoftwareShader& shader, const glm::vec4* varyings, glm::vec4& color)
+	{
+		color = varyings[0];
+		return true;
+	};
+	ge::SoftwareShader::Register("VertexPosColor", vertexPosColor);
+}
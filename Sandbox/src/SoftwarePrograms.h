@@ -0,0 +1,6 @@
+// C++ versions of the sandbox shaders for the software renderer
+
+#pragma once
+
+// Has to run before the shaders are loaded
+void RegisterSoftwarePrograms();
@@ -90,6 +90,13 @@ project "Game-Engine"
 			"GLFW_INCLUDE_NONE"
 		}
 
+	filter "system:linux"
+		defines
+		{
+			"GE_PLATFORM_LINUX",
+			"GLFW_INCLUDE_NONE"
+		}
+
 	filter "configurations:Debug"
 		defines "GE_DEBUG"
 		runtime "Debug"
@@ -161,3 +168,121 @@ project "Sandbox"
 		runtime "Release"
 		optimize "on"
 
+
+project "EngineTests"
+	location "EngineTests"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	-- CPU side checks of the renderer, GPU objects are faked so no window is opened
+	files 
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp"
+	}
+
+	includedirs
+	{
+		"Game-Engine/vendor/spdlog/include",
+		"Game-Engine/src",
+		"Game-Engine/vendor",
+		"%{IncludeDir.glm}",
+		"Game-Engine/vendor/assimp/include",
+	}
+
+	links
+	{
+		"Game-Engine",
+		"Game-Engine/vendor/assimp/lib/assimp.lib"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+			"GE_PLATFORM_WINDOWS"
+		}
+
+	filter "configurations:Debug"
+		defines "GE_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+
+	filter "configurations:Release"
+		defines "GE_Release"
+		runtime "Release"
+		optimize "on"
+
+
+	filter "configurations:Dist"
+		defines "GE_DIST"
+		runtime "Release"
+		optimize "on"
+
+project "MathTests"
+	location "MathTests"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	-- Only the header-only math library and the logger, so no OpenGL or window is needed
+	files 
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp",
+		"Game-Engine/src/GameEngine/Core/Log.cpp"
+	}
+
+	includedirs
+	{
+		"Game-Engine/vendor/spdlog/include",
+		"Game-Engine/src",
+		"%{IncludeDir.glm}"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+			"GE_PLATFORM_WINDOWS"
+		}
+
+	filter "system:linux"
+		defines
+		{
+			"GE_PLATFORM_LINUX"
+		}
+
+		links
+		{
+			"pthread"
+		}
+
+	filter "configurations:Debug"
+		defines "GE_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+
+	filter "configurations:Release"
+		defines "GE_Release"
+		runtime "Release"
+		optimize "on"
+
+
+	filter "configurations:Dist"
+		defines "GE_DIST"
+		runtime "Release"
+		optimize "on"